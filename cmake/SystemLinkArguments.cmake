@@ -0,0 +1,55 @@
+# Asks the C compiler driver for the linker command line of a dynamic executable, so that the compiler can link with
+# LLD without starting the driver on every run. The arguments before and after the object files are stored as a list of
+# C string literals, e.g. "-pie", "/usr/lib/Scrt1.o". The variables are empty if the driver output could not be parsed.
+function(system_link_arguments BEFORE_VAR AFTER_VAR)
+    set(probe_object wirthx_link_probe.o)
+    execute_process(
+            COMMAND ${CMAKE_C_COMPILER} "-###" ${ARGN} ${probe_object} -o wirthx_link_probe
+            ERROR_VARIABLE driver_output
+            OUTPUT_QUIET
+            RESULT_VARIABLE driver_result)
+    set(${BEFORE_VAR} "" PARENT_SCOPE)
+    set(${AFTER_VAR} "" PARENT_SCOPE)
+    if (NOT driver_result EQUAL 0)
+        return()
+    endif ()
+
+    # only the linker command sets the dynamic linker
+    string(REPLACE "\n" ";" driver_lines "${driver_output}")
+    set(link_line "")
+    foreach (line IN LISTS driver_lines)
+        if (line MATCHES "dynamic-linker" AND line MATCHES "${probe_object}")
+            set(link_line "${line}")
+        endif ()
+    endforeach ()
+    separate_arguments(link_arguments UNIX_COMMAND "${link_line}")
+    if (NOT link_arguments)
+        return()
+    endif ()
+    # the first argument is the linker itself
+    list(REMOVE_AT link_arguments 0)
+
+    set(before "")
+    set(after "")
+    set(found_object FALSE)
+    set(skip_next FALSE)
+    foreach (argument IN LISTS link_arguments)
+        if (skip_next)
+            set(skip_next FALSE)
+        elseif (argument STREQUAL "-o" OR argument STREQUAL "-plugin")
+            set(skip_next TRUE)
+        elseif (argument MATCHES "^-plugin-opt=")
+            # lto plugin options of the gcc driver, lld runs lto itself
+        elseif (argument STREQUAL probe_object)
+            set(found_object TRUE)
+        elseif (found_object)
+            string(APPEND after "\"${argument}\", ")
+        else ()
+            string(APPEND before "\"${argument}\", ")
+        endif ()
+    endforeach ()
+    if (found_object)
+        set(${BEFORE_VAR} "${before}" PARENT_SCOPE)
+        set(${AFTER_VAR} "${after}" PARENT_SCOPE)
+    endif ()
+endfunction()
@@ -1,10 +1,10 @@
-#include <cassert>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include "Lexer.h"
 #include "Parser.h"
+#include "compiler/CompileServer.h"
 #include "compiler/Compiler.h"
 #include "config.h"
 #include "lsp/LanguageServer.h"
@@ -16,11 +16,23 @@ void printHelp(const std::string &program)
     std::cout << "Usage: " + program + " [options] file...\n";
     std::cout << "Options:\n";
     std::cout << "  --run\t\t\tRuns the compiled program\n";
-    std::cout << "  --debug\t\tCreates a debug build\n";
-    std::cout << "  --release\t\tCreates a release build\n";
+    std::cout << "  --jit\t\t\tRuns the program in memory without creating an executable (not on windows)\n";
+    std::cout << "  --incremental\t\tCompiles every unit separately and only rebuilds changed units\n";
+    std::cout << "  -j <count>\t\tLexes very large files and emits the machine code on the given number of threads\n";
+    std::cout << "  --build-rtl\t\tPrecompiles the units of the rtl into bitcode files\n";
+    std::cout << "  --debug\t\tCreates a debug build (same as -O0)\n";
+    std::cout << "  --release\t\tCreates a release build (same as -O2)\n";
+    std::cout << "  -O0, -O1, -O2, -O3\tSets the optimization level\n";
+    std::cout << "  -Os\t\t\tOptimizes for code size\n";
+    std::cout << "  --march=native\t\tGenerates code for the cpu of the host\n";
+    std::cout << "  --mcpu=<name>\t\tGenerates code for the given cpu\n";
+    std::cout << "  --mattr=<list>\t\tEnables (+feature) or disables (-feature) target features\n";
     std::cout << "  --rtl\t\t\tsets the path for the rtl (run time library)\n";
     std::cout << "  --output\t\tsets the output / build directory\n";
-    std::cout << "  --llvm-ir\t\tOutputs the LLVM-IR to the standard error output\n";
+    std::cout << "  --server <socket>\tRuns the compiler as a server listening on the local socket\n";
+    std::cout << "  --connect <socket>\tSends the compile request to the compiler server on the socket\n";
+    std::cout << "  --cache-dir <path>\tCaches the interfaces of the units in the directory\n";
+    std::cout << "  --llvm-ir\t\tOutputs the LLVM-IR to the standard output\n";
     std::cout << "  --help\t\tOutputs the program help\n";
     std::cout << "  --version\t\tPrints the current version of the compiler\n";
 }
@@ -34,6 +46,7 @@ int main(int args, char **argv)
     }
 
     auto program = argList[0];
+    const std::vector<std::string> arguments(argList.begin() + 1, argList.end());
 
     if (argList.size() == 2)
     {
@@ -62,6 +75,21 @@ int main(int args, char **argv)
         return 0;
     }
 
+    if (!options.serverSocket.empty())
+    {
+        return run_compile_server(options);
+    }
+    if (!options.connectSocket.empty())
+    {
+        return run_compile_client(options, arguments);
+    }
+
+    if (options.option == CompileOption::BUILD_RTL)
+    {
+        init_compiler();
+        return build_rtl(options, std::cerr, std::cout) ? 0 : 1;
+    }
+
     std::ifstream file;
     std::istringstream is;
     std::string s;
@@ -82,10 +110,12 @@ int main(int args, char **argv)
     switch (options.option)
     {
         case CompileOption::COMPILE:
-            compile_file(options, file_path, std::cout, std::cout);
-            break;
+            return compile_file(options, file_path, std::cout, std::cout, std::cout) ? 0 : 1;
         case CompileOption::JIT:
-            assert(false && "JIT compiler is not implemented yet.");
+            return jit_file(options, file_path, std::cout, std::cout, std::cout) ? 0 : 1;
+        case CompileOption::BUILD_RTL:
+            // handled before the input file is checked
+            break;
     }
     return 0;
 }
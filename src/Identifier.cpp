@@ -0,0 +1,182 @@
+#include "Identifier.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    constexpr char foldCase(const char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c; }
+
+    // folds the upper case letters of 8 characters at once
+    constexpr uint64_t foldWord(const uint64_t word)
+    {
+        constexpr uint64_t ones = 0x0101010101010101ull;
+        const uint64_t ascii = word & (0x7F * ones);
+        const uint64_t aboveZ = ascii + (0x7F - 'Z') * ones;
+        const uint64_t fromA = ascii + (0x80 - 'A') * ones;
+        const uint64_t upper = (fromA ^ aboveZ) & ~word & (0x80 * ones);
+        return word | (upper >> 2);
+    }
+
+    uint64_t loadWord(const std::string_view name, const size_t offset)
+    {
+        uint64_t word = 0;
+        if (offset + sizeof(word) <= name.size())
+        {
+            std::memcpy(&word, name.data() + offset, sizeof(word));
+            return word;
+        }
+        for (size_t i = offset; i < name.size(); ++i)
+        {
+            word |= static_cast<uint64_t>(static_cast<unsigned char>(name[i])) << (8 * (i - offset));
+        }
+        return word;
+    }
+
+    // the keys of the table are already folded, the names which are looked up are folded while they are hashed
+    struct FoldedHash
+    {
+        size_t operator()(const std::string_view name) const
+        {
+            constexpr uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+            uint64_t hash = name.size() * multiplier;
+            for (size_t i = 0; i < name.size(); i += sizeof(uint64_t))
+            {
+                hash = (hash ^ foldWord(loadWord(name, i))) * multiplier;
+                hash ^= hash >> 32;
+            }
+            // a multiplication only moves the bits up, so the high bits are mixed into the low bits at the end
+            hash *= multiplier;
+            return hash ^ (hash >> 29);
+        }
+    };
+
+    struct FoldedEqual
+    {
+        bool operator()(const std::string_view a, const std::string_view b) const
+        {
+            if (a.size() != b.size())
+                return false;
+            for (size_t i = 0; i < a.size(); i += sizeof(uint64_t))
+            {
+                if (foldWord(loadWord(a, i)) != foldWord(loadWord(b, i)))
+                    return false;
+            }
+            return true;
+        }
+    };
+
+    static_assert(foldWord(0x5A41407B615B7A00ull) == 0x7A61407B615B7A00ull);
+
+    /**
+     * the names are never removed and their characters are stored in blocks which are never moved, so the views in
+     * the index and the views returned by name() stay valid. Most identifiers of a file were seen before, so the
+     * lookups only take a shared lock.
+     */
+    class IdentifierTable
+    {
+        static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+        std::shared_mutex m_mutex;
+        std::vector<std::unique_ptr<char[]>> m_blocks;
+        size_t m_blockUsed = BLOCK_SIZE;
+        std::vector<std::string_view> m_names;
+        std::unordered_map<std::string_view, Identifier, FoldedHash, FoldedEqual> m_index;
+
+        std::string_view store(const std::string_view name)
+        {
+            if (name.size() > BLOCK_SIZE - m_blockUsed)
+            {
+                m_blocks.push_back(std::make_unique<char[]>(std::max(BLOCK_SIZE, name.size())));
+                m_blockUsed = 0;
+            }
+            char *folded = m_blocks.back().get() + m_blockUsed;
+            std::ranges::transform(name, folded, foldCase);
+            m_blockUsed += name.size();
+            return {folded, name.size()};
+        }
+
+    public:
+        IdentifierTable()
+        {
+            m_names.emplace_back();
+            m_index.reserve(4096);
+        }
+
+        Identifier intern(const std::string_view name)
+        {
+            // the recently used names of a thread are looked up without taking the lock
+            struct RecentName
+            {
+                std::string_view name;
+                Identifier identifier = Identifier::NONE;
+            };
+            thread_local std::array<RecentName, 1024> recentNames;
+            auto &recent = recentNames[FoldedHash{}(name) % recentNames.size()];
+            if (recent.identifier != Identifier::NONE && FoldedEqual{}(recent.name, name))
+            {
+                return recent.identifier;
+            }
+
+            {
+                std::shared_lock lock(m_mutex);
+                if (const auto it = m_index.find(name); it != m_index.end())
+                {
+                    recent = {it->first, it->second};
+                    return it->second;
+                }
+            }
+            std::unique_lock lock(m_mutex);
+            // another thread may have added the name after the shared lock was released
+            if (const auto it = m_index.find(name); it != m_index.end())
+            {
+                recent = {it->first, it->second};
+                return it->second;
+            }
+            if (m_names.size() == Identifiers::MAX_IDENTIFIERS)
+            {
+                throw std::length_error("too many identifiers");
+            }
+            const auto identifier = static_cast<Identifier>(m_names.size());
+            m_names.push_back(store(name));
+            m_index.emplace(m_names.back(), identifier);
+            recent = {m_names.back(), identifier};
+            return identifier;
+        }
+
+        Identifier find(const std::string_view name)
+        {
+            std::shared_lock lock(m_mutex);
+            if (const auto it = m_index.find(name); it != m_index.end())
+            {
+                return it->second;
+            }
+            return Identifier::NONE;
+        }
+
+        std::string_view name(const Identifier identifier)
+        {
+            std::shared_lock lock(m_mutex);
+            return m_names[static_cast<size_t>(identifier)];
+        }
+    };
+
+    IdentifierTable &identifierTable()
+    {
+        static IdentifierTable table;
+        return table;
+    }
+} // namespace
+
+Identifier Identifiers::intern(const std::string_view name) { return identifierTable().intern(name); }
+
+Identifier Identifiers::find(const std::string_view name) { return identifierTable().find(name); }
+
+std::string_view Identifiers::name(const Identifier identifier) { return identifierTable().name(identifier); }
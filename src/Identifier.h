@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * id of an interned identifier. Pascal identifiers are case insensitive, so every spelling of a name has the same id.
+ */
+enum class Identifier : uint32_t
+{
+    NONE = 0
+};
+
+/**
+ * process wide table of the identifiers of all parsed files.
+ * A name is folded to lower case once when it is interned, e.g. by the lexer, so the parser and the code generator
+ * compare and hash the ids instead of comparing the names character by character.
+ */
+class Identifiers
+{
+public:
+    // the tokens store the ids in ID_BITS bits next to their type
+    static constexpr uint32_t ID_BITS = 24;
+    static constexpr uint32_t MAX_IDENTIFIERS = 1u << ID_BITS;
+
+    /**
+     * returns the id of the name and adds the name to the table if it is not known yet.
+     * Throws std::length_error if the table already holds MAX_IDENTIFIERS names.
+     */
+    static Identifier intern(std::string_view name);
+    /**
+     * returns the id of the name or NONE if it was never interned, the table is not changed.
+     */
+    [[nodiscard]] static Identifier find(std::string_view name);
+    /**
+     * returns the lower case spelling of the identifier.
+     */
+    [[nodiscard]] static std::string_view name(Identifier identifier);
+};
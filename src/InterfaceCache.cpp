@@ -0,0 +1,321 @@
+#include "InterfaceCache.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include "ast/types/FileType.h"
+#include "ast/types/StringType.h"
+#include "llvm/Support/xxhash.h"
+
+// bump when the layout of an entry or the descriptions of the types change
+static constexpr uint32_t CACHE_VERSION = 1;
+static constexpr std::string_view CACHE_MAGIC = "wirthx-interface";
+
+InterfaceCache::InterfaceCache(std::filesystem::path directory) : m_directory(std::move(directory)) {}
+
+bool InterfaceCache::isEnabled() const { return !m_directory.empty(); }
+
+std::filesystem::path InterfaceCache::entryPath(const std::string &filename, const std::string_view source,
+                                                const MacroMap &definitions, const std::string &importContext) const
+{
+    // the order of an unordered_map is not stable, so the definitions are sorted for the key
+    std::vector<std::string> defines;
+    for (auto &[name, value]: definitions)
+    {
+        defines.push_back(name + (value ? "=1" : "=0"));
+    }
+    std::ranges::sort(defines);
+
+    std::string key = std::to_string(llvm::xxHash64(llvm::StringRef(source.data(), source.size())));
+    for (auto &define: defines)
+    {
+        key += ";" + define;
+    }
+    key += ";" + importContext;
+    std::stringstream entryName;
+    entryName << std::filesystem::path(filename).stem().string() << "." << std::hex << llvm::xxHash64(key)
+              << ".interface";
+    return m_directory / entryName.str();
+}
+
+std::optional<UnitInterface> InterfaceCache::load(const std::string &filename, const std::string_view source,
+                                                  const MacroMap &definitions, const std::string &importContext) const
+{
+    if (!isEnabled())
+    {
+        return std::nullopt;
+    }
+    std::ifstream file(entryPath(filename, source, definitions, importContext));
+    if (!file.is_open())
+    {
+        return std::nullopt;
+    }
+
+    std::string magic;
+    uint32_t version = 0;
+    UnitInterface interface;
+    file >> magic >> version;
+    if (magic != CACHE_MAGIC || version != CACHE_VERSION)
+    {
+        return std::nullopt;
+    }
+    // one declaration per line, the fields of a record and the params of a function follow their declaration
+    for (std::string kind; file >> kind;)
+    {
+        if (kind == "unit")
+        {
+            file >> std::quoted(interface.unitName) >> interface.byteOffset >> interface.numBytes;
+        }
+        else if (kind == "import")
+        {
+            auto &import = interface.imports.emplace_back();
+            file >> std::quoted(import.filename) >> import.includeSystem;
+        }
+        else if (kind == "type")
+        {
+            auto &type = interface.types.emplace_back();
+            file >> std::quoted(type.name) >> std::quoted(type.type);
+        }
+        else if (kind == "record")
+        {
+            auto &type = interface.types.emplace_back();
+            size_t fieldCount = 0;
+            file >> std::quoted(type.name) >> fieldCount;
+            for (size_t i = 0; i < fieldCount && file; ++i)
+            {
+                auto &field = type.fields.emplace_back();
+                file >> kind >> std::quoted(field.name) >> std::quoted(field.type);
+            }
+        }
+        else if (kind == "function")
+        {
+            auto &function = interface.functions.emplace_back();
+            size_t paramCount = 0;
+            file >> std::quoted(function.name) >> function.byteOffset >> function.numBytes >>
+                    std::quoted(function.externalName) >> std::quoted(function.libName) >>
+                    std::quoted(function.unitName) >> function.isProcedure >> function.isInline >>
+                    std::quoted(function.returnType) >> paramCount;
+            for (size_t i = 0; i < paramCount && file; ++i)
+            {
+                auto &param = function.params.emplace_back();
+                file >> kind >> std::quoted(param.name) >> param.isReference >> std::quoted(param.type);
+            }
+        }
+        else
+        {
+            return std::nullopt;
+        }
+        if (file.fail())
+        {
+            return std::nullopt;
+        }
+    }
+
+    // the locations of the names point into the source of the unit
+    const auto isInSource = [&source](const uint32_t byteOffset, const uint32_t numBytes)
+    { return static_cast<size_t>(byteOffset) + numBytes <= source.size(); };
+    if (interface.unitName.empty() || !isInSource(interface.byteOffset, interface.numBytes) ||
+        !std::ranges::all_of(interface.functions, [&](const UnitInterface::Function &function)
+                             { return isInSource(function.byteOffset, function.numBytes); }))
+    {
+        return std::nullopt;
+    }
+    return interface;
+}
+
+void InterfaceCache::store(const UnitInterface &interface, const std::string &filename, const std::string_view source,
+                           const MacroMap &definitions, const std::string &importContext) const
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    if (error)
+    {
+        return;
+    }
+
+    // write to a temporary file first, so a concurrent compiler never reads a partial entry
+    const auto path = entryPath(filename, source, definitions, importContext);
+    auto temporaryPath = path;
+    temporaryPath += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::trunc);
+        if (!file.is_open())
+        {
+            return;
+        }
+        file << CACHE_MAGIC << ' ' << CACHE_VERSION << '\n';
+        file << "unit " << std::quoted(interface.unitName) << ' ' << interface.byteOffset << ' ' << interface.numBytes
+             << '\n';
+        for (auto &import: interface.imports)
+        {
+            file << "import " << std::quoted(import.filename) << ' ' << import.includeSystem << '\n';
+        }
+        for (auto &type: interface.types)
+        {
+            if (!type.type.empty())
+            {
+                file << "type " << std::quoted(type.name) << ' ' << std::quoted(type.type) << '\n';
+                continue;
+            }
+            file << "record " << std::quoted(type.name) << ' ' << type.fields.size() << '\n';
+            for (auto &field: type.fields)
+            {
+                file << "field " << std::quoted(field.name) << ' ' << std::quoted(field.type) << '\n';
+            }
+        }
+        for (auto &function: interface.functions)
+        {
+            file << "function " << std::quoted(function.name) << ' ' << function.byteOffset << ' ' << function.numBytes
+                 << ' ' << std::quoted(function.externalName) << ' ' << std::quoted(function.libName) << ' '
+                 << std::quoted(function.unitName) << ' ' << function.isProcedure << ' ' << function.isInline << ' '
+                 << std::quoted(function.returnType) << ' ' << function.params.size() << '\n';
+            for (auto &param: function.params)
+            {
+                file << "param " << std::quoted(param.name) << ' ' << param.isReference << ' '
+                     << std::quoted(param.type) << '\n';
+            }
+        }
+        if (!file)
+        {
+            file.close();
+            std::filesystem::remove(temporaryPath, error);
+            return;
+        }
+    }
+    std::filesystem::rename(temporaryPath, path, error);
+}
+
+std::optional<std::string> InterfaceCache::describeType(const std::shared_ptr<VariableType> &type)
+{
+    if (type == nullptr)
+    {
+        return std::nullopt;
+    }
+    switch (type->kind())
+    {
+        case TypeKind::INTEGER:
+            return "integer " + std::to_string(typeCast<IntegerType>(type)->length);
+        case TypeKind::STRING:
+            return "string";
+        case TypeKind::FILE:
+            return "file";
+        case TypeKind::RECORD:
+            return "record " + type->typeName;
+        case TypeKind::POINTER:
+        {
+            const auto pointer = typeCast<PointerType>(type);
+            if (pointer->pointerBase == nullptr)
+            {
+                return "unqual";
+            }
+            const auto base = describeType(pointer->pointerBase);
+            return base ? std::optional("pointer " + *base) : std::nullopt;
+        }
+        case TypeKind::ARRAY:
+        {
+            const auto array = typeCast<ArrayType>(type);
+            const auto base = describeType(array->arrayBase);
+            if (!base)
+            {
+                return std::nullopt;
+            }
+            if (array->isDynArray)
+            {
+                return "dynarray " + *base;
+            }
+            return "array " + std::to_string(array->low) + " " + std::to_string(array->high) + " " + *base;
+        }
+        case TypeKind::BASIC:
+            switch (type->baseType)
+            {
+                case VariableBaseType::Float:
+                    return "single";
+                case VariableBaseType::Double:
+                    return "double";
+                case VariableBaseType::Boolean:
+                    return "boolean";
+                case VariableBaseType::Pointer:
+                    return "rawpointer";
+                case VariableBaseType::Unknown:
+                    return "unknown";
+                default:
+                    return std::nullopt;
+            }
+    }
+    return std::nullopt;
+}
+
+static std::shared_ptr<VariableType>
+resolveTypeDescription(std::istream &description,
+                       const std::function<std::shared_ptr<VariableType>(Identifier)> &findRecord)
+{
+    std::string kind;
+    description >> kind;
+    if (kind == "integer")
+    {
+        size_t length = 0;
+        return description >> length ? VariableType::getInteger(length) : nullptr;
+    }
+    if (kind == "string")
+        return StringType::getString();
+    if (kind == "file")
+        return FileType::getFileType();
+    if (kind == "single")
+        return VariableType::getSingle();
+    if (kind == "double")
+        return VariableType::getDouble();
+    if (kind == "boolean")
+        return VariableType::getBoolean();
+    if (kind == "unknown")
+        return VariableType::getUnknown();
+    if (kind == "rawpointer")
+        return VariableType::getPointer();
+    if (kind == "unqual")
+        return PointerType::getUnqual();
+    if (kind == "record")
+    {
+        std::string name;
+        if (!(description >> name))
+            return nullptr;
+        const auto record = findRecord(Identifiers::intern(name));
+        return record && record->kind() == TypeKind::RECORD ? record : nullptr;
+    }
+    if (kind == "pointer")
+    {
+        const auto base = resolveTypeDescription(description, findRecord);
+        return base ? PointerType::getPointerTo(base) : nullptr;
+    }
+    if (kind == "dynarray")
+    {
+        const auto base = resolveTypeDescription(description, findRecord);
+        return base ? ArrayType::getDynArray(base) : nullptr;
+    }
+    if (kind == "array")
+    {
+        size_t low = 0;
+        size_t high = 0;
+        if (!(description >> low >> high))
+            return nullptr;
+        const auto base = resolveTypeDescription(description, findRecord);
+        return base ? ArrayType::getFixedArray(low, high, base) : nullptr;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<VariableType>
+InterfaceCache::resolveType(const std::string &description,
+                            const std::function<std::shared_ptr<VariableType>(Identifier)> &findRecord)
+{
+    std::istringstream stream(description);
+    auto type = resolveTypeDescription(stream, findRecord);
+    // the whole description has to be used
+    stream >> std::ws;
+    return stream.eof() ? type : nullptr;
+}
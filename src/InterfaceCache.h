@@ -0,0 +1,107 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Identifier.h"
+#include "MacroParser.h"
+#include "ast/types/VariableType.h"
+
+/**
+ * the declarations of a unit which its importers need: the units it imports, the types it declares and the signatures
+ * of its own functions. The bodies of the functions are not part of it.
+ * Types are stored as descriptions, see InterfaceCache::describeType.
+ */
+struct UnitInterface
+{
+    struct Import
+    {
+        std::string filename;
+        bool includeSystem = true;
+    };
+
+    struct Field
+    {
+        std::string name;
+        std::string type;
+    };
+
+    struct Type
+    {
+        std::string name;
+        // the description of the type, empty for a record which is declared with the type
+        std::string type;
+        std::vector<Field> fields;
+    };
+
+    struct Param
+    {
+        std::string name;
+        std::string type;
+        bool isReference = false;
+    };
+
+    struct Function
+    {
+        std::string name;
+        // the name token of the function in the source of the unit
+        uint32_t byteOffset = 0;
+        uint32_t numBytes = 0;
+        std::string externalName;
+        std::string libName;
+        std::string unitName;
+        bool isProcedure = false;
+        bool isInline = false;
+        // empty if the function has no return type
+        std::string returnType;
+        std::vector<Param> params;
+    };
+
+    std::string unitName;
+    uint32_t byteOffset = 0;
+    uint32_t numBytes = 0;
+    std::vector<Import> imports;
+    std::vector<Type> types;
+    std::vector<Function> functions;
+};
+
+/**
+ * on-disk cache of the interfaces of the imported units.
+ * An entry is keyed by a hash of the source of the unit, the macro definitions and the directories which the imports
+ * of the unit are resolved against, so it is only used for the same source parsed the same way.
+ */
+class InterfaceCache
+{
+    std::filesystem::path m_directory;
+
+    [[nodiscard]] std::filesystem::path entryPath(const std::string &filename, std::string_view source,
+                                                  const MacroMap &definitions, const std::string &importContext) const;
+
+public:
+    explicit InterfaceCache(std::filesystem::path directory);
+    ~InterfaceCache() = default;
+
+    [[nodiscard]] bool isEnabled() const;
+    [[nodiscard]] std::optional<UnitInterface> load(const std::string &filename, std::string_view source,
+                                                    const MacroMap &definitions,
+                                                    const std::string &importContext) const;
+    void store(const UnitInterface &interface, const std::string &filename, std::string_view source,
+               const MacroMap &definitions, const std::string &importContext) const;
+
+    /**
+     * describes a type by its structure, e.g. "array 0 9 integer 32", records are described by their name.
+     * Returns nothing for a type which can not be described.
+     */
+    static std::optional<std::string> describeType(const std::shared_ptr<VariableType> &type);
+    /**
+     * returns the type of the description, the interned types are looked up by their structure and the records by
+     * findRecord. Returns nullptr if the description is invalid or a record is not known.
+     */
+    static std::shared_ptr<VariableType>
+    resolveType(const std::string &description,
+                const std::function<std::shared_ptr<VariableType>(Identifier)> &findRecord);
+};
@@ -0,0 +1,215 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+enum class Keyword : uint8_t
+{
+    NONE,
+    PROGRAM,
+    UNIT,
+    USES,
+    BEGIN,
+    END,
+    PROCEDURE,
+    FUNCTION,
+    VAR,
+    IF,
+    THEN,
+    ELSE,
+    WHILE,
+    DO,
+    FOR,
+    TO,
+    BREAK,
+    REPEAT,
+    UNTIL,
+    TYPE,
+    ARRAY,
+    OF,
+    K_CONST,
+    K_TRUE,
+    K_FALSE,
+    AND,
+    OR,
+    NOT,
+    RECORD,
+    EXTERNAL,
+    NAME,
+    MOD,
+    INLINE,
+    IMPLEMENTATION,
+    INTERFACE,
+    FINALIZATION,
+    INITIALIZATION,
+    DIV,
+    DOWNTO,
+    FILE,
+    // keywords of the macros
+    IFDEF,
+    ENDIF,
+};
+
+namespace keywords
+{
+    struct KeywordEntry
+    {
+        std::string_view name;
+        Keyword keyword;
+    };
+
+    inline constexpr std::array<KeywordEntry, 39> LANGUAGE_KEYWORDS = {{
+            {"program", Keyword::PROGRAM},
+            {"unit", Keyword::UNIT},
+            {"uses", Keyword::USES},
+            {"begin", Keyword::BEGIN},
+            {"end", Keyword::END},
+            {"procedure", Keyword::PROCEDURE},
+            {"function", Keyword::FUNCTION},
+            {"var", Keyword::VAR},
+            {"if", Keyword::IF},
+            {"then", Keyword::THEN},
+            {"else", Keyword::ELSE},
+            {"while", Keyword::WHILE},
+            {"do", Keyword::DO},
+            {"for", Keyword::FOR},
+            {"to", Keyword::TO},
+            {"break", Keyword::BREAK},
+            {"repeat", Keyword::REPEAT},
+            {"until", Keyword::UNTIL},
+            {"type", Keyword::TYPE},
+            {"array", Keyword::ARRAY},
+            {"of", Keyword::OF},
+            {"const", Keyword::K_CONST},
+            {"true", Keyword::K_TRUE},
+            {"false", Keyword::K_FALSE},
+            {"and", Keyword::AND},
+            {"or", Keyword::OR},
+            {"not", Keyword::NOT},
+            {"record", Keyword::RECORD},
+            {"external", Keyword::EXTERNAL},
+            {"name", Keyword::NAME},
+            {"mod", Keyword::MOD},
+            {"inline", Keyword::INLINE},
+            {"implementation", Keyword::IMPLEMENTATION},
+            {"interface", Keyword::INTERFACE},
+            {"finalization", Keyword::FINALIZATION},
+            {"initialization", Keyword::INITIALIZATION},
+            {"div", Keyword::DIV},
+            {"downto", Keyword::DOWNTO},
+            {"file", Keyword::FILE},
+    }};
+
+    inline constexpr std::array<KeywordEntry, 3> MACRO_KEYWORDS = {{
+            {"ifdef", Keyword::IFDEF},
+            {"else", Keyword::ELSE},
+            {"endif", Keyword::ENDIF},
+    }};
+
+    // the keywords only consist of ascii letters, setting the case bit lowers letters and keeps them distinct
+    // from digits and '_'
+    constexpr char lower(const char value) { return static_cast<char>(value | 0x20); }
+
+    constexpr uint32_t hash(const std::string_view word, const uint32_t seed)
+    {
+        uint32_t result = seed ^ static_cast<uint32_t>(word.size());
+        for (const char value: word)
+        {
+            result = (result ^ static_cast<uint8_t>(lower(value))) * 16777619u;
+        }
+        return result;
+    }
+
+    /**
+     * collision free hash table of a keyword set, the seed of the hash function is searched at compile time.
+     */
+    template<size_t N>
+    struct PerfectHashTable
+    {
+        static constexpr size_t TABLE_SIZE = 256;
+
+        uint32_t seed = 0;
+        size_t minLength = 0;
+        size_t maxLength = 0;
+        // index + 1 of the keyword in the slot, 0 marks an empty slot
+        std::array<uint8_t, TABLE_SIZE> slots{};
+        std::array<KeywordEntry, N> entries{};
+
+        consteval explicit PerfectHashTable(const std::array<KeywordEntry, N> &keywords) : entries(keywords)
+        {
+            minLength = keywords[0].name.size();
+            maxLength = keywords[0].name.size();
+            for (const auto &entry: keywords)
+            {
+                minLength = std::min(minLength, entry.name.size());
+                maxLength = std::max(maxLength, entry.name.size());
+            }
+            for (seed = 1;; ++seed)
+            {
+                slots = {};
+                bool collision = false;
+                for (size_t i = 0; i < N && !collision; ++i)
+                {
+                    auto &slot = slots[hash(keywords[i].name, seed) % TABLE_SIZE];
+                    collision = slot != 0;
+                    slot = static_cast<uint8_t>(i + 1);
+                }
+                if (!collision)
+                    break;
+            }
+        }
+
+        [[nodiscard]] constexpr Keyword find(const std::string_view word) const
+        {
+            if (word.size() < minLength || word.size() > maxLength)
+                return Keyword::NONE;
+            const auto slot = slots[hash(word, seed) % TABLE_SIZE];
+            if (slot == 0)
+                return Keyword::NONE;
+            const auto &entry = entries[slot - 1];
+            if (entry.name.size() != word.size())
+                return Keyword::NONE;
+            for (size_t i = 0; i < word.size(); ++i)
+            {
+                if (lower(word[i]) != entry.name[i])
+                    return Keyword::NONE;
+            }
+            return entry.keyword;
+        }
+    };
+
+    inline constexpr PerfectHashTable LANGUAGE_TABLE{LANGUAGE_KEYWORDS};
+    inline constexpr PerfectHashTable MACRO_TABLE{MACRO_KEYWORDS};
+} // namespace keywords
+
+/**
+ * returns the keyword of the word, the comparison is case insensitive. Returns Keyword::NONE for other words.
+ */
+constexpr Keyword findKeyword(const std::string_view word) { return keywords::LANGUAGE_TABLE.find(word); }
+
+/**
+ * returns the macro keyword of the word, the comparison is case insensitive. Returns Keyword::NONE for other words.
+ */
+constexpr Keyword findMacroKeyword(const std::string_view word) { return keywords::MACRO_TABLE.find(word); }
+
+constexpr std::string_view keywordName(const Keyword keyword)
+{
+    for (const auto &entry: keywords::LANGUAGE_KEYWORDS)
+    {
+        if (entry.keyword == keyword)
+            return entry.name;
+    }
+    for (const auto &entry: keywords::MACRO_KEYWORDS)
+    {
+        if (entry.keyword == keyword)
+            return entry.name;
+    }
+    return "";
+}
+
+static_assert(findKeyword("Begin") == Keyword::BEGIN);
+static_assert(findKeyword("IMPLEMENTATION") == Keyword::IMPLEMENTATION);
+static_assert(findKeyword("beginning") == Keyword::NONE);
+static_assert(findKeyword("x") == Keyword::NONE);
+static_assert(findMacroKeyword("EndIf") == Keyword::ENDIF);
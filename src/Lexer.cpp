@@ -1,255 +1,318 @@
 #include "Lexer.h"
-#include <iostream>
-#include "compare.h"
-
-inline std::vector<std::string> possible_tokens = {"program",   "unit",         "uses",
-                                                   "begin",     "end",          "procedure",
-                                                   "function",  "var",          "if",
-                                                   "then",      "else",         "while",
-                                                   "do",        "for",          "to",
-                                                   "break",     "repeat",       "until",
-                                                   "type",      "array",        "of",
-                                                   "const",     "true",         "false",
-                                                   "and",       "or",           "not",
-                                                   "record",    "external",     "name",
-                                                   "mod",       "inline",       "implementation",
-                                                   "interface", "finalization", "initialization",
-                                                   "div",       "downto",       "file"};
-
-inline std::vector<std::string> macro_token{"ifdef", "else", "endif"};
+#include <algorithm>
+#include <future>
+#include "Keyword.h"
+#include "ScanKernels.h"
 
 Lexer::Lexer() {}
 
 Lexer::~Lexer() {}
 
+// the sources in the file table are followed by a '\0', so the lexer may look at the character after the end
+static char charAt(const std::string_view content, const size_t index) { return content.data()[index]; }
+
 constexpr bool validStartNameChar(const char value)
 {
     return (value >= 'A' && value <= 'Z') || (value >= 'a' && value <= 'z') || value == '_';
 }
 
-constexpr bool validNameChar(const char value) { return validStartNameChar(value) || (value >= '0' && value <= '9'); }
-
 std::vector<Token> Lexer::tokenize(const std::string &filename, const std::string &content)
 {
-    std::vector<Token> tokens;
+    const auto file = SourceFiles::add(filename, content);
+    return tokenize(file.fileId());
+}
 
-    size_t row = 1;
-    size_t column = 1;
-    auto contentPtr = std::make_shared<std::string>(content);
-    bool parseMacros = false;
-    for (size_t i = 0; i < content.size(); ++i)
+std::vector<Token> Lexer::tokenize(const uint32_t fileId)
+{
+    LexerSource source(fileId);
+    std::vector<Token> tokens;
+    do
     {
+        tokens.push_back(source.nextToken());
+    }
+    while (tokens.back().tokenType() != TokenType::T_EOF);
+    return tokens;
+}
 
-        auto ch = content[i];
-        size_t endPosition = i;
+namespace
+{
+    /**
+     * the tokens of a chunk of a file, they are lexed on the assumption that the chunk does not start inside of a
+     * comment, a string or a macro.
+     */
+    struct LexedChunk
+    {
+        size_t start = 0;
+        size_t end = 0;
+        std::vector<Token> tokens;
+        // the position of the lexer after every token
+        std::vector<uint32_t> positions;
+        // the state of the lexer after the chunk
+        size_t position = 0;
+        bool parseMacros = false;
+    };
+
+    // only the start and the end of a macro change the macro state of the lexer
+    bool parseMacrosAfter(const Token &token, const bool parseMacros)
+    {
+        if (token.tokenType() == TokenType::MACRO_START)
+            return true;
+        if (token.tokenType() == TokenType::MACRO_END)
+            return false;
+        return parseMacros;
+    }
 
-        bool found = (content[i] == '{' && content[i + 1] == '$');
-        if (found)
+    LexedChunk lexChunk(const uint32_t fileId, const size_t start, const size_t end)
+    {
+        LexedChunk chunk{.start = start, .end = end};
+        LexerSource source(fileId, start, end, false);
+        for (auto token = source.nextToken(); token.tokenType() != TokenType::T_EOF; token = source.nextToken())
         {
-            constexpr size_t offset = 2;
-            endPosition = i + 2;
-            SourceLocation source_location = {
-                    .filename = filename, .source = contentPtr, .byte_offset = i, .num_bytes = offset};
-            tokens.emplace_back(source_location, row, column, TokenType::MACRO_START);
-            i = endPosition - 1;
-            column += offset;
-            parseMacros = true;
-            continue;
+            chunk.tokens.push_back(token);
+            chunk.positions.push_back(static_cast<uint32_t>(source.position()));
         }
+        chunk.position = source.position();
+        chunk.parseMacros = source.parseMacros();
+        return chunk;
+    }
 
-        found = find_comment(content, i, &endPosition);
-        if (found)
+    /**
+     * lexes the chunk again from the state in which the previous chunk ended, e.g. inside of a comment.
+     * As soon as the lexer reaches the state it had after one of the speculative tokens, the following tokens are the
+     * same and are kept.
+     */
+    void relexChunk(const uint32_t fileId, LexedChunk &chunk, const size_t position, const bool parseMacros)
+    {
+        LexerSource source(fileId, position, chunk.end, parseMacros);
+        std::vector<Token> tokens;
+        size_t speculative = 0;
+        bool speculativeParseMacros = false;
+        for (auto token = source.nextToken(); token.tokenType() != TokenType::T_EOF; token = source.nextToken())
         {
-            // count lines
-            for (size_t start = i; start < endPosition; start++)
+            tokens.push_back(token);
+            while (speculative < chunk.tokens.size() && chunk.positions[speculative] < source.position())
             {
-                if (content[start] == '\n')
-                    row++;
+                speculativeParseMacros = parseMacrosAfter(chunk.tokens[speculative], speculativeParseMacros);
+                ++speculative;
+            }
+            if (speculative < chunk.tokens.size() && chunk.positions[speculative] == source.position() &&
+                parseMacrosAfter(chunk.tokens[speculative], speculativeParseMacros) == source.parseMacros())
+            {
+                tokens.insert(tokens.end(), chunk.tokens.begin() + static_cast<std::ptrdiff_t>(speculative) + 1,
+                              chunk.tokens.end());
+                chunk.tokens = std::move(tokens);
+                return;
             }
-            size_t offset = endPosition - i;
-            i = endPosition;
-            column += offset + 1;
-            continue;
         }
+        chunk.tokens = std::move(tokens);
+        chunk.position = source.position();
+        chunk.parseMacros = source.parseMacros();
+    }
+} // namespace
+
+std::vector<Token> Lexer::tokenize(const uint32_t fileId, const size_t chunkCount)
+{
+    const auto content = SourceFiles::source(fileId);
+    // the chunks start after a line break, so only comments, strings and macros can reach into the next chunk
+    std::vector<size_t> starts = {0};
+    for (size_t i = 1; i < chunkCount; ++i)
+    {
+        const size_t start = scanForChar(content, std::max(starts.back(), content.size() / chunkCount * i), '\n') + 1;
+        if (start < content.size())
+            starts.push_back(start);
+    }
+    if (starts.size() == 1)
+        return tokenize(fileId);
+
+    std::vector<std::future<LexedChunk>> futures;
+    for (size_t i = 0; i < starts.size(); ++i)
+    {
+        const size_t end = i + 1 < starts.size() ? starts[i + 1] : content.size();
+        futures.push_back(std::async(std::launch::async, lexChunk, fileId, starts[i], end));
+    }
+    std::vector<LexedChunk> chunks;
+    size_t tokenCount = 1;
+    for (auto &future: futures)
+    {
+        tokenCount += chunks.emplace_back(future.get()).tokens.size();
+    }
 
-        found = parseMacros && find_macro_keyword(content, i, &endPosition);
+    // the chunks are joined in order, a chunk is fixed up if the previous one ended in another state than it assumed
+    std::vector<Token> tokens;
+    tokens.reserve(tokenCount);
+    size_t position = 0;
+    bool parseMacros = false;
+    for (auto &chunk: chunks)
+    {
+        if (position != chunk.start || parseMacros)
+            relexChunk(fileId, chunk, position, parseMacros);
+        tokens.insert(tokens.end(), chunk.tokens.begin(), chunk.tokens.end());
+        position = chunk.position;
+        parseMacros = chunk.parseMacros;
+    }
+    tokens.emplace_back(SourceLocation{.fileId = fileId, .byte_offset = static_cast<uint32_t>(content.size())},
+                        TokenType::T_EOF);
+    return tokens;
+}
+
+LexerSource::LexerSource(const std::string &filename, const std::string &content) :
+    LexerSource(SourceFiles::add(filename, content))
+{
+}
+
+LexerSource::LexerSource(SourceFileReference file) :
+    m_file(std::move(file)), m_content(SourceFiles::source(m_file.fileId())), m_end(m_content.size())
+{
+}
+
+LexerSource::LexerSource(const uint32_t fileId) : LexerSource(SourceFileReference(fileId)) {}
+
+LexerSource::LexerSource(const uint32_t fileId, const size_t start, const size_t end, const bool parseMacros) :
+    m_file(fileId), m_content(SourceFiles::source(fileId)), m_position(start), m_end(end), m_parseMacros(parseMacros)
+{
+}
+
+SourceLocation LexerSource::makeLocation(const size_t byteOffset, const size_t numBytes) const
+{
+    // the rows and columns are computed from the byte offsets when they are needed
+    return SourceLocation{.fileId = m_file.fileId(),
+                          .byte_offset = static_cast<uint32_t>(byteOffset),
+                          .num_bytes = static_cast<uint32_t>(numBytes)};
+}
+
+Token LexerSource::nextToken()
+{
+    const auto content = m_content;
+    while (m_position < m_end)
+    {
+        const size_t i = m_position;
+        const auto ch = charAt(content, i);
+        size_t endPosition = i;
+
+        bool found = (charAt(content, i) == '{' && charAt(content, i + 1) == '$');
         if (found)
         {
-            const size_t offset = endPosition - i;
-            SourceLocation source_location = {
-                    .filename = filename, .source = contentPtr, .byte_offset = i, .num_bytes = offset};
-            tokens.emplace_back(source_location, row, column, TokenType::MACROKEYWORD);
-            i = endPosition - 1;
-            column += offset;
-            continue;
+            constexpr size_t offset = 2;
+            m_position = i + offset;
+            m_parseMacros = true;
+            return {makeLocation(i, offset), TokenType::MACRO_START};
         }
 
-        found = find_fixed_token(content, i, &endPosition);
+        found = Lexer::find_comment(content, i, &endPosition);
         if (found)
         {
-            const size_t offset = endPosition - i;
-            SourceLocation source_location = {
-                    .filename = filename, .source = contentPtr, .byte_offset = i, .num_bytes = offset};
-            tokens.emplace_back(source_location, row, column, TokenType::KEYWORD);
-            i = endPosition - 1;
-            column += offset;
+            m_position = endPosition + 1;
             continue;
         }
 
-        found = find_token(content, i, &endPosition);
+        found = Lexer::find_token(content, i, &endPosition);
         if (found)
         {
-            const size_t offset = endPosition - i + 1;
-            SourceLocation source_location = {
-                    .filename = filename, .source = contentPtr, .byte_offset = i, .num_bytes = offset};
-            tokens.emplace_back(source_location, row, column, TokenType::NAMEDTOKEN);
-            i = endPosition;
-            column += offset;
-            continue;
+            m_position = endPosition + 1;
+            const auto word = std::string_view(content).substr(i, endPosition - i + 1);
+            const auto location = makeLocation(i, word.size());
+            // inside of a macro the macro keywords take precedence, e.g. for {$else}
+            if (const auto keyword = m_parseMacros ? findMacroKeyword(word) : Keyword::NONE; keyword != Keyword::NONE)
+                return {location, TokenType::MACROKEYWORD, keyword};
+            if (const auto keyword = findKeyword(word); keyword != Keyword::NONE)
+                return {location, TokenType::KEYWORD, keyword};
+            return {location, Identifiers::intern(word)};
         }
 
         endPosition = i;
-        found = find_string(content, i, &endPosition);
+        found = Lexer::find_string(content, i, &endPosition);
         if (found)
         {
-            size_t offset = endPosition - i;
-            auto string_length = (offset - 1);
-            SourceLocation source_location = {
-                    .filename = filename, .source = contentPtr, .byte_offset = i + 1, .num_bytes = string_length};
-            if (string_length != 1)
-                tokens.emplace_back(source_location, row, column, TokenType::STRING);
-            else
-                tokens.emplace_back(source_location, row, column, TokenType::CHAR);
-            i = endPosition;
-            column += offset + 1;
-            continue;
+            const size_t string_length = endPosition - i - 1;
+            m_position = endPosition + 1;
+            return {makeLocation(i + 1, string_length), string_length != 1 ? TokenType::STRING : TokenType::CHAR};
         }
 
-        found = find_escape_sequence(content, i, &endPosition);
+        found = Lexer::find_escape_sequence(content, i, &endPosition);
         if (found)
         {
-            size_t offset = endPosition - i;
-            auto string_length = (offset);
-
-            SourceLocation source_location = {
-                    .filename = filename, .source = contentPtr, .byte_offset = i, .num_bytes = string_length};
-            if (string_length != 1)
-                tokens.emplace_back(source_location, row, column, TokenType::ESCAPED_STRING);
-            else
-                tokens.emplace_back(source_location, row, column, TokenType::CHAR);
-            i = endPosition - 1;
-            column += offset;
-            continue;
+            const size_t string_length = endPosition - i;
+            m_position = endPosition;
+            return {makeLocation(i, string_length), string_length != 1 ? TokenType::ESCAPED_STRING : TokenType::CHAR};
         }
 
         endPosition = i;
-        found = find_number(content, i, &endPosition);
+        found = Lexer::find_number(content, i, &endPosition);
         if (found)
         {
-            const size_t offset = endPosition - i + 1;
-            SourceLocation source_location = {
-                    .filename = filename, .source = contentPtr, .byte_offset = i, .num_bytes = offset};
-            tokens.emplace_back(source_location, row, column, TokenType::NUMBER);
-            i = endPosition;
-            column += offset;
-            continue;
+            m_position = endPosition + 1;
+            return {makeLocation(i, endPosition - i + 1), TokenType::NUMBER};
         }
-        // TokenType tokenType;
-        SourceLocation source_location = {.filename = filename, .source = contentPtr, .byte_offset = i, .num_bytes = 1};
+
+        m_position = i + 1;
+        const auto source_location = makeLocation(i, 1);
         switch (ch)
         {
-            case '\n':
-                column = 1;
-                row++;
-                continue;
             case '+':
-                tokens.emplace_back(source_location, row, column, TokenType::PLUS);
-                break;
+                return {source_location, TokenType::PLUS};
             case '-':
-                tokens.emplace_back(source_location, row, column, TokenType::MINUS);
-                break;
+                return {source_location, TokenType::MINUS};
             case '*':
-                tokens.emplace_back(source_location, row, column, TokenType::MUL);
-                break;
+                return {source_location, TokenType::MUL};
             case '/':
-                tokens.emplace_back(source_location, row, column, TokenType::DIV);
-                break;
+                return {source_location, TokenType::DIV};
             case '(':
-                tokens.emplace_back(source_location, row, column, TokenType::LEFT_CURLY);
-                break;
+                return {source_location, TokenType::LEFT_CURLY};
             case ')':
-                tokens.emplace_back(source_location, row, column, TokenType::RIGHT_CURLY);
-                break;
+                return {source_location, TokenType::RIGHT_CURLY};
             case '[':
-                tokens.emplace_back(source_location, row, column, TokenType::LEFT_SQUAR);
-                break;
+                return {source_location, TokenType::LEFT_SQUAR};
             case ']':
-                tokens.emplace_back(source_location, row, column, TokenType::RIGHT_SQUAR);
-                break;
+                return {source_location, TokenType::RIGHT_SQUAR};
             case '=':
-                tokens.emplace_back(source_location, row, column, TokenType::EQUAL);
-                break;
+                return {source_location, TokenType::EQUAL};
             case '<':
-                tokens.emplace_back(source_location, row, column, TokenType::LESS);
-                break;
+                return {source_location, TokenType::LESS};
             case '>':
-                tokens.emplace_back(source_location, row, column, TokenType::GREATER);
-                break;
+                return {source_location, TokenType::GREATER};
             case ',':
-                tokens.emplace_back(source_location, row, column, TokenType::COMMA);
-                break;
+                return {source_location, TokenType::COMMA};
             case ';':
-                tokens.emplace_back(source_location, row, column, TokenType::SEMICOLON);
-                break;
+                return {source_location, TokenType::SEMICOLON};
             case ':':
-                tokens.emplace_back(source_location, row, column, TokenType::COLON);
-                break;
+                return {source_location, TokenType::COLON};
             case '.':
-                tokens.emplace_back(source_location, row, column, TokenType::DOT);
-                break;
+                return {source_location, TokenType::DOT};
             case '^':
-                tokens.emplace_back(source_location, row, column, TokenType::CARET);
-                break;
+                return {source_location, TokenType::CARET};
             case '!':
-                tokens.emplace_back(source_location, row, column, TokenType::BANG);
-                break;
+                return {source_location, TokenType::BANG};
             case '@':
-                tokens.emplace_back(source_location, row, column, TokenType::AT);
-                break;
+                return {source_location, TokenType::AT};
             case '}':
-                tokens.emplace_back(source_location, row, column, TokenType::MACRO_END);
-                parseMacros = false;
-                break;
+                m_parseMacros = false;
+                return {source_location, TokenType::MACRO_END};
             default:
                 break;
         }
-        column++;
     }
-    SourceLocation source_location = {
-            .filename = filename, .source = contentPtr, .byte_offset = content.size(), .num_bytes = 0};
-    tokens.emplace_back(source_location, row, column, TokenType::T_EOF);
-    return tokens;
+    return {makeLocation(content.size(), 0), TokenType::T_EOF};
 }
 
-bool Lexer::find_escape_sequence(const std::string &content, size_t start, size_t *endPosition)
+bool Lexer::find_escape_sequence(const std::string_view content, size_t start, size_t *endPosition)
 {
-    char current = content[start];
+    char current = charAt(content, start);
     if (current != '#')
         return false;
 
     *endPosition = start + 1;
-    current = content[start + 1];
+    current = charAt(content, start + 1);
     while (true)
     {
         if (current == '#')
         {
             *endPosition += 1;
-            current = content[*endPosition];
+            current = charAt(content, *endPosition);
         }
-        else if (content[*endPosition] >= '0' && content[*endPosition] <= '9')
+        else if (charAt(content, *endPosition) >= '0' && charAt(content, *endPosition) <= '9')
         {
             *endPosition += 1;
-            current = content[*endPosition];
+            current = charAt(content, *endPosition);
             continue;
         }
         else
@@ -259,57 +322,17 @@ bool Lexer::find_escape_sequence(const std::string &content, size_t start, size_
     }
     return true;
 }
-bool Lexer::find_macro_keyword(const std::string &content, size_t start, size_t *endPosition)
-{
-    char current = content[start];
-    *endPosition = start + 1;
-    if (!validStartNameChar(current))
-        return false;
-
-    while (validNameChar(current))
-    {
-
-        *endPosition += 1;
-        current = content[*endPosition];
-    }
-
-    const auto tmp = content.substr(start, *endPosition - start);
-    for (const auto &token: macro_token)
-    {
-        if (iequals(tmp, token))
-        {
-            return true;
-        }
-    }
-
-    return false;
-}
-
-bool Lexer::find_string(const std::string &content, size_t start, size_t *endPosition)
+bool Lexer::find_string(const std::string_view content, size_t start, size_t *endPosition)
 {
-    char current = content[start];
-    if (current != '\'')
+    if (charAt(content, start) != '\'')
         return false;
-    *endPosition = start + 1;
-    current = content[start + 1];
-    while (true)
+    // a quote inside of a string is written as two quotes
+    size_t position = scanForChar(content, start + 1, '\'');
+    while (position + 1 < content.size() && charAt(content, position + 1) == '\'')
     {
-        if (current == '\'')
-        {
-            if (content.size() - 1 > *endPosition + 1 && content[*endPosition + 1] == '\'')
-            {
-                *endPosition += 2;
-                current = content[*endPosition];
-            }
-            else
-            {
-                break;
-            }
-        }
-
-        *endPosition += 1;
-        current = content[*endPosition];
+        position = scanForChar(content, position + 2, '\'');
     }
+    *endPosition = position;
     return true;
 }
 constexpr bool isNumber(const char c) { return (c >= '0' && c <= '9'); }
@@ -317,20 +340,20 @@ constexpr bool isNumber(const char c) { return (c >= '0' && c <= '9'); }
 constexpr bool isNumberStart(const char c) { return isNumber(c) || c == '-'; }
 
 
-bool Lexer::find_number(const std::string &content, const size_t start, size_t *endPosition)
+bool Lexer::find_number(const std::string_view content, const size_t start, size_t *endPosition)
 {
     int index = 0;
-    char current = content[start];
-    if (current == '-' && !isNumberStart(content[start + 1]))
+    char current = charAt(content, start);
+    if (current == '-' && !isNumberStart(charAt(content, start + 1)))
         return false;
     if (!isNumberStart(current))
         return false;
     while (isNumber(current) or (index == 0 and current == '-') or
-           (current == '.' and isNumber(content[*endPosition + 1])))
+           (current == '.' and isNumber(charAt(content, *endPosition + 1))))
     {
 
         *endPosition += 1;
-        current = content[*endPosition];
+        current = charAt(content, *endPosition);
         index++;
     }
     if (current < '0' || current > '9')
@@ -338,71 +361,26 @@ bool Lexer::find_number(const std::string &content, const size_t start, size_t *
     return true;
 }
 
-bool Lexer::find_token(const std::string &content, const size_t start, size_t *endPosition)
+bool Lexer::find_token(const std::string_view content, const size_t start, size_t *endPosition)
 {
-    char current = content[start];
-    *endPosition = start;
-    if (!validStartNameChar(current))
+    if (!validStartNameChar(charAt(content, start)))
         return false;
 
-    while (validNameChar(current))
-    {
-
-        *endPosition += 1;
-        current = content[*endPosition];
-    }
-    while (!validNameChar(current))
-    {
-        *endPosition -= 1;
-        current = content[*endPosition];
-    }
+    *endPosition = scanIdentifierEnd(content, start + 1) - 1;
     return true;
 }
 
-bool Lexer::find_fixed_token(const std::string &content, const size_t start, size_t *endPosition)
-{
-
-    char current = content[start];
-    *endPosition = start + 1;
-    if (!validStartNameChar(current))
-        return false;
-
-    while (validNameChar(current))
-    {
-
-        *endPosition += 1;
-        current = content[*endPosition];
-    }
-
-    const auto tmp = content.substr(start, *endPosition - start);
-    return std::ranges::any_of(possible_tokens, [tmp](const std::string &token) { return iequals(tmp, token); });
-}
-
-bool Lexer::find_comment(const std::string &content, const size_t start, size_t *endPosition)
+bool Lexer::find_comment(const std::string_view content, const size_t start, size_t *endPosition)
 {
-    if (content[start] == '{')
+    if (charAt(content, start) == '{')
     {
-        char current = content[start];
-        *endPosition = start + 1;
-
-        while (current != '}' && current != 0)
-        {
-            *endPosition += 1;
-            current = content[*endPosition];
-        }
+        *endPosition = scanForChar(content, start + 1, '}');
         return true;
     }
-    if (content[start] == '/' && content[start + 1] == '/')
+    if (charAt(content, start) == '/' && charAt(content, start + 1) == '/')
     {
-        char current = content[start];
-        *endPosition = start + 3;
-
-        while (current != '\n' && current != 0)
-        {
-            *endPosition += 1;
-            current = content[*endPosition];
-        }
-        *endPosition -= 1;
+        // the line break is not part of the comment
+        *endPosition = scanForChar(content, start + 2, '\n') - 1;
         return true;
     }
 
@@ -1,24 +1,72 @@
 #pragma once
 #include <string_view>
 #include <vector>
+#include "Keyword.h"
 #include "Token.h"
+#include "TokenStream.h"
 
 
 class Lexer
 {
 private:
-    static bool find_fixed_token(const std::string &content, size_t start, size_t *endPosition);
-    static bool find_token(const std::string &content, size_t start, size_t *endPosition);
+    friend class LexerSource;
 
-    static bool find_string(const std::string &content, size_t start, size_t *endPosition);
-    static bool find_number(const std::string &content, size_t start, size_t *endPosition);
-    static bool find_comment(const std::string &content, size_t start, size_t *endPosition);
-    static bool find_escape_sequence(const std::string &content, size_t start, size_t *endPosition);
-    static bool find_macro_keyword(const std::string &content, size_t start, size_t *endPosition);
+    static bool find_token(std::string_view content, size_t start, size_t *endPosition);
+
+    static bool find_string(std::string_view content, size_t start, size_t *endPosition);
+    static bool find_number(std::string_view content, size_t start, size_t *endPosition);
+    static bool find_comment(std::string_view content, size_t start, size_t *endPosition);
+    static bool find_escape_sequence(std::string_view content, size_t start, size_t *endPosition);
 
 public:
     Lexer();
     ~Lexer();
 
+    /**
+     * adds the content to the source file table and tokenizes it.
+     * The tokens stay valid until the file is replaced by another content of the same file name.
+     */
     std::vector<Token> tokenize(const std::string &filename, const std::string &content);
+    /**
+     * tokenizes a file of the source file table.
+     */
+    std::vector<Token> tokenize(uint32_t fileId);
+    /**
+     * tokenizes a file of the source file table in chunkCount parts of about the same size on their own threads.
+     * The tokens are the same as the ones of the serial tokenize.
+     */
+    std::vector<Token> tokenize(uint32_t fileId, size_t chunkCount);
+};
+
+/**
+ * lexes a file on demand, one token per call of nextToken.
+ */
+class LexerSource final : public TokenSource
+{
+    // keeps the source alive while it is lexed
+    SourceFileReference m_file;
+    std::string_view m_content;
+    size_t m_position = 0;
+    // no token is started at or after the end, but the last token may reach past it
+    size_t m_end;
+    bool m_parseMacros = false;
+
+    [[nodiscard]] SourceLocation makeLocation(size_t byteOffset, size_t numBytes) const;
+
+public:
+    LexerSource(const std::string &filename, const std::string &content);
+    explicit LexerSource(SourceFileReference file);
+    explicit LexerSource(uint32_t fileId);
+    /**
+     * lexes the tokens which start in the range [start, end) of the file, beginning in the given macro state.
+     */
+    LexerSource(uint32_t fileId, size_t start, size_t end, bool parseMacros);
+    ~LexerSource() override = default;
+
+    Token nextToken() override;
+    /**
+     * the position after the last token and whether the lexer is inside of a macro, they determine the next tokens.
+     */
+    [[nodiscard]] size_t position() const { return m_position; }
+    [[nodiscard]] bool parseMacros() const { return m_parseMacros; }
 };
@@ -1,70 +1,72 @@
-
-
 #include "MacroParser.h"
 
-#include <compare.h>
 #include <exceptions/CompilerException.h>
 #include <magic_enum/magic_enum.hpp>
 
 MacroParser::MacroParser(const std::unordered_map<std::string, bool> &definitions) :
-    m_current(0), m_definitions(definitions)
+    MacroParser(definitions, std::make_unique<TokenVectorSource>(std::vector<Token>{}))
+{
+}
+
+MacroParser::MacroParser(const MacroMap &definitions, std::unique_ptr<TokenSource> source) :
+    m_tokens(std::move(source)), m_definitions(definitions)
 {
 }
 
-void MacroParser::parseIfDef(std::vector<Token> &result)
+bool MacroParser::isActive() const { return m_conditions.empty() || m_conditions.back().active; }
+
+void MacroParser::parseIfDef()
 {
-    consumeKeyWord("ifdef");
+    consumeKeyWord(Keyword::IFDEF);
     Token macroKeyword = current();
     consume(TokenType::NAMEDTOKEN);
-    bool useMacro = isVariableDefined(macroKeyword.lexical());
-
     consume(TokenType::MACRO_END);
-    while (!(canConsume(TokenType::MACRO_START) and (canConsumeKeyWord("else", 1) or canConsumeKeyWord("endif", 1))))
-    {
-        if (tryParseMacroDefinition(result))
-            continue;
 
-        if (useMacro && !canConsume(TokenType::MACRO_START) && !canConsume(TokenType::MACRO_END) &&
-            !canConsume(TokenType::MACROKEYWORD))
-        {
-            result.push_back(current());
-        }
-        next();
-    }
-    consume(TokenType::MACRO_START);
-    if (tryConsumeKeyWord("else"))
+    const bool defined = isVariableDefined(std::string(macroKeyword.lexical()));
+    m_conditions.push_back(Condition{.defined = defined, .parentActive = isActive(), .active = isActive() && defined});
+}
+
+void MacroParser::parseElse()
+{
+    if (m_conditions.empty())
     {
-        consume(TokenType::MACRO_END);
-        tryParseMacroDefinition(result);
+        addError(current(), "found {$else} without {$ifdef}!");
+    }
+    consumeKeyWord(Keyword::ELSE);
+    consume(TokenType::MACRO_END);
 
-        while (!(canConsume(TokenType::MACRO_START) and canConsumeKeyWord("endif", 1)))
-        {
-            if (tryParseMacroDefinition(result))
-                continue;
+    auto &condition = m_conditions.back();
+    condition.active = condition.parentActive && !condition.defined;
+}
 
-            if (!useMacro && !canConsume(TokenType::MACRO_START) && !canConsume(TokenType::MACRO_END) &&
-                !canConsume(TokenType::MACROKEYWORD))
-            {
-                result.push_back(current());
-            }
-            next();
-        }
-        // consume(TokenType::MACRO_END);
-        consume(TokenType::MACRO_START);
+void MacroParser::parseEndIf()
+{
+    if (m_conditions.empty())
+    {
+        addError(current(), "found {$endif} without {$ifdef}!");
     }
-
-    consumeKeyWord("endif");
+    consumeKeyWord(Keyword::ENDIF);
     consume(TokenType::MACRO_END);
+    m_conditions.pop_back();
 }
-bool MacroParser::tryParseMacroDefinition(std::vector<Token> &result)
+
+bool MacroParser::tryParseMacroDefinition()
 {
     if (!tryConsume(TokenType::MACRO_START))
     {
         return false;
     }
-    if (canConsumeKeyWord("ifdef"))
+    if (canConsumeKeyWord(Keyword::IFDEF))
+    {
+        parseIfDef();
+    }
+    else if (canConsumeKeyWord(Keyword::ELSE))
     {
-        parseIfDef(result);
+        parseElse();
+    }
+    else if (canConsumeKeyWord(Keyword::ENDIF))
+    {
+        parseEndIf();
     }
     else if (canConsume(TokenType::NAMEDTOKEN) && canConsume(TokenType::LEFT_CURLY, 1))
     {
@@ -75,49 +77,41 @@ bool MacroParser::tryParseMacroDefinition(std::vector<Token> &result)
         Token macroName = current();
         consume(TokenType::RIGHT_CURLY);
         consume(TokenType::MACRO_END);
-        if (iequals(macroFunction.lexical(), "define"))
+        static const auto define = Identifiers::intern("define");
+        if (isActive() && macroFunction.identifier() == define)
         {
-            m_definitions[macroFunction.lexical()] = true;
+            m_definitions[std::string(macroName.lexical())] = true;
         }
     }
     return true;
 }
 
-bool MacroParser::hasError() const { return !m_errors.empty(); }
-void MacroParser::printErrors(std::ostream &outputStream)
+void MacroParser::addError(const Token &token, const std::string &message)
 {
-    for (auto &error: m_errors)
-    {
-        outputStream << error.token.sourceLocation.filename << ":" << error.token.row << ":" << error.token.col << ": "
-                     << error.message << "\n";
-    }
+    m_errors.push_back(ParserError{.token = token, .message = message});
+    throw ParserException(m_errors);
 }
 
+std::vector<ParserError> MacroParser::errors() const { return m_errors; }
+
 
 Token MacroParser::next()
 {
-    ++m_current;
+    m_tokens.advance();
     return current();
 }
-Token MacroParser::current() { return m_tokens[m_current]; }
+Token MacroParser::current() { return m_tokens.peek(); }
 bool MacroParser::isVariableDefined(const std::string &name) const { return m_definitions.contains(name); }
-bool MacroParser::hasNext() const { return m_current < m_tokens.size() - 1; }
 bool MacroParser::consume(const TokenType tokenType)
 {
     if (canConsume(tokenType))
     {
-        ++m_current;
+        m_tokens.advance();
         return true;
     }
 
-    m_errors.push_back(ParserError{
-
-            .token = m_tokens[m_current],
-            .message = "expected token '" + std::string(magic_enum::enum_name(tokenType)) + "' but found " +
-                       std::string(magic_enum::enum_name(m_tokens[m_current].tokenType)) + "!"});
-    throw ParserException(m_errors);
-
-    return false;
+    addError(m_tokens.peek(), "expected token '" + std::string(magic_enum::enum_name(tokenType)) + "' but found " +
+                                      std::string(magic_enum::enum_name(m_tokens.peek().tokenType())) + "!");
 }
 bool MacroParser::tryConsume(const TokenType tokenType)
 {
@@ -131,14 +125,14 @@ bool MacroParser::tryConsume(const TokenType tokenType)
 bool MacroParser::canConsume(TokenType tokenType) const { return canConsume(tokenType, 0); }
 bool MacroParser::canConsume(TokenType tokenType, size_t next) const
 {
-    return hasNext() && m_tokens[m_current + next].tokenType == tokenType;
+    return m_tokens.peek(next).tokenType() == tokenType;
 }
-bool MacroParser::canConsumeKeyWord(const std::string &keyword, size_t next) const
+bool MacroParser::canConsumeKeyWord(const Keyword keyword, size_t next) const
 {
-    return canConsume(TokenType::MACROKEYWORD, next) && iequals(m_tokens[m_current + next].lexical(), keyword);
+    return canConsume(TokenType::MACROKEYWORD, next) && m_tokens.peek(next).keyword() == keyword;
 }
 
-bool MacroParser::tryConsumeKeyWord(const std::string &keyword)
+bool MacroParser::tryConsumeKeyWord(const Keyword keyword)
 {
     if (canConsumeKeyWord(keyword))
     {
@@ -148,43 +142,55 @@ bool MacroParser::tryConsumeKeyWord(const std::string &keyword)
     return false;
 }
 
-bool MacroParser::consumeKeyWord(const std::string &keyword)
+bool MacroParser::consumeKeyWord(const Keyword keyword)
 {
     if (tryConsumeKeyWord(keyword))
     {
         return true;
     }
-    m_errors.push_back(ParserError{.token = m_tokens[m_current],
-                                   .message = "expected keyword  '" + keyword + "' but found " +
-                                              std::string(m_tokens[m_current].lexical()) + "!"});
-    throw ParserException(m_errors);
+    addError(m_tokens.peek(), "expected keyword  '" + std::string(keywordName(keyword)) + "' but found " +
+                                      std::string(m_tokens.peek().lexical()) + "!");
 }
 
 
 MacroMap MacroParser::macroDefinitions() const { return m_definitions; }
-std::vector<Token> MacroParser::parseFile(const std::vector<Token> &tokens)
-{
-    m_tokens = tokens;
-    m_current = 0;
-    std::vector<Token> result;
-    result.reserve(tokens.size());
 
-
-    while (m_current < tokens.size())
+Token MacroParser::nextToken()
+{
+    while (true)
     {
-        if (!tryParseMacroDefinition(result))
+        if (tryParseMacroDefinition())
+            continue;
+
+        const auto token = current();
+        if (token.tokenType() == TokenType::T_EOF)
         {
-            if (current().tokenType == TokenType::MACRO_END)
+            if (!m_conditions.empty())
             {
-                next();
+                addError(token, "expected {$endif} but found the end of the file!");
             }
-            result.push_back(current());
-            if (hasNext())
-                next();
-            else
-                break;
+            return token;
         }
+        next();
+        // the remains of unknown macros
+        if (token.tokenType() == TokenType::MACRO_END || token.tokenType() == TokenType::MACROKEYWORD)
+            continue;
+        if (isActive())
+            return token;
+    }
+}
+
+std::vector<Token> MacroParser::parseFile(const std::vector<Token> &tokens)
+{
+    m_tokens = TokenStream(std::make_unique<TokenVectorSource>(tokens));
+    m_conditions.clear();
+    std::vector<Token> result;
+    result.reserve(tokens.size());
+    do
+    {
+        result.push_back(nextToken());
     }
+    while (result.back().tokenType() != TokenType::T_EOF);
 
     return result;
 }
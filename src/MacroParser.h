@@ -1,43 +1,69 @@
 #pragma once
+#include <memory>
 #include <unordered_map>
 #include <vector>
 #include "Token.h"
+#include "TokenStream.h"
 
 #include <exceptions/CompilerException.h>
 
 typedef std::unordered_map<std::string, bool> MacroMap;
 
-class MacroParser
+/**
+ * filter stage between the lexer and the parser which evaluates the macros.
+ * The tokens are pulled from the source one by one, only the open {$ifdef} blocks are remembered.
+ */
+class MacroParser final : public TokenSource
 {
 
 private:
-    std::vector<Token> m_tokens;
-    size_t m_current;
+    /**
+     * an {$ifdef} block which is not closed by {$endif} yet.
+     */
+    struct Condition
+    {
+        bool defined;
+        // the tokens of the enclosing block are used
+        bool parentActive;
+        // the tokens of the current branch are used
+        bool active;
+    };
+
+    TokenStream m_tokens;
+    std::vector<Condition> m_conditions;
     std::vector<ParserError> m_errors;
     MacroMap m_definitions;
 
-    bool tryParseMacroDefinition(std::vector<Token> &result);
-    bool hasError() const;
-    void printErrors(std::ostream &outputStream);
+    bool tryParseMacroDefinition();
+    [[nodiscard]] bool isActive() const;
+    void parseIfDef();
+    void parseElse();
+    void parseEndIf();
+    [[noreturn]] void addError(const Token &token, const std::string &message);
 
     Token next();
     Token current();
     [[nodiscard]] bool isVariableDefined(const std::string &name) const;
-    [[nodiscard]] bool hasNext() const;
     bool consume(TokenType tokenType);
     bool tryConsume(TokenType tokenType);
     [[nodiscard]] bool canConsume(TokenType tokenType) const;
     [[nodiscard]] bool canConsume(TokenType tokenType, size_t next) const;
-    bool canConsumeKeyWord(const std::string &keyword, size_t next = 0) const;
-    bool tryConsumeKeyWord(const std::string &keyword);
-    bool consumeKeyWord(const std::string &keyword);
+    bool canConsumeKeyWord(Keyword keyword, size_t next = 0) const;
+    bool tryConsumeKeyWord(Keyword keyword);
+    bool consumeKeyWord(Keyword keyword);
 
 public:
     explicit MacroParser(const MacroMap &definitions);
-    void parseIfDef(std::vector<Token> &result);
-    ~MacroParser() = default;
+    MacroParser(const MacroMap &definitions, std::unique_ptr<TokenSource> source);
+    ~MacroParser() override = default;
 
     MacroMap macroDefinitions() const;
 
+    Token nextToken() override;
+    [[nodiscard]] std::vector<ParserError> errors() const override;
+
+    /**
+     * evaluates the macros of an already tokenized file.
+     */
     [[nodiscard]] std::vector<Token> parseFile(const std::vector<Token> &tokens);
 };
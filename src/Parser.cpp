@@ -3,10 +3,17 @@
 #include <MacroParser.h>
 #include <ast/AddressNode.h>
 #include <ast/ArrayInitialisationNode.h>
+#include <algorithm>
+#include <chrono>
 #include <cmath>
-#include <fstream>
+#include <functional>
+#include <future>
 #include <iostream>
 #include <llvm/IR/InstrTypes.h>
+#include <mutex>
+#include <semaphore>
+#include <thread>
+#include <variant>
 
 #include "ast/ArrayAccessNode.h"
 #include "ast/ArrayAssignmentNode.h"
@@ -36,28 +43,176 @@
 #include "magic_enum/magic_enum.hpp"
 
 
-static std::unordered_map<std::string, std::unique_ptr<UnitNode>> unitCache;
+struct ParsedUnit
+{
+    std::shared_ptr<UnitNode> unit;
+    // all messages of the unit and the units imported by it
+    std::vector<ParserError> errors;
+    // the messages point into the source of the unit, even if it could not be parsed
+    SourceFileReference file;
+    // the files of the unit and of all units imported by it with their modification time when they were read
+    std::map<std::filesystem::path, std::filesystem::file_time_type> files;
+
+    /**
+     * a unit is out of date if its file or the file of one of its imports changed since it was parsed.
+     */
+    [[nodiscard]] bool isCurrent() const
+    {
+        return std::ranges::all_of(files,
+                                   [](const auto &file)
+                                   {
+                                       std::error_code error;
+                                       return std::filesystem::last_write_time(file.first, error) == file.second;
+                                   });
+    }
+};
+
+/**
+ * the result of loading an imported unit.
+ */
+struct UnitImport
+{
+    // empty if the file does not exist or if the import closes a cycle
+    std::optional<std::shared_future<ParsedUnit>> unit;
+    // the file names of the units which import each other, starting and ending with the importer
+    std::vector<std::string> cycle;
+};
+
+namespace
+{
+    /**
+     * concurrency safe cache of the parsed units.
+     * Every unit is parsed only once, other importers of the same unit wait for the result of the first parse.
+     * A unit which is out of date is replaced by the next importer, so the cache holds one version of every unit.
+     * The imports of the units which are parsed at the moment are tracked, an import which closes a cycle would wait
+     * for its own result and is rejected instead.
+     */
+    class UnitCache
+    {
+        struct Import
+        {
+            std::string key;
+            std::string filename;
+        };
+
+        std::mutex m_mutex;
+        std::unordered_map<std::string, std::shared_future<ParsedUnit>> m_units;
+        std::unordered_map<std::string, std::vector<Import>> m_imports;
+
+        // the file names of the imports on the way from one unit to another, nothing if there is no way
+        std::optional<std::vector<std::string>> findImportPath(const std::string &from, const std::string &to,
+                                                               std::unordered_set<std::string> &visited) const
+        {
+            if (from == to)
+            {
+                return std::vector<std::string>{};
+            }
+            const auto imports = m_imports.find(from);
+            if (imports == m_imports.end() || !visited.insert(from).second)
+            {
+                return std::nullopt;
+            }
+            for (auto &[key, filename]: imports->second)
+            {
+                if (auto path = findImportPath(key, to, visited))
+                {
+                    path->insert(path->begin(), filename);
+                    return path;
+                }
+            }
+            return std::nullopt;
+        }
+
+        // a unit which is still parsed was read just now
+        static bool isUsable(const std::shared_future<ParsedUnit> &unit)
+        {
+            return unit.wait_for(std::chrono::seconds(0)) != std::future_status::ready || unit.get().isCurrent();
+        }
+
+        void finish(const std::string &key)
+        {
+            std::scoped_lock lock(m_mutex);
+            m_imports.erase(key);
+        }
+
+    public:
+        /**
+         * returns the unit of the key which is imported by the importer, an empty importer is a program.
+         * Returns the file names of the cycle if the unit already imports the importer, directly or through other
+         * units which are parsed at the moment.
+         */
+        std::variant<std::shared_future<ParsedUnit>, std::vector<std::string>>
+        getOrParse(const std::string &importer, const std::string &key, const std::string &filename,
+                   const std::function<ParsedUnit()> &parse)
+        {
+            std::promise<ParsedUnit> promise;
+            auto future = promise.get_future().share();
+            {
+                std::scoped_lock lock(m_mutex);
+                if (!importer.empty())
+                {
+                    std::unordered_set<std::string> visited;
+                    if (auto path = findImportPath(key, importer, visited))
+                    {
+                        path->insert(path->begin(), filename);
+                        return std::move(*path);
+                    }
+                    m_imports[importer].push_back(Import{.key = key, .filename = filename});
+                }
+                if (const auto it = m_units.find(key); it != m_units.end() && isUsable(it->second))
+                {
+                    return it->second;
+                }
+                m_units.insert_or_assign(key, future);
+            }
+            try
+            {
+                promise.set_value(parse());
+                finish(key);
+            }
+            catch (...)
+            {
+                // a unit which could not be parsed is not cached, so it is parsed again by the next importer
+                {
+                    std::scoped_lock lock(m_mutex);
+                    m_units.erase(key);
+                    m_imports.erase(key);
+                }
+                promise.set_exception(std::current_exception());
+            }
+            return future;
+        }
+    };
+
+    UnitCache unitCache;
+} // namespace
 
 Parser::Parser(const std::vector<std::filesystem::path> &rtlDirectories, std::filesystem::path path,
                const std::unordered_map<std::string, bool> &definitions, const std::vector<Token> &tokens) :
-    m_rtlDirectories(std::move(rtlDirectories)), m_file_path(std::move(path)), m_tokens(tokens),
-    m_definitions(definitions)
+    Parser(rtlDirectories, std::move(path), definitions, std::make_unique<TokenVectorSource>(tokens))
 {
-    m_typeDefinitions["shortint"] = VariableType::getInteger(8);
-    m_typeDefinitions["byte"] = VariableType::getInteger(8);
-    m_typeDefinitions["char"] = VariableType::getInteger(8);
-    m_typeDefinitions["smallint"] = VariableType::getInteger(16);
-    m_typeDefinitions["word"] = VariableType::getInteger(16);
-    m_typeDefinitions["longint"] = VariableType::getInteger();
-    m_typeDefinitions["integer"] = VariableType::getInteger();
-    m_typeDefinitions["int64"] = VariableType::getInteger(64);
-    m_typeDefinitions["string"] = StringType::getString();
-    m_typeDefinitions["boolean"] = VariableType::getBoolean();
-    m_typeDefinitions["pointer"] = PointerType::getUnqual();
-    m_typeDefinitions["pinteger"] = PointerType::getPointerTo(VariableType::getInteger());
-    m_typeDefinitions["double"] = VariableType::getDouble();
-    m_typeDefinitions["real"] = VariableType::getDouble();
-    m_typeDefinitions["single"] = VariableType::getSingle();
+}
+
+Parser::Parser(const std::vector<std::filesystem::path> &rtlDirectories, std::filesystem::path path,
+               const std::unordered_map<std::string, bool> &definitions, std::unique_ptr<TokenSource> tokens) :
+    m_rtlDirectories(rtlDirectories), m_file_path(std::move(path)), m_tokens(std::move(tokens)),
+    m_arena(std::make_shared<ASTArena>()), m_definitions(definitions)
+{
+    m_typeDefinitions[Identifiers::intern("shortint")] = VariableType::getInteger(8);
+    m_typeDefinitions[Identifiers::intern("byte")] = VariableType::getInteger(8);
+    m_typeDefinitions[Identifiers::intern("char")] = VariableType::getInteger(8);
+    m_typeDefinitions[Identifiers::intern("smallint")] = VariableType::getInteger(16);
+    m_typeDefinitions[Identifiers::intern("word")] = VariableType::getInteger(16);
+    m_typeDefinitions[Identifiers::intern("longint")] = VariableType::getInteger();
+    m_typeDefinitions[Identifiers::intern("integer")] = VariableType::getInteger();
+    m_typeDefinitions[Identifiers::intern("int64")] = VariableType::getInteger(64);
+    m_typeDefinitions[Identifiers::intern("string")] = StringType::getString();
+    m_typeDefinitions[Identifiers::intern("boolean")] = VariableType::getBoolean();
+    m_typeDefinitions[Identifiers::intern("pointer")] = PointerType::getUnqual();
+    m_typeDefinitions[Identifiers::intern("pinteger")] = PointerType::getPointerTo(VariableType::getInteger());
+    m_typeDefinitions[Identifiers::intern("double")] = VariableType::getDouble();
+    m_typeDefinitions[Identifiers::intern("real")] = VariableType::getDouble();
+    m_typeDefinitions[Identifiers::intern("single")] = VariableType::getSingle();
 }
 bool Parser::hasError() const
 {
@@ -80,24 +235,24 @@ void Parser::printErrors(std::ostream &outputStream, bool printColor)
 
 Token Parser::next()
 {
-    ++m_current;
+    m_tokens.advance();
     return current();
 }
-Token Parser::current() { return m_tokens[m_current]; }
-bool Parser::hasNext() const { return m_current < m_tokens.size(); }
+Token Parser::current() { return m_tokens.peek(); }
+bool Parser::hasNext() const { return m_tokens.hasToken(); }
 bool Parser::consume(const TokenType tokenType)
 {
     if (canConsume(tokenType))
     {
-        ++m_current;
+        m_tokens.advance();
         return true;
     }
 
     m_errors.push_back(ParserError{
 
-            .token = m_tokens[m_current + 1],
+            .token = m_tokens.peek(1),
             .message = "expected token '" + std::string(magic_enum::enum_name(tokenType)) + "' but found " +
-                       std::string(magic_enum::enum_name(m_tokens[m_current + 1].tokenType)) + "!"});
+                       std::string(magic_enum::enum_name(m_tokens.peek(1).tokenType())) + "!"});
     throw ParserException(m_errors);
 
     return false;
@@ -106,7 +261,7 @@ bool Parser::tryConsume(const TokenType tokenType)
 {
     if (canConsume(tokenType))
     {
-        ++m_current;
+        m_tokens.advance();
         return true;
     }
     return false;
@@ -114,27 +269,27 @@ bool Parser::tryConsume(const TokenType tokenType)
 bool Parser::canConsume(const TokenType tokenType) const { return canConsume(tokenType, 1); }
 bool Parser::canConsume(const TokenType tokenType, const size_t next) const
 {
-    return hasNext() && m_tokens[m_current + next].tokenType == tokenType;
+    return hasNext() && m_tokens.peek(next).tokenType() == tokenType;
 }
 
-bool Parser::consumeKeyWord(const std::string &keyword)
+bool Parser::consumeKeyWord(const Keyword keyword)
 {
     if (tryConsumeKeyWord(keyword))
     {
         return true;
     }
-    m_errors.push_back(ParserError{.token = m_tokens[m_current + 1],
-                                   .message = "expected keyword  '" + keyword + "' but found " +
-                                              std::string(m_tokens[m_current + 1].lexical()) + "!"});
+    m_errors.push_back(ParserError{.token = m_tokens.peek(1),
+                                   .message = "expected keyword  '" + std::string(keywordName(keyword)) + "' but found " +
+                                              std::string(m_tokens.peek(1).lexical()) + "!"});
     throw ParserException(m_errors);
 }
 
-bool Parser::canConsumeKeyWord(const std::string &keyword) const
+bool Parser::canConsumeKeyWord(const Keyword keyword) const
 {
-    return canConsume(TokenType::KEYWORD) && iequals(m_tokens[m_current + 1].lexical(), keyword);
+    return canConsume(TokenType::KEYWORD) && m_tokens.peek(1).keyword() == keyword;
 }
 
-bool Parser::tryConsumeKeyWord(const std::string &keyword)
+bool Parser::tryConsumeKeyWord(const Keyword keyword)
 {
     if (canConsumeKeyWord(keyword))
     {
@@ -144,18 +299,16 @@ bool Parser::tryConsumeKeyWord(const std::string &keyword)
     return false;
 }
 
-std::optional<std::shared_ptr<VariableType>> Parser::determinVariableTypeByName(const std::string &name) const
+std::optional<std::shared_ptr<VariableType>> Parser::determinVariableTypeByName(const Identifier identifier) const
 {
-    for (const auto &[defName, definition]: m_typeDefinitions)
+    if (const auto it = m_typeDefinitions.find(identifier); it != m_typeDefinitions.end())
     {
-        if (iequals(defName, name))
-            return definition;
+        return it->second;
     }
-
     return std::nullopt;
 }
 
-std::shared_ptr<ASTNode> Parser::parseEscapedString(const Token &token)
+ASTNode *Parser::parseEscapedString(const Token &token)
 {
     auto result = std::string{};
     size_t x = 1;
@@ -164,34 +317,38 @@ std::shared_ptr<ASTNode> Parser::parseEscapedString(const Token &token)
         auto next = token.lexical().find('#', x);
         if (next == std::string::npos)
             next = token.sourceLocation.num_bytes;
-        auto tmp = token.lexical().substr(x, next - x);
+        auto tmp = std::string(token.lexical().substr(x, next - x));
         result += std::atoi(tmp.data());
         x = next + 1;
     }
-    return std::make_shared<StringConstantNode>(token, result);
+    return m_arena->make<StringConstantNode>(token, result);
 }
 
-std::shared_ptr<ASTNode> Parser::parseNumber()
+ASTNode *Parser::parseNumber()
 {
     consume(TokenType::NUMBER);
     auto token = current();
     if (token.lexical().find('.') != std::string::npos)
     {
-        auto value = std::atof(token.lexical().data());
-        return std::make_shared<DoubleNode>(token, value);
+        auto value = std::atof(std::string(token.lexical()).c_str());
+        return m_arena->make<DoubleNode>(token, value);
     }
 
-    auto value = std::atoll(token.lexical().data());
+    auto value = std::atoll(std::string(token.lexical()).c_str());
     auto base = 1 + static_cast<int>(std::log2(value));
     base = (base > 32) ? 64 : 32;
-    return std::make_shared<NumberNode>(token, value, base);
+    return m_arena->make<NumberNode>(token, value, base);
 }
 
 
-bool Parser::isVariableDefined(const std::string_view &name, const size_t scope)
+bool Parser::isVariableDefined(const Identifier identifier, const size_t scope) const
 {
-    return std::ranges::any_of(m_known_variable_definitions, [name, scope](const VariableDefinition &def)
-                               { return iequals(def.variableName, name) && def.scopeId <= scope; });
+    return m_symbols.isDefined(identifier, scope);
+}
+
+bool Parser::isVariableDeclaredIn(const Identifier identifier, const size_t scope) const
+{
+    return m_symbols.isDeclaredIn(identifier, scope);
 }
 
 void Parser::parseTypeDefinitions(const size_t scope)
@@ -200,37 +357,39 @@ void Parser::parseTypeDefinitions(const size_t scope)
     while (tryConsume(TokenType::NAMEDTOKEN))
     {
 
-        const auto typeName = current().lexical();
+        const auto typeName = std::string(current().lexical());
+        const auto typeIdentifier = current().identifier();
+        m_declaredTypes.push_back(typeIdentifier);
         consume(TokenType::EQUAL);
         const auto isPointerType = tryConsume(TokenType::CARET);
         // parse type
-        if (tryConsumeKeyWord("array"))
+        if (tryConsumeKeyWord(Keyword::ARRAY))
         {
-            m_typeDefinitions[typeName] = parseArray(scope);
+            m_typeDefinitions[typeIdentifier] = parseArray(scope);
 
             consume(TokenType::SEMICOLON);
         }
-        else if (tryConsumeKeyWord("record"))
+        else if (tryConsumeKeyWord(Keyword::RECORD))
         {
             std::vector<VariableDefinition> fieldDefinitions;
 
-            while (!canConsumeKeyWord("end"))
+            while (!canConsumeKeyWord(Keyword::END))
             {
                 for (const auto &definition: parseVariableDefinitions(scope))
                     fieldDefinitions.emplace_back(definition);
             }
 
-            consumeKeyWord("end");
+            consumeKeyWord(Keyword::END);
             consume(TokenType::SEMICOLON);
 
 
-            m_typeDefinitions[typeName] = std::make_shared<RecordType>(fieldDefinitions, typeName);
+            m_typeDefinitions[typeIdentifier] = std::make_shared<RecordType>(fieldDefinitions, typeName);
         }
         else if (tryConsume(TokenType::NAMEDTOKEN))
         {
 
-            auto internalTypeName = current().lexical();
-            auto internalType = determinVariableTypeByName(internalTypeName);
+            auto internalTypeName = std::string(current().lexical());
+            auto internalType = determinVariableTypeByName(current().identifier());
             if (!internalType.has_value())
             {
                 m_errors.push_back(ParserError{
@@ -239,11 +398,11 @@ void Parser::parseTypeDefinitions(const size_t scope)
             }
             if (isPointerType)
             {
-                m_typeDefinitions[typeName] = PointerType::getPointerTo(internalType.value());
+                m_typeDefinitions[typeIdentifier] = PointerType::getPointerTo(internalType.value());
             }
             else
             {
-                m_typeDefinitions[typeName] = internalType.value();
+                m_typeDefinitions[typeIdentifier] = internalType.value();
             }
 
             consume(TokenType::SEMICOLON);
@@ -259,7 +418,7 @@ std::shared_ptr<ArrayType> Parser::parseArray(size_t scope)
     {
 
         auto arrayStartNode = parseToken(scope);
-        if (auto node = std::dynamic_pointer_cast<NumberNode>(arrayStartNode))
+        if (auto node = nodeCast<NumberNode>(arrayStartNode))
         {
             arrayStart = node->getValue();
         }
@@ -267,33 +426,25 @@ std::shared_ptr<ArrayType> Parser::parseArray(size_t scope)
         consume(TokenType::DOT);
 
         auto arrayEndNode = parseToken(scope);
-        if (auto node = std::dynamic_pointer_cast<NumberNode>(arrayEndNode))
+        if (auto node = nodeCast<NumberNode>(arrayEndNode))
         {
             arrayEnd = node->getValue();
         }
-        else if (auto node = std::dynamic_pointer_cast<VariableAccessNode>(arrayEndNode))
+        else if (auto node = nodeCast<VariableAccessNode>(arrayEndNode))
         {
-            const auto varName = node->expressionToken().lexical();
-            for (auto &var: m_known_variable_definitions)
+            if (const auto binding = m_symbols.lookup(node->expressionToken().identifier()))
             {
-                if (iequals(var.variableName, varName))
+                if (const auto valueNode = nodeCast<NumberNode>(binding->constantValue))
                 {
-                    if (var.constant)
-                    {
-                        if (const auto valueNode = std::dynamic_pointer_cast<NumberNode>(var.value))
-                        {
-                            arrayEnd = valueNode->getValue();
-                        }
-                    }
+                    arrayEnd = valueNode->getValue();
                 }
             }
         }
         consume(TokenType::RIGHT_SQUAR);
     }
-    consumeKeyWord("of");
+    consumeKeyWord(Keyword::OF);
     consume(TokenType::NAMEDTOKEN);
-    auto internalTypeName = std::string(current().lexical());
-    auto internalType = determinVariableTypeByName(internalTypeName);
+    auto internalType = determinVariableTypeByName(current().identifier());
 
 
     if (isFixedArray)
@@ -322,9 +473,9 @@ std::optional<VariableDefinition> Parser::parseConstantDefinition(size_t scope)
     {
         consume(TokenType::NAMEDTOKEN);
         varType = std::string(current().lexical());
-        type = determinVariableTypeByName(varType);
+        type = determinVariableTypeByName(current().identifier());
     }
-    std::shared_ptr<ASTNode> value;
+    ASTNode *value = nullptr;
     if (consume(TokenType::EQUAL))
     {
         value = parseToken(scope);
@@ -340,7 +491,7 @@ std::optional<VariableDefinition> Parser::parseConstantDefinition(size_t scope)
 
     consume(TokenType::SEMICOLON);
 
-    if (isVariableDefined(varName, scope))
+    if (isVariableDeclaredIn(varNameToken.identifier(), scope))
     {
         m_errors.push_back(
                 ParserError{.token = varNameToken,
@@ -356,12 +507,16 @@ std::optional<VariableDefinition> Parser::parseConstantDefinition(size_t scope)
         return std::nullopt;
     }
 
-    return VariableDefinition{
-            .variableType = type.value(), .variableName = varName, .scopeId = scope, .value = value, .constant = true};
+    return VariableDefinition{.variableType = type.value(),
+                              .variableName = varName,
+                              .identifier = varNameToken.identifier(),
+                              .scopeId = scope,
+                              .value = value,
+                              .constant = true};
 }
-std::shared_ptr<ASTNode> Parser::parseArrayConstructor(size_t size)
+ASTNode *Parser::parseArrayConstructor(size_t size)
 {
-    std::vector<std::shared_ptr<ASTNode>> arguments;
+    std::vector<ASTNode *> arguments;
     consume(TokenType::LEFT_SQUAR);
     Token startToken = current();
 
@@ -371,7 +526,7 @@ std::shared_ptr<ASTNode> Parser::parseArrayConstructor(size_t size)
         tryConsume(TokenType::COMMA);
     }
     consume(TokenType::RIGHT_SQUAR);
-    return std::make_shared<ArrayInitialisationNode>(startToken, arguments);
+    return m_arena->make<ArrayInitialisationNode>(startToken, arguments);
 }
 std::vector<VariableDefinition> Parser::parseVariableDefinitions(const size_t scope)
 {
@@ -381,13 +536,12 @@ std::vector<VariableDefinition> Parser::parseVariableDefinitions(const size_t sc
     // consume var declarations
 
 
-    std::vector<std::string> varNames;
+    std::vector<Token> varNames;
     do
     {
         consume(TokenType::NAMEDTOKEN);
         _currentToken = current();
-        auto varName = std::string(_currentToken.lexical());
-        varNames.push_back(varName);
+        varNames.push_back(_currentToken);
         if (!tryConsume(TokenType::COMMA))
         {
             break;
@@ -406,15 +560,15 @@ std::vector<VariableDefinition> Parser::parseVariableDefinitions(const size_t sc
         {
             _currentToken = current();
             varType = std::string(_currentToken.lexical());
-            type = determinVariableTypeByName(varType);
+            type = determinVariableTypeByName(_currentToken.identifier());
         }
-        else if (canConsumeKeyWord("file"))
+        else if (canConsumeKeyWord(Keyword::FILE))
         {
-            consumeKeyWord("file");
+            consumeKeyWord(Keyword::FILE);
             varType = std::string(_currentToken.lexical());
             type = FileType::getFileType();
         }
-        else if (tryConsumeKeyWord("array"))
+        else if (tryConsumeKeyWord(Keyword::ARRAY))
         {
             varType = "array";
             type = parseArray(scope);
@@ -424,7 +578,7 @@ std::vector<VariableDefinition> Parser::parseVariableDefinitions(const size_t sc
             type = PointerType::getPointerTo(type.value());
         }
     }
-    std::shared_ptr<ASTNode> value;
+    ASTNode *value = nullptr;
     if (type && type.value()->baseType == VariableBaseType::Array)
     {
         if (tryConsume(TokenType::EQUAL))
@@ -446,9 +600,10 @@ std::vector<VariableDefinition> Parser::parseVariableDefinitions(const size_t sc
     }
 
     consume(TokenType::SEMICOLON);
-    for (const auto &varName: varNames)
+    for (const auto &varNameToken: varNames)
     {
-        if (isVariableDefined(varName, scope))
+        const auto varName = std::string(varNameToken.lexical());
+        if (isVariableDeclaredIn(varNameToken.identifier(), scope))
         {
             m_errors.push_back(ParserError{.token = _currentToken,
                                            .message = "A variable or constant with the name " + varName +
@@ -465,6 +620,7 @@ std::vector<VariableDefinition> Parser::parseVariableDefinitions(const size_t sc
 
         result.push_back(VariableDefinition{.variableType = type.value(),
                                             .variableName = varName,
+                                            .identifier = varNameToken.identifier(),
                                             .scopeId = scope,
                                             .value = value,
                                             .constant = false});
@@ -472,203 +628,154 @@ std::vector<VariableDefinition> Parser::parseVariableDefinitions(const size_t sc
     return result;
 }
 
-std::shared_ptr<ASTNode> Parser::parseLogicalExpression(const size_t scope, std::shared_ptr<ASTNode> lhs)
-{
-    if (canConsumeKeyWord("not"))
-    {
-        consumeKeyWord("not");
-        auto token = current();
-        auto rhs = parseExpression(scope);
-        return parseExpression(scope, std::make_shared<LogicalExpressionNode>(token, LogicalOperator::NOT, rhs));
-    }
-
-    if (!lhs)
-        return nullptr;
-
-    if (canConsumeKeyWord("or"))
-    {
-        consumeKeyWord("or");
-        auto token = current();
-        auto rhs = parseExpression(scope);
-        return parseExpression(scope, std::make_shared<LogicalExpressionNode>(token, LogicalOperator::OR, lhs, rhs));
-    }
-    if (canConsumeKeyWord("and"))
-    {
-        consumeKeyWord("and");
-        auto token = current();
-        auto rhs = parseExpression(scope);
-        return parseExpression(scope, std::make_shared<LogicalExpressionNode>(token, LogicalOperator::AND, lhs, rhs));
-    }
-    return lhs;
-}
-
-void Parser::checkLhsExists(const std::shared_ptr<ASTNode> &lhs, const Token &token)
+void Parser::checkLhsExists(ASTNode *lhs, const Token &token)
 {
     if (!lhs)
     {
         m_errors.push_back(ParserError{
 
                 .token = token,
-                .message = "unexpected token " + std::string(magic_enum::enum_name(token.tokenType)) + "!"});
+                .message = "unexpected token " + std::string(magic_enum::enum_name(token.tokenType())) + "!"});
     }
 }
-/*
- a1 * a2 + b1 * b2 ==> (a * a) + (b * b)
- 1. lhs = a1
- 2. parse *
- 3. parse a2;
-*/
-static std::map<Operator, int> operatorPrecedence{
-        {Operator::MUL, 20}, {Operator::DIV, 10}, {Operator::PLUS, 5}, {Operator::MINUS, 2}};
-std::shared_ptr<ASTNode> Parser::parseBaseExpression(const size_t scope, const std::shared_ptr<ASTNode> &origLhs,
-                                                     bool includeCompare)
+namespace
 {
-    auto lhs = (origLhs) ? origLhs : parseToken(scope);
-
-
-    if (tryConsume(TokenType::PLUS))
-    {
-        Token operatorToken = current();
-        checkLhsExists(lhs, operatorToken);
-        auto rhs = parseToken(scope);
-
-        if (canConsume(TokenType::MUL) or canConsume(TokenType::DIV) or canConsume(TokenType::LEFT_CURLY))
-        {
-            rhs = parseBaseExpression(scope, rhs, false);
+    /**
+     * a binary operator of an expression, it is applied by a BinaryOperationNode, a ComparrisionNode or a
+     * LogicalExpressionNode.
+     */
+    struct BinaryOperator
+    {
+        Precedence precedence = Precedence::NONE;
+        // the number of tokens of the operator, e.g. 2 for >=
+        size_t length = 1;
+        std::variant<Operator, CMPOperator, LogicalOperator> operation;
+    };
+
+    /**
+     * the binary operator which starts with the first token, the second token completes the comparisons which are
+     * written with two characters. Any other token ends the expression and has the precedence NONE.
+     */
+    BinaryOperator binaryOperator(const Token &first, const Token &second)
+    {
+        switch (first.tokenType())
+        {
+            case TokenType::PLUS:
+                return {Precedence::ADDITIVE, 1, Operator::PLUS};
+            case TokenType::MINUS:
+                return {Precedence::ADDITIVE, 1, Operator::MINUS};
+            case TokenType::MUL:
+                return {Precedence::MULTIPLICATIVE, 1, Operator::MUL};
+            case TokenType::DIV:
+                return {Precedence::MULTIPLICATIVE, 1, Operator::DIV};
+            case TokenType::EQUAL:
+                return {Precedence::COMPARISON, 1, CMPOperator::EQUALS};
+            case TokenType::GREATER:
+                if (second.tokenType() == TokenType::EQUAL)
+                    return {Precedence::COMPARISON, 2, CMPOperator::GREATER_EQUAL};
+                return {Precedence::COMPARISON, 1, CMPOperator::GREATER};
+            case TokenType::LESS:
+                if (second.tokenType() == TokenType::EQUAL)
+                    return {Precedence::COMPARISON, 2, CMPOperator::LESS_EQUAL};
+                if (second.tokenType() == TokenType::GREATER)
+                    return {Precedence::COMPARISON, 2, CMPOperator::NOT_EQUALS};
+                return {Precedence::COMPARISON, 1, CMPOperator::LESS};
+            case TokenType::BANG:
+                if (second.tokenType() == TokenType::EQUAL)
+                    return {Precedence::COMPARISON, 2, CMPOperator::NOT_EQUALS};
+                break;
+            case TokenType::KEYWORD:
+                switch (first.keyword())
+                {
+                    case Keyword::MOD:
+                        return {Precedence::MULTIPLICATIVE, 1, Operator::MOD};
+                    case Keyword::DIV:
+                        return {Precedence::MULTIPLICATIVE, 1, Operator::IDIV};
+                    case Keyword::AND:
+                        return {Precedence::AND, 1, LogicalOperator::AND};
+                    case Keyword::OR:
+                        return {Precedence::OR, 1, LogicalOperator::OR};
+                    default:
+                        break;
+                }
+                break;
+            default:
+                break;
         }
-
-        return parseExpression(scope, std::make_shared<BinaryOperationNode>(operatorToken, Operator::PLUS, lhs, rhs));
+        return {};
     }
-    if (tryConsume(TokenType::MINUS))
-    {
-        Token operatorToken = current();
-        checkLhsExists(lhs, operatorToken);
-        auto rhs = parseToken(scope);
-        if (canConsume(TokenType::MUL) or canConsume(TokenType::DIV) or canConsume(TokenType::LEFT_CURLY))
-        {
-            rhs = parseBaseExpression(scope, rhs, false);
-        }
 
-        return parseExpression(scope, std::make_shared<BinaryOperationNode>(operatorToken, Operator::MINUS, lhs, rhs));
-    }
-    if (tryConsume(TokenType::MUL))
-    {
-        Token operatorToken = current();
-        checkLhsExists(lhs, operatorToken);
-        auto rhs = parseToken(scope);
-        return parseExpression(scope, std::make_shared<BinaryOperationNode>(operatorToken, Operator::MUL, lhs, rhs));
-    }
-    if (tryConsume(TokenType::DIV))
-    {
-        Token operatorToken = current();
-        checkLhsExists(lhs, operatorToken);
-        auto rhs = parseToken(scope);
-        return parseExpression(scope, std::make_shared<BinaryOperationNode>(operatorToken, Operator::DIV, lhs, rhs));
-    }
-    if (canConsumeKeyWord("mod"))
+    constexpr Precedence nextPrecedence(const Precedence precedence)
     {
-        Token operatorToken = current();
-        checkLhsExists(lhs, operatorToken);
-        consumeKeyWord("mod");
-        auto rhs = parseToken(scope);
-        return parseExpression(scope, std::make_shared<BinaryOperationNode>(operatorToken, Operator::MOD, lhs, rhs));
+        return static_cast<Precedence>(static_cast<uint8_t>(precedence) + 1);
     }
-    if (canConsumeKeyWord("div"))
+} // namespace
+
+ASTNode *Parser::parseOperand(const size_t scope)
+{
+    if (tryConsumeKeyWord(Keyword::NOT))
     {
-        Token operatorToken = current();
-        checkLhsExists(lhs, operatorToken);
-        consumeKeyWord("div");
-        auto rhs = parseToken(scope);
-        return parseExpression(scope, std::make_shared<BinaryOperationNode>(operatorToken, Operator::IDIV, lhs, rhs));
+        const Token token = current();
+        // the negation applies to a whole comparison, "not a = b" is "not (a = b)"
+        auto operand = parseBinaryExpression(scope, Precedence::COMPARISON);
+        return m_arena->make<LogicalExpressionNode>(token, LogicalOperator::NOT, operand);
     }
-    if (canConsume(TokenType::LEFT_CURLY))
+    if (tryConsume(TokenType::LEFT_CURLY))
     {
-        consume(TokenType::LEFT_CURLY);
-        auto result = parseExpression(scope, nullptr);
+        auto expression = parseExpression(scope);
         consume(TokenType::RIGHT_CURLY);
-        if (auto binOp = std::dynamic_pointer_cast<BinaryOperationNode>(lhs))
-        {
-            result = std::make_shared<BinaryOperationNode>(binOp->expressionToken(), binOp->binoperator(), binOp->lhs(),
-                                                           result);
-        }
-        return parseExpression(scope, result);
+        return expression;
     }
+    return parseToken(scope);
+}
 
-    if (includeCompare)
-    {
-        if (canConsume(TokenType::GREATER))
-        {
-            consume(TokenType::GREATER);
-            auto operatorToken = current();
-            checkLhsExists(lhs, operatorToken);
-            if (canConsume(TokenType::EQUAL))
-            {
-                consume(TokenType::EQUAL);
-                auto rhs = parseBaseExpression(scope);
-                return std::make_shared<ComparrisionNode>(operatorToken, CMPOperator::GREATER_EQUAL, lhs, rhs);
-            }
-            auto rhs = parseBaseExpression(scope);
-            return parseExpression(scope,
-                                   std::make_shared<ComparrisionNode>(operatorToken, CMPOperator::GREATER, lhs, rhs));
-        }
-
-        if (canConsume(TokenType::LESS))
+ASTNode *Parser::parseBinaryExpression(const size_t scope, const Precedence minimumPrecedence)
+{
+    auto lhs = parseOperand(scope);
+    bool compared = false;
+    // the operators of the same precedence are applied in this loop from left to right, only an operator which binds
+    // stronger parses its right operand in a nested call
+    while (hasNext())
+    {
+        const auto binary = binaryOperator(m_tokens.peek(1), m_tokens.peek(2));
+        if (binary.precedence == Precedence::NONE)
+            break;
+        if (binary.precedence < minimumPrecedence)
         {
-            consume(TokenType::LESS);
-            auto operatorToken = current();
-            checkLhsExists(lhs, operatorToken);
-            if (canConsume(TokenType::EQUAL))
-            {
-                consume(TokenType::EQUAL);
-                auto rhs = parseBaseExpression(scope);
-                return std::make_shared<ComparrisionNode>(operatorToken, CMPOperator::LESS_EQUAL, lhs, rhs);
-            }
-            auto rhs = parseBaseExpression(scope);
-            return parseExpression(scope,
-                                   std::make_shared<ComparrisionNode>(operatorToken, CMPOperator::LESS, lhs, rhs));
+            // the operand is missing, e.g. the second = of "a == b"
+            checkLhsExists(lhs, m_tokens.peek(1));
+            break;
         }
 
-        if (canConsume(TokenType::BANG) && canConsume(TokenType::EQUAL, 2))
+        const Token operatorToken = next();
+        for (size_t i = 1; i < binary.length; ++i)
+            next();
+        checkLhsExists(lhs, operatorToken);
+        // like in pascal comparisons are not chained, "a = b = c" has to be written with parentheses
+        if (binary.precedence == Precedence::COMPARISON && compared)
         {
-            consume(TokenType::BANG);
-            consume(TokenType::EQUAL);
-            auto operatorToken = current();
-            checkLhsExists(lhs, operatorToken);
-            auto rhs = parseBaseExpression(scope);
-            return parseExpression(
-                    scope, std::make_shared<ComparrisionNode>(operatorToken, CMPOperator::NOT_EQUALS, lhs, rhs));
+            m_errors.push_back(ParserError{.token = operatorToken,
+                                           .message = "the result of a comparison can not be compared without "
+                                                      "parentheses!"});
         }
+        auto rhs = parseBinaryExpression(scope, nextPrecedence(binary.precedence));
+        // a comparison without a right operand was already reported, e.g. the first = of "a == b"
+        compared = compared || (binary.precedence == Precedence::COMPARISON && rhs != nullptr);
 
-        if (canConsume(TokenType::EQUAL))
-        {
-            consume(TokenType::EQUAL);
-            auto operatorToken = current();
-            checkLhsExists(lhs, operatorToken);
-            auto rhs = parseBaseExpression(scope);
-            return parseExpression(scope,
-                                   std::make_shared<ComparrisionNode>(operatorToken, CMPOperator::EQUALS, lhs, rhs));
-        }
+        if (const auto *operation = std::get_if<Operator>(&binary.operation))
+            lhs = m_arena->make<BinaryOperationNode>(operatorToken, *operation, lhs, rhs);
+        else if (const auto *comparison = std::get_if<CMPOperator>(&binary.operation))
+            lhs = m_arena->make<ComparrisionNode>(operatorToken, *comparison, lhs, rhs);
+        else
+            lhs = m_arena->make<LogicalExpressionNode>(operatorToken, std::get<LogicalOperator>(binary.operation),
+                                                       lhs, rhs);
     }
-
     return lhs;
 }
 
-std::shared_ptr<ASTNode> Parser::parseExpression(const size_t scope, const std::shared_ptr<ASTNode> &origLhs)
-{
-    auto lhs = parseLogicalExpression(scope, origLhs);
-    if (!lhs)
-        lhs = origLhs;
-
-    if (!lhs)
-        lhs = parseBaseExpression(scope);
-
-    if (auto rhs = parseLogicalExpression(scope, parseBaseExpression(scope, lhs)))
-        return rhs;
-
-    return lhs;
-}
+ASTNode *Parser::parseExpression(const size_t scope) { return parseBinaryExpression(scope, Precedence::OR); }
 
-std::shared_ptr<ASTNode> Parser::parseVariableAssignment(size_t scope)
+ASTNode *Parser::parseVariableAssignment(size_t scope)
 {
     consume(TokenType::NAMEDTOKEN);
     auto currentToken = current();
@@ -688,7 +795,7 @@ std::shared_ptr<ASTNode> Parser::parseVariableAssignment(size_t scope)
             return nullptr;
         }
 
-        if (!isVariableDefined(variableName, scope))
+        if (!isVariableDefined(variableNameToken.identifier(), scope))
         {
             m_errors.push_back(
                     ParserError{.token = currentToken,
@@ -697,7 +804,7 @@ std::shared_ptr<ASTNode> Parser::parseVariableAssignment(size_t scope)
 
         // parse expression
         auto expression = parseExpression(scope);
-        return std::make_shared<VariableAssignmentNode>(variableNameToken, expression, dereference);
+        return m_arena->make<VariableAssignmentNode>(variableNameToken, expression, dereference);
     }
     else if (canConsume(TokenType::DOT))
     {
@@ -716,7 +823,7 @@ std::shared_ptr<ASTNode> Parser::parseVariableAssignment(size_t scope)
             return nullptr;
         }
 
-        if (!isVariableDefined(variableName, scope))
+        if (!isVariableDefined(variableNameToken.identifier(), scope))
         {
             m_errors.push_back(
                     ParserError{.token = currentToken,
@@ -729,7 +836,7 @@ std::shared_ptr<ASTNode> Parser::parseVariableAssignment(size_t scope)
 
         auto variable = currentToken;
         auto field = fieldName;
-        return std::make_shared<FieldAssignmentNode>(variable, field, expression);
+        return m_arena->make<FieldAssignmentNode>(variable, field, expression);
     }
     else
     {
@@ -743,7 +850,7 @@ std::shared_ptr<ASTNode> Parser::parseVariableAssignment(size_t scope)
             return nullptr;
         }
 
-        if (!isVariableDefined(variableName, scope))
+        if (!isVariableDefined(variableNameToken.identifier(), scope))
         {
             m_errors.push_back(
                     ParserError{.token = currentToken,
@@ -751,10 +858,10 @@ std::shared_ptr<ASTNode> Parser::parseVariableAssignment(size_t scope)
             return nullptr;
         }
         auto expression = parseExpression(scope);
-        return std::make_shared<ArrayAssignmentNode>(variableNameToken, index, expression);
+        return m_arena->make<ArrayAssignmentNode>(variableNameToken, index, expression);
     }
 }
-std::shared_ptr<ASTNode> Parser::parseVariableAccess(const size_t scope)
+ASTNode *Parser::parseVariableAccess(const size_t scope)
 {
     consume(TokenType::NAMEDTOKEN);
     auto token = current();
@@ -762,44 +869,44 @@ std::shared_ptr<ASTNode> Parser::parseVariableAccess(const size_t scope)
     if (canConsume(TokenType::LEFT_SQUAR))
     {
         const Token arrayName = token;
-        if (!isVariableDefined(token.lexical(), scope))
+        if (!isVariableDefined(token.identifier(), scope))
         {
             m_errors.push_back(
                     ParserError{.token = token,
-                                .message = "A variable with the name '" + token.lexical() + "' is not yet defined!"});
+                                .message = "A variable with the name '" + std::string(token.lexical()) + "' is not yet defined!"});
             return nullptr;
         }
         consume(TokenType::LEFT_SQUAR);
         auto indexNode = parseExpression(scope);
         consume(TokenType::RIGHT_SQUAR);
-        return std::make_shared<ArrayAccessNode>(arrayName, indexNode);
+        return m_arena->make<ArrayAccessNode>(arrayName, indexNode);
     }
     if (canConsume(TokenType::DOT))
     {
         consume(TokenType::DOT);
         consume(TokenType::NAMEDTOKEN);
         Token field = current();
-        if (!isVariableDefined(token.lexical(), scope))
+        if (!isVariableDefined(token.identifier(), scope))
         {
             m_errors.push_back(
                     ParserError{.token = token,
-                                .message = "A variable with the name '" + token.lexical() + "' is not yet defined!"});
+                                .message = "A variable with the name '" + std::string(token.lexical()) + "' is not yet defined!"});
             return nullptr;
         }
-        return std::make_shared<FieldAccessNode>(token, field);
+        return m_arena->make<FieldAccessNode>(token, field);
     }
 
-    if (!isVariableDefined(token.lexical(), scope))
+    if (!isVariableDefined(token.identifier(), scope))
     {
         m_errors.push_back(ParserError{
-                .token = token, .message = "A variable with the name '" + token.lexical() + "' is not yet defined!"});
+                .token = token, .message = "A variable with the name '" + std::string(token.lexical()) + "' is not yet defined!"});
         return nullptr;
     }
     auto dereference = tryConsume(TokenType::CARET);
 
-    return std::make_shared<VariableAccessNode>(token, dereference);
+    return m_arena->make<VariableAccessNode>(token, dereference);
 }
-std::shared_ptr<ASTNode> Parser::parseToken(const size_t scope)
+ASTNode *Parser::parseToken(const size_t scope)
 {
     if (canConsume(TokenType::NUMBER))
     {
@@ -809,12 +916,12 @@ std::shared_ptr<ASTNode> Parser::parseToken(const size_t scope)
     {
         consume(TokenType::STRING);
 
-        return std::make_shared<StringConstantNode>(current(), std::string(current().lexical()));
+        return m_arena->make<StringConstantNode>(current(), std::string(current().lexical()));
     }
     if (canConsume(TokenType::CHAR))
     {
         consume(TokenType::CHAR);
-        return std::make_shared<CharConstantNode>(current(), std::string(current().lexical()));
+        return m_arena->make<CharConstantNode>(current(), std::string(current().lexical()));
     }
     if (canConsume(TokenType::ESCAPED_STRING))
     {
@@ -826,7 +933,7 @@ std::shared_ptr<ASTNode> Parser::parseToken(const size_t scope)
         consume(TokenType::AT);
         consume(TokenType::NAMEDTOKEN);
         Token field = current();
-        return std::make_shared<AddressNode>(field);
+        return m_arena->make<AddressNode>(field);
     }
     if (canConsume(TokenType::NAMEDTOKEN))
     {
@@ -837,61 +944,61 @@ std::shared_ptr<ASTNode> Parser::parseToken(const size_t scope)
 
         return parseVariableAccess(scope);
     }
-    if (tryConsumeKeyWord("true"))
+    if (tryConsumeKeyWord(Keyword::K_TRUE))
     {
-        return std::make_shared<BooleanNode>(current(), true);
+        return m_arena->make<BooleanNode>(current(), true);
     }
-    if (tryConsumeKeyWord("false"))
+    if (tryConsumeKeyWord(Keyword::K_FALSE))
     {
-        return std::make_shared<BooleanNode>(current(), false);
+        return m_arena->make<BooleanNode>(current(), false);
     }
     return nullptr;
 }
-std::shared_ptr<FunctionDefinitionNode> Parser::parseFunctionDeclaration(size_t scope, bool isFunction)
+FunctionDefinitionNode *Parser::parseFunctionDeclaration(size_t scope, bool isFunction)
 {
     consume(TokenType::NAMEDTOKEN);
     auto functionNameToken = current();
-    auto functionName = current().lexical();
-    m_known_function_names.push_back(functionName);
+    auto functionName = std::string(current().lexical());
+    m_known_function_names.insert(functionNameToken.identifier());
     std::string libName;
     std::string externalName = functionName;
 
-    std::shared_ptr<FunctionDefinitionNode> functionDefinition = nullptr;
-
     consume(TokenType::LEFT_CURLY);
     auto token = next();
     std::vector<FunctionArgument> functionParams;
     std::vector<FunctionAttribute> functionAttributes;
-    while (token.tokenType != TokenType::RIGHT_CURLY)
+    while (token.tokenType() != TokenType::RIGHT_CURLY)
     {
 
         bool isReference = false;
-        if (token.tokenType == TokenType::KEYWORD && iequals(token.lexical(), "var"))
+        if (token.keyword() == Keyword::VAR)
         {
             next();
             isReference = true;
         }
         token = current();
-        const std::string funcParamName = token.lexical();
-        std::vector<std::string> paramNames;
-        paramNames.push_back(funcParamName);
+        const std::string funcParamName(token.lexical());
+        std::vector<Token> paramNames;
+        paramNames.push_back(token);
         while (canConsume(TokenType::COMMA))
         {
             consume(TokenType::COMMA);
             consume(TokenType::NAMEDTOKEN);
-            paramNames.emplace_back(current().lexical());
+            paramNames.push_back(current());
         }
 
         consume(TokenType::COLON);
         if (canConsume(TokenType::NAMEDTOKEN))
         {
             token = next();
-            auto type = determinVariableTypeByName(token.lexical());
+            auto type = determinVariableTypeByName(token.identifier());
 
-            for (const auto &param: paramNames)
+            for (const auto &paramToken: paramNames)
             {
-
-                if (isVariableDefined(param, scope))
+                const auto param = std::string(paramToken.lexical());
+                // the params may shadow the variables and constants of the unit, but not each other
+                if (std::ranges::any_of(functionParams, [&param](const FunctionArgument &argument)
+                                        { return iequals(argument.argumentName, param); }))
                 {
                     m_errors.push_back(ParserError{
                             .token = token, .message = "A variable with the name " + param + " was allready defined!"});
@@ -899,7 +1006,7 @@ std::shared_ptr<FunctionDefinitionNode> Parser::parseFunctionDeclaration(size_t
                 else if (!type.has_value())
                 {
                     m_errors.push_back(ParserError{.token = token,
-                                                   .message = "A type " + token.lexical() + " of the variable " +
+                                                   .message = "A type " + std::string(token.lexical()) + " of the variable " +
                                                               param + " could not be determined!"});
                 }
                 else
@@ -912,14 +1019,15 @@ std::shared_ptr<FunctionDefinitionNode> Parser::parseFunctionDeclaration(size_t
             }
             tryConsume(TokenType::SEMICOLON);
         }
-        else if (canConsumeKeyWord("file"))
+        else if (canConsumeKeyWord(Keyword::FILE))
         {
-            consumeKeyWord("file");
+            consumeKeyWord(Keyword::FILE);
             std::shared_ptr<VariableType> variableType = FileType::getFileType();
-            for (const auto &param: paramNames)
+            for (const auto &paramToken: paramNames)
             {
-                functionParams.push_back(
-                        FunctionArgument{.type = variableType, .argumentName = param, .isReference = isReference});
+                functionParams.push_back(FunctionArgument{.type = variableType,
+                                                          .argumentName = std::string(paramToken.lexical()),
+                                                          .isReference = isReference});
             }
             tryConsume(TokenType::SEMICOLON);
         }
@@ -945,8 +1053,8 @@ std::shared_ptr<FunctionDefinitionNode> Parser::parseFunctionDeclaration(size_t
 
     if (isFunction && consume(TokenType::NAMEDTOKEN))
     {
-        const auto typeName = current().lexical();
-        const auto type = determinVariableTypeByName(typeName);
+        const auto typeName = std::string(current().lexical());
+        const auto type = determinVariableTypeByName(current().identifier());
         if (!type)
         {
             m_errors.push_back(
@@ -960,74 +1068,76 @@ std::shared_ptr<FunctionDefinitionNode> Parser::parseFunctionDeclaration(size_t
     }
     consume(TokenType::SEMICOLON);
 
-    if (tryConsumeKeyWord("external"))
+    if (tryConsumeKeyWord(Keyword::EXTERNAL))
     {
         if (tryConsume(TokenType::STRING) || tryConsume(TokenType::CHAR))
             libName = std::string(current().lexical());
 
-        if (tryConsumeKeyWord("name"))
+        if (tryConsumeKeyWord(Keyword::NAME))
         {
             consume(TokenType::STRING);
             externalName = std::string(current().lexical());
         }
         tryConsume(TokenType::SEMICOLON);
     }
-    else if (tryConsumeKeyWord("inline"))
+    else if (tryConsumeKeyWord(Keyword::INLINE))
     {
         functionAttributes.emplace_back(FunctionAttribute::Inline);
         consume(TokenType::SEMICOLON);
     }
 
 
-    return std::make_shared<FunctionDefinitionNode>(functionNameToken, functionName, externalName, libName,
+    return m_arena->make<FunctionDefinitionNode>(functionNameToken, functionName, externalName, libName,
                                                     functionParams, !isFunction, returnType);
 }
-std::shared_ptr<FunctionDefinitionNode> Parser::parseFunctionDefinition(size_t scope, bool isFunction)
+FunctionDefinitionNode *Parser::parseFunctionDefinition(size_t scope, bool isFunction)
 {
     consume(TokenType::NAMEDTOKEN);
     auto functionNameToken = current();
-    auto functionName = current().lexical();
-    m_known_function_names.push_back(functionName);
+    auto functionName = std::string(current().lexical());
+    m_known_function_names.insert(functionNameToken.identifier());
+    // the parameters, the result and the local variables are only visible in the function
+    m_symbols.pushScope();
     bool isExternalFunction = false;
     std::string libName;
     std::string externalName = functionName;
 
-    std::shared_ptr<FunctionDefinitionNode> functionDefinition = nullptr;
+    FunctionDefinitionNode *functionDefinition = nullptr;
 
     consume(TokenType::LEFT_CURLY);
     auto token = next();
     std::vector<FunctionArgument> functionParams;
     std::vector<FunctionAttribute> functionAttributes;
-    while (token.tokenType != TokenType::RIGHT_CURLY)
+    while (token.tokenType() != TokenType::RIGHT_CURLY)
     {
 
         bool isReference = false;
-        if (token.tokenType == TokenType::KEYWORD && iequals(token.lexical(), "var"))
+        if (token.keyword() == Keyword::VAR)
         {
             next();
             isReference = true;
         }
         token = current();
-        const std::string funcParamName = token.lexical();
-        std::vector<std::string> paramNames;
-        paramNames.push_back(funcParamName);
+        const std::string funcParamName(token.lexical());
+        std::vector<Token> paramNames;
+        paramNames.push_back(token);
         while (canConsume(TokenType::COMMA))
         {
             consume(TokenType::COMMA);
             consume(TokenType::NAMEDTOKEN);
-            paramNames.emplace_back(current().lexical());
+            paramNames.push_back(current());
         }
 
         consume(TokenType::COLON);
         if (canConsume(TokenType::NAMEDTOKEN))
         {
             token = next();
-            auto type = determinVariableTypeByName(token.lexical());
+            auto type = determinVariableTypeByName(token.identifier());
 
-            for (const auto &param: paramNames)
+            for (const auto &paramToken: paramNames)
             {
-
-                if (isVariableDefined(param, scope))
+                const auto param = std::string(paramToken.lexical());
+                if (isVariableDeclaredIn(paramToken.identifier(), scope + 1))
                 {
                     m_errors.push_back(ParserError{
                             .token = token, .message = "A variable with the name " + param + " was allready defined!"});
@@ -1035,14 +1145,16 @@ std::shared_ptr<FunctionDefinitionNode> Parser::parseFunctionDefinition(size_t s
                 else if (!type.has_value())
                 {
                     m_errors.push_back(ParserError{.token = token,
-                                                   .message = "A type " + token.lexical() + " of the variable " +
+                                                   .message = "A type " + std::string(token.lexical()) + " of the variable " +
                                                               param + " could not be determined!"});
                 }
                 else
                 {
 
-                    m_known_variable_definitions.push_back(
-                            VariableDefinition{.variableType = type.value(), .variableName = param, .scopeId = scope});
+                    m_symbols.declare(VariableDefinition{.variableType = type.value(),
+                                                         .variableName = param,
+                                                         .identifier = paramToken.identifier(),
+                                                         .scopeId = scope + 1});
 
                     functionParams.push_back(
                             FunctionArgument{.type = type.value(), .argumentName = param, .isReference = isReference});
@@ -1064,7 +1176,7 @@ std::shared_ptr<FunctionDefinitionNode> Parser::parseFunctionDefinition(size_t s
         if (!tryConsume(TokenType::COLON))
         {
             m_errors.push_back(
-                    ParserError{.token = m_tokens[m_current + 1],
+                    ParserError{.token = m_tokens.peek(1),
                                 .message = "the return type for the function \"" + functionName + "\" is missing."});
             throw ParserException(m_errors);
         }
@@ -1072,8 +1184,8 @@ std::shared_ptr<FunctionDefinitionNode> Parser::parseFunctionDefinition(size_t s
 
     if (isFunction && consume(TokenType::NAMEDTOKEN))
     {
-        const auto typeName = current().lexical();
-        const auto type = determinVariableTypeByName(typeName);
+        const auto typeName = std::string(current().lexical());
+        const auto type = determinVariableTypeByName(current().identifier());
         if (!type)
         {
             m_errors.push_back(
@@ -1085,27 +1197,31 @@ std::shared_ptr<FunctionDefinitionNode> Parser::parseFunctionDefinition(size_t s
             returnType = type.value();
         }
 
-        m_known_variable_definitions.push_back(
-                VariableDefinition{.variableType = returnType, .variableName = functionName, .scopeId = scope});
-        m_known_variable_definitions.push_back(
-                VariableDefinition{.variableType = returnType, .variableName = "result", .scopeId = scope});
+        m_symbols.declare(VariableDefinition{.variableType = returnType,
+                                             .variableName = functionName,
+                                             .identifier = functionNameToken.identifier(),
+                                             .scopeId = scope + 1});
+        m_symbols.declare(VariableDefinition{.variableType = returnType,
+                                             .variableName = "result",
+                                             .identifier = Identifiers::intern("result"),
+                                             .scopeId = scope + 1});
     }
     consume(TokenType::SEMICOLON);
 
-    if (tryConsumeKeyWord("external"))
+    if (tryConsumeKeyWord(Keyword::EXTERNAL))
     {
         isExternalFunction = true;
         if (tryConsume(TokenType::STRING) || tryConsume(TokenType::CHAR))
             libName = std::string(current().lexical());
 
-        if (tryConsumeKeyWord("name"))
+        if (tryConsumeKeyWord(Keyword::NAME))
         {
             consume(TokenType::STRING);
             externalName = std::string(current().lexical());
         }
         tryConsume(TokenType::SEMICOLON);
     }
-    else if (tryConsumeKeyWord("inline"))
+    else if (tryConsumeKeyWord(Keyword::INLINE))
     {
         functionAttributes.emplace_back(FunctionAttribute::Inline);
         consume(TokenType::SEMICOLON);
@@ -1115,7 +1231,7 @@ std::shared_ptr<FunctionDefinitionNode> Parser::parseFunctionDefinition(size_t s
     // parse function body
     if (isExternalFunction)
     {
-        functionDefinition = std::make_shared<FunctionDefinitionNode>(functionNameToken, functionName, externalName,
+        functionDefinition = m_arena->make<FunctionDefinitionNode>(functionNameToken, functionName, externalName,
                                                                       libName, functionParams, !isFunction, returnType);
     }
     else
@@ -1126,46 +1242,25 @@ std::shared_ptr<FunctionDefinitionNode> Parser::parseFunctionDefinition(size_t s
         {
             functionBody->addVariableDefinition(VariableDefinition{.variableType = returnType,
                                                                    .variableName = functionName,
+                                                                   .identifier = functionNameToken.identifier(),
                                                                    .alias = "result",
                                                                    .scopeId = 0,
                                                                    .value = nullptr,
                                                                    .constant = false});
         }
-        functionDefinition = std::make_shared<FunctionDefinitionNode>(functionNameToken, functionName, functionParams,
+        functionDefinition = m_arena->make<FunctionDefinitionNode>(functionNameToken, functionName, functionParams,
                                                                       functionBody, !isFunction, returnType);
         for (auto attribute: functionAttributes)
             functionDefinition->addAttribute(attribute);
-
-        for (auto &def: functionBody->getVariableDefinitions())
-        {
-            m_known_variable_definitions.erase(
-                    std::ranges::remove_if(m_known_variable_definitions, [def](const VariableDefinition &value)
-                                           { return def.variableName == value.variableName; })
-                            .begin());
-            if (!def.alias.empty())
-            {
-                m_known_variable_definitions.erase(std::ranges::remove_if(m_known_variable_definitions,
-                                                                          [def](const VariableDefinition &value)
-                                                                          { return def.alias == value.variableName; })
-                                                           .begin());
-            }
-        }
     }
 
-
-    for (auto &param: functionParams)
-    {
-        m_known_variable_definitions.erase(std::ranges::remove_if(m_known_variable_definitions,
-                                                                  [param](const VariableDefinition &value)
-                                                                  { return param.argumentName == value.variableName; })
-                                                   .begin());
-    }
+    m_symbols.popScope();
     return functionDefinition;
 }
 
-std::shared_ptr<ASTNode> Parser::parseStatement(size_t scope, bool withSemicolon)
+ASTNode *Parser::parseStatement(size_t scope, bool withSemicolon)
 {
-    std::shared_ptr<ASTNode> result = nullptr;
+    ASTNode *result = nullptr;
     if (canConsume(TokenType::NAMEDTOKEN))
     {
         if (canConsume(TokenType::LEFT_CURLY, 2))
@@ -1186,9 +1281,9 @@ std::shared_ptr<ASTNode> Parser::parseStatement(size_t scope, bool withSemicolon
     if (!result)
     {
         m_errors.push_back(
-                ParserError{.token = m_tokens[m_current + 1],
+                ParserError{.token = m_tokens.peek(1),
                             .message = "unexpected token found " +
-                                       std::string(magic_enum::enum_name(m_tokens[m_current + 1].tokenType)) + "!"});
+                                       std::string(magic_enum::enum_name(m_tokens.peek(1).tokenType())) + "!"});
     }
 
     return result;
@@ -1197,41 +1292,41 @@ std::shared_ptr<ASTNode> Parser::parseStatement(size_t scope, bool withSemicolon
 
 void Parser::parseConstantDefinitions(size_t scope, std::vector<VariableDefinition> &variable_definitions)
 {
-    if (tryConsumeKeyWord("const"))
+    if (tryConsumeKeyWord(Keyword::K_CONST))
     {
         while (!canConsume(TokenType::KEYWORD))
         {
-            const auto definition = parseConstantDefinition(scope);
+            auto definition = parseConstantDefinition(scope);
             if (definition.has_value())
             {
-                variable_definitions.push_back(definition.value());
-                m_known_variable_definitions.push_back(definition.value());
+                m_symbols.declare(definition.value());
+                variable_definitions.push_back(std::move(definition.value()));
             }
         }
     }
 }
-std::shared_ptr<BlockNode> Parser::parseBlock(const size_t scope)
+BlockNode *Parser::parseBlock(const size_t scope)
 {
     std::vector<VariableDefinition> variable_definitions;
 
     parseConstantDefinitions(scope, variable_definitions);
 
-    if (tryConsumeKeyWord("var"))
+    if (tryConsumeKeyWord(Keyword::VAR))
     {
-        while (!canConsumeKeyWord("begin"))
+        while (!canConsumeKeyWord(Keyword::BEGIN))
         {
             auto def = parseVariableDefinitions(scope);
             for (auto &definition: def)
             {
-                variable_definitions.push_back(definition);
-                m_known_variable_definitions.push_back(definition);
+                m_symbols.declare(definition);
+                variable_definitions.push_back(std::move(definition));
             }
         }
     }
-    consumeKeyWord("begin");
+    consumeKeyWord(Keyword::BEGIN);
     auto beginToken = current();
-    std::vector<std::shared_ptr<ASTNode>> expressions;
-    while (!tryConsumeKeyWord("end"))
+    std::vector<ASTNode *> expressions;
+    while (!tryConsumeKeyWord(Keyword::END))
     {
         if (auto statement = parseStatement(scope))
         {
@@ -1247,19 +1342,19 @@ std::shared_ptr<BlockNode> Parser::parseBlock(const size_t scope)
         }
     }
 
-    return std::make_shared<BlockNode>(beginToken, variable_definitions, expressions);
+    return m_arena->make<BlockNode>(beginToken, variable_definitions, expressions);
 }
-std::shared_ptr<ASTNode> Parser::parseKeyword(size_t scope, bool withSemicolon)
+ASTNode *Parser::parseKeyword(size_t scope, bool withSemicolon)
 {
-    if (tryConsumeKeyWord("if"))
+    if (tryConsumeKeyWord(Keyword::IF))
     {
         auto ifToken = current();
 
         auto condition = parseExpression(scope);
-        std::vector<std::shared_ptr<ASTNode>> ifStatements;
-        std::vector<std::shared_ptr<ASTNode>> elseStatements;
-        consumeKeyWord("then");
-        auto blockIf = canConsumeKeyWord("begin");
+        std::vector<ASTNode *> ifStatements;
+        std::vector<ASTNode *> elseStatements;
+        consumeKeyWord(Keyword::THEN);
+        auto blockIf = canConsumeKeyWord(Keyword::BEGIN);
         if (blockIf)
         {
             ifStatements.emplace_back(parseBlock(scope + 1));
@@ -1269,9 +1364,9 @@ std::shared_ptr<ASTNode> Parser::parseKeyword(size_t scope, bool withSemicolon)
         {
             ifStatements.emplace_back(parseStatement(scope, false));
         }
-        if (tryConsumeKeyWord("else"))
+        if (tryConsumeKeyWord(Keyword::ELSE))
         {
-            if (canConsumeKeyWord("begin"))
+            if (canConsumeKeyWord(Keyword::BEGIN))
             {
                 elseStatements.emplace_back(parseBlock(scope + 1));
                 tryConsume(TokenType::SEMICOLON);
@@ -1286,42 +1381,46 @@ std::shared_ptr<ASTNode> Parser::parseKeyword(size_t scope, bool withSemicolon)
             consume(TokenType::SEMICOLON);
         }
 
-        return std::make_shared<IfConditionNode>(ifToken, condition, ifStatements, elseStatements);
+        return m_arena->make<IfConditionNode>(ifToken, condition, ifStatements, elseStatements);
     }
 
-    if (tryConsumeKeyWord("for"))
+    if (tryConsumeKeyWord(Keyword::FOR))
     {
         auto forToken = current();
         consume(TokenType::NAMEDTOKEN);
         auto loopVariable = std::string(current().lexical());
-        m_known_variable_definitions.push_back(VariableDefinition{
-                .variableType = VariableType::getInteger(64), .variableName = loopVariable, .scopeId = scope + 1});
+        // the loop variable is only visible in the loop
+        m_symbols.pushScope();
+        m_symbols.declare(VariableDefinition{.variableType = VariableType::getInteger(64),
+                                             .variableName = loopVariable,
+                                             .identifier = current().identifier(),
+                                             .scopeId = scope + 1});
         consume(TokenType::COLON);
         consume(TokenType::EQUAL);
-        auto loopStart = parseBaseExpression(scope + 1);
+        auto loopStart = parseExpression(scope + 1);
         int increment;
-        if (tryConsumeKeyWord("to"))
+        if (tryConsumeKeyWord(Keyword::TO))
         {
             increment = 1;
         }
-        else if (tryConsumeKeyWord("downto"))
+        else if (tryConsumeKeyWord(Keyword::DOWNTO))
         {
             increment = -1;
         }
         else
         {
-            m_errors.push_back(ParserError{.token = m_tokens[m_current + 1],
+            m_errors.push_back(ParserError{.token = m_tokens.peek(1),
                                            .message = "expected keyword  'to' or 'downto' but found " +
-                                                      std::string(m_tokens[m_current + 1].lexical()) + "!"});
+                                                      std::string(m_tokens.peek(1).lexical()) + "!"});
             throw ParserException(m_errors);
         }
-        auto loopEnd = parseBaseExpression(scope + 1);
+        auto loopEnd = parseExpression(scope + 1);
 
-        std::vector<std::shared_ptr<ASTNode>> forNodes;
+        std::vector<ASTNode *> forNodes;
 
-        consumeKeyWord("do");
+        consumeKeyWord(Keyword::DO);
 
-        if (canConsumeKeyWord("begin"))
+        if (canConsumeKeyWord(Keyword::BEGIN))
         {
             forNodes.emplace_back(parseBlock(scope + 1));
             if (withSemicolon)
@@ -1331,19 +1430,19 @@ std::shared_ptr<ASTNode> Parser::parseKeyword(size_t scope, bool withSemicolon)
         {
             forNodes.emplace_back(parseStatement(scope));
         }
+        m_symbols.popScope();
 
-
-        return std::make_shared<ForNode>(forToken, loopVariable, loopStart, loopEnd, forNodes, increment);
+        return m_arena->make<ForNode>(forToken, loopVariable, loopStart, loopEnd, forNodes, increment);
     }
-    if (tryConsumeKeyWord("while"))
+    if (tryConsumeKeyWord(Keyword::WHILE))
     {
         auto whileToken = current();
 
         auto expression = parseExpression(scope + 1);
-        std::vector<std::shared_ptr<ASTNode>> whileNodes;
+        std::vector<ASTNode *> whileNodes;
 
-        consumeKeyWord("do");
-        if (!canConsumeKeyWord("begin"))
+        consumeKeyWord(Keyword::DO);
+        if (!canConsumeKeyWord(Keyword::BEGIN))
         {
             whileNodes.push_back(parseStatement(scope));
             tryConsume(TokenType::SEMICOLON);
@@ -1355,15 +1454,15 @@ std::shared_ptr<ASTNode> Parser::parseKeyword(size_t scope, bool withSemicolon)
                 consume(TokenType::SEMICOLON);
         }
 
-        return std::make_shared<WhileNode>(whileToken, expression, whileNodes);
+        return m_arena->make<WhileNode>(whileToken, expression, whileNodes);
     }
 
-    if (tryConsumeKeyWord("repeat"))
+    if (tryConsumeKeyWord(Keyword::REPEAT))
     {
         auto repeatToken = current();
 
-        std::vector<std::shared_ptr<ASTNode>> whileNodes;
-        if (!canConsumeKeyWord("begin"))
+        std::vector<ASTNode *> whileNodes;
+        if (!canConsumeKeyWord(Keyword::BEGIN))
         {
             whileNodes.push_back(parseStatement(scope));
         }
@@ -1373,40 +1472,40 @@ std::shared_ptr<ASTNode> Parser::parseKeyword(size_t scope, bool withSemicolon)
         }
         tryConsume(TokenType::SEMICOLON);
 
-        consumeKeyWord("until");
+        consumeKeyWord(Keyword::UNTIL);
         auto expression = parseExpression(scope + 1);
         if (withSemicolon)
             tryConsume(TokenType::SEMICOLON);
 
-        return std::make_shared<RepeatUntilNode>(repeatToken, expression, whileNodes);
+        return m_arena->make<RepeatUntilNode>(repeatToken, expression, whileNodes);
     }
 
-    if (tryConsumeKeyWord("break"))
+    if (tryConsumeKeyWord(Keyword::BREAK))
     {
         if (withSemicolon)
             tryConsume(TokenType::SEMICOLON);
-        return std::make_shared<BreakNode>(current());
+        return m_arena->make<BreakNode>(current());
     }
 
     m_errors.push_back(
-            ParserError{.token = m_tokens[m_current + 1],
-                        .message = "unexpected keyword found " + std::string(m_tokens[m_current + 1].lexical()) + "!"});
+            ParserError{.token = m_tokens.peek(1),
+                        .message = "unexpected keyword found " + std::string(m_tokens.peek(1).lexical()) + "!"});
 
     return nullptr;
 }
-std::shared_ptr<ASTNode> Parser::parseFunctionCall(const size_t scope)
+ASTNode *Parser::parseFunctionCall(const size_t scope)
 {
     consume(TokenType::NAMEDTOKEN);
     auto nameToken = current();
-    auto functionName = current().lexical();
-    const bool isSysCall = isKnownSystemCall(functionName);
-    if (!isSysCall && !isFunctionDeclared(functionName))
+    auto functionName = std::string(current().lexical());
+    const bool isSysCall = isKnownSystemCall(nameToken.identifier());
+    if (!isSysCall && !isFunctionDeclared(nameToken.identifier()))
     {
         m_errors.push_back(ParserError{
                 .token = current(), .message = "a function with the name '" + functionName + "' is not yet defined!"});
     }
 
-    std::vector<std::shared_ptr<ASTNode>> callArgs;
+    std::vector<ASTNode *> callArgs;
     consume(TokenType::LEFT_CURLY);
     while (true)
     {
@@ -1424,12 +1523,12 @@ std::shared_ptr<ASTNode> Parser::parseFunctionCall(const size_t scope)
     consume(TokenType::RIGHT_CURLY);
     if (isSysCall)
     {
-        return std::make_shared<SystemFunctionCallNode>(nameToken, functionName, callArgs);
+        return m_arena->make<SystemFunctionCallNode>(nameToken, functionName, callArgs);
     }
-    return std::make_shared<FunctionCallNode>(nameToken, functionName, callArgs);
+    return m_arena->make<FunctionCallNode>(nameToken, functionName, callArgs);
 }
 
-bool Parser::importUnit(const Token &token, const std::string &filename, bool includeSystem)
+std::filesystem::path Parser::resolveUnitPath(const std::string &filename) const
 {
     auto path = this->m_file_path.parent_path() / filename;
     auto it = m_rtlDirectories.begin();
@@ -1440,122 +1539,443 @@ bool Parser::importUnit(const Token &token, const std::string &filename, bool in
         path = *it / filename;
         ++it;
     }
-    if (!unitCache.contains(path.string()))
+    return path;
+}
+
+UnitImport Parser::loadUnit(const std::filesystem::path &path, const std::string &filename, bool includeSystem) const
+{
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error))
+    {
+        return {};
+    }
+    // the cache lives as long as the process, e.g. in server mode, so every set of defines needs its own entry.
+    // The path is absolute, because the server changes its working directory for every request
+    std::vector<std::string> defines;
+    for (auto &[name, value]: m_definitions)
+    {
+        defines.push_back(name + (value ? "=1" : "=0"));
+    }
+    std::ranges::sort(defines);
+    auto key = std::filesystem::absolute(path, error).lexically_normal().string();
+    for (auto &define: defines)
+    {
+        key += ";" + define;
+    }
+    // the interface of a unit whose bodies are compiled on their own is loaded from the cache, it needs its own entry
+    // because its functions have no bodies
+    const bool interfaceOnly = !m_cacheDirectory.empty() && m_hasCompiledBodies && m_hasCompiledBodies(path);
+    if (interfaceOnly)
+    {
+        key += ";interface";
+    }
+    const InterfaceCache interfaceCache(m_cacheDirectory);
+    // the imports of the unit are resolved against its directory and the rtl directories
+    std::string importContext;
+    if (interfaceCache.isEnabled())
     {
-        std::ifstream file;
-        std::istringstream is;
-        file.open(path, std::ios::in);
-        if (!file.is_open())
+        importContext = std::filesystem::absolute(path, error).parent_path().lexically_normal().string();
+        for (auto &directory: m_rtlDirectories)
         {
-            m_errors.push_back(ParserError{.token = token, .message = filename + " is not a valid unit"});
-            m_errors.push_back(ParserError{.token = token, .message = filename + " is not a valid pascal file"});
+            importContext += ";" + std::filesystem::absolute(directory, error).lexically_normal().string();
+        }
+        importContext += includeSystem ? ";system" : "";
+    }
+    auto result = unitCache.getOrParse(
+            m_unitKey, key, filename,
+            [&]
+            {
+                // the time is taken before the file is read, so a change while it is read is found by the next import
+                std::error_code timeError;
+                const auto modificationTime = std::filesystem::last_write_time(path, timeError);
+                auto file = SourceFiles::map(filename, path);
+                if (!file)
+                {
+                    return ParsedUnit{.unit = nullptr,
+                                      .errors = {ParserError{.message = filename + " could not be read"}},
+                                      .files = {{path, modificationTime}}};
+                }
+                const auto source = SourceFiles::source(file->fileId());
+                if (interfaceOnly)
+                {
+                    if (const auto interface = interfaceCache.load(filename, source, m_definitions, importContext))
+                    {
+                        Parser parser(m_rtlDirectories, path, m_definitions, std::vector<Token>{});
+                        parser.m_unitKey = key;
+                        parser.setInterfaceCache(m_cacheDirectory, m_hasCompiledBodies);
+                        if (std::shared_ptr<UnitNode> unit = parser.loadInterface(*interface, file->fileId()))
+                        {
+                            parser.m_importedFiles.emplace(path, modificationTime);
+                            return ParsedUnit{.unit = std::move(unit),
+                                              .errors = std::move(parser.m_errors),
+                                              .file = std::move(*file),
+                                              .files = std::move(parser.m_importedFiles)};
+                        }
+                    }
+                }
+                // the unit is lexed and its macros are evaluated while it is parsed
+                Parser parser(m_rtlDirectories, path, m_definitions,
+                              std::make_unique<MacroParser>(m_definitions, std::make_unique<LexerSource>(*file)));
+                parser.m_unitKey = key;
+                parser.setInterfaceCache(m_cacheDirectory, m_hasCompiledBodies);
+                std::shared_ptr<UnitNode> unit = parser.parseUnit(includeSystem);
+                if (unit && parser.m_errors.empty() && interfaceCache.isEnabled())
+                {
+                    if (const auto interface = parser.describeInterface(*unit))
+                    {
+                        interfaceCache.store(*interface, filename, source, m_definitions, importContext);
+                    }
+                }
+                parser.m_importedFiles.emplace(path, modificationTime);
+                return ParsedUnit{.unit = std::move(unit),
+                                  .errors = std::move(parser.m_errors),
+                                  .file = std::move(*file),
+                                  .files = std::move(parser.m_importedFiles)};
+            });
+    if (auto *cycle = std::get_if<std::vector<std::string>>(&result))
+    {
+        cycle->insert(cycle->begin(), m_file_path.filename().string());
+        return UnitImport{.cycle = std::move(*cycle)};
+    }
+    return UnitImport{.unit = std::get<std::shared_future<ParsedUnit>>(result)};
+}
 
+namespace
+{
+    /**
+     * the threads which parse the units of a uses clause in advance.
+     * They are shared by all parsers, so the nested uses clauses of the imported units do not multiply them.
+     */
+    std::counting_semaphore<> &unitLoaders()
+    {
+        static std::counting_semaphore<> loaders(std::max<std::ptrdiff_t>(std::thread::hardware_concurrency(), 2) - 1);
+        return loaders;
+    }
+} // namespace
 
-            return true;
-        }
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        Lexer lexer;
-        auto tokens = lexer.tokenize(filename, buffer.str());
-        MacroParser macroParser(m_definitions);
-        Parser parser(m_rtlDirectories, path, m_definitions, macroParser.parseFile(tokens));
-        auto unit = parser.parseUnit(includeSystem);
-        unitCache[path.string()] = std::move(unit);
-        for (auto &error: parser.m_errors)
+void Parser::importUnits(const std::vector<Token> &tokens, bool includeSystem)
+{
+    // the units of a uses clause are parsed concurrently while they are imported in source order.
+    // A unit which gets no thread is parsed when it is imported.
+    std::vector<std::future<void>> pendingUnits;
+    for (size_t i = 1; i < tokens.size() && unitLoaders().try_acquire(); ++i)
+    {
+        auto filename = std::string(tokens[i].lexical()) + ".pas";
+        pendingUnits.push_back(std::async(std::launch::async,
+                                          [this, filename, includeSystem]
+                                          {
+                                              if (auto unit = loadUnit(resolveUnitPath(filename), filename,
+                                                                       includeSystem).unit)
+                                                  unit->wait();
+                                              unitLoaders().release();
+                                          }));
+    }
+    for (auto &token: tokens)
+    {
+        importUnit(token, std::string(token.lexical()) + ".pas", includeSystem);
+    }
+}
+
+bool Parser::importUnit(const Token &token, const std::string &filename, bool includeSystem)
+{
+    m_imports.push_back(UnitInterface::Import{.filename = filename, .includeSystem = includeSystem});
+    const auto path = resolveUnitPath(filename);
+    const auto parsedUnit = loadUnit(path, filename, includeSystem);
+    if (!parsedUnit.unit)
+    {
+        // the import is tried again after the file was created or the cycle was removed
+        std::error_code error;
+        m_importedFiles.emplace(path, std::filesystem::last_write_time(path, error));
+    }
+    if (!parsedUnit.cycle.empty())
+    {
+        std::string cycle;
+        for (auto &unit: parsedUnit.cycle)
         {
-            m_errors.push_back(error);
+            cycle += (cycle.empty() ? "" : " -> ") + unit;
         }
-        if (!m_errors.empty())
+        m_errors.push_back(ParserError{.token = token, .message = "the units import each other: " + cycle});
+        return true;
+    }
+    if (!parsedUnit.unit)
+    {
+        m_errors.push_back(ParserError{.token = token, .message = filename + " is not a valid unit"});
+        m_errors.push_back(ParserError{.token = token, .message = filename + " is not a valid pascal file"});
+
+
+        return true;
+    }
+    const auto &[unit, errors, file, files] = parsedUnit.unit->get();
+    m_importedFiles.insert(files.begin(), files.end());
+    // a unit may be reached through several imports, its messages are only reported once
+    for (auto &error: errors)
+    {
+        const auto &location = error.token.sourceLocation;
+        if (m_importedErrors.insert(location.filename() + ":" + std::to_string(location.byte_offset) + ":" +
+                                    error.message)
+                    .second)
         {
-            return true;
+            m_errors.push_back(error);
         }
     }
-    for (auto &[typeName, newType]: unitCache[path.string()]->getTypeDefinitions())
+    if (!errors.empty())
     {
-        if (!m_typeDefinitions.contains(typeName))
+        return true;
+    }
+    for (auto &[typeIdentifier, newType]: unit->getTypeDefinitions())
+    {
+        m_typeDefinitions.try_emplace(typeIdentifier, newType);
+    }
+
+    // the merged function definitions stay in the arena of the imported unit
+    m_arena->retain(unit->arena());
+    for (auto &definition: unit->getFunctionDefinitions())
+    {
+        m_importedFunctions.insert(definition);
+        if (m_functionDefinitions.addIfMissing(definition))
         {
-            m_typeDefinitions[typeName] = newType;
+            m_known_function_names.insert(definition->identifier());
         }
     }
 
-    for (auto &definition: unitCache[path.string()]->getFunctionDefinitions())
+
+    return false;
+}
+void Parser::setInterfaceCache(std::filesystem::path cacheDirectory,
+                               std::function<bool(const std::filesystem::path &)> hasCompiledBodies)
+{
+    m_cacheDirectory = std::move(cacheDirectory);
+    m_hasCompiledBodies = std::move(hasCompiledBodies);
+}
+
+std::optional<UnitInterface> Parser::describeInterface(UnitNode &unit)
+{
+    const auto findRecord = [this](const Identifier identifier)
+    { return determinVariableTypeByName(identifier).value_or(nullptr); };
+    // a type is only described if its description finds the same type again, which is not the case for a record
+    // whose name was declared again after it was used
+    const auto describe = [&findRecord](const std::shared_ptr<VariableType> &type) -> std::optional<std::string>
     {
-        bool functionExists = false;
-        for (auto &function: m_functionDefinitions)
+        auto description = InterfaceCache::describeType(type);
+        if (description && InterfaceCache::resolveType(*description, findRecord) == type)
         {
+            return description;
+        }
+        return std::nullopt;
+    };
 
-            if (function->functionSignature() == definition->functionSignature())
+    const auto unitNameToken = unit.expressionToken();
+    UnitInterface interface{.unitName = unit.getUnitName(),
+                            .byteOffset = unitNameToken.sourceLocation.byte_offset,
+                            .numBytes = unitNameToken.sourceLocation.num_bytes,
+                            .imports = m_imports};
+    std::unordered_set<Identifier> declaredTypes;
+    for (const auto identifier: m_declaredTypes)
+    {
+        const auto type = determinVariableTypeByName(identifier);
+        if (!type || !declaredTypes.insert(identifier).second)
+        {
+            return std::nullopt;
+        }
+        if ((*type)->kind() == TypeKind::RECORD && Identifiers::intern((*type)->typeName) == identifier)
+        {
+            const auto record = typeCast<RecordType>(*type);
+            auto &recordType = interface.types.emplace_back(UnitInterface::Type{.name = record->typeName});
+            for (size_t i = 0; i < record->size(); ++i)
             {
-                functionExists = true;
-                break;
+                const auto field = record->getField(i);
+                const auto fieldType = describe(field.variableType);
+                if (!fieldType)
+                {
+                    return std::nullopt;
+                }
+                recordType.fields.push_back(UnitInterface::Field{.name = field.variableName, .type = *fieldType});
             }
+            continue;
         }
-        if (!functionExists)
+        const auto description = describe(*type);
+        if (!description)
         {
-            m_functionDefinitions.push_back(definition);
-            m_known_function_names.push_back(definition->name());
+            return std::nullopt;
         }
+        interface.types.push_back(
+                UnitInterface::Type{.name = std::string(Identifiers::name(identifier)), .type = *description});
     }
 
-
-    return false;
+    for (auto *definition: unit.getFunctionDefinitions())
+    {
+        if (m_importedFunctions.contains(definition))
+        {
+            continue;
+        }
+        const auto nameToken = definition->expressionToken();
+        UnitInterface::Function function{
+                .name = definition->name(),
+                .byteOffset = nameToken.sourceLocation.byte_offset,
+                .numBytes = nameToken.sourceLocation.num_bytes,
+                .externalName = definition->externalName(),
+                .libName = definition->libName(),
+                .unitName = definition->unitName(),
+                .isProcedure = definition->isProcedure(),
+                .isInline = std::ranges::find(definition->attributes(), FunctionAttribute::Inline) !=
+                            definition->attributes().end()};
+        if (const auto returnType = definition->returnType())
+        {
+            const auto description = describe(returnType);
+            if (!description)
+            {
+                return std::nullopt;
+            }
+            function.returnType = *description;
+        }
+        for (auto &param: definition->params())
+        {
+            const auto paramType = describe(param.type);
+            if (!paramType)
+            {
+                return std::nullopt;
+            }
+            function.params.push_back(UnitInterface::Param{
+                    .name = param.argumentName, .type = *paramType, .isReference = param.isReference});
+        }
+        interface.functions.push_back(std::move(function));
+    }
+    return interface;
 }
-bool Parser::isFunctionDeclared(const std::string &name)
+
+std::unique_ptr<UnitNode> Parser::loadInterface(const UnitInterface &interface, const uint32_t fileId)
 {
-    for (const auto &function: m_functionDefinitions)
+    // the names point into the source of the unit, so the messages of the importers show the declarations
+    const auto tokenAt = [fileId](const uint32_t byteOffset, const uint32_t numBytes, const std::string &name)
+    {
+        return Token(SourceLocation{.fileId = fileId, .byte_offset = byteOffset, .num_bytes = numBytes},
+                     Identifiers::intern(name));
+    };
+    const auto unitNameToken = tokenAt(interface.byteOffset, interface.numBytes, interface.unitName);
+    for (auto &[filename, includeSystem]: interface.imports)
     {
-        if (iequals(function->name(), name))
+        importUnit(unitNameToken, filename, includeSystem);
+    }
+    if (!m_errors.empty())
+    {
+        return nullptr;
+    }
+
+    const auto resolve = [this](const std::string &description)
+    {
+        return InterfaceCache::resolveType(description, [this](const Identifier identifier)
+                                           { return determinVariableTypeByName(identifier).value_or(nullptr); });
+    };
+    for (auto &type: interface.types)
+    {
+        std::shared_ptr<VariableType> newType;
+        if (type.type.empty())
         {
-            return true;
+            std::vector<VariableDefinition> fields;
+            for (auto &[fieldName, fieldDescription]: type.fields)
+            {
+                const auto fieldType = resolve(fieldDescription);
+                if (!fieldType)
+                {
+                    return nullptr;
+                }
+                fields.push_back(VariableDefinition{.variableType = fieldType,
+                                                    .variableName = fieldName,
+                                                    .identifier = Identifiers::intern(fieldName),
+                                                    .scopeId = 0});
+            }
+            newType = std::make_shared<RecordType>(fields, type.name);
         }
+        else
+        {
+            newType = resolve(type.type);
+        }
+        if (!newType)
+        {
+            return nullptr;
+        }
+        m_typeDefinitions[Identifiers::intern(type.name)] = newType;
     }
-    for (const auto &function_name: m_known_function_names)
+
+    for (auto &function: interface.functions)
     {
-        if (iequals(function_name, name))
+        std::vector<FunctionArgument> params;
+        for (auto &param: function.params)
         {
-            return true;
+            const auto paramType = resolve(param.type);
+            if (!paramType)
+            {
+                return nullptr;
+            }
+            params.push_back(
+                    FunctionArgument{.type = paramType, .argumentName = param.name, .isReference = param.isReference});
+        }
+        std::shared_ptr<VariableType> returnType;
+        if (!function.returnType.empty() && !(returnType = resolve(function.returnType)))
+        {
+            return nullptr;
         }
+        // the body is compiled with the unit itself
+        auto *definition = m_arena->make<FunctionDefinitionNode>(
+                tokenAt(function.byteOffset, function.numBytes, function.name), function.name, function.externalName,
+                function.libName, std::move(params), function.isProcedure, returnType);
+        if (function.isInline)
+        {
+            definition->addAttribute(FunctionAttribute::Inline);
+        }
+        definition->setUnitName(function.unitName);
+        m_functionDefinitions.add(definition);
+        m_known_function_names.insert(definition->identifier());
     }
-    return false;
+
+    m_arena->retain(SourceFileReference(fileId));
+    return std::make_unique<UnitNode>(unitNameToken, UnitType::UNIT, interface.unitName,
+                                      std::move(m_functionDefinitions), m_typeDefinitions, nullptr, m_arena);
+}
+
+bool Parser::isFunctionDeclared(const Identifier identifier) const
+{
+    // the names of the parsed and the imported functions are all added to the known names
+    return m_known_function_names.contains(identifier);
 }
 
 void Parser::parseInterfaceSection()
 {
-    if (tryConsumeKeyWord("uses"))
+    if (tryConsumeKeyWord(Keyword::USES))
     {
+        std::vector<Token> units;
         while (consume(TokenType::NAMEDTOKEN))
         {
-            auto filename = std::string(current().lexical()) + ".pas";
-            importUnit(current(), filename);
-
+            units.push_back(current());
 
             if (!tryConsume(TokenType::COMMA))
                 break;
         }
         consume(TokenType::SEMICOLON);
+        importUnits(units);
     }
 
-    while (!canConsumeKeyWord("implementation"))
+    while (!canConsumeKeyWord(Keyword::IMPLEMENTATION))
     {
-        if (tryConsumeKeyWord("type"))
+        if (tryConsumeKeyWord(Keyword::TYPE))
         {
             parseTypeDefinitions(0);
         }
-        else if (tryConsumeKeyWord("procedure"))
+        else if (tryConsumeKeyWord(Keyword::PROCEDURE))
         {
             m_functionDeclarations.emplace_back(parseFunctionDeclaration(0, false));
         }
-        else if (tryConsumeKeyWord("function"))
+        else if (tryConsumeKeyWord(Keyword::FUNCTION))
         {
             m_functionDeclarations.emplace_back(parseFunctionDeclaration(0, true));
         }
-        else if (!canConsumeKeyWord("implementation"))
+        else if (!canConsumeKeyWord(Keyword::IMPLEMENTATION))
         {
             m_errors.push_back(ParserError{
 
-                    .token = m_tokens[m_current + 1],
+                    .token = m_tokens.peek(1),
                     .message = "unexpected token found " +
-                               std::string(magic_enum::enum_name(m_tokens[m_current + 1].tokenType)) + "!"});
+                               std::string(magic_enum::enum_name(m_tokens.peek(1).tokenType())) + "!"});
             break;
         }
     }
@@ -1563,41 +1983,41 @@ void Parser::parseInterfaceSection()
 
 void Parser::parseImplementationSection(bool includeSystem)
 {
-    if (tryConsumeKeyWord("uses"))
+    if (tryConsumeKeyWord(Keyword::USES))
     {
+        std::vector<Token> units;
         while (consume(TokenType::NAMEDTOKEN))
         {
-            auto filename = std::string(current().lexical()) + ".pas";
-            importUnit(current(), filename, includeSystem);
-
+            units.push_back(current());
 
             if (!tryConsume(TokenType::COMMA))
                 break;
         }
         consume(TokenType::SEMICOLON);
+        importUnits(units, includeSystem);
     }
 
-    while (!canConsumeKeyWord("end") && !canConsumeKeyWord("initialization"))
+    while (!canConsumeKeyWord(Keyword::END) && !canConsumeKeyWord(Keyword::INITIALIZATION))
     {
-        if (tryConsumeKeyWord("type"))
+        if (tryConsumeKeyWord(Keyword::TYPE))
         {
             parseTypeDefinitions(0);
         }
-        else if (tryConsumeKeyWord("procedure"))
+        else if (tryConsumeKeyWord(Keyword::PROCEDURE))
         {
-            m_functionDefinitions.emplace_back(parseFunctionDefinition(0, false));
+            m_functionDefinitions.add(parseFunctionDefinition(0, false));
         }
-        else if (tryConsumeKeyWord("function"))
+        else if (tryConsumeKeyWord(Keyword::FUNCTION))
         {
-            m_functionDefinitions.emplace_back(parseFunctionDefinition(0, true));
+            m_functionDefinitions.add(parseFunctionDefinition(0, true));
         }
-        else if (!canConsumeKeyWord("end") && !canConsumeKeyWord("initialization"))
+        else if (!canConsumeKeyWord(Keyword::END) && !canConsumeKeyWord(Keyword::INITIALIZATION))
         {
             m_errors.push_back(ParserError{
 
-                    .token = m_tokens[m_current + 1],
+                    .token = m_tokens.peek(1),
                     .message = "unexpected token found " +
-                               std::string(magic_enum::enum_name(m_tokens[m_current + 1].tokenType)) + "!"});
+                               std::string(magic_enum::enum_name(m_tokens.peek(1).tokenType())) + "!"});
             break;
         }
     }
@@ -1619,18 +2039,18 @@ std::unique_ptr<UnitNode> Parser::parseUnit(bool includeSystem)
         consume(TokenType::SEMICOLON);
 
 
-        std::shared_ptr<BlockNode> blockNode = nullptr;
+        BlockNode *blockNode = nullptr;
         while (hasNext())
         {
-            if (tryConsumeKeyWord("interface"))
+            if (tryConsumeKeyWord(Keyword::INTERFACE))
             {
                 parseInterfaceSection();
             }
-            else if (tryConsumeKeyWord("implementation"))
+            else if (tryConsumeKeyWord(Keyword::IMPLEMENTATION))
             {
                 parseImplementationSection(includeSystem);
             }
-            else if (tryConsumeKeyWord("end"))
+            else if (tryConsumeKeyWord(Keyword::END))
             {
                 consume(TokenType::DOT);
                 consume(TokenType::T_EOF);
@@ -1644,9 +2064,9 @@ std::unique_ptr<UnitNode> Parser::parseUnit(bool includeSystem)
             {
                 m_errors.push_back(ParserError{
 
-                        .token = m_tokens[m_current + 1],
+                        .token = m_tokens.peek(1),
                         .message = "unexpected token found " +
-                                   std::string(magic_enum::enum_name(m_tokens[m_current + 1].tokenType)) + "!"});
+                                   std::string(magic_enum::enum_name(m_tokens.peek(1).tokenType())) + "!"});
                 break;
             }
         }
@@ -1656,29 +2076,27 @@ std::unique_ptr<UnitNode> Parser::parseUnit(bool includeSystem)
             throw ParserException(m_errors);
         }
 
-        for (auto declaration: m_functionDeclarations)
+        for (auto &definition: m_functionDefinitions.definitions())
         {
-            bool found = false;
-            for (auto def: m_functionDefinitions)
-            {
-                if (def->functionSignature() == declaration->functionSignature())
-                {
-                    found = true;
-                    break;
-                }
-            }
-            if (!found)
+            if (definition->unitName().empty())
             {
-                m_functionDefinitions.emplace_back(declaration);
+                definition->setUnitName(unitName);
             }
         }
+        for (auto &declaration: m_functionDeclarations)
+        {
+            m_functionDefinitions.addIfMissing(declaration);
+        }
 
 
-        return std::make_unique<UnitNode>(unitNameToken, unitType, unitName, m_functionDefinitions, m_typeDefinitions,
-                                          blockNode);
+        // the tokens of the nodes point into the source of the file
+        m_arena->retain(SourceFileReference(unitNameToken.sourceLocation.fileId));
+        return std::make_unique<UnitNode>(unitNameToken, unitType, unitName, std::move(m_functionDefinitions),
+                                          m_typeDefinitions, blockNode, m_arena);
     }
     catch (ParserException &e)
     {
+        appendSourceErrors();
     }
     return nullptr;
 }
@@ -1689,6 +2107,7 @@ std::unique_ptr<UnitNode> Parser::parseProgram()
     try
     {
         UnitType unitType = UnitType::PROGRAM;
+        const auto programToken = current();
 
 
         consume(TokenType::NAMEDTOKEN);
@@ -1701,10 +2120,12 @@ std::unique_ptr<UnitNode> Parser::parseProgram()
             while (canConsume(TokenType::NAMEDTOKEN))
             {
                 consume(TokenType::NAMEDTOKEN);
-                auto paramName = current().lexical();
+                auto paramName = std::string(current().lexical());
                 paramNames.emplace_back(paramName);
-                m_known_variable_definitions.push_back(VariableDefinition{
-                        .variableType = FileType::getFileType(), .variableName = paramName, .scopeId = 0});
+                m_symbols.declare(VariableDefinition{.variableType = FileType::getFileType(),
+                                                     .variableName = paramName,
+                                                     .identifier = current().identifier(),
+                                                     .scopeId = 0});
                 tryConsume(TokenType::COMMA);
             }
             consume(TokenType::RIGHT_CURLY);
@@ -1714,23 +2135,23 @@ std::unique_ptr<UnitNode> Parser::parseProgram()
 
         if (unitName != "system")
         {
-            importUnit(m_tokens.front(), "system.pas", false);
+            importUnit(programToken, "system.pas", false);
         }
 
-        std::shared_ptr<BlockNode> blockNode = nullptr;
+        BlockNode *blockNode = nullptr;
         std::vector<VariableDefinition> variable_definitions;
         while (hasNext())
         {
             constexpr int scope = 0;
-            if (tryConsumeKeyWord("type"))
+            if (tryConsumeKeyWord(Keyword::TYPE))
             {
                 parseTypeDefinitions(scope);
             }
-            else if (canConsumeKeyWord("const"))
+            else if (canConsumeKeyWord(Keyword::K_CONST))
             {
                 parseConstantDefinitions(scope, variable_definitions);
             }
-            else if (tryConsumeKeyWord("var"))
+            else if (tryConsumeKeyWord(Keyword::VAR))
             {
                 while (!canConsume(TokenType::KEYWORD))
                 {
@@ -1739,33 +2160,33 @@ std::unique_ptr<UnitNode> Parser::parseProgram()
                         break;
                     for (auto &definition: def)
                     {
-                        variable_definitions.push_back(definition);
-                        m_known_variable_definitions.push_back(definition);
+                        m_symbols.declare(definition);
+                        variable_definitions.push_back(std::move(definition));
                     }
                 }
             }
-            else if (tryConsumeKeyWord("uses"))
+            else if (tryConsumeKeyWord(Keyword::USES))
             {
+                std::vector<Token> units;
                 while (consume(TokenType::NAMEDTOKEN))
                 {
-                    auto filename = std::string(current().lexical()) + ".pas";
-                    importUnit(current(), filename);
-
+                    units.push_back(current());
 
                     if (!tryConsume(TokenType::COMMA))
                         break;
                 }
                 consume(TokenType::SEMICOLON);
+                importUnits(units);
             }
-            else if (tryConsumeKeyWord("procedure"))
+            else if (tryConsumeKeyWord(Keyword::PROCEDURE))
             {
-                m_functionDefinitions.emplace_back(parseFunctionDefinition(scope, false));
+                m_functionDefinitions.add(parseFunctionDefinition(scope, false));
             }
-            else if (tryConsumeKeyWord("function"))
+            else if (tryConsumeKeyWord(Keyword::FUNCTION))
             {
-                m_functionDefinitions.emplace_back(parseFunctionDefinition(scope, true));
+                m_functionDefinitions.add(parseFunctionDefinition(scope, true));
             }
-            else if (canConsumeKeyWord("const") || canConsumeKeyWord("var") || canConsumeKeyWord("begin"))
+            else if (canConsumeKeyWord(Keyword::K_CONST) || canConsumeKeyWord(Keyword::VAR) || canConsumeKeyWord(Keyword::BEGIN))
             {
                 blockNode = parseBlock(scope);
                 consume(TokenType::DOT);
@@ -1778,9 +2199,9 @@ std::unique_ptr<UnitNode> Parser::parseProgram()
             {
                 m_errors.push_back(ParserError{
 
-                        .token = m_tokens[m_current + 1],
+                        .token = m_tokens.peek(1),
                         .message = "unexpected token found " +
-                                   std::string(magic_enum::enum_name(m_tokens[m_current + 1].tokenType)) + "!"});
+                                   std::string(magic_enum::enum_name(m_tokens.peek(1).tokenType())) + "!"});
                 break;
             }
         }
@@ -1794,29 +2215,41 @@ std::unique_ptr<UnitNode> Parser::parseProgram()
             blockNode->addVariableDefinition(var);
         }
 
-        return std::make_unique<UnitNode>(unitNameToken, unitType, unitName, paramNames, m_functionDefinitions,
-                                          m_typeDefinitions, blockNode);
+        // the tokens of the nodes point into the source of the file
+        m_arena->retain(SourceFileReference(unitNameToken.sourceLocation.fileId));
+        return std::make_unique<UnitNode>(unitNameToken, unitType, unitName, paramNames,
+                                          std::move(m_functionDefinitions), m_typeDefinitions, blockNode, m_arena);
     }
     catch (ParserException &e)
     {
+        appendSourceErrors();
     }
     return nullptr;
 }
 
 
+void Parser::appendSourceErrors()
+{
+    // errors of the macro parser end the parsing of the file like the errors of the parser itself
+    for (auto &error: m_tokens.errors())
+    {
+        m_errors.push_back(error);
+    }
+}
+
 std::unique_ptr<UnitNode> Parser::parseFile()
 {
-    const bool isProgram = current().tokenType == TokenType::KEYWORD && iequals(current().lexical(), "program");
-    const bool isUnit = current().tokenType == TokenType::KEYWORD && iequals(current().lexical(), "unit");
+    const bool isProgram = current().keyword() == Keyword::PROGRAM;
+    const bool isUnit = current().keyword() == Keyword::UNIT;
 
     if (isProgram)
         return parseProgram();
     if (isUnit)
         return parseUnit(true);
 
-    m_errors.push_back(ParserError{.token = m_tokens[m_current + 1],
+    m_errors.push_back(ParserError{.token = m_tokens.peek(1),
                                    .message = "unexpected expected token found " +
-                                              std::string(magic_enum::enum_name(m_tokens[m_current + 1].tokenType)) +
+                                              std::string(magic_enum::enum_name(m_tokens.peek(1).tokenType())) +
                                               "!"});
     throw ParserException(m_errors);
 }
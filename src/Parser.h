@@ -1,9 +1,15 @@
 #pragma once
 #include <filesystem>
+#include <functional>
+#include <future>
 #include <map>
 #include <memory>
 #include <vector>
+#include "InterfaceCache.h"
 #include "Lexer.h"
+#include "SymbolTable.h"
+#include "TokenStream.h"
+#include "ast/ASTArena.h"
 #include "ast/ASTNode.h"
 #include "ast/UnitNode.h"
 #include "ast/VariableDefinition.h"
@@ -11,75 +17,133 @@
 #include "exceptions/CompilerException.h"
 
 #include <unordered_map>
+#include <unordered_set>
 
+struct ParsedUnit;
+struct UnitImport;
+
+/**
+ * the precedence of the binary operators of an expression, an operator with a higher precedence binds stronger.
+ * Unlike in standard Pascal the comparisons bind stronger than and and or, so "i mod 3 = 0 or i mod 5 = 0" needs no
+ * parentheses.
+ */
+enum class Precedence : uint8_t
+{
+    NONE,
+    OR,
+    AND,
+    COMPARISON,
+    ADDITIVE,
+    MULTIPLICATIVE
+};
 
 class Parser
 {
     std::vector<std::filesystem::path> m_rtlDirectories;
     std::filesystem::path m_file_path;
-    size_t m_current = 0;
-    std::vector<Token> m_tokens;
+    TokenStream m_tokens;
+    // the nodes of the parsed unit, the arena is handed over to the UnitNode
+    std::shared_ptr<ASTArena> m_arena;
     std::vector<ParserError> m_errors;
-    std::unordered_map<std::string, std::shared_ptr<VariableType>> m_typeDefinitions;
-    std::vector<VariableDefinition> m_known_variable_definitions;
-    std::vector<std::string> m_known_function_names;
-    std::vector<std::shared_ptr<FunctionDefinitionNode>> m_functionDeclarations;
-    std::vector<std::shared_ptr<FunctionDefinitionNode>> m_functionDefinitions;
-    std::vector<std::shared_ptr<ASTNode>> m_nodes;
+    std::unordered_map<Identifier, std::shared_ptr<VariableType>> m_typeDefinitions;
+    SymbolTable m_symbols;
+    std::unordered_set<Identifier> m_known_function_names;
+    std::vector<FunctionDefinitionNode *> m_functionDeclarations;
+    FunctionIndex m_functionDefinitions;
+    std::vector<ASTNode *> m_nodes;
     std::unordered_map<std::string, bool> m_definitions;
     bool m_includeSystem = false;
+    // the key of the unit in the unit cache, empty for a program
+    std::string m_unitKey;
+    // the messages of the imported units which were already reported
+    std::unordered_set<std::string> m_importedErrors;
+    // the files of the imported units with their modification time when they were read
+    std::map<std::filesystem::path, std::filesystem::file_time_type> m_importedFiles;
+    // the interfaces of the imported units whose function bodies are compiled on their own are loaded from here
+    std::filesystem::path m_cacheDirectory;
+    std::function<bool(const std::filesystem::path &)> m_hasCompiledBodies;
+    // the imports, the types and the functions of the unit itself, which make up its interface
+    std::vector<UnitInterface::Import> m_imports;
+    std::vector<Identifier> m_declaredTypes;
+    std::unordered_set<FunctionDefinitionNode *> m_importedFunctions;
 
     Token next();
     Token current();
-    [[nodiscard]] bool isVariableDefined(const std::string_view &name, size_t scope);
+    [[nodiscard]] bool isVariableDefined(Identifier identifier, size_t scope) const;
+    [[nodiscard]] bool isVariableDeclaredIn(Identifier identifier, size_t scope) const;
     [[nodiscard]] bool hasNext() const;
     bool consume(TokenType tokenType);
     bool tryConsume(TokenType tokenType);
     [[nodiscard]] bool canConsume(TokenType tokenType) const;
     [[nodiscard]] bool canConsume(TokenType tokenType, size_t next) const;
-    bool consumeKeyWord(const std::string &keyword);
-    bool tryConsumeKeyWord(const std::string &keyword);
-    [[nodiscard]] bool canConsumeKeyWord(const std::string &keyword) const;
+    bool consumeKeyWord(Keyword keyword);
+    bool tryConsumeKeyWord(Keyword keyword);
+    [[nodiscard]] bool canConsumeKeyWord(Keyword keyword) const;
     [[nodiscard]] std::optional<std::shared_ptr<VariableType>>
-    determinVariableTypeByName(const std::string &name) const;
-    std::shared_ptr<ASTNode> parseEscapedString(const Token &token);
-    std::shared_ptr<ASTNode> parseNumber();
+    determinVariableTypeByName(Identifier identifier) const;
+    ASTNode *parseEscapedString(const Token &token);
+    ASTNode *parseNumber();
     void parseTypeDefinitions(size_t scope);
     std::optional<VariableDefinition> parseConstantDefinition(size_t scope);
-    std::shared_ptr<ASTNode> parseArrayConstructor(size_t size);
+    ASTNode *parseArrayConstructor(size_t size);
     std::vector<VariableDefinition> parseVariableDefinitions(size_t scope);
     std::shared_ptr<ArrayType> parseArray(size_t scope);
-    std::shared_ptr<ASTNode> parseStatement(size_t scope, bool withSemicolon = true);
+    ASTNode *parseStatement(size_t scope, bool withSemicolon = true);
     void parseConstantDefinitions(size_t scope, std::vector<VariableDefinition> &variable_definitions);
-    std::shared_ptr<ASTNode> parseBaseExpression(size_t scope, const std::shared_ptr<ASTNode> &origLhs = nullptr,
-                                                 bool includeCompare = true);
-    std::shared_ptr<ASTNode> parseExpression(size_t scope, const std::shared_ptr<ASTNode> &origLhs = nullptr);
-    std::shared_ptr<ASTNode> parseLogicalExpression(size_t scope, std::shared_ptr<ASTNode> lhs);
+    /**
+     * a constant, a variable, a call, an expression in parentheses or a negation.
+     */
+    ASTNode *parseOperand(size_t scope);
+    /**
+     * parses the operands and the binary operators which bind at least as strong as the minimum precedence.
+     */
+    ASTNode *parseBinaryExpression(size_t scope, Precedence minimumPrecedence);
+    ASTNode *parseExpression(size_t scope);
 
-    std::shared_ptr<BlockNode> parseBlock(size_t scope);
-    std::shared_ptr<ASTNode> parseKeyword(size_t scope, bool withSemicolon);
-    std::shared_ptr<ASTNode> parseFunctionCall(size_t scope);
-    std::shared_ptr<ASTNode> parseVariableAssignment(size_t scope);
-    std::shared_ptr<ASTNode> parseVariableAccess(size_t scope);
-    std::shared_ptr<ASTNode> parseToken(size_t scope);
-    std::shared_ptr<FunctionDefinitionNode> parseFunctionDeclaration(size_t scope, bool isFunction);
-    std::shared_ptr<FunctionDefinitionNode> parseFunctionDefinition(size_t scope, bool isFunction);
+    BlockNode *parseBlock(size_t scope);
+    ASTNode *parseKeyword(size_t scope, bool withSemicolon);
+    ASTNode *parseFunctionCall(size_t scope);
+    ASTNode *parseVariableAssignment(size_t scope);
+    ASTNode *parseVariableAccess(size_t scope);
+    ASTNode *parseToken(size_t scope);
+    FunctionDefinitionNode *parseFunctionDeclaration(size_t scope, bool isFunction);
+    FunctionDefinitionNode *parseFunctionDefinition(size_t scope, bool isFunction);
 
     std::unique_ptr<UnitNode> parseUnit(bool includeSystem);
+    [[nodiscard]] std::filesystem::path resolveUnitPath(const std::string &filename) const;
+    [[nodiscard]] UnitImport loadUnit(const std::filesystem::path &path, const std::string &filename,
+                                      bool includeSystem) const;
     bool importUnit(const Token &token, const std::string &filename, bool includeSystem = true);
+    void importUnits(const std::vector<Token> &tokens, bool includeSystem = true);
 
-    bool isFunctionDeclared(const std::string &name);
+    [[nodiscard]] bool isFunctionDeclared(Identifier identifier) const;
 
     [[nodiscard]] std::unique_ptr<UnitNode> parseUnit();
     [[nodiscard]] std::unique_ptr<UnitNode> parseProgram();
 
     void parseInterfaceSection();
     void parseImplementationSection(bool includeSystem);
-    void checkLhsExists(const std::shared_ptr<ASTNode> &lhs, const Token &token);
+    void checkLhsExists(ASTNode *lhs, const Token &token);
+    void appendSourceErrors();
+    /**
+     * describes the imports, the types and the function signatures of the parsed unit, nothing if one of its types can
+     * not be described.
+     */
+    [[nodiscard]] std::optional<UnitInterface> describeInterface(UnitNode &unit);
+    /**
+     * creates the unit of the interface without function bodies, the imports of the unit are imported again.
+     * returns nullptr if the interface does not match the imported units anymore.
+     */
+    std::unique_ptr<UnitNode> loadInterface(const UnitInterface &interface, uint32_t fileId);
 
 public:
     Parser(const std::vector<std::filesystem::path> &rtlDirectories, std::filesystem::path path,
            const std::unordered_map<std::string, bool> &definitions, const std::vector<Token> &tokens);
+    /**
+     * creates a parser which pulls its tokens on demand from the source, e.g. the lexer followed by the macro parser.
+     */
+    Parser(const std::vector<std::filesystem::path> &rtlDirectories, std::filesystem::path path,
+           const std::unordered_map<std::string, bool> &definitions, std::unique_ptr<TokenSource> tokens);
     ~Parser() = default;
     [[nodiscard]] bool hasError() const;
     [[nodiscard]] bool hasMessages() const;
@@ -87,4 +151,11 @@ public:
 
     [[nodiscard]] std::unique_ptr<UnitNode> parseFile();
     std::vector<ParserError> getErrors() { return m_errors; }
+    /**
+     * caches the interfaces of the imported units in the directory.
+     * An imported unit is loaded from its cached interface instead of being parsed if hasCompiledBodies returns true
+     * for its path, e.g. because the bodies of its functions are linked in from precompiled bitcode.
+     */
+    void setInterfaceCache(std::filesystem::path cacheDirectory,
+                           std::function<bool(const std::filesystem::path &)> hasCompiledBodies);
 };
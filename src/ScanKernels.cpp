@@ -0,0 +1,192 @@
+#include "ScanKernels.h"
+
+#include <bit>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define WIRTHX_SCAN_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__)
+#define WIRTHX_SCAN_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+namespace
+{
+    constexpr bool isIdentifierChar(const char value)
+    {
+        const char lower = static_cast<char>(value | 0x20);
+        return (lower >= 'a' && lower <= 'z') || (value >= '0' && value <= '9') || value == '_';
+    }
+
+    size_t scalarScanForChar(const std::string_view text, size_t start, const char value)
+    {
+        while (start < text.size() && text[start] != value)
+            ++start;
+        return start;
+    }
+
+    size_t scalarScanIdentifierEnd(const std::string_view text, size_t start)
+    {
+        while (start < text.size() && isIdentifierChar(text[start]))
+            ++start;
+        return start;
+    }
+
+    size_t scalarCountChar(const std::string_view text, const char value)
+    {
+        size_t count = 0;
+        for (const char current: text)
+            count += current == value;
+        return count;
+    }
+
+#ifdef WIRTHX_SCAN_SSE2
+    // the bytes of value which are in [low, high], bytes >= 0x80 are negative and never match the ascii ranges
+    inline __m128i inRange(const __m128i value, const char low, const char high)
+    {
+        return _mm_and_si128(_mm_cmpgt_epi8(value, _mm_set1_epi8(static_cast<char>(low - 1))),
+                             _mm_cmplt_epi8(value, _mm_set1_epi8(static_cast<char>(high + 1))));
+    }
+
+    inline uint32_t identifierMask(const __m128i chunk)
+    {
+        const auto letters = inRange(_mm_or_si128(chunk, _mm_set1_epi8(0x20)), 'a', 'z');
+        const auto digits = inRange(chunk, '0', '9');
+        const auto underscore = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('_'));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letters, digits), underscore)));
+    }
+
+    size_t sse2ScanForChar(const std::string_view text, size_t start, const char value)
+    {
+        const auto needle = _mm_set1_epi8(value);
+        for (; start + 16 <= text.size(); start += 16)
+        {
+            const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text.data() + start));
+            const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+            if (mask != 0)
+                return start + std::countr_zero(mask);
+        }
+        return scalarScanForChar(text, start, value);
+    }
+
+    size_t sse2ScanIdentifierEnd(const std::string_view text, size_t start)
+    {
+        for (; start + 16 <= text.size(); start += 16)
+        {
+            const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text.data() + start));
+            const auto mask = ~identifierMask(chunk) & 0xFFFFu;
+            if (mask != 0)
+                return start + std::countr_zero(mask);
+        }
+        return scalarScanIdentifierEnd(text, start);
+    }
+
+    size_t sse2CountChar(const std::string_view text, const char value)
+    {
+        const auto needle = _mm_set1_epi8(value);
+        size_t count = 0;
+        size_t position = 0;
+        for (; position + 16 <= text.size(); position += 16)
+        {
+            const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text.data() + position));
+            count += std::popcount(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle))));
+        }
+        return count + scalarCountChar(text.substr(position), value);
+    }
+#endif
+
+#ifdef WIRTHX_SCAN_AVX2
+    __attribute__((target("avx2"))) inline __m256i inRange256(const __m256i value, const char low, const char high)
+    {
+        return _mm256_and_si256(_mm256_cmpgt_epi8(value, _mm256_set1_epi8(static_cast<char>(low - 1))),
+                                _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(high + 1)), value));
+    }
+
+    __attribute__((target("avx2"))) size_t avx2ScanForChar(const std::string_view text, size_t start,
+                                                            const char value)
+    {
+        const auto needle = _mm256_set1_epi8(value);
+        for (; start + 32 <= text.size(); start += 32)
+        {
+            const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text.data() + start));
+            const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle)));
+            if (mask != 0)
+                return start + std::countr_zero(mask);
+        }
+        return sse2ScanForChar(text, start, value);
+    }
+
+    __attribute__((target("avx2"))) size_t avx2ScanIdentifierEnd(const std::string_view text, size_t start)
+    {
+        for (; start + 32 <= text.size(); start += 32)
+        {
+            const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text.data() + start));
+            const auto letters = inRange256(_mm256_or_si256(chunk, _mm256_set1_epi8(0x20)), 'a', 'z');
+            const auto digits = inRange256(chunk, '0', '9');
+            const auto underscore = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('_'));
+            const auto identifier = _mm256_or_si256(_mm256_or_si256(letters, digits), underscore);
+            const auto mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(identifier));
+            if (mask != 0)
+                return start + std::countr_zero(mask);
+        }
+        return sse2ScanIdentifierEnd(text, start);
+    }
+
+    __attribute__((target("avx2,popcnt"))) size_t avx2CountChar(const std::string_view text, const char value)
+    {
+        const auto needle = _mm256_set1_epi8(value);
+        size_t count = 0;
+        size_t position = 0;
+        for (; position + 32 <= text.size(); position += 32)
+        {
+            const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text.data() + position));
+            count += std::popcount(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle))));
+        }
+        return count + sse2CountChar(text.substr(position), value);
+    }
+#endif
+
+    struct ScanKernels
+    {
+        size_t (*scanForChar)(std::string_view, size_t, char);
+        size_t (*scanIdentifierEnd)(std::string_view, size_t);
+        size_t (*countChar)(std::string_view, char);
+        std::string_view name;
+    };
+
+    ScanKernels selectKernels()
+    {
+#ifdef WIRTHX_SCAN_AVX2
+        if (__builtin_cpu_supports("avx2"))
+            return {avx2ScanForChar, avx2ScanIdentifierEnd, avx2CountChar, "avx2"};
+#endif
+#ifdef WIRTHX_SCAN_SSE2
+        // sse2 is part of every x86-64 cpu
+        return {sse2ScanForChar, sse2ScanIdentifierEnd, sse2CountChar, "sse2"};
+#else
+        return {scalarScanForChar, scalarScanIdentifierEnd, scalarCountChar, "scalar"};
+#endif
+    }
+
+    const ScanKernels &kernels()
+    {
+        static const ScanKernels selected = selectKernels();
+        return selected;
+    }
+} // namespace
+
+size_t scanForChar(const std::string_view text, const size_t start, const char value)
+{
+    return kernels().scanForChar(text, start, value);
+}
+
+size_t scanIdentifierEnd(const std::string_view text, const size_t start)
+{
+    return kernels().scanIdentifierEnd(text, start);
+}
+
+size_t countChar(const std::string_view text, const char value) { return kernels().countChar(text, value); }
+
+std::string_view scanKernelName() { return kernels().name; }
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+
+/**
+ * vectorized scanning kernels of the lexer.
+ * The kernels use AVX2 or SSE2 on x86 depending on the cpu, other platforms use the scalar versions.
+ */
+
+/**
+ * returns the index of the first occurrence of value at or after start, or the size of the text if there is none.
+ */
+size_t scanForChar(std::string_view text, size_t start, char value);
+
+/**
+ * returns the index of the first character at or after start which can not be part of an identifier
+ * ([A-Za-z0-9_]), or the size of the text.
+ */
+size_t scanIdentifierEnd(std::string_view text, size_t start);
+
+/**
+ * counts the occurrences of value in the text.
+ */
+size_t countChar(std::string_view text, char value);
+
+/**
+ * the name of the kernels which were selected for the cpu, e.g. "avx2".
+ */
+std::string_view scanKernelName();
@@ -3,3 +3,281 @@
 //
 
 #include "SourceLocation.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "ScanKernels.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+namespace
+{
+    struct SourceFile
+    {
+        std::string filename;
+        // the source is either owned by the buffer, e.g. for unsaved documents of the language server, or mapped
+        std::string buffer;
+        std::unique_ptr<llvm::MemoryBuffer> mapping;
+        // the path and the modification time of a mapped file, when it was mapped
+        std::filesystem::path path;
+        std::filesystem::file_time_type modificationTime;
+        std::string_view source;
+        std::atomic<uint32_t> references = 0;
+        std::once_flag lineOffsetsFlag;
+        // byte offsets of the first character of every line
+        std::vector<size_t> lineOffsets;
+    };
+
+    /**
+     * the slots of the files are stored in chunks which are never moved or freed.
+     * A file can therefore be read without a lock by everybody who holds a reference to it.
+     * The files themselves are freed when they are no longer referenced and a newer version of the same file was
+     * added, e.g. after every edit of a document in the language server.
+     */
+    class SourceFileTable
+    {
+        static constexpr size_t CHUNK_SIZE = 1024;
+        static constexpr size_t MAX_CHUNKS = 4096;
+
+        std::mutex m_mutex;
+        std::array<std::unique_ptr<std::unique_ptr<SourceFile>[]>, MAX_CHUNKS> m_chunks;
+        size_t m_size = 0;
+        std::vector<uint32_t> m_freeFiles;
+        std::unordered_map<std::string, uint32_t> m_latestFiles;
+
+    public:
+        SourceFileTable() { add("", ""); }
+
+        /**
+         * adds the file and returns its id, the reference of the caller is already counted.
+         */
+        uint32_t add(const std::string &filename, std::string source)
+        {
+            std::scoped_lock lock(m_mutex);
+            if (const auto fileId = findLatest(filename, source))
+            {
+                return *fileId;
+            }
+            const auto fileId = append(filename);
+            auto &file = get(fileId);
+            file.buffer = std::move(source);
+            file.source = file.buffer;
+            return fileId;
+        }
+
+        uint32_t add(const std::string &filename, std::unique_ptr<llvm::MemoryBuffer> mapping,
+                     std::filesystem::path path, const std::filesystem::file_time_type modificationTime)
+        {
+            std::scoped_lock lock(m_mutex);
+            if (const auto fileId = findLatest(filename, mapping->getBuffer()))
+            {
+                return *fileId;
+            }
+            const auto fileId = append(filename);
+            auto &file = get(fileId);
+            file.source = mapping->getBuffer();
+            file.mapping = std::move(mapping);
+            file.path = std::move(path);
+            file.modificationTime = modificationTime;
+            return fileId;
+        }
+
+        SourceFile &get(const uint32_t fileId) { return *slot(fileId); }
+
+        // only the holder of a reference retains a file, so it can not be freed concurrently
+        void retain(const uint32_t fileId) { get(fileId).references.fetch_add(1, std::memory_order_relaxed); }
+
+        void release(const uint32_t fileId)
+        {
+            std::scoped_lock lock(m_mutex);
+            if (get(fileId).references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                freeIfUnused(fileId);
+            }
+        }
+
+    private:
+        std::unique_ptr<SourceFile> &slot(const uint32_t fileId)
+        {
+            return m_chunks[fileId / CHUNK_SIZE][fileId % CHUNK_SIZE];
+        }
+
+        /**
+         * a mapped file which was changed on disk since it was mapped may be shorter than its mapping, reading the
+         * pages behind its new end raises SIGBUS. Such a mapping is not read to compare it with a newer version.
+         */
+        static bool isMappingIntact(const SourceFile &file)
+        {
+            if (!file.mapping || file.mapping->getBufferKind() != llvm::MemoryBuffer::MemoryBuffer_MMap)
+            {
+                return true;
+            }
+            std::error_code error;
+            const auto size = std::filesystem::file_size(file.path, error);
+            if (error || size != file.source.size())
+            {
+                return false;
+            }
+            return std::filesystem::last_write_time(file.path, error) == file.modificationTime && !error;
+        }
+
+        // the language server and the compiler server read the same files again and again
+        std::optional<uint32_t> findLatest(const std::string &filename, const std::string_view source)
+        {
+            const auto it = m_latestFiles.find(filename);
+            if (it != m_latestFiles.end() && isMappingIntact(get(it->second)) && get(it->second).source == source)
+            {
+                retain(it->second);
+                return it->second;
+            }
+            return std::nullopt;
+        }
+
+        uint32_t append(const std::string &filename)
+        {
+            uint32_t fileId;
+            if (!m_freeFiles.empty())
+            {
+                fileId = m_freeFiles.back();
+                m_freeFiles.pop_back();
+            }
+            else
+            {
+                if (m_size == CHUNK_SIZE * MAX_CHUNKS)
+                {
+                    throw std::length_error("too many source files");
+                }
+                auto &chunk = m_chunks[m_size / CHUNK_SIZE];
+                if (!chunk)
+                {
+                    chunk = std::make_unique<std::unique_ptr<SourceFile>[]>(CHUNK_SIZE);
+                }
+                fileId = static_cast<uint32_t>(m_size++);
+            }
+            slot(fileId) = std::make_unique<SourceFile>();
+            auto &file = get(fileId);
+            file.filename = filename;
+            file.references = 1;
+
+            const auto [latest, inserted] = m_latestFiles.try_emplace(filename, fileId);
+            if (!inserted)
+            {
+                const auto previousId = std::exchange(latest->second, fileId);
+                freeIfUnused(previousId);
+            }
+            return fileId;
+        }
+
+        // the latest version of a file is kept, so it is not read again
+        void freeIfUnused(const uint32_t fileId)
+        {
+            auto &file = get(fileId);
+            if (fileId == SourceFiles::EMPTY_FILE || file.references.load(std::memory_order_acquire) != 0)
+            {
+                return;
+            }
+            if (const auto latest = m_latestFiles.find(file.filename);
+                latest != m_latestFiles.end() && latest->second == fileId)
+            {
+                return;
+            }
+            slot(fileId).reset();
+            m_freeFiles.push_back(fileId);
+        }
+    };
+
+    SourceFileTable &sourceFileTable()
+    {
+        // references held by other static objects, e.g. the unit cache, are released after the end of main
+        static auto *table = new SourceFileTable();
+        return *table;
+    }
+} // namespace
+
+SourceFileReference SourceFiles::add(const std::string &filename, std::string source)
+{
+    return {SourceFileReference::Adopt{}, sourceFileTable().add(filename, std::move(source))};
+}
+
+std::optional<SourceFileReference> SourceFiles::map(const std::string &filename, const std::filesystem::path &path)
+{
+    // the time is taken before the file is mapped, so a change while it is mapped makes the mapping look outdated
+    std::error_code error;
+    const auto modificationTime = std::filesystem::last_write_time(path, error);
+    // llvm only maps files which are larger than a few pages, smaller files are read into a buffer
+    auto mapping = llvm::MemoryBuffer::getFile(path.string(), false, true);
+    if (!mapping || error)
+    {
+        return std::nullopt;
+    }
+    return SourceFileReference(SourceFileReference::Adopt{},
+                               sourceFileTable().add(filename, std::move(*mapping), path, modificationTime));
+}
+
+const std::string &SourceFiles::filename(const uint32_t fileId) { return sourceFileTable().get(fileId).filename; }
+
+std::string_view SourceFiles::source(const uint32_t fileId) { return sourceFileTable().get(fileId).source; }
+
+void SourceFiles::retain(const uint32_t fileId)
+{
+    if (fileId != EMPTY_FILE)
+    {
+        sourceFileTable().retain(fileId);
+    }
+}
+
+void SourceFiles::release(const uint32_t fileId)
+{
+    if (fileId != EMPTY_FILE)
+    {
+        sourceFileTable().release(fileId);
+    }
+}
+
+std::pair<size_t, size_t> SourceFiles::position(const uint32_t fileId, const size_t byteOffset)
+{
+    auto &file = sourceFileTable().get(fileId);
+    std::call_once(file.lineOffsetsFlag,
+                   [&file]
+                   {
+                       file.lineOffsets.reserve(countChar(file.source, '\n') + 1);
+                       file.lineOffsets.push_back(0);
+                       for (size_t i = scanForChar(file.source, 0, '\n'); i < file.source.size();
+                            i = scanForChar(file.source, i + 1, '\n'))
+                       {
+                           file.lineOffsets.push_back(i + 1);
+                       }
+                   });
+    const auto line = std::ranges::upper_bound(file.lineOffsets, byteOffset);
+    const auto row = static_cast<size_t>(line - file.lineOffsets.begin());
+    return {row, byteOffset - *(line - 1) + 1};
+}
+
+SourceFileReference::SourceFileReference(Adopt, const uint32_t fileId) : m_fileId(fileId) {}
+
+SourceFileReference::SourceFileReference(const uint32_t fileId) : m_fileId(fileId) { SourceFiles::retain(m_fileId); }
+
+SourceFileReference::SourceFileReference(const SourceFileReference &other) : m_fileId(other.m_fileId)
+{
+    SourceFiles::retain(m_fileId);
+}
+
+SourceFileReference::SourceFileReference(SourceFileReference &&other) noexcept :
+    m_fileId(std::exchange(other.m_fileId, SourceFiles::EMPTY_FILE))
+{
+}
+
+SourceFileReference &SourceFileReference::operator=(SourceFileReference other) noexcept
+{
+    std::swap(m_fileId, other.m_fileId);
+    return *this;
+}
+
+SourceFileReference::~SourceFileReference() { SourceFiles::release(m_fileId); }
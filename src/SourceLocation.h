@@ -1,20 +1,92 @@
 #pragma once
 
-#include <memory>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
 #include <string>
+#include <string_view>
+
+class SourceFileReference;
+
+/**
+ * table of all source files read by the compiler.
+ * A file is referenced by a 32 bit id, so the locations of the tokens do not need to own a copy of the file name or
+ * the source. The line offsets of a file are only computed when the row of a location is requested.
+ * Files on disk are memory mapped, every source is followed by a '\0' which is not part of its view.
+ * A file is freed when it was replaced by a newer version of the same file and is no longer referenced, the ids of
+ * freed files are reused.
+ */
+class SourceFiles
+{
+public:
+    // id of the empty file, used by default constructed locations
+    static constexpr uint32_t EMPTY_FILE = 0;
+
+    /**
+     * adds the source of a file to the table and returns a reference to it.
+     * Adding the same content for a file again returns the existing file.
+     */
+    static SourceFileReference add(const std::string &filename, std::string source);
+    /**
+     * maps the file at path into memory and adds it to the table, e.g. for the files which are compiled.
+     * The source is not copied. Returns nothing if the file could not be read.
+     */
+    static std::optional<SourceFileReference> map(const std::string &filename, const std::filesystem::path &path);
+    [[nodiscard]] static const std::string &filename(uint32_t fileId);
+    [[nodiscard]] static std::string_view source(uint32_t fileId);
+    /**
+     * returns the 1 based row and column of the byte offset in the file.
+     */
+    [[nodiscard]] static std::pair<size_t, size_t> position(uint32_t fileId, size_t byteOffset);
+
+private:
+    friend class SourceFileReference;
+    static void retain(uint32_t fileId);
+    static void release(uint32_t fileId);
+};
+
+/**
+ * keeps a file of the source file table alive, e.g. for the nodes of a syntax tree which refer to its source.
+ * The latest version of a file stays in the table without references, so reading it again does not copy it.
+ */
+class SourceFileReference
+{
+    uint32_t m_fileId = SourceFiles::EMPTY_FILE;
+
+    friend class SourceFiles;
+    struct Adopt
+    {
+    };
+    // takes over a reference which was already counted by the table
+    SourceFileReference(Adopt, uint32_t fileId);
+
+public:
+    SourceFileReference() = default;
+    explicit SourceFileReference(uint32_t fileId);
+    SourceFileReference(const SourceFileReference &other);
+    SourceFileReference(SourceFileReference &&other) noexcept;
+    SourceFileReference &operator=(SourceFileReference other) noexcept;
+    ~SourceFileReference();
+
+    [[nodiscard]] uint32_t fileId() const { return m_fileId; }
+};
+
 struct SourceLocation
 {
-    std::string filename;
-    std::shared_ptr<std::string> source;
-    std::size_t byte_offset;
-    std::size_t num_bytes;
+    uint32_t fileId = SourceFiles::EMPTY_FILE;
+    uint32_t byte_offset = 0;
+    uint32_t num_bytes = 0;
 
-    [[nodiscard]] std::string text() const { return source->substr(byte_offset, num_bytes); }
-    [[nodiscard]] size_t lineStart() const { return source->rfind('\n', byte_offset) + 1; }
+    [[nodiscard]] const std::string &filename() const { return SourceFiles::filename(fileId); }
+    [[nodiscard]] std::string_view source() const { return SourceFiles::source(fileId); }
+    [[nodiscard]] std::string_view text() const { return source().substr(byte_offset, num_bytes); }
+    [[nodiscard]] size_t lineStart() const { return source().rfind('\n', byte_offset) + 1; }
     [[nodiscard]] std::string sourceline() const
     {
-        const size_t endPos = source->find('\n', byte_offset);
+        const size_t endPos = source().find('\n', byte_offset);
         const size_t startPos = lineStart();
-        return source->substr(startPos, endPos - startPos);
+        return std::string(source().substr(startPos, endPos - startPos));
     }
+    [[nodiscard]] size_t row() const { return SourceFiles::position(fileId, byte_offset).first; }
+    [[nodiscard]] size_t col() const { return SourceFiles::position(fileId, byte_offset).second; }
 };
@@ -0,0 +1,59 @@
+#include "SymbolTable.h"
+
+#include <algorithm>
+
+void SymbolTable::pushScope() { m_scopeStarts.push_back(m_declared.size()); }
+
+void SymbolTable::popScope()
+{
+    if (m_scopeStarts.empty())
+    {
+        return;
+    }
+    const size_t start = m_scopeStarts.back();
+    m_scopeStarts.pop_back();
+    for (size_t i = start; i < m_declared.size(); ++i)
+    {
+        // the stacks are kept when they become empty, so the next function with the same names reuses them
+        m_bindings[m_declared[i]].pop_back();
+    }
+    m_declared.resize(start);
+}
+
+void SymbolTable::declare(const VariableDefinition &definition)
+{
+    m_bindings[definition.identifier].push_back(
+            Binding{.scopeId = definition.scopeId, .constantValue = definition.constant ? definition.value : nullptr});
+    m_declared.push_back(definition.identifier);
+}
+
+const SymbolTable::Binding *SymbolTable::lookup(const Identifier identifier) const
+{
+    const auto it = m_bindings.find(identifier);
+    if (it == m_bindings.end() || it->second.empty())
+    {
+        return nullptr;
+    }
+    return &it->second.back();
+}
+
+bool SymbolTable::isDefined(const Identifier identifier, const size_t scope) const
+{
+    const auto it = m_bindings.find(identifier);
+    if (it == m_bindings.end())
+    {
+        return false;
+    }
+    // a name is rarely declared more than once, so the stack has almost always a single binding
+    return std::ranges::any_of(it->second, [scope](const Binding &binding) { return binding.scopeId <= scope; });
+}
+
+bool SymbolTable::isDeclaredIn(const Identifier identifier, const size_t scope) const
+{
+    const auto it = m_bindings.find(identifier);
+    if (it == m_bindings.end())
+    {
+        return false;
+    }
+    return std::ranges::any_of(it->second, [scope](const Binding &binding) { return binding.scopeId == scope; });
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "Identifier.h"
+#include "ast/VariableDefinition.h"
+
+class ASTNode;
+
+/**
+ * the variables and constants which are visible while a unit is parsed.
+ * Every name maps to the stack of its bindings, the innermost binding is on top. A scope records the names which were
+ * declared in it, so closing the scope only pops the bindings of these names.
+ */
+class SymbolTable
+{
+public:
+    struct Binding
+    {
+        size_t scopeId;
+        // the value of a constant, nullptr for variables
+        ASTNode *constantValue;
+    };
+
+private:
+    std::unordered_map<Identifier, std::vector<Binding>> m_bindings;
+    std::vector<Identifier> m_declared;
+    std::vector<size_t> m_scopeStarts;
+
+public:
+    SymbolTable() = default;
+    ~SymbolTable() = default;
+
+    /**
+     * opens a scope, e.g. for the parameters and local variables of a function.
+     */
+    void pushScope();
+    /**
+     * removes the names which were declared since the matching pushScope.
+     */
+    void popScope();
+    void declare(const VariableDefinition &definition);
+    /**
+     * returns the innermost binding of the name or nullptr if the name is not declared.
+     */
+    [[nodiscard]] const Binding *lookup(Identifier identifier) const;
+    /**
+     * returns true if the name has a binding which was declared in the scope or one of its parents.
+     */
+    [[nodiscard]] bool isDefined(Identifier identifier, size_t scope) const;
+    /**
+     * returns true if the name was declared in the scope itself, a declaration of an inner scope may shadow it.
+     */
+    [[nodiscard]] bool isDeclaredIn(Identifier identifier, size_t scope) const;
+};
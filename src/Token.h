@@ -1,9 +1,12 @@
 #pragma once
 #include <filesystem>
 #include <string_view>
+#include <type_traits>
 #include <utility>
+#include "Identifier.h"
+#include "Keyword.h"
 #include "SourceLocation.h"
-enum class TokenType : uint16_t
+enum class TokenType : uint8_t
 {
     NUMBER,
     STRING,
@@ -40,14 +43,26 @@ enum class TokenType : uint16_t
 struct Token
 {
     SourceLocation sourceLocation;
-    size_t row{};
-    size_t col{};
-    TokenType tokenType;
 
-    Token() : sourceLocation(), tokenType(TokenType::T_EOF) {}
+private:
+    // the type and the value share one 32 bit unit, bit fields of different types are not packed together by every
+    // compiler. The value is the keyword of KEYWORD and MACROKEYWORD tokens or the interned name of NAMEDTOKEN tokens,
+    // a token never has both
+    uint32_t m_type : 32 - Identifiers::ID_BITS;
+    uint32_t m_value : Identifiers::ID_BITS;
 
-    Token(const SourceLocation &sourceLocation, const size_t row, const size_t col, const TokenType tokenType) :
-        sourceLocation(sourceLocation), row(row), col(col), tokenType(tokenType)
+public:
+    Token() : sourceLocation(), m_type(static_cast<uint32_t>(TokenType::T_EOF)), m_value(0) {}
+
+    Token(const SourceLocation &sourceLocation, const TokenType tokenType, const Keyword keyword = Keyword::NONE) :
+        sourceLocation(sourceLocation), m_type(static_cast<uint32_t>(tokenType)),
+        m_value(static_cast<uint32_t>(keyword))
+    {
+    }
+
+    Token(const SourceLocation &sourceLocation, const Identifier identifier) :
+        sourceLocation(sourceLocation), m_type(static_cast<uint32_t>(TokenType::NAMEDTOKEN)),
+        m_value(static_cast<uint32_t>(identifier))
     {
     }
 
@@ -56,5 +71,23 @@ struct Token
 
     Token &operator=(const Token &other) = default;
 
-    [[nodiscard]] std::string lexical() const { return sourceLocation.text(); }
+    [[nodiscard]] TokenType tokenType() const { return static_cast<TokenType>(m_type); }
+    [[nodiscard]] Keyword keyword() const
+    {
+        const bool isKeyword = tokenType() == TokenType::KEYWORD || tokenType() == TokenType::MACROKEYWORD;
+        return isKeyword ? static_cast<Keyword>(m_value) : Keyword::NONE;
+    }
+    [[nodiscard]] Identifier identifier() const
+    {
+        return tokenType() == TokenType::NAMEDTOKEN ? static_cast<Identifier>(m_value) : Identifier::NONE;
+    }
+    [[nodiscard]] std::string_view lexical() const { return sourceLocation.text(); }
+    [[nodiscard]] size_t row() const { return sourceLocation.row(); }
+    [[nodiscard]] size_t col() const { return sourceLocation.col(); }
 };
+
+// tokens are copied a lot by the parsers, so they have to stay small and trivially copyable
+static_assert(sizeof(Token) == 16);
+// MACRO_END is the last token type
+static_assert(static_cast<uint32_t>(TokenType::MACRO_END) < 1u << (32 - Identifiers::ID_BITS));
+static_assert(std::is_trivially_copyable_v<Token>);
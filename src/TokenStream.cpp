@@ -0,0 +1,53 @@
+#include "TokenStream.h"
+
+#include <cassert>
+#include <utility>
+
+TokenVectorSource::TokenVectorSource(std::vector<Token> tokens) : m_tokens(std::move(tokens)) {}
+
+Token TokenVectorSource::nextToken()
+{
+    if (m_current < m_tokens.size())
+    {
+        return m_tokens[m_current++];
+    }
+    return m_tokens.empty() ? Token() : m_tokens.back();
+}
+
+TokenStream::TokenStream(std::unique_ptr<TokenSource> source) : m_source(std::move(source)) {}
+
+void TokenStream::fill(const size_t position) const
+{
+    while (m_filled <= position && m_filled < m_end)
+    {
+        const auto token = m_source->nextToken();
+        m_buffer[m_filled & (CAPACITY - 1)] = token;
+        ++m_filled;
+        if (token.tokenType() == TokenType::T_EOF)
+        {
+            m_end = m_filled;
+        }
+    }
+}
+
+const Token &TokenStream::peek(const size_t offset) const
+{
+    assert(offset <= MAX_LOOKAHEAD && "the lookahead is larger than the ring buffer");
+    const auto position = m_position + offset;
+    fill(position);
+    if (position >= m_end)
+    {
+        return m_buffer[(m_end - 1) & (CAPACITY - 1)];
+    }
+    return m_buffer[position & (CAPACITY - 1)];
+}
+
+void TokenStream::advance() { ++m_position; }
+
+bool TokenStream::hasToken() const
+{
+    fill(m_position);
+    return m_position < m_end;
+}
+
+std::vector<ParserError> TokenStream::errors() const { return m_source->errors(); }
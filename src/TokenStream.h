@@ -0,0 +1,80 @@
+#pragma once
+#include <array>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "Token.h"
+#include "exceptions/CompilerException.h"
+
+/**
+ * a producer of tokens which are pulled one by one. After the T_EOF token a source keeps returning T_EOF.
+ */
+class TokenSource
+{
+public:
+    virtual ~TokenSource() = default;
+
+    virtual Token nextToken() = 0;
+    /**
+     * the errors which were found while producing the tokens.
+     */
+    [[nodiscard]] virtual std::vector<ParserError> errors() const { return {}; }
+};
+
+/**
+ * serves the tokens of an already tokenized file.
+ */
+class TokenVectorSource final : public TokenSource
+{
+    std::vector<Token> m_tokens;
+    size_t m_current = 0;
+
+public:
+    explicit TokenVectorSource(std::vector<Token> tokens);
+    ~TokenVectorSource() override = default;
+
+    Token nextToken() override;
+};
+
+/**
+ * pulls the tokens from a source on demand and keeps a small ring buffer of them for the lookahead of a parser.
+ * Only the current token and the tokens after it are available, so the memory does not depend on the size of a file.
+ */
+class TokenStream
+{
+public:
+    static constexpr size_t MAX_LOOKAHEAD = 7;
+
+private:
+    static constexpr size_t CAPACITY = MAX_LOOKAHEAD + 1;
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "the capacity has to be a power of two");
+
+    std::unique_ptr<TokenSource> m_source;
+    // the ring buffer is filled lazily, also from the const lookahead functions of the parsers
+    mutable std::array<Token, CAPACITY> m_buffer;
+    // absolute index of the current token
+    size_t m_position = 0;
+    // absolute index after the last token which was read from the source
+    mutable size_t m_filled = 0;
+    // absolute index after the T_EOF token, as soon as it was read
+    mutable size_t m_end = std::numeric_limits<size_t>::max();
+
+    void fill(size_t position) const;
+
+public:
+    explicit TokenStream(std::unique_ptr<TokenSource> source);
+    TokenStream(TokenStream &&other) = default;
+    TokenStream &operator=(TokenStream &&other) = default;
+    ~TokenStream() = default;
+
+    /**
+     * returns the token offset tokens after the current one, the T_EOF token is returned for positions after the end.
+     */
+    [[nodiscard]] const Token &peek(size_t offset = 0) const;
+    void advance();
+    /**
+     * true as long as the current position did not move past the T_EOF token.
+     */
+    [[nodiscard]] bool hasToken() const;
+    [[nodiscard]] std::vector<ParserError> errors() const;
+};
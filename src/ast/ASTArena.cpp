@@ -0,0 +1,49 @@
+#include "ASTArena.h"
+
+#include <algorithm>
+
+ASTArena::~ASTArena()
+{
+    // the nodes are destroyed in the reverse order of their creation, like the members of a class
+    for (auto it = m_nodes.rbegin(); it != m_nodes.rend(); ++it)
+    {
+        (*it)->~ASTNode();
+    }
+}
+
+void *ASTArena::allocate(const size_t size, const size_t alignment)
+{
+    size_t offset = (m_blockUsed + alignment - 1) & ~(alignment - 1);
+    if (m_blocks.empty() || offset + size > BLOCK_SIZE)
+    {
+        m_blocks.push_back(std::make_unique<std::byte[]>(std::max(BLOCK_SIZE, size)));
+        offset = 0;
+    }
+    m_blockUsed = offset + size;
+    m_bytesUsed += size;
+    return m_blocks.back().get() + offset;
+}
+
+void ASTArena::retain(const std::shared_ptr<ASTArena> &arena)
+{
+    if (arena && arena.get() != this && std::ranges::find(m_imports, arena) == m_imports.end())
+    {
+        m_imports.push_back(arena);
+    }
+}
+
+void ASTArena::retain(SourceFileReference file)
+{
+    if (std::ranges::none_of(m_files, [&file](const auto &retained) { return retained.fileId() == file.fileId(); }))
+    {
+        m_files.push_back(std::move(file));
+    }
+}
+
+const std::vector<ASTNode *> &ASTArena::nodes() const { return m_nodes; }
+
+size_t ASTArena::nodeCount() const { return m_nodes.size(); }
+
+size_t ASTArena::bytesUsed() const { return m_bytesUsed; }
+
+size_t ASTArena::blockCount() const { return m_blocks.size(); }
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ASTNode.h"
+#include "SourceLocation.h"
+
+/**
+ * owns the nodes of the syntax tree of a unit, the nodes refer to each other by raw pointers.
+ * The nodes are placed one after another in large blocks, so building a tree needs one heap allocation per block
+ * instead of one per node, and a walk over the tree touches memory in the order in which the nodes were parsed.
+ * The nodes are destroyed together with the arena.
+ */
+class ASTArena
+{
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+    size_t m_blockUsed = BLOCK_SIZE;
+    size_t m_bytesUsed = 0;
+    std::vector<ASTNode *> m_nodes;
+    // the arenas of the imported units, their function definitions are referenced by the nodes of this arena
+    std::vector<std::shared_ptr<ASTArena>> m_imports;
+    // the source files the tokens of the nodes point into
+    std::vector<SourceFileReference> m_files;
+
+    void *allocate(size_t size, size_t alignment);
+
+public:
+    ASTArena() = default;
+    ASTArena(const ASTArena &) = delete;
+    ASTArena &operator=(const ASTArena &) = delete;
+    ~ASTArena();
+
+    template<typename T, typename... Args>
+    T *make(Args &&...args)
+    {
+        static_assert(std::is_base_of_v<ASTNode, T>);
+        auto *node = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        m_nodes.push_back(node);
+        return node;
+    }
+
+    /**
+     * keeps the arena of an imported unit alive as long as this arena.
+     */
+    void retain(const std::shared_ptr<ASTArena> &arena);
+    /**
+     * keeps a source file alive as long as this arena.
+     */
+    void retain(SourceFileReference file);
+
+    /**
+     * the nodes in the order of their creation.
+     */
+    [[nodiscard]] const std::vector<ASTNode *> &nodes() const;
+    [[nodiscard]] size_t nodeCount() const;
+    [[nodiscard]] size_t bytesUsed() const;
+    [[nodiscard]] size_t blockCount() const;
+};
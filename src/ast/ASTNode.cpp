@@ -5,23 +5,18 @@
 
 #include "UnitNode.h"
 
-ASTNode::ASTNode(const Token &token) : m_token(token) {}
+ASTNode::ASTNode(const Token &token, const NodeKind kind) : m_token(token), m_kind(kind) {}
 
 std::shared_ptr<VariableType> ASTNode::resolveType([[maybe_unused]] const std::unique_ptr<UnitNode> &unit,
                                                    ASTNode *parentNode)
 {
-    return std::make_shared<VariableType>();
+    return VariableType::getUnknown();
 }
 ASTNode *ASTNode::resolveParent(const std::unique_ptr<Context> &context)
 {
-    ASTNode *parent = context->ProgramUnit.get();
-    if (context->TopLevelFunction)
+    if (context->TopLevelDefinition)
     {
-        if (const auto def =
-                    context->ProgramUnit->getFunctionDefinition(std::string(context->TopLevelFunction->getName())))
-        {
-            parent = def.value().get();
-        }
+        return context->TopLevelDefinition;
     }
-    return parent;
+    return context->ProgramUnit.get();
 }
@@ -1,4 +1,6 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include "types/VariableType.h"
@@ -12,22 +14,103 @@ struct Context;
 
 
 class UnitNode;
+class Binder;
+
+/**
+ * the concrete class of a node, so the kind of a node can be tested without RTTI.
+ */
+enum class NodeKind : uint8_t
+{
+    ADDRESS,
+    ARRAY_ACCESS,
+    ARRAY_ASSIGNMENT,
+    ARRAY_INITIALISATION,
+    BINARY_OPERATION,
+    BLOCK,
+    BOOLEAN,
+    BREAK,
+    CHAR_CONSTANT,
+    COMPARISON,
+    DOUBLE,
+    FIELD_ACCESS,
+    FIELD_ASSIGNMENT,
+    FOR,
+    FUNCTION_CALL,
+    FUNCTION_DEFINITION,
+    IF_CONDITION,
+    LOGICAL_EXPRESSION,
+    NUMBER,
+    REPEAT_UNTIL,
+    RETURN,
+    STRING_CONSTANT,
+    SYSTEM_FUNCTION_CALL,
+    UNIT,
+    VARIABLE_ACCESS,
+    VARIABLE_ASSIGNMENT,
+    WHILE
+};
 
 class ASTNode
 {
     Token m_token;
+    NodeKind m_kind;
+    // the type resolved for the node and the analysis in which it was resolved
+    std::shared_ptr<VariableType> m_resolvedType;
+    uint32_t m_resolvedEpoch = 0;
+    inline static std::atomic<uint32_t> s_analysisEpoch = 1;
 
 public:
-    explicit ASTNode(const Token &token);
+    ASTNode(const Token &token, NodeKind kind);
     virtual ~ASTNode() = default;
 
+    [[nodiscard]] NodeKind kind() const { return m_kind; }
+
     virtual void print() = 0;
     virtual llvm::Value *codegen(std::unique_ptr<Context> &context) = 0;
 
     virtual std::shared_ptr<VariableType> resolveType(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode);
-    virtual std::optional<std::shared_ptr<ASTNode>> block() { return std::nullopt; }
+    virtual std::optional<ASTNode *> block() { return std::nullopt; }
     virtual void typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode) {};
+    /**
+     * resolves the variables of the node and its children to their slots, see Binder.
+     */
+    virtual void bind(Binder &binder) {}
 
     virtual Token expressionToken() { return m_token; }
     static ASTNode *resolveParent(const std::unique_ptr<Context> &context);
+
+    /**
+     * the type which was resolved for the node in the current analysis or nullptr, see ast::resolveType.
+     */
+    [[nodiscard]] std::shared_ptr<VariableType> cachedType() const
+    {
+        if (m_resolvedEpoch != s_analysisEpoch.load(std::memory_order_relaxed))
+            return nullptr;
+        return m_resolvedType;
+    }
+    void cacheType(std::shared_ptr<VariableType> type)
+    {
+        m_resolvedType = std::move(type);
+        m_resolvedEpoch = s_analysisEpoch.load(std::memory_order_relaxed);
+    }
+    /**
+     * starts a new analysis, the types cached before are resolved again. The type check of a unit calls it, so a
+     * unit which is checked again, e.g. a cached import in server mode, does not read the types of the last check.
+     */
+    static void invalidateResolvedTypes() { s_analysisEpoch.fetch_add(1, std::memory_order_relaxed); }
 };
+
+/**
+ * returns the node as a T if it is one and nullptr otherwise, the replacement of dynamic_cast for nodes.
+ * A class which has subclasses decides with classof, every other class is identified by its KIND.
+ */
+template<typename T>
+T *nodeCast(ASTNode *node)
+{
+    if (node == nullptr)
+        return nullptr;
+    if constexpr (requires { T::classof(node); })
+        return T::classof(node) ? static_cast<T *>(node) : nullptr;
+    else
+        return node->kind() == T::KIND ? static_cast<T *>(node) : nullptr;
+}
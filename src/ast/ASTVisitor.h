@@ -0,0 +1,137 @@
+#pragma once
+#include <stdexcept>
+
+#include "ASTNode.h"
+#include "AddressNode.h"
+#include "ArrayAccessNode.h"
+#include "ArrayAssignmentNode.h"
+#include "ArrayInitialisationNode.h"
+#include "BinaryOperationNode.h"
+#include "BlockNode.h"
+#include "BooleanNode.h"
+#include "BreakNode.h"
+#include "CharConstantNode.h"
+#include "ComparissionNode.h"
+#include "DoubleNode.h"
+#include "FieldAccessNode.h"
+#include "FieldAssignmentNode.h"
+#include "ForNode.h"
+#include "FunctionCallNode.h"
+#include "FunctionDefinitionNode.h"
+#include "IfConditionNode.h"
+#include "LogicalExpressionNode.h"
+#include "NumberNode.h"
+#include "RepeatUntilNode.h"
+#include "ReturnNode.h"
+#include "StringConstantNode.h"
+#include "SystemFunctionCallNode.h"
+#include "UnitNode.h"
+#include "VariableAccessNode.h"
+#include "VariableAssignmentNode.h"
+#include "WhileNode.h"
+
+/**
+ * calls the function with the node cast to its concrete class, the class is chosen by a switch over the kind of the
+ * node. The function is usually a generic lambda, e.g. [](auto *node) { ... }, or a class with an overload for every
+ * kind it handles differently.
+ */
+template<typename Function>
+decltype(auto) visitNode(ASTNode *node, Function &&function)
+{
+    switch (node->kind())
+    {
+        case NodeKind::ADDRESS:
+            return function(static_cast<AddressNode *>(node));
+        case NodeKind::ARRAY_ACCESS:
+            return function(static_cast<ArrayAccessNode *>(node));
+        case NodeKind::ARRAY_ASSIGNMENT:
+            return function(static_cast<ArrayAssignmentNode *>(node));
+        case NodeKind::ARRAY_INITIALISATION:
+            return function(static_cast<ArrayInitialisationNode *>(node));
+        case NodeKind::BINARY_OPERATION:
+            return function(static_cast<BinaryOperationNode *>(node));
+        case NodeKind::BLOCK:
+            return function(static_cast<BlockNode *>(node));
+        case NodeKind::BOOLEAN:
+            return function(static_cast<BooleanNode *>(node));
+        case NodeKind::BREAK:
+            return function(static_cast<BreakNode *>(node));
+        case NodeKind::CHAR_CONSTANT:
+            return function(static_cast<CharConstantNode *>(node));
+        case NodeKind::COMPARISON:
+            return function(static_cast<ComparrisionNode *>(node));
+        case NodeKind::DOUBLE:
+            return function(static_cast<DoubleNode *>(node));
+        case NodeKind::FIELD_ACCESS:
+            return function(static_cast<FieldAccessNode *>(node));
+        case NodeKind::FIELD_ASSIGNMENT:
+            return function(static_cast<FieldAssignmentNode *>(node));
+        case NodeKind::FOR:
+            return function(static_cast<ForNode *>(node));
+        case NodeKind::FUNCTION_CALL:
+            return function(static_cast<FunctionCallNode *>(node));
+        case NodeKind::FUNCTION_DEFINITION:
+            return function(static_cast<FunctionDefinitionNode *>(node));
+        case NodeKind::IF_CONDITION:
+            return function(static_cast<IfConditionNode *>(node));
+        case NodeKind::LOGICAL_EXPRESSION:
+            return function(static_cast<LogicalExpressionNode *>(node));
+        case NodeKind::NUMBER:
+            return function(static_cast<NumberNode *>(node));
+        case NodeKind::REPEAT_UNTIL:
+            return function(static_cast<RepeatUntilNode *>(node));
+        case NodeKind::RETURN:
+            return function(static_cast<ReturnNode *>(node));
+        case NodeKind::STRING_CONSTANT:
+            return function(static_cast<StringConstantNode *>(node));
+        case NodeKind::SYSTEM_FUNCTION_CALL:
+            return function(static_cast<SystemFunctionCallNode *>(node));
+        case NodeKind::UNIT:
+            return function(static_cast<UnitNode *>(node));
+        case NodeKind::VARIABLE_ACCESS:
+            return function(static_cast<VariableAccessNode *>(node));
+        case NodeKind::VARIABLE_ASSIGNMENT:
+            return function(static_cast<VariableAssignmentNode *>(node));
+        case NodeKind::WHILE:
+            return function(static_cast<WhileNode *>(node));
+    }
+    throw std::logic_error("unknown node kind");
+}
+
+/**
+ * the operations of the nodes dispatched by the kind of the node. The implementation of the concrete class is called
+ * without a virtual call, so the walks over the statements of a block can inline it.
+ */
+namespace ast
+{
+    inline llvm::Value *codegen(ASTNode *node, std::unique_ptr<Context> &context)
+    {
+        return visitNode(node, [&context]<typename Node>(Node *concrete) { return concrete->Node::codegen(context); });
+    }
+
+    inline void typeCheck(ASTNode *node, const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode)
+    {
+        visitNode(node, [&unit, parentNode]<typename Node>(Node *concrete)
+                  { concrete->Node::typeCheck(unit, parentNode); });
+    }
+
+    /**
+     * the type of a node is resolved once per analysis and read from the node afterwards, so the enclosing
+     * expressions and the code generation do not resolve the whole subtree again.
+     */
+    inline std::shared_ptr<VariableType> resolveType(ASTNode *node, const std::unique_ptr<UnitNode> &unit,
+                                                     ASTNode *parentNode)
+    {
+        if (auto type = node->cachedType())
+            return type;
+        auto type = visitNode(node, [&unit, parentNode]<typename Node>(Node *concrete)
+                              { return concrete->Node::resolveType(unit, parentNode); });
+        node->cacheType(type);
+        return type;
+    }
+
+    inline void print(ASTNode *node)
+    {
+        visitNode(node, []<typename Node>(Node *concrete) { concrete->Node::print(); });
+    }
+} // namespace ast
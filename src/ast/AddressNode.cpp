@@ -1,37 +1,29 @@
 #include "AddressNode.h"
 
-#include <compare.h>
 #include <compiler/Context.h>
+#include <compiler/codegen.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/IRBuilder.h>
 
+#include "Binder.h"
 #include "UnitNode.h"
 #include "VariableAccessNode.h"
 
-AddressNode::AddressNode(const Token &token) : ASTNode(token), m_variableName(token.lexical()) {}
+AddressNode::AddressNode(const Token &token) :
+    ASTNode(token, KIND), m_variableName(token.lexical()), m_identifier(token.identifier())
+{
+}
 
 void AddressNode::print() {}
 
 llvm::Value *AddressNode::codegen(std::unique_ptr<Context> &context)
 {
-    const auto variableName = to_lower(m_variableName);
-
-    llvm::AllocaInst *allocatedValue = context->NamedAllocations[m_variableName];
-
-    if (!allocatedValue)
+    // the allocation of a variable or the argument of the function
+    if (auto *value = codegen::slotValue(context, m_slot))
     {
-        for (auto &arg: context->TopLevelFunction->args())
-        {
-            if (iequals(arg.getName(), variableName))
-            {
-                return context->TopLevelFunction->getArg(arg.getArgNo());
-            }
-        }
-
-        return LogErrorV("Unknown variable name: " + m_variableName);
+        return value;
     }
-    // Load the value.
-    return allocatedValue;
+    return LogErrorV("Unknown variable name: " + m_variableName);
 }
 std::shared_ptr<VariableType> AddressNode::resolveType(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode)
 {
@@ -43,3 +35,5 @@ void AddressNode::typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *pare
 {
     ASTNode::typeCheck(unit, parentNode);
 }
+
+void AddressNode::bind(Binder &binder) { m_slot = binder.storage(m_identifier); }
@@ -1,13 +1,18 @@
 #pragma once
 #include "ASTNode.h"
+#include "VariableSlot.h"
 
 class AddressNode : public ASTNode
 {
 private:
     std::string m_variableName;
+    Identifier m_identifier;
+    VariableSlot m_slot;
 
 
 public:
+    static constexpr NodeKind KIND = NodeKind::ADDRESS;
+
     explicit AddressNode(const Token &token);
     ~AddressNode() override = default;
 
@@ -17,4 +22,5 @@ public:
 
     std::shared_ptr<VariableType> resolveType(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode) override;
     void typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode) override;
+    void bind(Binder &binder) override;
 };
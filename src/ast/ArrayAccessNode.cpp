@@ -3,16 +3,17 @@
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Instructions.h>
 
+#include "Binder.h"
 #include "ComparissionNode.h"
 #include "SystemFunctionCallNode.h"
 #include "UnitNode.h"
-#include "VariableAccessNode.h"
 #include "compiler/Context.h"
+#include "compiler/codegen.h"
 #include "types/StringType.h"
 
 
-ArrayAccessNode::ArrayAccessNode(Token arrayName, const std::shared_ptr<ASTNode> &indexNode) :
-    ASTNode(arrayName), m_arrayNameToken(std::move(arrayName)), m_indexNode(indexNode)
+ArrayAccessNode::ArrayAccessNode(Token arrayName, ASTNode *indexNode) :
+    ASTNode(arrayName, KIND), m_arrayNameToken(std::move(arrayName)), m_indexNode(indexNode)
 {
 }
 
@@ -21,18 +22,18 @@ void ArrayAccessNode::print() {}
 
 std::shared_ptr<VariableType> ArrayAccessNode::resolveType(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode)
 {
-    const auto definition = unit->getVariableDefinition(m_arrayNameToken.lexical());
+    const auto definition = unit->getVariableDefinition(std::string(m_arrayNameToken.lexical()));
     std::shared_ptr<VariableType> varType = nullptr;
     if (!definition)
     {
-        if (const auto functionDefinition = dynamic_cast<FunctionDefinitionNode *>(parentNode))
+        if (const auto functionDefinition = nodeCast<FunctionDefinitionNode>(parentNode))
         {
-            if (const auto param = functionDefinition->getParam(m_arrayNameToken.lexical()))
+            if (const auto param = functionDefinition->getParam(m_arrayNameToken.identifier()))
             {
                 varType = param.value().type;
             }
             else if (const auto variableDef =
-                             functionDefinition->body()->getVariableDefinition(m_arrayNameToken.lexical()))
+                             functionDefinition->body()->getVariableDefinition(std::string(m_arrayNameToken.lexical())))
             {
                 varType = variableDef->variableType;
             }
@@ -45,12 +46,12 @@ std::shared_ptr<VariableType> ArrayAccessNode::resolveType(const std::unique_ptr
 
     if (varType)
     {
-        if (const auto array = std::dynamic_pointer_cast<ArrayType>(varType))
+        if (const auto array = typeCast<ArrayType>(varType))
             return array->arrayBase;
-        if (auto array = std::dynamic_pointer_cast<StringType>(varType))
+        if (auto array = typeCast<StringType>(varType))
             return IntegerType::getInteger(8);
     }
-    return std::make_shared<VariableType>();
+    return VariableType::getUnknown();
 }
 Token ArrayAccessNode::expressionToken()
 {
@@ -64,40 +65,27 @@ Token ArrayAccessNode::expressionToken()
 
 llvm::Value *ArrayAccessNode::codegen(std::unique_ptr<Context> &context)
 {
-    const llvm::Value *V = context->NamedAllocations[m_arrayNameToken.lexical()];
-
-
-    if (!V)
-    {
-        for (auto &arg: context->TopLevelFunction->args())
-        {
-            if (arg.getName() == m_arrayNameToken.lexical())
-            {
-                V = context->TopLevelFunction->getArg(arg.getArgNo());
-                break;
-            }
-        }
-    }
+    llvm::Value *V = codegen::slotValue(context, m_slot);
 
     if (!V)
-        return LogErrorV("Unknown variable for array access: " + m_arrayNameToken.lexical());
+        return LogErrorV("Unknown variable for array access: " + std::string(m_arrayNameToken.lexical()));
 
     const auto parent = resolveParent(context);
 
-    const auto arrayDef = context->ProgramUnit->getVariableDefinition(m_arrayNameToken.lexical());
+    const auto arrayDef = context->ProgramUnit->getVariableDefinition(std::string(m_arrayNameToken.lexical()));
     std::shared_ptr<VariableType> arrayDefType = nullptr;
     if (arrayDef)
     {
         arrayDefType = arrayDef->variableType;
     }
 
-    if (const auto functionDefinition = dynamic_cast<FunctionDefinitionNode *>(parent))
+    if (const auto functionDefinition = nodeCast<FunctionDefinitionNode>(parent))
     {
-        if (const auto param = functionDefinition->getParam(m_arrayNameToken.lexical()))
+        if (const auto param = functionDefinition->getParam(m_arrayNameToken.identifier()))
         {
             arrayDefType = param.value().type;
         }
-        else if (const auto variableDef = functionDefinition->body()->getVariableDefinition(m_arrayNameToken.lexical()))
+        else if (const auto variableDef = functionDefinition->body()->getVariableDefinition(std::string(m_arrayNameToken.lexical())))
         {
             arrayDefType = variableDef->variableType;
         }
@@ -105,12 +93,11 @@ llvm::Value *ArrayAccessNode::codegen(std::unique_ptr<Context> &context)
 
     if (!arrayDefType)
     {
-        return LogErrorV("Unknown variable for array access: " + m_arrayNameToken.lexical());
+        return LogErrorV("Unknown variable for array access: " + std::string(m_arrayNameToken.lexical()));
     }
-    if (const auto fieldAccessType = std::dynamic_pointer_cast<FieldAccessableType>(arrayDefType))
+    if (const auto fieldAccessType = typeCast<FieldAccessableType>(arrayDefType))
     {
         Token token = expressionToken();
-        std::vector<std::shared_ptr<ASTNode>> args = {std::make_shared<VariableAccessNode>(m_arrayNameToken, false)};
 
         auto index = m_indexNode->codegen(context);
         constexpr unsigned maxBitWith = 64;
@@ -120,15 +107,21 @@ llvm::Value *ArrayAccessNode::codegen(std::unique_ptr<Context> &context)
             index = context->Builder->CreateIntCast(index, targetType, true, "lhs_cast");
         }
         const auto lowValue = fieldAccessType->getLowValue(context);
-        const auto highValue = fieldAccessType->generateHighValue(m_arrayNameToken, context);
+        const auto highValue = fieldAccessType->generateHighValue(V, context);
         const auto compareSmaller = context->Builder->CreateICmpSLE(index, highValue);
         const auto compareGreater = context->Builder->CreateICmpSGE(index, lowValue);
         const auto andNode = context->Builder->CreateAnd(compareGreater, compareSmaller);
-        const std::string message = "index out of range for expression: " + token.lexical();
+        const std::string message = "index out of range for expression: " + std::string(token.lexical());
         SystemFunctionCallNode::codegen_assert(context, resolveParent(context), this, andNode, message);
 
 
-        return fieldAccessType->generateFieldAccess(m_arrayNameToken, index, context);
+        return fieldAccessType->generateFieldAccess(m_arrayNameToken, V, index, context);
     }
-    return LogErrorV("variable can not access elements by [] operator: " + m_arrayNameToken.lexical());
+    return LogErrorV("variable can not access elements by [] operator: " + std::string(m_arrayNameToken.lexical()));
+}
+
+void ArrayAccessNode::bind(Binder &binder)
+{
+    m_indexNode->bind(binder);
+    m_slot = binder.storage(m_arrayNameToken.identifier());
 }
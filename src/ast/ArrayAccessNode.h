@@ -2,20 +2,25 @@
 
 #include "ASTNode.h"
 #include "Token.h"
+#include "VariableSlot.h"
 
 class ArrayAccessNode : public ASTNode
 {
 private:
     Token m_arrayNameToken;
-    std::shared_ptr<ASTNode> m_indexNode;
+    ASTNode *m_indexNode;
+    VariableSlot m_slot;
 
 public:
-    ArrayAccessNode(Token arrayName, const std::shared_ptr<ASTNode> &indexNode);
+    static constexpr NodeKind KIND = NodeKind::ARRAY_ACCESS;
+
+    ArrayAccessNode(Token arrayName, ASTNode *indexNode);
     ~ArrayAccessNode() override = default;
     void print() override;
     llvm::Value *codegen(std::unique_ptr<Context> &context) override;
 
     std::shared_ptr<VariableType> resolveType(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode) override;
+    void bind(Binder &binder) override;
 
     Token expressionToken() override;
 };
@@ -4,21 +4,23 @@
 
 #include "ArrayAccessNode.h"
 #include "BinaryOperationNode.h"
+#include "Binder.h"
 #include "ComparissionNode.h"
 #include "LogicalExpressionNode.h"
 #include "SystemFunctionCallNode.h"
 #include "UnitNode.h"
 #include "VariableAccessNode.h"
 #include "compiler/Context.h"
+#include "compiler/codegen.h"
 #include "exceptions/CompilerException.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Type.h"
 #include "types/StringType.h"
 
-ArrayAssignmentNode::ArrayAssignmentNode(const Token &arrayToken, const std::shared_ptr<ASTNode> &indexNode,
-                                         const std::shared_ptr<ASTNode> &expression) :
-    ASTNode(arrayToken), m_arrayToken(arrayToken), m_variableName(std::string(arrayToken.lexical())),
+ArrayAssignmentNode::ArrayAssignmentNode(const Token &arrayToken, ASTNode *indexNode,
+                                         ASTNode *expression) :
+    ASTNode(arrayToken, KIND), m_arrayToken(arrayToken), m_variableName(std::string(arrayToken.lexical())),
     m_indexNode(indexNode), m_expression(expression)
 {
 }
@@ -27,7 +29,7 @@ void ArrayAssignmentNode::print() {}
 
 
 void ArrayAssignmentNode::range_check(const std::shared_ptr<FieldAccessableType> &fieldAccesableType,
-                                      std::unique_ptr<Context> &context)
+                                      llvm::Value *array, std::unique_ptr<Context> &context)
 {
     const Token token = expressionToken();
 
@@ -40,11 +42,11 @@ void ArrayAssignmentNode::range_check(const std::shared_ptr<FieldAccessableType>
         index = context->Builder->CreateIntCast(index, targetType, true, "lhs_cast");
     }
 
-    const auto highValue = fieldAccesableType->generateHighValue(m_arrayToken, context);
+    const auto highValue = fieldAccesableType->generateHighValue(array, context);
     const auto compareSmaller = context->Builder->CreateICmpSLE(index, highValue);
     const auto compareGreater = context->Builder->CreateICmpSGE(index, lowValue);
     const auto andNode = context->Builder->CreateAnd(compareGreater, compareSmaller);
-    const std::string message = "index out of range for expression: " + token.lexical();
+    const std::string message = "index out of range for expression: " + std::string(token.lexical());
 
     SystemFunctionCallNode::codegen_assert(context, resolveParent(context), this, andNode, message);
 }
@@ -52,19 +54,7 @@ void ArrayAssignmentNode::range_check(const std::shared_ptr<FieldAccessableType>
 llvm::Value *ArrayAssignmentNode::codegen(std::unique_ptr<Context> &context)
 {
     // Look this variable up in the function.
-    llvm::Value *V = context->NamedAllocations[m_variableName];
-
-    if (!V && context->TopLevelFunction)
-    {
-        for (auto &arg: context->TopLevelFunction->args())
-        {
-            if (arg.getName() == m_variableName)
-            {
-                V = context->TopLevelFunction->getArg(arg.getArgNo());
-                break;
-            }
-        }
-    }
+    llvm::Value *V = codegen::slotValue(context, m_slot);
 
     if (!V)
         return LogErrorV("Unknown variable name for array assignment: " + m_variableName);
@@ -75,17 +65,13 @@ llvm::Value *ArrayAssignmentNode::codegen(std::unique_ptr<Context> &context)
     auto arrayDef = context->ProgramUnit->getVariableDefinition(m_variableName);
     std::shared_ptr<VariableType> variableType = nullptr;
 
-    if (context->TopLevelFunction)
+    if (const auto functionDef = context->TopLevelDefinition)
     {
-        if (const auto functionDef =
-                    context->ProgramUnit->getFunctionDefinition(context->TopLevelFunction->getName().str()))
+        arrayDef = functionDef->body()->getVariableDefinition(m_variableName);
+        if (!arrayDef)
         {
-            arrayDef = functionDef.value()->body()->getVariableDefinition(m_variableName);
-            if (!arrayDef)
-            {
-                const auto param = functionDef.value()->getParam(m_variableName);
-                variableType = param.value().type;
-            }
+            const auto param = functionDef->getParam(m_variableName);
+            variableType = param.value().type;
         }
     }
     if (arrayDef)
@@ -96,7 +82,7 @@ llvm::Value *ArrayAssignmentNode::codegen(std::unique_ptr<Context> &context)
     {
         return LogErrorV("Unknown variable name for array assignment: " + m_variableName);
     }
-    if (const auto def = std::dynamic_pointer_cast<ArrayType>(variableType))
+    if (const auto def = typeCast<ArrayType>(variableType))
     {
         bool runtimeRangeCheck = true;
         if (llvm::isa<llvm::ConstantInt>(index) && !def->isDynArray)
@@ -120,8 +106,8 @@ llvm::Value *ArrayAssignmentNode::codegen(std::unique_ptr<Context> &context)
 
         if (runtimeRangeCheck)
         {
-            auto type = std::dynamic_pointer_cast<FieldAccessableType>(def);
-            range_check(type, context);
+            auto type = typeCast<FieldAccessableType>(def);
+            range_check(type, V, context);
         }
 
         if (def->isDynArray)
@@ -148,10 +134,10 @@ llvm::Value *ArrayAssignmentNode::codegen(std::unique_ptr<Context> &context)
         context->Builder->CreateStore(result, bounds);
         return result;
     }
-    if (const auto def = std::dynamic_pointer_cast<StringType>(variableType))
+    if (const auto def = typeCast<StringType>(variableType))
     {
-        auto type = std::dynamic_pointer_cast<FieldAccessableType>(def);
-        range_check(type, context);
+        auto type = typeCast<FieldAccessableType>(def);
+        range_check(type, V, context);
         const auto llvmRecordType = def->generateLlvmType(context);
         const auto arrayBaseType = IntegerType::getInteger(8)->generateLlvmType(context);
 
@@ -168,6 +154,13 @@ llvm::Value *ArrayAssignmentNode::codegen(std::unique_ptr<Context> &context)
     }
     return nullptr;
 }
+void ArrayAssignmentNode::bind(Binder &binder)
+{
+    m_indexNode->bind(binder);
+    m_expression->bind(binder);
+    m_slot = binder.storage(m_arrayToken.identifier());
+}
+
 Token ArrayAssignmentNode::expressionToken()
 {
     auto start = m_arrayToken.sourceLocation.byte_offset;
@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include "ASTNode.h"
+#include "VariableSlot.h"
 
 
 class ArrayAssignmentNode : public ASTNode
@@ -8,17 +9,22 @@ class ArrayAssignmentNode : public ASTNode
 private:
     Token m_arrayToken;
     std::string m_variableName;
-    std::shared_ptr<ASTNode> m_indexNode;
-    std::shared_ptr<ASTNode> m_expression;
-    void range_check(const std::shared_ptr<FieldAccessableType> &fieldAccesableType, std::unique_ptr<Context> &context);
+    ASTNode *m_indexNode;
+    ASTNode *m_expression;
+    VariableSlot m_slot;
+    void range_check(const std::shared_ptr<FieldAccessableType> &fieldAccesableType, llvm::Value *array,
+                     std::unique_ptr<Context> &context);
 
 public:
-    ArrayAssignmentNode(const Token &arrayToken, const std::shared_ptr<ASTNode> &indexNode,
-                        const std::shared_ptr<ASTNode> &expression);
+    static constexpr NodeKind KIND = NodeKind::ARRAY_ASSIGNMENT;
+
+    ArrayAssignmentNode(const Token &arrayToken, ASTNode *indexNode,
+                        ASTNode *expression);
     ~ArrayAssignmentNode() override = default;
     void print() override;
 
     llvm::Value *codegen(std::unique_ptr<Context> &context) override;
+    void bind(Binder &binder) override;
 
     Token expressionToken() override;
 };
@@ -5,9 +5,13 @@
 #include <llvm/IR/Constant.h>
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/DerivedTypes.h>
+
+#include "ASTVisitor.h"
+#include "Binder.h"
+
 ArrayInitialisationNode::ArrayInitialisationNode(const Token &token,
-                                                 const std::vector<std::shared_ptr<ASTNode>> &arguments) :
-    ASTNode(token), m_arguments(arguments)
+                                                 const std::vector<ASTNode *> &arguments) :
+    ASTNode(token, KIND), m_arguments(arguments)
 {
 }
 void ArrayInitialisationNode::print() {}
@@ -15,7 +19,7 @@ llvm::Value *ArrayInitialisationNode::codegen(std::unique_ptr<Context> &context)
 {
 
     auto valueType =
-            m_arguments[0]->resolveType(context->ProgramUnit, resolveParent(context))->generateLlvmType(context);
+            ast::resolveType(m_arguments[0], context->ProgramUnit, resolveParent(context))->generateLlvmType(context);
     llvm::ArrayType *ArrayTy = llvm::ArrayType::get(valueType, m_arguments.size());
 
     // Define the array content
@@ -27,3 +31,11 @@ llvm::Value *ArrayInitialisationNode::codegen(std::unique_ptr<Context> &context)
 
     return llvm::ConstantArray::get(ArrayTy, Elements);
 }
+
+void ArrayInitialisationNode::bind(Binder &binder)
+{
+    for (const auto &argument: m_arguments)
+    {
+        argument->bind(binder);
+    }
+}
@@ -6,11 +6,14 @@
 class ArrayInitialisationNode : public ASTNode
 {
 private:
-    std::vector<std::shared_ptr<ASTNode>> m_arguments;
+    std::vector<ASTNode *> m_arguments;
 
 public:
-    explicit ArrayInitialisationNode(const Token &token, const std::vector<std::shared_ptr<ASTNode>> &arguments);
+    static constexpr NodeKind KIND = NodeKind::ARRAY_INITIALISATION;
+
+    explicit ArrayInitialisationNode(const Token &token, const std::vector<ASTNode *> &arguments);
 
     void print() override;
     llvm::Value *codegen(std::unique_ptr<Context> &context) override;
+    void bind(Binder &binder) override;
 };
@@ -2,6 +2,8 @@
 #include <iostream>
 #include <llvm/IR/IRBuilder.h>
 
+#include "ASTVisitor.h"
+#include "Binder.h"
 #include "UnitNode.h"
 #include "compiler/Context.h"
 #include "exceptions/CompilerException.h"
@@ -9,8 +11,8 @@
 #include "types/StringType.h"
 
 BinaryOperationNode::BinaryOperationNode(const Token &operatorToken, const Operator op,
-                                         const std::shared_ptr<ASTNode> &lhs, const std::shared_ptr<ASTNode> &rhs) :
-    ASTNode(operatorToken), m_operatorToken(operatorToken), m_lhs(lhs), m_rhs(rhs), m_operator(op)
+                                         ASTNode *lhs, ASTNode *rhs) :
+    ASTNode(operatorToken, KIND), m_operatorToken(operatorToken), m_lhs(lhs), m_rhs(rhs), m_operator(op)
 {
 }
 
@@ -265,8 +267,8 @@ llvm::Value *BinaryOperationNode::codegen(std::unique_ptr<Context> &context)
         return generateForInteger(lhs, rhs, context);
     }
 
-    const auto lhs_type = m_lhs->resolveType(context->ProgramUnit, parent);
-    const auto rhs_type = m_rhs->resolveType(context->ProgramUnit, parent);
+    const auto lhs_type = ast::resolveType(m_lhs, context->ProgramUnit, parent);
+    const auto rhs_type = ast::resolveType(m_rhs, context->ProgramUnit, parent);
 
 
     switch (lhs_type->baseType)
@@ -298,15 +300,16 @@ llvm::Value *BinaryOperationNode::codegen(std::unique_ptr<Context> &context)
 std::shared_ptr<VariableType> BinaryOperationNode::resolveType(const std::unique_ptr<UnitNode> &unit,
                                                                ASTNode *parentNode)
 {
-    if (auto type = m_lhs->resolveType(unit, parentNode))
+    if (auto type = ast::resolveType(m_lhs, unit, parentNode))
     {
         return type;
     }
-    return std::make_shared<VariableType>();
+    return VariableType::getUnknown();
 }
 void BinaryOperationNode::typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode)
 {
-    if (const auto lhsType = m_lhs->resolveType(unit, parentNode); auto rhsType = m_rhs->resolveType(unit, parentNode))
+    if (const auto lhsType = ast::resolveType(m_lhs, unit, parentNode);
+        auto rhsType = ast::resolveType(m_rhs, unit, parentNode))
     {
         if (*lhsType != *rhsType)
         {
@@ -329,3 +332,9 @@ Token BinaryOperationNode::expressionToken()
     token.sourceLocation.byte_offset = start;
     return token;
 }
+
+void BinaryOperationNode::bind(Binder &binder)
+{
+    m_lhs->bind(binder);
+    m_rhs->bind(binder);
+}
@@ -1,3 +1,4 @@
+#pragma once
 #include "ASTNode.h"
 #include "NumberNode.h"
 
@@ -14,8 +15,8 @@ enum class Operator : char
 class BinaryOperationNode : public ASTNode
 {
     Token m_operatorToken;
-    std::shared_ptr<ASTNode> m_lhs;
-    std::shared_ptr<ASTNode> m_rhs;
+    ASTNode *m_lhs;
+    ASTNode *m_rhs;
     Operator m_operator;
 
     llvm::Value *generateForInteger(llvm::Value *lhs, llvm::Value *rhs, std::unique_ptr<Context> &context);
@@ -23,19 +24,22 @@ class BinaryOperationNode : public ASTNode
     llvm::Value *generateForString(llvm::Value *lhs, llvm::Value *rhs, std::unique_ptr<Context> &context);
 
 public:
-    BinaryOperationNode(const Token &operatorToken, Operator op, const std::shared_ptr<ASTNode> &lhs,
-                        const std::shared_ptr<ASTNode> &rhs);
+    static constexpr NodeKind KIND = NodeKind::BINARY_OPERATION;
+
+    BinaryOperationNode(const Token &operatorToken, Operator op, ASTNode *lhs,
+                        ASTNode *rhs);
     ~BinaryOperationNode() override = default;
 
     void print() override;
     llvm::Value *generateForStringPlusInteger(llvm::Value *lhs, llvm::Value *rhs, std::unique_ptr<Context> &context);
     llvm::Value *codegen(std::unique_ptr<Context> &context) override;
+    void bind(Binder &binder) override;
     std::shared_ptr<VariableType> resolveType(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode) override;
 
     void typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode) override;
 
-    [[nodiscard]] std::shared_ptr<ASTNode> lhs() const { return m_lhs; }
-    [[nodiscard]] std::shared_ptr<ASTNode> rhs() const { return m_rhs; }
+    [[nodiscard]] ASTNode *lhs() const { return m_lhs; }
+    [[nodiscard]] ASTNode *rhs() const { return m_rhs; }
     [[nodiscard]] Operator binoperator() const { return m_operator; }
 
     Token expressionToken() override;
@@ -0,0 +1,89 @@
+#include "Binder.h"
+
+#include "FunctionDefinitionNode.h"
+
+VariableSlot Binder::nextSlot(const SlotKind kind) { return VariableSlot{.kind = kind, .index = m_slotCount++}; }
+
+void Binder::beginFunction(FunctionDefinitionNode *function)
+{
+    m_function = function;
+    m_values.clear();
+    m_locals.clear();
+    m_slotCount = 0;
+}
+
+uint32_t Binder::endFunction()
+{
+    const auto slotCount = m_slotCount;
+    beginFunction(nullptr);
+    return slotCount;
+}
+
+uint32_t Binder::globalCount() const { return static_cast<uint32_t>(m_globals.size()); }
+
+VariableSlot Binder::declareVariable(const Identifier identifier)
+{
+    const auto slot = nextSlot(SlotKind::LOCAL);
+    m_locals.insert_or_assign(identifier, slot);
+    return slot;
+}
+
+void Binder::declareAlias(const Identifier identifier, const VariableSlot slot)
+{
+    m_locals.insert_or_assign(identifier, slot);
+}
+
+VariableSlot Binder::declareConstant(const Identifier identifier)
+{
+    if (m_function == nullptr)
+    {
+        // the main block of a program declares the constants again, which were bound before its functions
+        const auto [it, inserted] = m_globals.try_emplace(
+                identifier, VariableSlot{.kind = SlotKind::GLOBAL, .index = static_cast<uint32_t>(m_globals.size())});
+        return it->second;
+    }
+    const auto slot = nextSlot(SlotKind::VALUE);
+    m_values.insert_or_assign(identifier, slot);
+    return slot;
+}
+
+VariableSlot Binder::declareLoopVariable(const Identifier identifier)
+{
+    const auto slot = nextSlot(SlotKind::VALUE);
+    m_values.insert_or_assign(identifier, slot);
+    return slot;
+}
+
+VariableSlot Binder::value(const Identifier identifier) const
+{
+    if (const auto it = m_values.find(identifier); it != m_values.end())
+    {
+        return it->second;
+    }
+    // the variables and params of a function shadow the constants of the program
+    if (const auto slot = storage(identifier); slot.bound())
+    {
+        return slot;
+    }
+    if (const auto it = m_globals.find(identifier); it != m_globals.end())
+    {
+        return it->second;
+    }
+    return VariableSlot{};
+}
+
+VariableSlot Binder::storage(const Identifier identifier) const
+{
+    if (const auto it = m_locals.find(identifier); it != m_locals.end())
+    {
+        return it->second;
+    }
+    if (m_function != nullptr)
+    {
+        if (const auto argNo = m_function->paramIndex(identifier))
+        {
+            return VariableSlot{.kind = SlotKind::ARGUMENT, .index = static_cast<uint32_t>(*argNo)};
+        }
+    }
+    return VariableSlot{};
+}
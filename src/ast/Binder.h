@@ -0,0 +1,62 @@
+#pragma once
+#include <unordered_map>
+#include "Identifier.h"
+#include "VariableSlot.h"
+
+class FunctionDefinitionNode;
+
+/**
+ * the binding pass, it runs after the type check and before the code generation.
+ * Every name of a variable, constant or parameter is resolved to the slot of the function in which the code generation
+ * stores its value, so the code generation indexes the slots instead of looking up the names.
+ * Like the code generation the slots of a function are flat, a name keeps its slot until the end of the function.
+ */
+class Binder
+{
+    std::unordered_map<Identifier, VariableSlot> m_globals;
+    // the constants and loop variables of the current function, they are read as values
+    std::unordered_map<Identifier, VariableSlot> m_values;
+    // the allocated variables of the current function
+    std::unordered_map<Identifier, VariableSlot> m_locals;
+    FunctionDefinitionNode *m_function = nullptr;
+    uint32_t m_slotCount = 0;
+
+    VariableSlot nextSlot(SlotKind kind);
+
+public:
+    Binder() = default;
+    ~Binder() = default;
+
+    /**
+     * opens the slots of a function, nullptr opens the slots of the main block of a program.
+     */
+    void beginFunction(FunctionDefinitionNode *function);
+    /**
+     * closes the slots of the current function and returns their number.
+     */
+    uint32_t endFunction();
+    [[nodiscard]] uint32_t globalCount() const;
+
+    VariableSlot declareVariable(Identifier identifier);
+    /**
+     * binds a second name to the slot of a variable, e.g. result to the result variable of a function.
+     */
+    void declareAlias(Identifier identifier, VariableSlot slot);
+    /**
+     * a constant outside of a function is a global of the program.
+     */
+    VariableSlot declareConstant(Identifier identifier);
+    /**
+     * the loop variable of a for loop is read from its own slot while the assignments still go to the variable.
+     */
+    VariableSlot declareLoopVariable(Identifier identifier);
+
+    /**
+     * returns the slot from which the value of the name is read.
+     */
+    [[nodiscard]] VariableSlot value(Identifier identifier) const;
+    /**
+     * returns the slot of the memory of the name, which is used by assignments and by the access to elements and fields.
+     */
+    [[nodiscard]] VariableSlot storage(Identifier identifier) const;
+};
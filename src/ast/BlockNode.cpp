@@ -1,15 +1,17 @@
 #include "BlockNode.h"
 #include <iostream>
 
-#include "compare.h"
+#include "ASTVisitor.h"
+#include "Binder.h"
 #include "compiler/Context.h"
+#include "compiler/codegen.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/IRBuilder.h"
 
 
 BlockNode::BlockNode(const Token &token, const std::vector<VariableDefinition> &variableDefinitions,
-                     const std::vector<std::shared_ptr<ASTNode>> &expressions) :
-    ASTNode(token), m_expressions(expressions), m_variableDefinitions(variableDefinitions)
+                     const std::vector<ASTNode *> &expressions) :
+    ASTNode(token, KIND), m_expressions(expressions), m_variableDefinitions(variableDefinitions)
 {
 }
 
@@ -24,7 +26,7 @@ void BlockNode::print()
     std::cout << "begin\n";
     for (auto exp: m_expressions)
     {
-        exp->print();
+        ast::print(exp);
     }
 
     std::cout << "end;\n";
@@ -38,7 +40,7 @@ void BlockNode::codegenConstantDefinitions(std::unique_ptr<Context> &context)
     {
         if (def.constant)
         {
-            context->NamedValues[def.variableName] = def.generateCodeForConstant(context);
+            codegen::setSlotValue(context, def.slot, def.generateCodeForConstant(context));
         }
     }
 }
@@ -59,11 +61,9 @@ llvm::Value *BlockNode::codegen(std::unique_ptr<Context> &context)
         if (!def.constant)
 
         {
-            context->NamedAllocations[def.variableName] = def.generateCode(context);
-            if (!def.alias.empty())
-            {
-                context->NamedAllocations[def.alias] = context->NamedAllocations[def.variableName];
-            }
+            // an alias shares the slot of the variable
+            llvm::AllocaInst *allocation = def.generateCode(context);
+            codegen::setSlotValue(context, def.slot, allocation);
             if (def.value)
             {
 
@@ -91,8 +91,7 @@ llvm::Value *BlockNode::codegen(std::unique_ptr<Context> &context)
                     uint64_t structSize = DL.getTypeAllocSize(llvmArgType);
 
 
-                    memcopyArgs.push_back(context->Builder->CreateBitCast(context->NamedAllocations[def.variableName],
-                                                                          context->Builder->getPtrTy()));
+                    memcopyArgs.push_back(context->Builder->CreateBitCast(allocation, context->Builder->getPtrTy()));
                     memcopyArgs.push_back(context->Builder->CreateBitCast(result, context->Builder->getPtrTy()));
                     memcopyArgs.push_back(context->Builder->getInt64(structSize));
                     memcopyArgs.push_back(context->Builder->getFalse());
@@ -101,7 +100,7 @@ llvm::Value *BlockNode::codegen(std::unique_ptr<Context> &context)
                 }
                 else
                 {
-                    context->Builder->CreateStore(result, context->NamedAllocations[def.variableName]);
+                    context->Builder->CreateStore(result, allocation);
                 }
             }
         }
@@ -110,34 +109,9 @@ llvm::Value *BlockNode::codegen(std::unique_ptr<Context> &context)
 
     for (const auto &exp: m_expressions)
     {
-        values.push_back(exp->codegen(context));
+        values.push_back(ast::codegen(exp, context));
     }
 
-    auto topLevelFunctionName = (context->TopLevelFunction) ? context->TopLevelFunction->getName().str() : "";
-    if (context->TopLevelFunction)
-        topLevelFunctionName = topLevelFunctionName.substr(0, topLevelFunctionName.find('('));
-    for (auto &def: m_variableDefinitions)
-    {
-
-        if (def.variableType->baseType == VariableBaseType::String)
-        {
-            // auto stringStructPtr = context->NamedAllocations[def.variableName];
-            // auto type = def.variableType;
-            // const auto arrayPointerOffset = context->Builder->CreateStructGEP(type->generateLlvmType(context),
-            //                                                                   stringStructPtr, 2,
-            //                                                                   "string.ptr.offset");
-            // auto strValuePtr = context->Builder->CreateLoad(llvm::PointerType::getUnqual(*context->TheContext),
-            //                                                 arrayPointerOffset);
-
-            // context->Builder->CreateCall(context->TheModule->getFunction("free"), strValuePtr);
-        }
-
-        if (!context->TopLevelFunction || !iequals(def.variableName, topLevelFunctionName))
-        {
-            context->NamedValues.erase(def.variableName);
-            context->NamedAllocations.erase(def.variableName);
-        }
-    }
     return llvm::Constant::getNullValue(llvm::Type::getDoubleTy(*context->TheContext));
 }
 
@@ -157,7 +131,7 @@ std::optional<VariableDefinition> BlockNode::getVariableDefinition(const std::st
         {
             continue;
         }
-        if (auto b = std::dynamic_pointer_cast<BlockNode>(block.value()))
+        if (auto b = nodeCast<BlockNode>(block.value()))
         {
             auto result = b->getVariableDefinition(name);
             if (result)
@@ -172,18 +146,72 @@ std::optional<VariableDefinition> BlockNode::getVariableDefinition(const std::st
 
 void BlockNode::addVariableDefinition(VariableDefinition definition) { m_variableDefinitions.emplace_back(definition); }
 
+void BlockNode::setVariableValue(const Identifier identifier, llvm::Value *value)
+{
+    for (auto &def: m_variableDefinitions)
+    {
+        if (def.identifier == identifier)
+        {
+            def.llvmValue = value;
+        }
+    }
+}
+
 
-void BlockNode::appendExpression(const std::shared_ptr<ASTNode> &node) { m_expressions.push_back(node); }
+void BlockNode::appendExpression(ASTNode *node) { m_expressions.push_back(node); }
 void BlockNode::typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode)
 {
     for (const auto &exp: m_expressions)
     {
-        exp->typeCheck(unit, parentNode);
+        ast::typeCheck(exp, unit, parentNode);
+    }
+}
+
+void BlockNode::bindConstants(Binder &binder)
+{
+    for (auto &def: m_variableDefinitions)
+    {
+        if (def.constant)
+        {
+            if (def.value)
+            {
+                def.value->bind(binder);
+            }
+            def.slot = binder.declareConstant(def.identifier);
+        }
+    }
+}
+
+void BlockNode::bind(Binder &binder)
+{
+    for (auto &def: m_variableDefinitions)
+    {
+        if (def.value)
+        {
+            def.value->bind(binder);
+        }
+        if (def.constant)
+        {
+            def.slot = binder.declareConstant(def.identifier);
+        }
+        else
+        {
+            def.slot = binder.declareVariable(def.identifier);
+            if (!def.alias.empty())
+            {
+                binder.declareAlias(Identifiers::intern(def.alias), def.slot);
+            }
+        }
+    }
+    for (const auto &exp: m_expressions)
+    {
+        exp->bind(binder);
     }
 }
+
 std::vector<VariableDefinition> BlockNode::getVariableDefinitions() { return m_variableDefinitions; }
 
-void BlockNode::preappendExpression(std::shared_ptr<ASTNode> node)
+void BlockNode::preappendExpression(ASTNode *node)
 {
     m_expressions.emplace(m_expressions.begin(), node);
 }
@@ -8,13 +8,15 @@
 class BlockNode : public ASTNode
 {
 private:
-    std::vector<std::shared_ptr<ASTNode>> m_expressions;
+    std::vector<ASTNode *> m_expressions;
     std::vector<VariableDefinition> m_variableDefinitions;
     std::string m_blockname;
 
 public:
+    static constexpr NodeKind KIND = NodeKind::BLOCK;
+
     BlockNode(const Token &token, const std::vector<VariableDefinition> &variableDefinitions,
-              const std::vector<std::shared_ptr<ASTNode>> &expressions);
+              const std::vector<ASTNode *> &expressions);
     ~BlockNode() override = default;
 
     void print() override;
@@ -23,8 +25,17 @@ public:
     llvm::Value *codegen(std::unique_ptr<Context> &context) override;
     std::optional<VariableDefinition> getVariableDefinition(const std::string &name);
     void addVariableDefinition(VariableDefinition definition);
-    void preappendExpression(std::shared_ptr<ASTNode> node);
-    void appendExpression(const std::shared_ptr<ASTNode> &node);
+    /**
+     * sets the llvm value with which the code generation initializes the variable.
+     */
+    void setVariableValue(Identifier identifier, llvm::Value *value);
+    void preappendExpression(ASTNode *node);
+    void appendExpression(ASTNode *node);
     void typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode) override;
+    /**
+     * binds only the constants, the constants of a program are visible in its functions.
+     */
+    void bindConstants(Binder &binder);
+    void bind(Binder &binder) override;
     std::vector<VariableDefinition> getVariableDefinitions();
 };
@@ -8,6 +8,8 @@ private:
     const bool m_value;
 
 public:
+    static constexpr NodeKind KIND = NodeKind::BOOLEAN;
+
     BooleanNode(const Token &token, bool value);
     ~BooleanNode() override = default;
 
@@ -7,6 +7,8 @@ class BreakNode : public ASTNode
 private:
     /* data */
 public:
+    static constexpr NodeKind KIND = NodeKind::BREAK;
+
     BreakNode(const Token &token);
     ~BreakNode() override = default;
 
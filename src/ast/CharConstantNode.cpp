@@ -3,7 +3,7 @@
 #include "llvm/IR/Constants.h"
 
 CharConstantNode::CharConstantNode(const Token &token, std::string_view literal) :
-    ASTNode(token), m_literal(literal.at(0))
+    ASTNode(token, KIND), m_literal(literal.at(0))
 {
 }
 
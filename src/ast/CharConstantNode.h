@@ -8,6 +8,8 @@ private:
     char m_literal;
 
 public:
+    static constexpr NodeKind KIND = NodeKind::CHAR_CONSTANT;
+
     CharConstantNode(const Token &token, std::string_view literal);
     ~CharConstantNode() override = default;
     void print() override;
@@ -15,17 +15,20 @@ class ComparrisionNode final : public ASTNode
 {
 private:
     Token m_operatorToken;
-    std::shared_ptr<ASTNode> m_lhs;
-    std::shared_ptr<ASTNode> m_rhs;
+    ASTNode *m_lhs;
+    ASTNode *m_rhs;
     CMPOperator m_operator;
 
 public:
-    ComparrisionNode(const Token &operatorToken, CMPOperator op, const std::shared_ptr<ASTNode> &lhs,
-                     const std::shared_ptr<ASTNode> &rhs);
+    static constexpr NodeKind KIND = NodeKind::COMPARISON;
+
+    ComparrisionNode(const Token &operatorToken, CMPOperator op, ASTNode *lhs,
+                     ASTNode *rhs);
     ~ComparrisionNode() override = default;
 
     void print() override;
     llvm::Value *codegen(std::unique_ptr<Context> &context) override;
+    void bind(Binder &binder) override;
     void typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode) override;
     std::shared_ptr<VariableType> resolveType(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode) override;
 
@@ -3,13 +3,15 @@
 #include <llvm/IR/IRBuilder.h>
 
 #include "ComparissionNode.h"
+#include "ASTVisitor.h"
+#include "Binder.h"
 #include "UnitNode.h"
 #include "compiler/Context.h"
 #include "exceptions/CompilerException.h"
 
 ComparrisionNode::ComparrisionNode(const Token &operatorToken, const CMPOperator op,
-                                   const std::shared_ptr<ASTNode> &lhs, const std::shared_ptr<ASTNode> &rhs) :
-    ASTNode(operatorToken), m_operatorToken(operatorToken), m_lhs(lhs), m_rhs(rhs), m_operator(op)
+                                   ASTNode *lhs, ASTNode *rhs) :
+    ASTNode(operatorToken, KIND), m_operatorToken(operatorToken), m_lhs(lhs), m_rhs(rhs), m_operator(op)
 {
 }
 
@@ -102,17 +104,10 @@ llvm::Value *ComparrisionNode::codegen(std::unique_ptr<Context> &context)
         }
     }
 
-    ASTNode *parent = context->ProgramUnit.get();
-    if (context->TopLevelFunction)
-    {
-        if (auto def = context->ProgramUnit->getFunctionDefinition(context->TopLevelFunction->getName().str()))
-        {
-            parent = def.value().get();
-        }
-    }
+    ASTNode *parent = resolveParent(context);
 
-    auto lhsType = m_lhs->resolveType(context->ProgramUnit, parent);
-    auto rhsType = m_rhs->resolveType(context->ProgramUnit, parent);
+    auto lhsType = ast::resolveType(m_lhs, context->ProgramUnit, parent);
+    auto rhsType = ast::resolveType(m_rhs, context->ProgramUnit, parent);
 
     if (*lhsType == *rhsType && lhsType->baseType == VariableBaseType::Integer)
     {
@@ -191,8 +186,8 @@ llvm::Value *ComparrisionNode::codegen(std::unique_ptr<Context> &context)
 }
 void ComparrisionNode::typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode)
 {
-    const auto lhsType = m_lhs->resolveType(unit, parentNode);
-    const auto rhsType = m_rhs->resolveType(unit, parentNode);
+    const auto lhsType = ast::resolveType(m_lhs, unit, parentNode);
+    const auto rhsType = ast::resolveType(m_rhs, unit, parentNode);
     if (*lhsType != *rhsType)
     {
         throw CompilerException(ParserError{.token = m_operatorToken,
@@ -216,3 +211,9 @@ Token ComparrisionNode::expressionToken()
     token.sourceLocation.byte_offset = start;
     return token;
 }
+
+void ComparrisionNode::bind(Binder &binder)
+{
+    m_lhs->bind(binder);
+    m_rhs->bind(binder);
+}
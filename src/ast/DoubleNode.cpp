@@ -4,7 +4,7 @@
 #include <llvm/IR/IRBuilder.h>
 
 #include "compiler/Context.h"
-DoubleNode::DoubleNode(const Token &token, const double value) : ASTNode(token), m_value(value) {}
+DoubleNode::DoubleNode(const Token &token, const double value) : ASTNode(token, KIND), m_value(value) {}
 void DoubleNode::print() {}
 llvm::Value *DoubleNode::codegen(std::unique_ptr<Context> &context)
 {
@@ -7,6 +7,8 @@ private:
     double m_value;
 
 public:
+    static constexpr NodeKind KIND = NodeKind::DOUBLE;
+
     DoubleNode(const Token &token, double value);
     ~DoubleNode() override = default;
     void print() override;
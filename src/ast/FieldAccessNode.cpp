@@ -1,8 +1,10 @@
 #include "FieldAccessNode.h"
+#include "Binder.h"
 #include "FunctionCallNode.h"
 #include "FunctionDefinitionNode.h"
 #include "UnitNode.h"
 #include "compiler/Context.h"
+#include "compiler/codegen.h"
 #include "exceptions/CompilerException.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/IRBuilder.h"
@@ -10,7 +12,8 @@
 
 
 FieldAccessNode::FieldAccessNode(const Token &element, const Token &field) :
-    ASTNode(element), m_element(element), m_elementName(element.lexical()), m_field(field), m_fieldName(field.lexical())
+    ASTNode(element, KIND), m_element(element), m_elementName(element.lexical()), m_field(field),
+    m_fieldName(field.lexical())
 {
 }
 
@@ -18,61 +21,51 @@ void FieldAccessNode::print() {}
 
 llvm::Value *FieldAccessNode::codegen(std::unique_ptr<Context> &context)
 {
-    llvm::AllocaInst *V = context->NamedAllocations[m_elementName];
-
     const auto fieldName = m_elementName + "." + m_fieldName;
-    if (!V)
+    if (m_slot.kind == SlotKind::ARGUMENT)
     {
-        for (size_t i = 0; i < context->TopLevelFunction->arg_size(); ++i)
-        {
-            auto arg = context->TopLevelFunction->getArg(static_cast<unsigned>(i));
-            if (arg->getName() == m_elementName)
-            {
+        auto arg = codegen::slotValue(context, m_slot);
+        auto structDef = context->TopLevelDefinition->getParam(m_slot.index);
 
-                auto functionDefinition =
-                        context->ProgramUnit->getFunctionDefinition(context->TopLevelFunction->getName().str());
-                auto structDef = functionDefinition.value()->getParam(m_elementName);
-
-                if (!structDef)
-                {
-                    return LogErrorV("Unknown struct with name: " + m_elementName);
-                }
+        if (!structDef)
+        {
+            return LogErrorV("Unknown struct with name: " + m_elementName);
+        }
 
-                auto recordType = std::dynamic_pointer_cast<RecordType>(structDef->type);
-                auto llvmRecordType = llvm::cast<llvm::StructType>(recordType->generateLlvmType(context));
+        auto recordType = typeCast<RecordType>(structDef->type);
+        auto llvmRecordType = llvm::cast<llvm::StructType>(recordType->generateLlvmType(context));
 
-                auto index = recordType->getFieldIndexByName(m_fieldName);
-                auto field = recordType->getField(index);
-                llvm::Value *value = arg;
-                if (arg->getType()->isStructTy())
-                {
-                    llvm::AllocaInst *alloca =
-                            context->Builder->CreateAlloca(llvmRecordType, nullptr, m_elementName + "_ptr");
-                    context->Builder->CreateStore(arg, alloca);
+        auto index = recordType->getFieldIndexByName(m_fieldName);
+        auto field = recordType->getField(index);
+        llvm::Value *value = arg;
+        if (arg->getType()->isStructTy())
+        {
+            llvm::AllocaInst *alloca = context->Builder->CreateAlloca(llvmRecordType, nullptr, m_elementName + "_ptr");
+            context->Builder->CreateStore(arg, alloca);
 
-                    value = alloca;
-                }
-                auto fieldType = field.variableType->generateLlvmType(context);
-                const llvm::DataLayout &DL = context->TheModule->getDataLayout();
-                auto alignment = DL.getPrefTypeAlign(fieldType);
+            value = alloca;
+        }
+        auto fieldType = field.variableType->generateLlvmType(context);
+        const llvm::DataLayout &DL = context->TheModule->getDataLayout();
+        auto alignment = DL.getPrefTypeAlign(fieldType);
 
 
-                auto arrayValue = context->Builder->CreateStructGEP(llvmRecordType, value, index, fieldName);
-                // if (fieldType->isPointerTy())
-                // {
-                //     return arrayValue;
-                // }
-                return context->Builder->CreateAlignedLoad(fieldType, arrayValue, alignment, fieldName);
-            }
-        }
+        auto arrayValue = context->Builder->CreateStructGEP(llvmRecordType, value, index, fieldName);
+        // if (fieldType->isPointerTy())
+        // {
+        //     return arrayValue;
+        // }
+        return context->Builder->CreateAlignedLoad(fieldType, arrayValue, alignment, fieldName);
+    }
+    if (m_slot.kind != SlotKind::LOCAL)
+    {
+        return LogErrorV("Unknown record variable name: " + m_elementName);
     }
+    const auto V = llvm::cast<llvm::AllocaInst>(codegen::slotValue(context, m_slot));
     std::optional<VariableDefinition> structDef;
-    if (context->TopLevelFunction)
+    if (context->TopLevelDefinition)
     {
-        auto functionDefinition =
-                context->ProgramUnit->getFunctionDefinition(context->TopLevelFunction->getName().str());
-        if (functionDefinition)
-            structDef = functionDefinition.value()->body()->getVariableDefinition(m_elementName);
+        structDef = context->TopLevelDefinition->body()->getVariableDefinition(m_elementName);
     }
 
     if (!structDef)
@@ -85,7 +78,7 @@ llvm::Value *FieldAccessNode::codegen(std::unique_ptr<Context> &context)
     }
     else
     {
-        auto recordType = std::dynamic_pointer_cast<RecordType>(structDef->variableType);
+        auto recordType = typeCast<RecordType>(structDef->variableType);
 
         auto index = recordType->getFieldIndexByName(m_fieldName);
         auto field = recordType->getField(index);
@@ -98,13 +91,13 @@ llvm::Value *FieldAccessNode::codegen(std::unique_ptr<Context> &context)
 
 std::shared_ptr<VariableType> FieldAccessNode::resolveType(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode)
 {
-    if (auto functionDefinition = dynamic_cast<FunctionDefinitionNode *>(parentNode))
+    if (auto functionDefinition = nodeCast<FunctionDefinitionNode>(parentNode))
     {
         if (auto param = functionDefinition->getParam(m_elementName))
         {
             if (param->type->baseType == VariableBaseType::Struct)
             {
-                auto type = std::dynamic_pointer_cast<RecordType>(param->type);
+                auto type = typeCast<RecordType>(param->type);
 
                 auto field = type->getFieldByName(m_fieldName);
 
@@ -118,7 +111,7 @@ std::shared_ptr<VariableType> FieldAccessNode::resolveType(const std::unique_ptr
         {
             if (variable->variableType->baseType == VariableBaseType::Struct)
             {
-                auto type = std::dynamic_pointer_cast<RecordType>(variable->variableType);
+                auto type = typeCast<RecordType>(variable->variableType);
 
                 if (auto field = type->getFieldByName(m_fieldName))
                 {
@@ -131,7 +124,7 @@ std::shared_ptr<VariableType> FieldAccessNode::resolveType(const std::unique_ptr
 
     if (definition->variableType->baseType == VariableBaseType::Struct)
     {
-        auto type = std::dynamic_pointer_cast<RecordType>(definition->variableType);
+        auto type = typeCast<RecordType>(definition->variableType);
 
         if (auto field = type->getFieldByName(m_fieldName))
         {
@@ -139,5 +132,7 @@ std::shared_ptr<VariableType> FieldAccessNode::resolveType(const std::unique_ptr
         }
     }
 
-    return std::make_shared<VariableType>();
+    return VariableType::getUnknown();
 }
+
+void FieldAccessNode::bind(Binder &binder) { m_slot = binder.storage(m_element.identifier()); }
@@ -4,6 +4,7 @@
 #include <string>
 #include "ASTNode.h"
 #include "Token.h"
+#include "VariableSlot.h"
 
 class FieldAccessNode : public ASTNode
 {
@@ -12,12 +13,16 @@ private:
     std::string m_elementName;
     Token m_field;
     std::string m_fieldName;
+    VariableSlot m_slot;
 
 public:
+    static constexpr NodeKind KIND = NodeKind::FIELD_ACCESS;
+
     FieldAccessNode(const Token &element, const Token &field);
     ~FieldAccessNode() = default;
     void print() override;
     llvm::Value *codegen(std::unique_ptr<Context> &context) override;
 
     std::shared_ptr<VariableType> resolveType(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode) override;
+    void bind(Binder &binder) override;
 };
@@ -1,15 +1,17 @@
 #include "FieldAssignmentNode.h"
+#include "Binder.h"
 #include "FunctionCallNode.h"
 #include "UnitNode.h"
 #include "compiler/Context.h"
+#include "compiler/codegen.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Type.h"
 #include "types/RecordType.h"
 
 FieldAssignmentNode::FieldAssignmentNode(const Token &variable, const Token &field,
-                                         const std::shared_ptr<ASTNode> &expression) :
-    ASTNode(variable), m_variable(variable), m_variableName(std::string(m_variable.lexical())), m_field(field),
+                                         ASTNode *expression) :
+    ASTNode(variable, KIND), m_variable(variable), m_variableName(std::string(m_variable.lexical())), m_field(field),
     m_fieldName(std::string(m_field.lexical())), m_expression(expression)
 {
 }
@@ -19,85 +21,71 @@ void FieldAssignmentNode::print() {}
 llvm::Value *FieldAssignmentNode::codegen(std::unique_ptr<Context> &context)
 {
     using namespace std::string_literals;
-    llvm::AllocaInst *V = context->NamedAllocations[m_variableName];
-
     const auto fieldName = m_variableName + "." + m_fieldName;
 
-    if (!V)
+    if (m_slot.kind == SlotKind::ARGUMENT)
     {
-        for (size_t i = 0; i < context->TopLevelFunction->arg_size(); ++i)
+        auto arg = codegen::slotValue(context, m_slot);
+        auto structDef = context->TopLevelDefinition->getParam(m_slot.index);
+
+        if (!structDef)
+        {
+            return LogErrorV("Unknown variable name");
+        }
+
+        auto recordType = typeCast<RecordType>(structDef->type);
+        auto llvmRecordType = llvm::cast<llvm::StructType>(recordType->generateLlvmType(context));
+
+        auto index = recordType->getFieldIndexByName(m_fieldName);
+        auto field = recordType->getField(index);
+        auto fieldType = field.variableType->generateLlvmType(context);
+        auto result = m_expression->codegen(context);
+
+        if (fieldType->isIntegerTy())
         {
-            auto arg = context->TopLevelFunction->getArg(static_cast<unsigned>(i));
-            if (arg->getName() == m_variableName)
+            auto bitLength = fieldType->getIntegerBitWidth();
+            if (result->getType()->isIntegerTy() && result->getType()->getIntegerBitWidth() != bitLength)
             {
-                auto functionDefinition =
-                        context->ProgramUnit->getFunctionDefinition(context->TopLevelFunction->getName().str());
-                if (!functionDefinition.has_value())
-                {
-                    return LogErrorV("Cannot find function definition for " +
-                                     context->TopLevelFunction->getName().str());
-                }
-                auto structDef = functionDefinition.value()->getParam(m_variableName);
-
-                if (!structDef)
-                {
-                    return LogErrorV("Unknown variable name");
-                }
-
-                auto recordType = std::dynamic_pointer_cast<RecordType>(structDef->type);
-                auto llvmRecordType = llvm::cast<llvm::StructType>(recordType->generateLlvmType(context));
-
-                auto index = recordType->getFieldIndexByName(m_fieldName);
-                auto field = recordType->getField(index);
-                auto fieldType = field.variableType->generateLlvmType(context);
-                auto result = m_expression->codegen(context);
-
-                if (fieldType->isIntegerTy())
-                {
-                    auto bitLength = fieldType->getIntegerBitWidth();
-                    if (result->getType()->isIntegerTy() && result->getType()->getIntegerBitWidth() != bitLength)
-                    {
-                        result = context->Builder->CreateIntCast(result, fieldType, true, "result_cast");
-                    }
-                }
-                if (arg->getType()->isStructTy())
-                {
-                    llvm::AllocaInst *alloca =
-                            context->Builder->CreateAlloca(llvmRecordType, nullptr, m_variableName + "_ptr");
-                    context->Builder->CreateStore(arg, alloca);
-
-                    auto arrayValue = context->Builder->CreateStructGEP(llvmRecordType, alloca, index, fieldName);
-                    context->Builder->CreateStore(result, arrayValue);
-                }
-                else
-                {
-                    auto arrayValue = context->Builder->CreateStructGEP(llvmRecordType, arg, index, fieldName);
-
-
-                    context->Builder->CreateStore(result, arrayValue);
-                }
-                return result;
+                result = context->Builder->CreateIntCast(result, fieldType, true, "result_cast");
             }
         }
+        if (arg->getType()->isStructTy())
+        {
+            llvm::AllocaInst *alloca = context->Builder->CreateAlloca(llvmRecordType, nullptr, m_variableName + "_ptr");
+            context->Builder->CreateStore(arg, alloca);
+
+            auto arrayValue = context->Builder->CreateStructGEP(llvmRecordType, alloca, index, fieldName);
+            context->Builder->CreateStore(result, arrayValue);
+        }
+        else
+        {
+            auto arrayValue = context->Builder->CreateStructGEP(llvmRecordType, arg, index, fieldName);
+
+
+            context->Builder->CreateStore(result, arrayValue);
+        }
+        return result;
+    }
+    llvm::AllocaInst *V = nullptr;
+    if (m_slot.kind == SlotKind::LOCAL)
+    {
+        V = llvm::cast<llvm::AllocaInst>(codegen::slotValue(context, m_slot));
     }
     if (!V)
         return LogErrorV("Unknown record variable name "s + m_variableName);
 
 
     std::optional<VariableDefinition> structDef;
-    if (context->TopLevelFunction)
+    if (context->TopLevelDefinition)
     {
-        auto functionDefinition =
-                context->ProgramUnit->getFunctionDefinition(context->TopLevelFunction->getName().str());
-        if (functionDefinition)
-            structDef = functionDefinition.value()->body()->getVariableDefinition(m_variableName);
+        structDef = context->TopLevelDefinition->body()->getVariableDefinition(m_variableName);
     }
 
     if (!structDef)
     {
         structDef = context->ProgramUnit->getVariableDefinition(m_variableName);
     }
-    auto recordType = std::dynamic_pointer_cast<RecordType>(structDef->variableType);
+    auto recordType = typeCast<RecordType>(structDef->variableType);
 
     auto index = recordType->getFieldIndexByName(m_fieldName);
     auto field = recordType->getField(index);
@@ -119,3 +107,9 @@ llvm::Value *FieldAssignmentNode::codegen(std::unique_ptr<Context> &context)
     context->Builder->CreateAlignedStore(result, elementPointer, alignment);
     return result;
 }
+
+void FieldAssignmentNode::bind(Binder &binder)
+{
+    m_expression->bind(binder);
+    m_slot = binder.storage(m_variable.identifier());
+}
@@ -2,6 +2,7 @@
 #include <string>
 #include "ASTNode.h"
 #include "Token.h"
+#include "VariableSlot.h"
 
 class FieldAssignmentNode : public ASTNode
 {
@@ -10,11 +11,15 @@ private:
     const std::string m_variableName;
     const Token m_field;
     const std::string m_fieldName;
-    std::shared_ptr<ASTNode> m_expression;
+    ASTNode *m_expression;
+    VariableSlot m_slot;
 
 public:
-    FieldAssignmentNode(const Token &variable, const Token &field, const std::shared_ptr<ASTNode> &expression);
+    static constexpr NodeKind KIND = NodeKind::FIELD_ASSIGNMENT;
+
+    FieldAssignmentNode(const Token &variable, const Token &field, ASTNode *expression);
     ~FieldAssignmentNode() = default;
     void print() override;
     llvm::Value *codegen(std::unique_ptr<Context> &context) override;
+    void bind(Binder &binder) override;
 };
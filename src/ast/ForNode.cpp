@@ -4,15 +4,18 @@
 
 #include <utility>
 
+#include "ASTVisitor.h"
+#include "Binder.h"
 #include "BlockNode.h"
 #include "UnitNode.h"
 #include "compiler/Context.h"
+#include "compiler/codegen.h"
 #include "exceptions/CompilerException.h"
 
-ForNode::ForNode(const Token &token, std::string loopVariable, const std::shared_ptr<ASTNode> &startExpression,
-                 const std::shared_ptr<ASTNode> &endExpression, const std::vector<std::shared_ptr<ASTNode>> &body,
+ForNode::ForNode(const Token &token, std::string loopVariable, ASTNode *startExpression,
+                 ASTNode *endExpression, const std::vector<ASTNode *> &body,
                  int increment) :
-    ASTNode(token), m_loopVariable(std::move(loopVariable)), m_startExpression(startExpression),
+    ASTNode(token, KIND), m_loopVariable(std::move(loopVariable)), m_startExpression(startExpression),
     m_endExpression(endExpression), m_body(body), m_increment(increment)
 {
 }
@@ -23,7 +26,7 @@ void ForNode::print() {}
 llvm::Value *ForNode::codegen(std::unique_ptr<Context> &context)
 {
 
-    llvm::Value *startValue = m_startExpression->codegen(context);
+    llvm::Value *startValue = ast::codegen(m_startExpression, context);
     if (!startValue)
         return nullptr;
 
@@ -51,7 +54,7 @@ llvm::Value *ForNode::codegen(std::unique_ptr<Context> &context)
     // Start the PHI node with an entry for Start.
     constexpr unsigned bitLength = 64;
     const auto targetType = llvm::Type::getIntNTy(*llvmContext, bitLength);
-    // if (auto integerType = std::dynamic_pointer_cast<IntegerType>(endExpressionType))
+    // if (auto integerType = typeCast<IntegerType>(endExpressionType))
     // {
     //     bitLength = integerType->length;
     // }
@@ -63,7 +66,7 @@ llvm::Value *ForNode::codegen(std::unique_ptr<Context> &context)
     }
     Variable->addIncoming(startValue, preheaderBB);
 
-    context->NamedValues[m_loopVariable] = Variable;
+    codegen::setSlotValue(context, m_slot, Variable);
 
     context->BreakBlock.Block = afterBB;
     context->BreakBlock.BlockUsed = false;
@@ -74,7 +77,7 @@ llvm::Value *ForNode::codegen(std::unique_ptr<Context> &context)
     for (const auto &exp: m_body)
     {
         builder->SetInsertPoint(loopBB);
-        exp->codegen(context);
+        ast::codegen(exp, context);
     }
     context->BreakBlock.Block = nullptr;
     // Emit the step value.
@@ -83,7 +86,7 @@ llvm::Value *ForNode::codegen(std::unique_ptr<Context> &context)
     llvm::Value *nextVar = builder->CreateAdd(Variable, stepValue, "nextvar");
     // builder->CreateStore(nextVar, context->NamedAllocations[m_loopVariable]);
     //  Compute the end condition.
-    llvm::Value *EndCond = m_endExpression->codegen(context);
+    llvm::Value *EndCond = ast::codegen(m_endExpression, context);
     if (!EndCond)
         return nullptr;
     if (EndCond->getType()->getIntegerBitWidth() != bitLength)
@@ -117,11 +120,11 @@ llvm::Value *ForNode::codegen(std::unique_ptr<Context> &context)
 }
 
 
-std::optional<std::shared_ptr<ASTNode>> ForNode::block()
+std::optional<ASTNode *> ForNode::block()
 {
     for (auto &exp: m_body)
     {
-        if (auto block = std::dynamic_pointer_cast<BlockNode>(exp))
+        if (auto block = nodeCast<BlockNode>(exp))
         {
             return block;
         }
@@ -130,8 +133,8 @@ std::optional<std::shared_ptr<ASTNode>> ForNode::block()
 }
 void ForNode::typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode)
 {
-    const auto startType = m_startExpression->resolveType(unit, parentNode);
-    const auto endType = m_endExpression->resolveType(unit, parentNode);
+    const auto startType = ast::resolveType(m_startExpression, unit, parentNode);
+    const auto endType = ast::resolveType(m_endExpression, unit, parentNode);
 
     if (*startType != *endType)
     {
@@ -142,6 +145,18 @@ void ForNode::typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNo
 
     for (const auto &exp: m_body)
     {
-        exp->typeCheck(unit, parentNode);
+        ast::typeCheck(exp, unit, parentNode);
     }
 }
+
+void ForNode::bind(Binder &binder)
+{
+    m_startExpression->bind(binder);
+    // the reads of the loop variable use the value of the phi node from here on
+    m_slot = binder.declareLoopVariable(Identifiers::intern(m_loopVariable));
+    for (const auto &exp: m_body)
+    {
+        exp->bind(binder);
+    }
+    m_endExpression->bind(binder);
+}
@@ -3,6 +3,8 @@
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Intrinsics.h>
 #include <utility>
+#include "ASTVisitor.h"
+#include "Binder.h"
 #include "FunctionDefinitionNode.h"
 #include "UnitNode.h"
 #include "compare.h"
@@ -10,9 +12,14 @@
 #include "stdlib.h"
 
 
-FunctionCallNode::FunctionCallNode(const Token &token, std::string name,
-                                   const std::vector<std::shared_ptr<ASTNode>> &args) :
-    ASTNode(token), m_name(std::move(name)), m_args(args)
+FunctionCallNode::FunctionCallNode(const Token &token, std::string name, const std::vector<ASTNode *> &args) :
+    FunctionCallNode(token, std::move(name), args, KIND)
+{
+}
+
+FunctionCallNode::FunctionCallNode(const Token &token, std::string name, const std::vector<ASTNode *> &args,
+                                   const NodeKind kind) :
+    ASTNode(token, kind), m_name(std::move(name)), m_identifier(Identifiers::intern(m_name)), m_args(args)
 {
 }
 
@@ -37,7 +44,7 @@ std::string FunctionCallNode::callSignature(const std::unique_ptr<UnitNode> &uni
     std::string result = to_lower(m_name) + "(";
     for (size_t i = 0; i < m_args.size(); ++i)
     {
-        const auto arg = m_args.at(i)->resolveType(unit, parent);
+        const auto arg = ast::resolveType(m_args.at(i), unit, parent);
 
         result += arg->typeName + ((i < m_args.size() - 1) ? "," : "");
     }
@@ -45,41 +52,43 @@ std::string FunctionCallNode::callSignature(const std::unique_ptr<UnitNode> &uni
     return result;
 }
 
-llvm::Value *FunctionCallNode::codegen(std::unique_ptr<Context> &context)
+FunctionKey FunctionCallNode::callKey(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode) const
 {
-    // Look up the name in the global module table.
-    ASTNode *parent = context->ProgramUnit.get();
-    if (context->TopLevelFunction)
+    ASTNode *parent = parentNode != nullptr ? parentNode : unit.get();
+    FunctionKey key{.name = m_identifier};
+    key.paramTypes.reserve(m_args.size());
+    for (auto &arg: m_args)
     {
-        if (auto def = context->ProgramUnit->getFunctionDefinition(context->TopLevelFunction->getName().str()))
-        {
-            parent = def.value().get();
-        }
+        key.paramTypes.push_back(ast::resolveType(arg, unit, parent)->mangledName());
     }
+    return key;
+}
 
-    std::string functionName = callSignature(context->ProgramUnit, parent);
+llvm::Value *FunctionCallNode::codegen(std::unique_ptr<Context> &context)
+{
+    // Look up the name in the global module table.
+    ASTNode *parent = resolveParent(context);
 
-    llvm::Function *CalleeF = context->TheModule->getFunction(functionName);
-    auto functionDefinition = context->ProgramUnit->getFunctionDefinition(functionName);
+    llvm::Function *CalleeF = nullptr;
+    auto functionDefinition = context->ProgramUnit->getFunctionDefinition(callKey(context->ProgramUnit, parent));
+    if (functionDefinition)
+        CalleeF = context->TheModule->getFunction(functionDefinition.value()->functionSignature());
     if (!CalleeF)
     {
         functionDefinition = context->ProgramUnit->getFunctionDefinition(m_name);
         if (functionDefinition)
             CalleeF = context->TheModule->getFunction(functionDefinition.value()->functionSignature());
-        if (CalleeF)
-        {
-            functionName = m_name;
-        }
     }
 
 
     if (!CalleeF)
-        return LogErrorV("Unknown function referenced: " + functionName);
+        return LogErrorV("Unknown function referenced: " + callSignature(context->ProgramUnit, parent));
 
     // If argument mismatch error.
     if (CalleeF->arg_size() != m_args.size() && !CalleeF->isVarArg())
     {
-        std::cerr << "incorrect argument size for call " << functionName << " != " << CalleeF->arg_size() << "\n";
+        std::cerr << "incorrect argument size for call " << CalleeF->getName().str() << " != " << CalleeF->arg_size()
+                  << "\n";
         return LogErrorV("Incorrect # arguments passed");
     }
 
@@ -160,7 +169,7 @@ llvm::Value *FunctionCallNode::codegen(std::unique_ptr<Context> &context)
 std::shared_ptr<VariableType> FunctionCallNode::resolveType(const std::unique_ptr<UnitNode> &unitNode,
                                                             ASTNode *parentNode)
 {
-    auto functionDefinition = unitNode->getFunctionDefinition(callSignature(unitNode, parentNode));
+    auto functionDefinition = unitNode->getFunctionDefinition(callKey(unitNode, parentNode));
     if (!functionDefinition)
     {
         functionDefinition = unitNode->getFunctionDefinition(m_name);
@@ -168,7 +177,7 @@ std::shared_ptr<VariableType> FunctionCallNode::resolveType(const std::unique_pt
 
     if (!functionDefinition)
     {
-        return std::make_shared<VariableType>();
+        return VariableType::getUnknown();
     }
 
     return functionDefinition.value()->returnType();
@@ -177,3 +186,11 @@ std::shared_ptr<VariableType> FunctionCallNode::resolveType(const std::unique_pt
 
 std::string FunctionCallNode::name() { return m_name; }
 void FunctionCallNode::typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode) {}
+
+void FunctionCallNode::bind(Binder &binder)
+{
+    for (const auto &arg: m_args)
+    {
+        arg->bind(binder);
+    }
+}
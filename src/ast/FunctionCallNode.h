@@ -3,16 +3,30 @@
 #include <string>
 #include <vector>
 #include "ASTNode.h"
+#include "FunctionIndex.h"
 
 class FunctionCallNode : public ASTNode
 {
 protected:
     std::string m_name;
-    std::vector<std::shared_ptr<ASTNode>> m_args;
+    Identifier m_identifier;
+    std::vector<ASTNode *> m_args;
     std::string callSignature(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode) const;
+    /**
+     * the key of the called overload, built from the types of the arguments.
+     */
+    FunctionKey callKey(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode) const;
+    FunctionCallNode(const Token &token, std::string name, const std::vector<ASTNode *> &args, NodeKind kind);
 
 public:
-    FunctionCallNode(const Token &token, std::string name, const std::vector<std::shared_ptr<ASTNode>> &args);
+    static constexpr NodeKind KIND = NodeKind::FUNCTION_CALL;
+    // a system function call is also a function call
+    static bool classof(const ASTNode *node)
+    {
+        return node->kind() == KIND || node->kind() == NodeKind::SYSTEM_FUNCTION_CALL;
+    }
+
+    FunctionCallNode(const Token &token, std::string name, const std::vector<ASTNode *> &args);
     ~FunctionCallNode() override = default;
     void print() override;
     llvm::Value *codegen(std::unique_ptr<Context> &context) override;
@@ -21,4 +35,5 @@ public:
     std::string name();
 
     void typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode) override;
+    void bind(Binder &binder) override;
 };
@@ -3,29 +3,39 @@
 #include <llvm/IR/IRBuilder.h>
 #include <utility>
 
+#include "Binder.h"
 #include "FieldAccessNode.h"
-#include "compare.h"
 #include "compiler/Context.h"
+#include "compiler/codegen.h"
 #include "llvm/IR/Function.h"
-#include "llvm/IR/PassManager.h"
 #include "llvm/IR/Verifier.h"
 #include "types/RecordType.h"
 
 
 FunctionDefinitionNode::FunctionDefinitionNode(const Token &token, std::string name,
-                                               std::vector<FunctionArgument> params, std::shared_ptr<BlockNode> body,
+                                               std::vector<FunctionArgument> params, BlockNode *body,
                                                const bool isProcedure, std::shared_ptr<VariableType> returnType) :
-    ASTNode(token), m_name(std::move(name)), m_externalName(m_name), m_params(std::move(params)),
-    m_body(std::move(body)), m_isProcedure(isProcedure), m_returnType(std::move(returnType))
+    ASTNode(token, KIND), m_name(std::move(name)), m_identifier(Identifiers::intern(m_name)), m_externalName(m_name),
+    m_params(std::move(params)), m_body(body), m_isProcedure(isProcedure),
+    m_returnType(std::move(returnType))
 {
+    for (auto &param: m_params)
+    {
+        m_paramIdentifiers.push_back(Identifiers::intern(param.argumentName));
+    }
 }
 
 FunctionDefinitionNode::FunctionDefinitionNode(const Token &token, std::string name, std::string externalName,
                                                std::string libName, std::vector<FunctionArgument> params,
                                                const bool isProcedure, std::shared_ptr<VariableType> returnType) :
-    ASTNode(token), m_name(std::move(name)), m_externalName(std::move(externalName)), m_libName(std::move(libName)),
-    m_params(std::move(params)), m_body(nullptr), m_isProcedure(isProcedure), m_returnType(std::move(returnType))
+    ASTNode(token, KIND), m_name(std::move(name)), m_identifier(Identifiers::intern(m_name)),
+    m_externalName(std::move(externalName)), m_libName(std::move(libName)), m_params(std::move(params)),
+    m_body(nullptr), m_isProcedure(isProcedure), m_returnType(std::move(returnType))
 {
+    for (auto &param: m_params)
+    {
+        m_paramIdentifiers.push_back(Identifiers::intern(param.argumentName));
+    }
 }
 
 void FunctionDefinitionNode::print()
@@ -64,6 +74,8 @@ void FunctionDefinitionNode::print()
 
 std::string &FunctionDefinitionNode::name() { return m_name; }
 
+Identifier FunctionDefinitionNode::identifier() const { return m_identifier; }
+
 std::shared_ptr<VariableType> FunctionDefinitionNode::returnType() { return m_returnType; }
 
 llvm::Value *FunctionDefinitionNode::codegen(std::unique_ptr<Context> &context)
@@ -105,6 +117,7 @@ llvm::Value *FunctionDefinitionNode::codegen(std::unique_ptr<Context> &context)
         llvm::AttrBuilder b(*context->TheContext);
         b.addAttribute("frame-pointer", "all");
         functionDefinition->addFnAttrs(b);
+        codegen::addTargetAttributes(context, functionDefinition);
     }
     for (const auto attribute: m_attributes)
     {
@@ -132,9 +145,16 @@ llvm::Value *FunctionDefinitionNode::codegen(std::unique_ptr<Context> &context)
         idx++;
     }
     context->FunctionDefinitions[functionSignature()] = functionDefinition;
+    if (context->PrecompiledUnits.contains(m_unitName))
+    {
+        // the body is linked in from the bitcode of the unit
+        return functionDefinition;
+    }
     // Create a new basic block to start insertion into.
 
     context->TopLevelFunction = functionDefinition;
+    context->TopLevelDefinition = this;
+    context->Slots.assign(m_slotCount, nullptr);
     if (m_body)
     {
         m_body->setBlockName(m_name + "_block");
@@ -144,25 +164,17 @@ llvm::Value *FunctionDefinitionNode::codegen(std::unique_ptr<Context> &context)
             context->Builder->CreateRetVoid();
 
             verifyFunction(*functionDefinition);
-            if (context->compilerOptions.buildMode == BuildMode::Release)
-            {
-                context->TheFPM->run(*functionDefinition, *context->TheFAM);
-            }
 
             return functionDefinition;
         }
 
-        context->Builder->CreateRet(context->Builder->CreateLoad(context->NamedAllocations[m_name]->getAllocatedType(),
-                                                                 context->NamedAllocations[m_name]));
+        const auto result = llvm::cast<llvm::AllocaInst>(codegen::slotValue(context, m_resultSlot));
+        context->Builder->CreateRet(context->Builder->CreateLoad(result->getAllocatedType(), result));
 
         // Finish off the function.
 
         // Validate the generated code, checking for consistency.
         llvm::verifyFunction(*functionDefinition);
-        if (context->compilerOptions.buildMode == BuildMode::Release)
-        {
-            context->TheFPM->run(*functionDefinition, *context->TheFAM);
-        }
     }
 
 
@@ -173,15 +185,38 @@ void FunctionDefinitionNode::typeCheck(const std::unique_ptr<UnitNode> &unit, AS
     if (m_body)
         m_body->typeCheck(unit, this);
 }
+void FunctionDefinitionNode::bind(Binder &binder)
+{
+    if (!m_body)
+        return;
+    binder.beginFunction(this);
+    m_body->bind(binder);
+    m_resultSlot = binder.storage(m_identifier);
+    m_slotCount = binder.endFunction();
+}
 void FunctionDefinitionNode::addAttribute(FunctionAttribute attribute) { m_attributes.emplace_back(attribute); }
 
 std::optional<FunctionArgument> FunctionDefinitionNode::getParam(const std::string &paramName)
 {
-    for (auto &param: m_params)
+    return getParam(Identifiers::find(paramName));
+}
+
+std::optional<FunctionArgument> FunctionDefinitionNode::getParam(const Identifier paramIdentifier)
+{
+    if (const auto index = paramIndex(paramIdentifier))
+    {
+        return m_params[*index];
+    }
+    return std::nullopt;
+}
+
+std::optional<size_t> FunctionDefinitionNode::paramIndex(const Identifier paramIdentifier) const
+{
+    for (size_t i = 0; i < m_paramIdentifiers.size(); ++i)
     {
-        if (iequals(param.argumentName, paramName))
+        if (m_paramIdentifiers[i] == paramIdentifier)
         {
-            return param;
+            return i;
         }
     }
     return std::nullopt;
@@ -196,7 +231,13 @@ std::optional<FunctionArgument> FunctionDefinitionNode::getParam(const size_t in
     return std::nullopt;
 }
 
-std::shared_ptr<BlockNode> FunctionDefinitionNode::body() { return m_body; }
+const std::vector<FunctionArgument> &FunctionDefinitionNode::params() const { return m_params; }
+
+BlockNode *FunctionDefinitionNode::body() { return m_body; }
+
+bool FunctionDefinitionNode::isProcedure() const { return m_isProcedure; }
+
+const std::vector<FunctionAttribute> &FunctionDefinitionNode::attributes() const { return m_attributes; }
 
 
 std::string FunctionDefinitionNode::functionSignature()
@@ -207,7 +248,7 @@ std::string FunctionDefinitionNode::functionSignature()
     if (m_functionSignature.empty())
     {
         std::stringstream stream;
-        stream << to_lower(m_name) << "(";
+        stream << Identifiers::name(m_identifier) << "(";
         for (size_t i = 0; i < m_params.size(); ++i)
         {
             stream << m_params[i].type->typeName << ((i < m_params.size() - 1) ? "," : "");
@@ -221,3 +262,7 @@ std::string FunctionDefinitionNode::functionSignature()
 std::string &FunctionDefinitionNode::externalName() { return m_externalName; }
 
 std::string &FunctionDefinitionNode::libName() { return m_libName; }
+
+std::string &FunctionDefinitionNode::unitName() { return m_unitName; }
+
+void FunctionDefinitionNode::setUnitName(const std::string &unitName) { m_unitName = unitName; }
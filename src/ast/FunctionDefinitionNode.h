@@ -22,34 +22,58 @@ class FunctionDefinitionNode : public ASTNode
 {
 private:
     std::string m_name;
+    Identifier m_identifier;
     std::string m_externalName;
     std::string m_libName;
     std::vector<FunctionArgument> m_params;
-    std::shared_ptr<BlockNode> m_body;
+    // the interned names of the params, in the order of the params
+    std::vector<Identifier> m_paramIdentifiers;
+    BlockNode *m_body;
     bool m_isProcedure;
     std::shared_ptr<VariableType> m_returnType;
     std::vector<FunctionAttribute> m_attributes;
     std::string m_functionSignature;
+    std::string m_unitName;
+    // the number of slots of the body and the slot of the result variable, assigned by the Binder
+    uint32_t m_slotCount = 0;
+    VariableSlot m_resultSlot;
 
 public:
+    static constexpr NodeKind KIND = NodeKind::FUNCTION_DEFINITION;
+
     FunctionDefinitionNode(const Token &token, std::string name, std::vector<FunctionArgument> params,
-                           std::shared_ptr<BlockNode> body, bool isProcedure,
-                           std::shared_ptr<VariableType> returnType = std::make_shared<VariableType>());
+                           BlockNode *body, bool isProcedure,
+                           std::shared_ptr<VariableType> returnType = VariableType::getUnknown());
     FunctionDefinitionNode(const Token &token, std::string name, std::string externalName, std::string libName,
                            std::vector<FunctionArgument> params, bool isProcedure,
-                           std::shared_ptr<VariableType> returnType = std::make_shared<VariableType>());
+                           std::shared_ptr<VariableType> returnType = VariableType::getUnknown());
     ~FunctionDefinitionNode() override = default;
     void print() override;
     std::string functionSignature();
     std::string &name();
+    [[nodiscard]] Identifier identifier() const;
     std::string &externalName();
     std::string &libName();
+    /**
+     * name of the unit which defines the function, empty for functions of a program.
+     */
+    std::string &unitName();
+    void setUnitName(const std::string &unitName);
     std::shared_ptr<VariableType> returnType();
     std::optional<FunctionArgument> getParam(const std::string &paramName);
+    std::optional<FunctionArgument> getParam(Identifier paramIdentifier);
+    /**
+     * returns the position of the param, which is also the position of the argument of the llvm function.
+     */
+    [[nodiscard]] std::optional<size_t> paramIndex(Identifier paramIdentifier) const;
     std::optional<FunctionArgument> getParam(const size_t index);
-    std::shared_ptr<BlockNode> body();
+    [[nodiscard]] const std::vector<FunctionArgument> &params() const;
+    BlockNode *body();
+    [[nodiscard]] bool isProcedure() const;
+    [[nodiscard]] const std::vector<FunctionAttribute> &attributes() const;
     llvm::Value *codegen(std::unique_ptr<Context> &context) override;
 
     void typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode) override;
+    void bind(Binder &binder) override;
     void addAttribute(FunctionAttribute attribute);
 };
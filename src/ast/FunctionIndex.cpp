@@ -0,0 +1,93 @@
+#include "FunctionIndex.h"
+
+#include "FunctionDefinitionNode.h"
+
+size_t FunctionKeyHash::operator()(const FunctionKey &key) const
+{
+    constexpr uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+    uint64_t hash = (static_cast<uint64_t>(key.name) << 1 | (key.external ? 1 : 0)) * multiplier;
+    for (const auto type: key.paramTypes)
+    {
+        hash = (hash ^ static_cast<uint64_t>(type)) * multiplier;
+    }
+    return hash ^ (hash >> 32);
+}
+
+FunctionIndex::FunctionIndex(const std::vector<FunctionDefinitionNode *> &definitions)
+{
+    m_definitions.reserve(definitions.size());
+    for (auto &definition: definitions)
+    {
+        add(definition);
+    }
+}
+
+FunctionKey FunctionIndex::keyOf(FunctionDefinitionNode &definition)
+{
+    // the signature of an external function is its external name
+    if (!definition.libName().empty())
+    {
+        return FunctionKey{.name = Identifiers::intern(definition.externalName()), .external = true};
+    }
+    FunctionKey key{.name = definition.identifier()};
+    key.paramTypes.reserve(definition.params().size());
+    for (auto &param: definition.params())
+    {
+        key.paramTypes.push_back(param.type->mangledName());
+    }
+    return key;
+}
+
+void FunctionIndex::add(FunctionDefinitionNode *definition)
+{
+    const size_t index = m_definitions.size();
+    m_definitions.push_back(definition);
+    m_byKey.try_emplace(keyOf(*definition), index);
+    m_bySignature.try_emplace(definition->functionSignature(), index);
+    // an external function can also be called by its name without a matching signature
+    if (!definition->libName().empty())
+    {
+        m_byName.try_emplace(Identifiers::intern(definition->externalName()), index);
+    }
+    if (definition->externalName() != definition->name())
+    {
+        m_byName.try_emplace(definition->identifier(), index);
+    }
+}
+
+bool FunctionIndex::addIfMissing(FunctionDefinitionNode *definition)
+{
+    if (m_byKey.contains(keyOf(*definition)))
+    {
+        return false;
+    }
+    add(definition);
+    return true;
+}
+
+FunctionDefinitionNode *FunctionIndex::find(const FunctionKey &key) const
+{
+    if (const auto it = m_byKey.find(key); it != m_byKey.end())
+    {
+        return m_definitions[it->second];
+    }
+    return nullptr;
+}
+
+FunctionDefinitionNode *FunctionIndex::find(const std::string_view functionName) const
+{
+    if (const auto it = m_bySignature.find(functionName); it != m_bySignature.end())
+    {
+        return m_definitions[it->second];
+    }
+    if (const auto it = m_byName.find(Identifiers::find(functionName)); it != m_byName.end())
+    {
+        return m_definitions[it->second];
+    }
+    return nullptr;
+}
+
+const std::vector<FunctionDefinitionNode *> &FunctionIndex::definitions() const
+{
+    return m_definitions;
+}
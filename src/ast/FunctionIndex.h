@@ -0,0 +1,72 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Identifier.h"
+
+class FunctionDefinitionNode;
+
+/**
+ * identifies an overload of a function by its name and the mangled names of its parameter types.
+ * External functions of a library are identified by their external name only.
+ */
+struct FunctionKey
+{
+    Identifier name = Identifier::NONE;
+    std::vector<Identifier> paramTypes;
+    bool external = false;
+
+    bool operator==(const FunctionKey &other) const = default;
+};
+
+struct FunctionKeyHash
+{
+    size_t operator()(const FunctionKey &key) const;
+};
+
+// allows to look up the signatures by a string_view without copying it into a string
+struct SignatureHash
+{
+    using is_transparent = void;
+    size_t operator()(const std::string_view signature) const { return std::hash<std::string_view>{}(signature); }
+};
+
+/**
+ * the function definitions of a unit in the order they were added, indexed by their key and by the names under
+ * which they can be called without a matching signature.
+ * The parser merges the imported units into it and the code generator resolves the calls with it.
+ */
+class FunctionIndex
+{
+    std::vector<FunctionDefinitionNode *> m_definitions;
+    std::unordered_map<FunctionKey, size_t, FunctionKeyHash> m_byKey;
+    std::unordered_map<std::string, size_t, SignatureHash, std::equal_to<>> m_bySignature;
+    std::unordered_map<Identifier, size_t> m_byName;
+
+public:
+    FunctionIndex() = default;
+    explicit FunctionIndex(const std::vector<FunctionDefinitionNode *> &definitions);
+
+    static FunctionKey keyOf(FunctionDefinitionNode &definition);
+
+    /**
+     * adds the definition, if the key is already known the first definition stays the one which is found.
+     */
+    void add(FunctionDefinitionNode *definition);
+    /**
+     * adds the definition only if no definition with the same key exists, returns true if it was added.
+     */
+    bool addIfMissing(FunctionDefinitionNode *definition);
+
+    [[nodiscard]] FunctionDefinitionNode *find(const FunctionKey &key) const;
+    /**
+     * finds a definition by its signature, e.g. "name(integer)" or the name of an llvm function, or by a plain name
+     * which is the external name or an alias of an external function.
+     */
+    [[nodiscard]] FunctionDefinitionNode *find(std::string_view functionName) const;
+    [[nodiscard]] const std::vector<FunctionDefinitionNode *> &definitions() const;
+};
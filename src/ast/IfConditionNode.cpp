@@ -2,14 +2,17 @@
 #include <iostream>
 #include <llvm/IR/IRBuilder.h>
 
+#include "ASTVisitor.h"
+#include "Binder.h"
 #include "compiler/Context.h"
 #include "exceptions/CompilerException.h"
 
 
-IfConditionNode::IfConditionNode(const Token &token, const std::shared_ptr<ASTNode> &conditionNode,
-                                 const std::vector<std::shared_ptr<ASTNode>> &ifExpressions,
-                                 const std::vector<std::shared_ptr<ASTNode>> &elseExpressions) :
-    ASTNode(token), m_conditionNode(conditionNode), m_ifExpressions(ifExpressions), m_elseExpressions(elseExpressions)
+IfConditionNode::IfConditionNode(const Token &token, ASTNode *conditionNode,
+                                 const std::vector<ASTNode *> &ifExpressions,
+                                 const std::vector<ASTNode *> &elseExpressions) :
+    ASTNode(token, KIND), m_conditionNode(conditionNode), m_ifExpressions(ifExpressions),
+    m_elseExpressions(elseExpressions)
 {
 }
 
@@ -21,14 +24,14 @@ void IfConditionNode::print()
 
     for (auto &exp: m_ifExpressions)
     {
-        exp->print();
+        ast::print(exp);
     }
     if (m_elseExpressions.size() > 0)
     {
         std::cout << "else\n";
         for (auto &exp: m_elseExpressions)
         {
-            exp->print();
+            ast::print(exp);
         }
         // std::cout << "end;\n";
     }
@@ -36,7 +39,7 @@ void IfConditionNode::print()
 
 llvm::Value *IfConditionNode::codegenIf(std::unique_ptr<Context> &context)
 {
-    llvm::Value *CondV = m_conditionNode->codegen(context);
+    llvm::Value *CondV = ast::codegen(m_conditionNode, context);
     if (!CondV)
         return nullptr;
     CondV = context->Builder->CreateICmpEQ(CondV, context->Builder->getTrue(), "ifcond");
@@ -51,7 +54,7 @@ llvm::Value *IfConditionNode::codegenIf(std::unique_ptr<Context> &context)
 
     for (auto &exp: m_ifExpressions)
     {
-        exp->codegen(context);
+        ast::codegen(exp, context);
     }
     if (!context->BreakBlock.BlockUsed)
         context->Builder->CreateBr(MergeBB);
@@ -64,7 +67,7 @@ llvm::Value *IfConditionNode::codegenIf(std::unique_ptr<Context> &context)
 
 llvm::Value *IfConditionNode::codegenIfElse(std::unique_ptr<Context> &context)
 {
-    llvm::Value *CondV = m_conditionNode->codegen(context);
+    llvm::Value *CondV = ast::codegen(m_conditionNode, context);
     if (!CondV)
         return nullptr;
 
@@ -84,7 +87,7 @@ llvm::Value *IfConditionNode::codegenIfElse(std::unique_ptr<Context> &context)
 
     for (auto &exp: m_ifExpressions)
     {
-        exp->codegen(context);
+        ast::codegen(exp, context);
     }
     if (!context->BreakBlock.BlockUsed)
         context->Builder->CreateBr(MergeBB);
@@ -97,7 +100,7 @@ llvm::Value *IfConditionNode::codegenIfElse(std::unique_ptr<Context> &context)
 
     for (auto &exp: m_elseExpressions)
     {
-        exp->codegen(context);
+        ast::codegen(exp, context);
     }
     if (!context->BreakBlock.BlockUsed)
         context->Builder->CreateBr(MergeBB);
@@ -124,7 +127,7 @@ llvm::Value *IfConditionNode::codegen(std::unique_ptr<Context> &context)
 }
 void IfConditionNode::typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode)
 {
-    const auto conditionType = m_conditionNode->resolveType(unit, parentNode);
+    const auto conditionType = ast::resolveType(m_conditionNode, unit, parentNode);
     if (conditionType->baseType != VariableBaseType::Boolean)
     {
         throw CompilerException(
@@ -134,11 +137,24 @@ void IfConditionNode::typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *
 
     for (const auto &exp: m_ifExpressions)
     {
-        exp->typeCheck(unit, parentNode);
+        ast::typeCheck(exp, unit, parentNode);
     }
 
     for (const auto &exp: m_elseExpressions)
     {
-        exp->typeCheck(unit, parentNode);
+        ast::typeCheck(exp, unit, parentNode);
+    }
+}
+
+void IfConditionNode::bind(Binder &binder)
+{
+    m_conditionNode->bind(binder);
+    for (const auto &exp: m_ifExpressions)
+    {
+        exp->bind(binder);
+    }
+    for (const auto &exp: m_elseExpressions)
+    {
+        exp->bind(binder);
     }
 }
@@ -5,20 +5,23 @@
 class IfConditionNode : public ASTNode
 {
 private:
-    std::shared_ptr<ASTNode> m_conditionNode;
-    std::vector<std::shared_ptr<ASTNode>> m_ifExpressions;
-    std::vector<std::shared_ptr<ASTNode>> m_elseExpressions;
+    ASTNode *m_conditionNode;
+    std::vector<ASTNode *> m_ifExpressions;
+    std::vector<ASTNode *> m_elseExpressions;
 
     llvm::Value *codegenIf(std::unique_ptr<Context> &context);
     llvm::Value *codegenIfElse(std::unique_ptr<Context> &context);
 
 public:
-    IfConditionNode(const Token &token, const std::shared_ptr<ASTNode> &conditionNode,
-                    const std::vector<std::shared_ptr<ASTNode>> &ifExpressions,
-                    const std::vector<std::shared_ptr<ASTNode>> &elseExpressions);
+    static constexpr NodeKind KIND = NodeKind::IF_CONDITION;
+
+    IfConditionNode(const Token &token, ASTNode *conditionNode,
+                    const std::vector<ASTNode *> &ifExpressions,
+                    const std::vector<ASTNode *> &elseExpressions);
     ~IfConditionNode() override = default;
     void print() override;
     llvm::Value *codegen(std::unique_ptr<Context> &context) override;
+    void bind(Binder &binder) override;
 
     void typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode) override;
 };
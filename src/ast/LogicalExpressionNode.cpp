@@ -2,18 +2,19 @@
 #include <iostream>
 #include <llvm/IR/IRBuilder.h>
 
+#include "Binder.h"
 #include "compiler/Context.h"
 
 
 LogicalExpressionNode::LogicalExpressionNode(const Token &token, LogicalOperator op,
-                                             const std::shared_ptr<ASTNode> &lhs, const std::shared_ptr<ASTNode> &rhs) :
-    ASTNode(token), m_lhs(lhs), m_rhs(rhs), m_operator(op)
+                                             ASTNode *lhs, ASTNode *rhs) :
+    ASTNode(token, KIND), m_lhs(lhs), m_rhs(rhs), m_operator(op)
 {
 }
 
 LogicalExpressionNode::LogicalExpressionNode(const Token &token, LogicalOperator op,
-                                             const std::shared_ptr<ASTNode> &rhs) :
-    ASTNode(token), m_lhs(nullptr), m_rhs(rhs), m_operator(op)
+                                             ASTNode *rhs) :
+    ASTNode(token, KIND), m_lhs(nullptr), m_rhs(rhs), m_operator(op)
 {
 }
 
@@ -79,3 +80,10 @@ Token LogicalExpressionNode::expressionToken()
     token.sourceLocation.byte_offset = start;
     return token;
 }
+
+void LogicalExpressionNode::bind(Binder &binder)
+{
+    if (m_lhs)
+        m_lhs->bind(binder);
+    m_rhs->bind(binder);
+}
@@ -1,3 +1,4 @@
+#pragma once
 #include "ASTNode.h"
 
 enum class LogicalOperator : char
@@ -10,18 +11,21 @@ enum class LogicalOperator : char
 class LogicalExpressionNode : public ASTNode
 {
 private:
-    std::shared_ptr<ASTNode> m_lhs;
-    std::shared_ptr<ASTNode> m_rhs;
+    ASTNode *m_lhs;
+    ASTNode *m_rhs;
     LogicalOperator m_operator;
 
 public:
-    LogicalExpressionNode(const Token &token, LogicalOperator op, const std::shared_ptr<ASTNode> &lhs,
-                          const std::shared_ptr<ASTNode> &rhs);
-    LogicalExpressionNode(const Token &token, LogicalOperator op, const std::shared_ptr<ASTNode> &rhs);
+    static constexpr NodeKind KIND = NodeKind::LOGICAL_EXPRESSION;
+
+    LogicalExpressionNode(const Token &token, LogicalOperator op, ASTNode *lhs,
+                          ASTNode *rhs);
+    LogicalExpressionNode(const Token &token, LogicalOperator op, ASTNode *rhs);
     ~LogicalExpressionNode() override = default;
 
     void print() override;
     llvm::Value *codegen(std::unique_ptr<Context> &context) override;
+    void bind(Binder &binder) override;
 
     std::shared_ptr<VariableType> resolveType(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode) override;
 
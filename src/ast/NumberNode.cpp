@@ -6,7 +6,7 @@
 
 
 NumberNode::NumberNode(const Token &token, int64_t value, size_t numBits) :
-    ASTNode(token), m_value(value), m_numBits(numBits)
+    ASTNode(token, KIND), m_value(value), m_numBits(numBits)
 {
 }
 
@@ -8,6 +8,8 @@ private:
     size_t m_numBits;
 
 public:
+    static constexpr NodeKind KIND = NodeKind::NUMBER;
+
     NumberNode(const Token &token, int64_t value, size_t numBits);
     ~NumberNode() override = default;
     void print() override;
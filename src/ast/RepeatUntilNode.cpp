@@ -3,12 +3,14 @@
 #include <llvm/IR/BasicBlock.h>
 #include <llvm/IR/IRBuilder.h>
 
+#include "ASTVisitor.h"
+#include "Binder.h"
 #include "compiler/Context.h"
 #include "exceptions/CompilerException.h"
 
-RepeatUntilNode::RepeatUntilNode(const Token &token, std::shared_ptr<ASTNode> loopCondition,
-                                 std::vector<std::shared_ptr<ASTNode>> nodes) :
-    ASTNode(token), m_loopCondition(std::move(loopCondition)), m_nodes(std::move(nodes))
+RepeatUntilNode::RepeatUntilNode(const Token &token, ASTNode *loopCondition,
+                                 std::vector<ASTNode *> nodes) :
+    ASTNode(token, KIND), m_loopCondition(loopCondition), m_nodes(std::move(nodes))
 {
 }
 void RepeatUntilNode::print() {}
@@ -34,7 +36,7 @@ llvm::Value *RepeatUntilNode::codegen(std::unique_ptr<Context> &context)
     for (auto &node: m_nodes)
     {
         context->Builder->SetInsertPoint(LoopBB);
-        node->codegen(context);
+        ast::codegen(node, context);
     }
 
     context->BreakBlock.Block = savedBreakBlock;
@@ -43,7 +45,7 @@ llvm::Value *RepeatUntilNode::codegen(std::unique_ptr<Context> &context)
 
     // Create the "after loop" block and insert it.
     // Compute the end condition.
-    llvm::Value *EndCond = m_loopCondition->codegen(context);
+    llvm::Value *EndCond = ast::codegen(m_loopCondition, context);
     if (!EndCond)
         return nullptr;
 
@@ -59,7 +61,7 @@ llvm::Value *RepeatUntilNode::codegen(std::unique_ptr<Context> &context)
 }
 void RepeatUntilNode::typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode)
 {
-    if (const auto &conditionType = m_loopCondition->resolveType(unit, parentNode))
+    if (const auto &conditionType = ast::resolveType(m_loopCondition, unit, parentNode))
     {
         if (conditionType->baseType != VariableBaseType::Boolean)
         {
@@ -69,6 +71,15 @@ void RepeatUntilNode::typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *
     }
     for (const auto &exp: m_nodes)
     {
-        exp->typeCheck(unit, parentNode);
+        ast::typeCheck(exp, unit, parentNode);
     }
 }
+
+void RepeatUntilNode::bind(Binder &binder)
+{
+    for (const auto &exp: m_nodes)
+    {
+        exp->bind(binder);
+    }
+    m_loopCondition->bind(binder);
+}
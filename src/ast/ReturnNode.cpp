@@ -2,10 +2,11 @@
 #include <iostream>
 #include <llvm/IR/IRBuilder.h>
 
+#include "Binder.h"
 #include "compiler/Context.h"
 
-ReturnNode::ReturnNode(const Token &token, std::shared_ptr<ASTNode> expression) :
-    ASTNode(token), m_expression(expression)
+ReturnNode::ReturnNode(const Token &token, ASTNode *expression) :
+    ASTNode(token, KIND), m_expression(expression)
 {
 }
 
@@ -23,3 +24,9 @@ llvm::Value *ReturnNode::codegen(std::unique_ptr<Context> &context)
     context->Builder->CreateRet(RetVal);
     return nullptr;
 }
+
+void ReturnNode::bind(Binder &binder)
+{
+    if (m_expression)
+        m_expression->bind(binder);
+}
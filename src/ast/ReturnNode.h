@@ -7,11 +7,14 @@
 class ReturnNode : public ASTNode
 {
 private:
-    std::shared_ptr<ASTNode> m_expression;
+    ASTNode *m_expression;
 
 public:
-    ReturnNode(const Token &token, std::shared_ptr<ASTNode> expression);
+    static constexpr NodeKind KIND = NodeKind::RETURN;
+
+    ReturnNode(const Token &token, ASTNode *expression);
     ~ReturnNode() override = default;
     void print() override;
     llvm::Value *codegen(std::unique_ptr<Context> &context) override;
+    void bind(Binder &binder) override;
 };
@@ -7,7 +7,7 @@
 
 
 StringConstantNode::StringConstantNode(const Token &token, const std::string &literal) :
-    ASTNode(token), m_literal(literal)
+    ASTNode(token, KIND), m_literal(literal)
 {
 }
 
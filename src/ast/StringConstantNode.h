@@ -9,6 +9,8 @@ private:
     std::string m_literal;
 
 public:
+    static constexpr NodeKind KIND = NodeKind::STRING_CONSTANT;
+
     StringConstantNode(const Token &token, const std::string &literal);
     ~StringConstantNode() override = default;
     void print() override;
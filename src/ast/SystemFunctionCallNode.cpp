@@ -3,35 +3,40 @@
 #include <iostream>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/TargetParser/Triple.h>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include <compiler/codegen.h>
 
 #include "../compare.h"
+#include "ASTVisitor.h"
+#include "Binder.h"
 #include "UnitNode.h"
+#include "VariableAccessNode.h"
 #include "compiler/Context.h"
 #include "types/FileType.h"
 #include "types/StringType.h"
 
 
-static std::vector<std::string> knownSystemCalls = {"writeln",    "write",  "printf",    "exit",  "low",    "high",
-                                                    "setlength",  "length", "pchar",     "new",   "halt",   "assert",
-                                                    "assignfile", "readln", "closefile", "reset", "rewrite"};
-
-bool isKnownSystemCall(const std::string &name)
+bool isKnownSystemCall(const Identifier identifier)
 {
-    for (auto &call: knownSystemCalls)
+    static const std::unordered_set<Identifier> knownSystemCalls = []
     {
-        if (iequals(call, name))
-            return true;
-    }
-    return false;
+        std::unordered_set<Identifier> calls;
+        for (const auto *name: {"writeln", "write", "printf", "exit", "low", "high", "setlength", "length", "pchar",
+                                "new", "halt", "assert", "assignfile", "readln", "closefile", "reset", "rewrite"})
+        {
+            calls.insert(Identifiers::intern(name));
+        }
+        return calls;
+    }();
+    return knownSystemCalls.contains(identifier);
 }
 
 SystemFunctionCallNode::SystemFunctionCallNode(const Token &token, std::string name,
-                                               const std::vector<std::shared_ptr<ASTNode>> &args) :
-    FunctionCallNode(token, std::move(name), args)
+                                               const std::vector<ASTNode *> &args) :
+    FunctionCallNode(token, std::move(name), args, KIND)
 {
 }
 
@@ -45,10 +50,10 @@ llvm::Value *SystemFunctionCallNode::codegen_setlength(std::unique_ptr<Context>
         return nullptr;
     }
 
-    auto arrayType = array->resolveType(context->ProgramUnit, parent);
+    auto arrayType = ast::resolveType(array, context->ProgramUnit, parent);
     if (arrayType->baseType == VariableBaseType::Array)
     {
-        auto realType = std::dynamic_pointer_cast<ArrayType>(arrayType);
+        auto realType = typeCast<ArrayType>(arrayType);
         auto indexType = VariableType::getInteger(64)->generateLlvmType(context);
         auto value = array->codegen(context);
         auto arrayBaseType = realType->arrayBase->generateLlvmType(context);
@@ -94,7 +99,7 @@ llvm::Value *SystemFunctionCallNode::codegen_setlength(std::unique_ptr<Context>
     }
     if (arrayType->baseType == VariableBaseType::String)
     {
-        auto realType = std::dynamic_pointer_cast<StringType>(arrayType);
+        auto realType = typeCast<StringType>(arrayType);
         auto indexType = VariableType::getInteger(64)->generateLlvmType(context);
         auto value = array->codegen(context);
         // const llvm::DataLayout &DL = context->TheModule->getDataLayout();
@@ -138,22 +143,22 @@ llvm::Value *SystemFunctionCallNode::codegen_setlength(std::unique_ptr<Context>
 }
 llvm::Value *SystemFunctionCallNode::codegen_length(std::unique_ptr<Context> &context, ASTNode *parent) const
 {
-    const auto paramType = m_args[0]->resolveType(context->ProgramUnit, parent);
-    if (const auto type = std::dynamic_pointer_cast<FieldAccessableType>(paramType))
+    const auto paramType = ast::resolveType(m_args[0], context->ProgramUnit, parent);
+    if (const auto type = typeCast<FieldAccessableType>(paramType))
     {
-        return type->generateLengthValue(m_args[0]->expressionToken(), context);
+        return type->generateLengthValue(codegen::slotValue(context, m_firstArgumentSlot), context);
     }
     return nullptr;
 }
 llvm::Value *SystemFunctionCallNode::find_target_fileout(std::unique_ptr<Context> &context, ASTNode *parent)
 {
     llvm::Value *loadedStdOut = context->Builder->CreateLoad(llvm::PointerType::getUnqual(*context->TheContext),
-                                                             context->NamedValues["stdout"]);
+                                                             context->StdOut);
 
     for (auto &arg: m_args)
     {
-        auto type = arg->resolveType(context->ProgramUnit, parent);
-        if (auto fileType = std::dynamic_pointer_cast<FileType>(type))
+        auto type = ast::resolveType(arg, context->ProgramUnit, parent);
+        if (auto fileType = typeCast<FileType>(type))
         {
             auto llvmFileType = fileType->generateLlvmType(context);
             auto argValue = arg->codegen(context);
@@ -176,12 +181,12 @@ llvm::Value *SystemFunctionCallNode::codegen_write(std::unique_ptr<Context> &con
         LogErrorV("the function fprintf was not found");
     for (auto &arg: m_args)
     {
-        auto type = arg->resolveType(context->ProgramUnit, parent);
+        auto type = ast::resolveType(arg, context->ProgramUnit, parent);
         auto argValue = arg->codegen(context);
 
         std::vector<llvm::Value *> ArgsV;
         ArgsV.push_back(loadedStdOut);
-        if (auto integerType = std::dynamic_pointer_cast<IntegerType>(type))
+        if (auto integerType = typeCast<IntegerType>(type))
         {
             if (context->TargetTriple->getOS() == llvm::Triple::Win32)
             {
@@ -204,7 +209,7 @@ llvm::Value *SystemFunctionCallNode::codegen_write(std::unique_ptr<Context> &con
 
             ArgsV.push_back(argValue);
         }
-        else if (auto stringType = std::dynamic_pointer_cast<StringType>(type))
+        else if (auto stringType = typeCast<StringType>(type))
         {
 
             ArgsV.push_back(context->Builder->CreateGlobalString("%s", "format_string"));
@@ -227,7 +232,7 @@ llvm::Value *SystemFunctionCallNode::codegen_write(std::unique_ptr<Context> &con
 
             ArgsV.push_back(context->Builder->CreateFPCast(argValue, context->Builder->getDoubleTy()));
         }
-        else if (auto fileType = std::dynamic_pointer_cast<FileType>(type))
+        else if (auto fileType = typeCast<FileType>(type))
         {
             continue;
         }
@@ -265,7 +270,7 @@ llvm::Value *SystemFunctionCallNode::codegen_assert(std::unique_ptr<Context> &co
                                                     ASTNode *argument, llvm::Value *expression,
                                                     const std::string &assertation)
 {
-    const auto callingFunctionName = parent->expressionToken().lexical();
+    const auto callingFunctionName = std::string(parent->expressionToken().lexical());
     const auto condition = context->Builder->CreateNot(expression);
     std::string assertFunction;
     if (context->TargetTriple->getOS() == llvm::Triple::Linux)
@@ -290,8 +295,8 @@ llvm::Value *SystemFunctionCallNode::codegen_assert(std::unique_ptr<Context> &co
                 auto token = argument->expressionToken();
                 ArgsV.push_back(ctx->Builder->CreateGlobalString(assertation, "assertion"));
                 ArgsV.push_back(
-                        ctx->Builder->CreateGlobalString(token.sourceLocation.filename, "assertion_source_file"));
-                ArgsV.push_back(ctx->Builder->getInt32(token.row));
+                        ctx->Builder->CreateGlobalString(token.sourceLocation.filename(), "assertion_source_file"));
+                ArgsV.push_back(ctx->Builder->getInt32(token.row()));
                 ArgsV.push_back(ctx->Builder->CreateGlobalString(callingFunctionName, "assertion_function"));
                 ctx->Builder->CreateCall(assertCall, ArgsV);
             });
@@ -300,29 +305,21 @@ llvm::Value *SystemFunctionCallNode::codegen_assert(std::unique_ptr<Context> &co
 llvm::Value *SystemFunctionCallNode::codegen_new(std::unique_ptr<Context> &context, ASTNode *parent) const
 {
     m_args[0]->codegen(context);
-    const auto type = m_args[0]->resolveType(context->ProgramUnit, parent);
-    if (const auto ptrType = std::dynamic_pointer_cast<PointerType>(type))
+    const auto type = ast::resolveType(m_args[0], context->ProgramUnit, parent);
+    if (const auto ptrType = typeCast<PointerType>(type))
         return context->Builder->CreateAlloca(ptrType->pointerBase->generateLlvmType(context));
 
     return LogErrorV("argument is not a pointer type");
 }
 llvm::Value *SystemFunctionCallNode::codegen(std::unique_ptr<Context> &context)
 {
-    ASTNode *parent = context->ProgramUnit.get();
-    if (context->TopLevelFunction)
-    {
-        auto def = context->ProgramUnit->getFunctionDefinition(std::string(context->TopLevelFunction->getName()));
-        if (def)
-        {
-            parent = def.value().get();
-        }
-    }
+    ASTNode *parent = resolveParent(context);
 
     if (iequals(m_name, "low"))
     {
 
-        auto paramType = m_args[0]->resolveType(context->ProgramUnit, parent);
-        if (auto arrayType = std::dynamic_pointer_cast<ArrayType>(paramType))
+        auto paramType = ast::resolveType(m_args[0], context->ProgramUnit, parent);
+        if (auto arrayType = typeCast<ArrayType>(paramType))
         {
             if (arrayType->isDynArray)
             {
@@ -330,7 +327,7 @@ llvm::Value *SystemFunctionCallNode::codegen(std::unique_ptr<Context> &context)
             }
             return context->Builder->getInt64(arrayType->low);
         }
-        if (const auto stringType = std::dynamic_pointer_cast<StringType>(paramType))
+        if (const auto stringType = typeCast<StringType>(paramType))
 
         {
             return context->Builder->getInt64(0);
@@ -338,8 +335,8 @@ llvm::Value *SystemFunctionCallNode::codegen(std::unique_ptr<Context> &context)
     }
     else if (iequals(m_name, "high"))
     {
-        auto paramType = m_args[0]->resolveType(context->ProgramUnit, parent);
-        if (auto arrayType = std::dynamic_pointer_cast<ArrayType>(paramType))
+        auto paramType = ast::resolveType(m_args[0], context->ProgramUnit, parent);
+        if (auto arrayType = typeCast<ArrayType>(paramType))
         {
             if (arrayType->isDynArray)
             {
@@ -347,7 +344,7 @@ llvm::Value *SystemFunctionCallNode::codegen(std::unique_ptr<Context> &context)
             }
             return context->Builder->getInt64(arrayType->high);
         }
-        if (const auto stringType = std::dynamic_pointer_cast<StringType>(paramType))
+        if (const auto stringType = typeCast<StringType>(paramType))
         {
             return context->Builder->CreateSub(codegen_length(context, parent), context->Builder->getInt64(1));
         }
@@ -372,7 +369,7 @@ llvm::Value *SystemFunctionCallNode::codegen(std::unique_ptr<Context> &context)
     else if (iequals(m_name, "pchar"))
     {
         auto stringStructPtr = m_args[0]->codegen(context);
-        auto type = m_args[0]->resolveType(context->ProgramUnit, parent);
+        auto type = ast::resolveType(m_args[0], context->ProgramUnit, parent);
         const auto arrayPointerOffset = context->Builder->CreateStructGEP(type->generateLlvmType(context),
                                                                           stringStructPtr, 2, "string.ptr.offset");
         return context->Builder->CreateLoad(llvm::PointerType::getUnqual(*context->TheContext), arrayPointerOffset);
@@ -390,8 +387,8 @@ llvm::Value *SystemFunctionCallNode::codegen(std::unique_ptr<Context> &context)
     }
     else if (iequals(m_name, "assert"))
     {
-        return codegen_assert(context, parent, m_args[0].get(), m_args[0]->codegen(context),
-                              m_args[0]->expressionToken().lexical());
+        return codegen_assert(context, parent, m_args[0], m_args[0]->codegen(context),
+                              std::string(m_args[0]->expressionToken().lexical()));
     }
     return FunctionCallNode::codegen(context);
 }
@@ -423,3 +420,12 @@ std::shared_ptr<VariableType> SystemFunctionCallNode::resolveType(const std::uni
 
     return nullptr;
 }
+
+void SystemFunctionCallNode::bind(Binder &binder)
+{
+    FunctionCallNode::bind(binder);
+    if (!m_args.empty() && nodeCast<VariableAccessNode>(m_args[0]))
+    {
+        m_firstArgumentSlot = binder.storage(m_args[0]->expressionToken().identifier());
+    }
+}
@@ -2,12 +2,15 @@
 
 
 #include "FunctionCallNode.h"
+#include "VariableSlot.h"
 
-bool isKnownSystemCall(const std::string &name);
+bool isKnownSystemCall(Identifier identifier);
 
 class SystemFunctionCallNode final : public FunctionCallNode
 {
 private:
+    // the memory of the variable which is the first argument, used by length
+    VariableSlot m_firstArgumentSlot;
     llvm::Value *codegen_setlength(std::unique_ptr<Context> &context, ASTNode *parent);
     llvm::Value *codegen_length(std::unique_ptr<Context> &context, ASTNode *parent) const;
     llvm::Value *find_target_fileout(std::unique_ptr<Context> &context, ASTNode *parent);
@@ -16,7 +19,9 @@ private:
     llvm::Value *codegen_new(std::unique_ptr<Context> &context, ASTNode *parent) const;
 
 public:
-    SystemFunctionCallNode(const Token &token, std::string name, const std::vector<std::shared_ptr<ASTNode>> &args);
+    static constexpr NodeKind KIND = NodeKind::SYSTEM_FUNCTION_CALL;
+
+    SystemFunctionCallNode(const Token &token, std::string name, const std::vector<ASTNode *> &args);
 
     static llvm::Value *codegen_assert(std::unique_ptr<Context> &context, ASTNode *parent, ASTNode *argument,
                                        llvm::Value *expression, const std::string &assertation);
@@ -24,4 +29,5 @@ public:
     ~SystemFunctionCallNode() override = default;
     llvm::Value *codegen(std::unique_ptr<Context> &context) override;
     std::shared_ptr<VariableType> resolveType(const std::unique_ptr<UnitNode> &unitNode, ASTNode *parentNode) override;
+    void bind(Binder &binder) override;
 };
@@ -1,34 +1,46 @@
 #include "ast/UnitNode.h"
+#include <array>
 #include <iostream>
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/TargetParser/Triple.h>
 
-#include "compare.h"
+#include "Binder.h"
 #include "compiler/Context.h"
+#include "compiler/codegen.h"
 #include "compiler/intrinsics.h"
 #include "llvm/IR/Function.h"
-#include "llvm/IR/PassManager.h"
 #include "llvm/IR/Verifier.h"
 #include "types/FileType.h"
 
 
 UnitNode::UnitNode(const Token &token, const UnitType unitType, const std::string &unitName,
-                   const std::vector<std::shared_ptr<FunctionDefinitionNode>> &functionDefinitions,
-                   const std::unordered_map<std::string, std::shared_ptr<VariableType>> &typeDefinitions,
-                   const std::shared_ptr<BlockNode> &blockNode) :
-    ASTNode(token), m_unitType(unitType), m_unitName(unitName), m_functionDefinitions(functionDefinitions),
-    m_typeDefinitions(typeDefinitions), m_blockNode(blockNode)
+                   FunctionIndex functionDefinitions,
+                   const std::unordered_map<Identifier, std::shared_ptr<VariableType>> &typeDefinitions,
+                   BlockNode *blockNode, std::shared_ptr<ASTArena> arena) :
+    ASTNode(token, KIND), m_arena(std::move(arena)), m_unitType(unitType), m_unitName(unitName),
+    m_functionDefinitions(std::move(functionDefinitions)), m_typeDefinitions(typeDefinitions), m_blockNode(blockNode)
 {
 }
 UnitNode::UnitNode(const Token &token, UnitType unitType, const std::string &unitName,
-                   const std::vector<std::string> &argumentNames,
-                   const std::vector<std::shared_ptr<FunctionDefinitionNode>> &functionDefinitions,
-                   const std::unordered_map<std::string, std::shared_ptr<VariableType>> &typeDefinitions,
-                   const std::shared_ptr<BlockNode> &blockNode) :
-    ASTNode(token), m_unitType(unitType), m_unitName(unitName), m_functionDefinitions(functionDefinitions),
-    m_typeDefinitions(typeDefinitions), m_blockNode(blockNode), m_argumentNames(argumentNames)
+                   const std::vector<std::string> &argumentNames, FunctionIndex functionDefinitions,
+                   const std::unordered_map<Identifier, std::shared_ptr<VariableType>> &typeDefinitions,
+                   BlockNode *blockNode, std::shared_ptr<ASTArena> arena) :
+    ASTNode(token, KIND), m_arena(std::move(arena)), m_unitType(unitType), m_unitName(unitName),
+    m_functionDefinitions(std::move(functionDefinitions)), m_typeDefinitions(typeDefinitions), m_blockNode(blockNode),
+    m_argumentNames(argumentNames)
 {
+    // the program arguments are files, the code generation sets their streams
+    for (const auto &argumentName: m_argumentNames)
+    {
+        if (!m_blockNode)
+            break;
+        m_blockNode->addVariableDefinition(VariableDefinition{.variableType = FileType::getFileType(),
+                                                              .variableName = argumentName,
+                                                              .identifier = Identifiers::intern(argumentName),
+                                                              .scopeId = 0,
+                                                              .constant = false});
+    }
 }
 
 void UnitNode::print()
@@ -42,44 +54,73 @@ void UnitNode::print()
         std::cout << "unit ";
     }
     std::cout << m_unitName << "\n";
-    for (auto def: m_functionDefinitions)
+    for (auto &def: m_functionDefinitions.definitions())
     {
         def->print();
     }
 
-    m_blockNode->print();
+    if (m_blockNode)
+    {
+        m_blockNode->print();
+    }
 }
 
-std::vector<std::shared_ptr<FunctionDefinitionNode>> UnitNode::getFunctionDefinitions()
+const std::vector<FunctionDefinitionNode *> &UnitNode::getFunctionDefinitions()
 {
-    return m_functionDefinitions;
+    return m_functionDefinitions.definitions();
 }
 
-std::optional<std::shared_ptr<FunctionDefinitionNode>> UnitNode::getFunctionDefinition(const std::string &functionName)
+const FunctionIndex &UnitNode::getFunctionIndex() const { return m_functionDefinitions; }
+
+std::optional<FunctionDefinitionNode *> UnitNode::getFunctionDefinition(const std::string &functionName)
 {
-    for (auto &def: m_functionDefinitions)
+    if (auto definition = m_functionDefinitions.find(functionName))
     {
-        if (iequals(def->functionSignature(), functionName) ||
-            (iequals(def->name(), functionName) && def->externalName() != def->name()))
-        {
-            return def;
-        }
+        return definition;
+    }
+    return std::nullopt;
+}
+
+std::optional<FunctionDefinitionNode *> UnitNode::getFunctionDefinition(const FunctionKey &key)
+{
+    if (auto definition = m_functionDefinitions.find(key))
+    {
+        return definition;
     }
     return std::nullopt;
 }
 
-void UnitNode::addFunctionDefinition(const std::shared_ptr<FunctionDefinitionNode> &functionDefinition)
+void UnitNode::addFunctionDefinition(FunctionDefinitionNode *functionDefinition)
 {
-    m_functionDefinitions.push_back(functionDefinition);
+    m_functionDefinitions.add(functionDefinition);
 }
 
 std::string UnitNode::getUnitName() { return m_unitName; }
 
+const std::shared_ptr<ASTArena> &UnitNode::arena() const { return m_arena; }
+
+UnitType UnitNode::getUnitType() { return m_unitType; }
+
 llvm::Value *UnitNode::codegen(std::unique_ptr<Context> &context)
 {
     std::vector<llvm::Type *> params;
 
-    m_blockNode->codegenConstantDefinitions(context);
+    context->Globals.assign(m_globalCount, nullptr);
+    if (m_blockNode)
+    {
+        m_blockNode->codegenConstantDefinitions(context);
+    }
+    else
+    {
+        // a unit only contains its own functions, the functions of the used units live in their modules
+        for (auto &fdef: m_functionDefinitions.definitions())
+        {
+            if (!fdef->unitName().empty() && fdef->unitName() != m_unitName)
+            {
+                context->PrecompiledUnits.insert(fdef->unitName());
+            }
+        }
+    }
     {
         // #define stdin  (__acrt_iob_func(0))
         // #define stdout (__acrt_iob_func(1))
@@ -92,72 +133,58 @@ llvm::Value *UnitNode::codegen(std::unique_ptr<Context> &context)
                                              llvm::ConstantPointerNull::get(cFile), "stdout");
 
             // ext_stdout->setExternallyInitialized(true);
-            context->NamedValues["stdout"] = ext_stdout;
+            context->StdOut = ext_stdout;
             // ext_stdout->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Local);
 
             auto ext_stderr =
                     new llvm::GlobalVariable(*context->TheModule, cFile, false, llvm::GlobalValue::InternalLinkage,
                                              llvm::ConstantPointerNull::get(cFile), "stderr");
-            context->NamedValues["stderr"] = ext_stderr;
+            context->StdErr = ext_stderr;
 
             auto ext_stdin =
                     new llvm::GlobalVariable(*context->TheModule, cFile, false, llvm::GlobalValue::InternalLinkage,
                                              llvm::ConstantPointerNull::get(cFile), "stdin");
             // ext_stdin->setExternallyInitialized(true);
-            context->NamedValues["stdin"] = ext_stdin;
+            context->StdIn = ext_stdin;
         }
         else
         {
             auto cFile = llvm::PointerType::getUnqual(*context->TheContext);
-            auto fileType = FileType::getFileType();
             auto ext_stderr = new llvm::GlobalVariable(*context->TheModule, cFile, false,
                                                        llvm::GlobalValue::ExternalLinkage, nullptr, "stderr");
             // ext_stderr->setExternallyInitialized(true);
             ext_stderr->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Local);
-            if (m_argumentNames.size() >= 3)
-            {
-                m_blockNode->addVariableDefinition(VariableDefinition{.variableType = fileType,
-                                                                      .variableName = m_argumentNames[2],
-                                                                      .scopeId = 0,
-                                                                      .llvmValue = ext_stderr,
-                                                                      .constant = false});
-            }
 
-            context->NamedValues["stderr"] = ext_stderr;
+            context->StdErr = ext_stderr;
             auto ext_stdout = new llvm::GlobalVariable(*context->TheModule, cFile, false,
                                                        llvm::GlobalValue::ExternalLinkage, nullptr, "stdout");
             // ext_stdout->setExternallyInitialized(true);
-            context->NamedValues["stdout"] = ext_stdout;
-            if (m_argumentNames.size() >= 2)
-            {
-                m_blockNode->addVariableDefinition(VariableDefinition{.variableType = fileType,
-                                                                      .variableName = m_argumentNames[1],
-                                                                      .scopeId = 0,
-                                                                      .llvmValue = ext_stdout,
-                                                                      .constant = false});
-            }
+            context->StdOut = ext_stdout;
             auto ext_stdin = new llvm::GlobalVariable(*context->TheModule, cFile, false,
                                                       llvm::GlobalValue::ExternalLinkage, nullptr, "stdin");
             // ext_stdin->setExternallyInitialized(true);
-            context->NamedValues["stdin"] = ext_stdin;
-            if (!m_argumentNames.empty())
-            {
-                m_blockNode->addVariableDefinition(VariableDefinition{.variableType = fileType,
-                                                                      .variableName = m_argumentNames[1],
-                                                                      .scopeId = 0,
-                                                                      .llvmValue = ext_stdin,
-                                                                      .constant = false});
-            }
+            context->StdIn = ext_stdin;
+        }
+
+        // the files of the program arguments are input, output and error
+        const std::array streams = {context->StdIn, context->StdOut, context->StdErr};
+        for (size_t i = 0; m_blockNode && i < m_argumentNames.size() && i < streams.size(); ++i)
+        {
+            m_blockNode->setVariableValue(Identifiers::intern(m_argumentNames[i]), streams[i]);
         }
 
         createReadLnStdinCall(context);
     }
 
 
-    for (auto &fdef: m_functionDefinitions)
+    for (auto &fdef: m_functionDefinitions.definitions())
     {
         fdef->codegen(context);
     }
+    if (!m_blockNode)
+    {
+        return nullptr;
+    }
     llvm::FunctionType *FT = llvm::FunctionType::get(llvm::Type::getInt32Ty(*context->TheContext), params, false);
 
     std::string functionName = m_unitName;
@@ -168,7 +195,10 @@ llvm::Value *UnitNode::codegen(std::unique_ptr<Context> &context)
 
     llvm::Function *F =
             llvm::Function::Create(FT, llvm::Function::ExternalLinkage, functionName, context->TheModule.get());
+    codegen::addTargetAttributes(context, F);
     context->TopLevelFunction = F;
+    context->TopLevelDefinition = nullptr;
+    context->Slots.assign(m_slotCount, nullptr);
     llvm::BasicBlock *BB = llvm::BasicBlock::Create(*context->TheContext, "entry", context->TopLevelFunction);
     context->Builder->SetInsertPoint(BB);
     if (context->TargetTriple->getOS() == llvm::Triple::Win32)
@@ -176,47 +206,15 @@ llvm::Value *UnitNode::codegen(std::unique_ptr<Context> &context)
         llvm::Function *CalleeF = context->TheModule->getFunction("__acrt_iob_func");
         auto stdOutArgs = llvm::ArrayRef<llvm::Value *>{context->Builder->getInt32(1)};
         auto stdOutPtr = context->Builder->CreateCall(CalleeF, stdOutArgs);
-        context->Builder->CreateStore(stdOutPtr, context->NamedValues["stdout"]);
+        context->Builder->CreateStore(stdOutPtr, context->StdOut);
 
         auto stdInPtr =
                 context->Builder->CreateCall(CalleeF, llvm::ArrayRef<llvm::Value *>{context->Builder->getInt32(0)});
-        context->Builder->CreateStore(stdInPtr, context->NamedValues["stdin"]);
+        context->Builder->CreateStore(stdInPtr, context->StdIn);
         auto stdErrPtr =
                 context->Builder->CreateCall(CalleeF, llvm::ArrayRef<llvm::Value *>{context->Builder->getInt32(2)});
 
-        context->Builder->CreateStore(stdErrPtr, context->NamedValues["stderr"]);
-
-        if (m_argumentNames.size() >= 2)
-        {
-            auto fileType = FileType::getFileType();
-
-
-            m_blockNode->addVariableDefinition(VariableDefinition{.variableType = fileType,
-                                                                  .variableName = m_argumentNames[1],
-                                                                  .scopeId = 0,
-                                                                  .llvmValue = context->NamedValues["stdout"],
-                                                                  .constant = false});
-        }
-        auto fileType = FileType::getFileType();
-
-        if (m_argumentNames.size() >= 1)
-        {
-            m_blockNode->addVariableDefinition(VariableDefinition{.variableType = fileType,
-                                                                  .variableName = m_argumentNames[0],
-                                                                  .scopeId = 0,
-                                                                  .llvmValue = context->NamedValues["stdin"],
-                                                                  .constant = false});
-        }
-
-
-        if (m_argumentNames.size() >= 2)
-        {
-            m_blockNode->addVariableDefinition(VariableDefinition{.variableType = fileType,
-                                                                  .variableName = m_argumentNames[2],
-                                                                  .scopeId = 0,
-                                                                  .llvmValue = context->NamedValues["stderr"],
-                                                                  .constant = false});
-        }
+        context->Builder->CreateStore(stdErrPtr, context->StdErr);
     }
 
     // m_blockNode->setBlockName("entry");
@@ -231,15 +229,15 @@ llvm::Value *UnitNode::codegen(std::unique_ptr<Context> &context)
 
     context->Builder->CreateRet(llvm::ConstantInt::get(*context->TheContext, llvm::APInt(32, 0)));
     verifyFunction(*F, &llvm::errs());
-    if (context->compilerOptions.buildMode == BuildMode::Release)
-    {
-        context->TheFPM->run(*F, *context->TheFAM);
-    }
     return nullptr;
 }
 
 std::optional<VariableDefinition> UnitNode::getVariableDefinition(const std::string &name)
 {
+    if (!m_blockNode)
+    {
+        return std::nullopt;
+    }
     return m_blockNode->getVariableDefinition(name);
 }
 
@@ -247,7 +245,7 @@ std::set<std::string> UnitNode::collectLibsToLink()
 {
     std::set<std::string> result;
     result.insert("c");
-    for (auto &function: m_functionDefinitions)
+    for (auto &function: m_functionDefinitions.definitions())
     {
         auto libName = function->libName();
         if (!libName.empty())
@@ -255,16 +253,40 @@ std::set<std::string> UnitNode::collectLibsToLink()
     }
     return result;
 }
-std::unordered_map<std::string, std::shared_ptr<VariableType>> UnitNode::getTypeDefinitions()
+std::unordered_map<Identifier, std::shared_ptr<VariableType>> UnitNode::getTypeDefinitions()
 {
     return m_typeDefinitions;
 }
+void UnitNode::bind(Binder &binder)
+{
+    // the constants of a program are bound first, so they are visible in the functions
+    if (m_blockNode)
+    {
+        m_blockNode->bindConstants(binder);
+    }
+    for (const auto &def: m_functionDefinitions.definitions())
+    {
+        def->bind(binder);
+    }
+    if (m_blockNode)
+    {
+        binder.beginFunction(nullptr);
+        m_blockNode->bind(binder);
+        m_slotCount = binder.endFunction();
+    }
+    m_globalCount = binder.globalCount();
+}
+
 void UnitNode::typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode)
 {
-    for (const auto &def: m_functionDefinitions)
+    ASTNode::invalidateResolvedTypes();
+    for (const auto &def: m_functionDefinitions.definitions())
     {
         def->typeCheck(unit, parentNode);
     }
 
-    m_blockNode->typeCheck(unit, parentNode);
+    if (m_blockNode)
+    {
+        m_blockNode->typeCheck(unit, parentNode);
+    }
 }
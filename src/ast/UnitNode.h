@@ -3,8 +3,10 @@
 #include <set>
 #include <unordered_map>
 #include "ASTNode.h"
+#include "ast/ASTArena.h"
 #include "ast/BlockNode.h"
 #include "ast/FunctionDefinitionNode.h"
+#include "ast/FunctionIndex.h"
 
 enum class UnitType
 {
@@ -15,35 +17,50 @@ enum class UnitType
 class UnitNode : public ASTNode
 {
 private:
+    // owns the nodes of the unit, it is declared first so it is destroyed after the members which point into it
+    std::shared_ptr<ASTArena> m_arena;
     UnitType m_unitType;
     std::string m_unitName;
-    std::vector<std::shared_ptr<FunctionDefinitionNode>> m_functionDefinitions;
-    std::unordered_map<std::string, std::shared_ptr<VariableType>> m_typeDefinitions;
-    std::shared_ptr<BlockNode> m_blockNode;
+    FunctionIndex m_functionDefinitions;
+    std::unordered_map<Identifier, std::shared_ptr<VariableType>> m_typeDefinitions;
+    BlockNode *m_blockNode;
     std::vector<std::string> m_argumentNames;
+    // the number of slots of the main block and of the constants of the program, assigned by the Binder
+    uint32_t m_slotCount = 0;
+    uint32_t m_globalCount = 0;
 
 public:
+    static constexpr NodeKind KIND = NodeKind::UNIT;
+
     UnitNode(const Token &token, UnitType unitType, const std::string &unitName,
-             const std::vector<std::shared_ptr<FunctionDefinitionNode>> &functionDefinitions,
-             const std::unordered_map<std::string, std::shared_ptr<VariableType>> &typeDefinitions,
-             const std::shared_ptr<BlockNode> &blockNode);
+             FunctionIndex functionDefinitions,
+             const std::unordered_map<Identifier, std::shared_ptr<VariableType>> &typeDefinitions,
+             BlockNode *blockNode, std::shared_ptr<ASTArena> arena);
     UnitNode(const Token &token, UnitType unitType, const std::string &unitName,
              const std::vector<std::string> &argumentNames,
-             const std::vector<std::shared_ptr<FunctionDefinitionNode>> &functionDefinitions,
-             const std::unordered_map<std::string, std::shared_ptr<VariableType>> &typeDefinitions,
-             const std::shared_ptr<BlockNode> &blockNode);
+             FunctionIndex functionDefinitions,
+             const std::unordered_map<Identifier, std::shared_ptr<VariableType>> &typeDefinitions,
+             BlockNode *blockNode, std::shared_ptr<ASTArena> arena);
     ~UnitNode() override = default;
 
     void print() override;
 
-    std::vector<std::shared_ptr<FunctionDefinitionNode>> getFunctionDefinitions();
-    std::optional<std::shared_ptr<FunctionDefinitionNode>> getFunctionDefinition(const std::string &functionName);
-    void addFunctionDefinition(const std::shared_ptr<FunctionDefinitionNode> &functionDefinition);
+    const std::vector<FunctionDefinitionNode *> &getFunctionDefinitions();
+    [[nodiscard]] const FunctionIndex &getFunctionIndex() const;
+    std::optional<FunctionDefinitionNode *> getFunctionDefinition(const std::string &functionName);
+    /**
+     * resolves a call by the name of the function and the types of its arguments.
+     */
+    std::optional<FunctionDefinitionNode *> getFunctionDefinition(const FunctionKey &key);
+    void addFunctionDefinition(FunctionDefinitionNode *functionDefinition);
     std::string getUnitName();
+    UnitType getUnitType();
+    [[nodiscard]] const std::shared_ptr<ASTArena> &arena() const;
     llvm::Value *codegen(std::unique_ptr<Context> &context) override;
     std::optional<VariableDefinition> getVariableDefinition(const std::string &name);
     std::set<std::string> collectLibsToLink();
-    std::unordered_map<std::string, std::shared_ptr<VariableType>> getTypeDefinitions();
+    std::unordered_map<Identifier, std::shared_ptr<VariableType>> getTypeDefinitions();
 
     void typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode) override;
+    void bind(Binder &binder) override;
 };
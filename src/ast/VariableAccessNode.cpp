@@ -1,14 +1,15 @@
 #include "VariableAccessNode.h"
 #include <iostream>
 #include <llvm/IR/IRBuilder.h>
+#include "Binder.h"
 #include "FunctionCallNode.h"
 #include "UnitNode.h"
-#include "compare.h"
 #include "compiler/Context.h"
+#include "compiler/codegen.h"
 
 
 VariableAccessNode::VariableAccessNode(const Token &token, bool dereference) :
-    ASTNode(token), m_variableName(token.lexical()), m_dereference(dereference)
+    ASTNode(token, KIND), m_variableName(token.lexical()), m_identifier(token.identifier()), m_dereference(dereference)
 {
 }
 
@@ -16,66 +17,53 @@ void VariableAccessNode::print() { std::cout << m_variableName; }
 
 llvm::Value *VariableAccessNode::codegen(std::unique_ptr<Context> &context)
 {
-    const auto variableName = to_lower(m_variableName);
-    llvm::Value *V = context->NamedValues[m_variableName];
-    if (V)
+    switch (m_slot.kind)
     {
-        return V;
-    }
+        case SlotKind::VALUE:
+        case SlotKind::GLOBAL:
+            return codegen::slotValue(context, m_slot);
+        case SlotKind::LOCAL:
+        {
+            const auto A = llvm::cast<llvm::AllocaInst>(codegen::slotValue(context, m_slot));
 
-    llvm::AllocaInst *A = context->NamedAllocations[m_variableName];
+            // Load the value.
+            if (A->getAllocatedType()->isStructTy() || !context->loadValue)
+                return A;
 
-    if (!A)
-    {
-        for (auto &arg: context->TopLevelFunction->args())
+            return context->Builder->CreateLoad(A->getAllocatedType(), A, m_variableName.c_str());
+        }
+        case SlotKind::ARGUMENT:
         {
-            if (iequals(arg.getName(), variableName))
+            // the arguments of the llvm function are in the order of the params of the function definition
+            const auto argType = context->TopLevelDefinition->getParam(m_slot.index);
+            const auto llvmArgType = argType->type->generateLlvmType(context);
+            auto argValue = codegen::slotValue(context, m_slot);
+            if (argType->type->baseType == VariableBaseType::Struct)
             {
-                auto functionDefinition =
-                        context->ProgramUnit->getFunctionDefinition(context->TopLevelFunction->getName().str());
-
-                const auto argType = functionDefinition.value()->getParam(arg.getArgNo());
-                const auto llvmArgType = argType->type->generateLlvmType(context);
-                auto argValue = context->TopLevelFunction->getArg(arg.getArgNo());
-                if (argType->type->baseType == VariableBaseType::Struct)
-                {
-                    llvm::AllocaInst *alloca =
-                            context->Builder->CreateAlloca(llvmArgType, nullptr, argType->argumentName + "_struct");
-                    return context->Builder->CreateLoad(A->getAllocatedType(), alloca, m_variableName.c_str());
-                }
-                if (argType->isReference && (argType->type->isSimpleType()))
-                {
-
-                    return context->Builder->CreateLoad(llvmArgType, argValue);
-                }
-
-                return argValue;
+                llvm::AllocaInst *alloca =
+                        context->Builder->CreateAlloca(llvmArgType, nullptr, argType->argumentName + "_struct");
+                return context->Builder->CreateLoad(llvmArgType, alloca, m_variableName.c_str());
             }
-        }
+            if (argType->isReference && (argType->type->isSimpleType()))
+            {
 
+                return context->Builder->CreateLoad(llvmArgType, argValue);
+            }
 
-        return LogErrorV("Unknown variable name: " + m_variableName);
+            return argValue;
+        }
+        case SlotKind::UNBOUND:
+            break;
     }
-
-    // if (m_dereference)
-    // {
-    //     return A;
-    // }
-
-    // Load the value.
-    if (A->getAllocatedType()->isStructTy() || !context->loadValue)
-        return A;
-
-
-    return context->Builder->CreateLoad(A->getAllocatedType(), A, m_variableName.c_str());
+    return LogErrorV("Unknown variable name: " + m_variableName);
 }
 
 std::shared_ptr<VariableType> VariableAccessNode::resolveType(const std::unique_ptr<UnitNode> &unit, ASTNode *parent)
 {
     std::shared_ptr<VariableType> type;
-    if (auto *functionDefinition = dynamic_cast<FunctionDefinitionNode *>(parent))
+    if (auto *functionDefinition = nodeCast<FunctionDefinitionNode>(parent))
     {
-        if (auto param = functionDefinition->getParam(m_variableName))
+        if (auto param = functionDefinition->getParam(m_identifier))
         {
             type = param.value().type;
         }
@@ -84,11 +72,11 @@ std::shared_ptr<VariableType> VariableAccessNode::resolveType(const std::unique_
             type = var.value().variableType;
         }
     }
-    else if (auto *functionCall = dynamic_cast<FunctionCallNode *>(parent))
+    else if (auto *functionCall = nodeCast<FunctionCallNode>(parent))
     {
         if (auto unitFunctionDefinition = unit->getFunctionDefinition(functionCall->name()))
         {
-            if (auto param = unitFunctionDefinition.value()->getParam(m_variableName))
+            if (auto param = unitFunctionDefinition.value()->getParam(m_identifier))
             {
                 type = param.value().type;
             }
@@ -108,7 +96,7 @@ std::shared_ptr<VariableType> VariableAccessNode::resolveType(const std::unique_
 
     if (m_dereference)
     {
-        if (auto ptrType = std::dynamic_pointer_cast<PointerType>(type))
+        if (auto ptrType = typeCast<PointerType>(type))
         {
             return ptrType->pointerBase;
         }
@@ -119,5 +107,7 @@ std::shared_ptr<VariableType> VariableAccessNode::resolveType(const std::unique_
     }
 
 
-    return std::make_shared<VariableType>();
+    return VariableType::getUnknown();
 }
+
+void VariableAccessNode::bind(Binder &binder) { m_slot = binder.value(m_identifier); }
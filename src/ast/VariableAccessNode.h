@@ -1,17 +1,24 @@
 #pragma once
 #include <string>
 #include "ASTNode.h"
+#include "VariableSlot.h"
 
 class VariableAccessNode : public ASTNode
 {
 private:
     std::string m_variableName;
+    Identifier m_identifier;
     bool m_dereference;
+    VariableSlot m_slot;
+
 public:
+    static constexpr NodeKind KIND = NodeKind::VARIABLE_ACCESS;
+
     explicit VariableAccessNode(const Token &token,bool dereference);
     ~VariableAccessNode() override = default;
     void print() override;
     llvm::Value *codegen(std::unique_ptr<Context> &context) override;
 
     std::shared_ptr<VariableType> resolveType(const std::unique_ptr<UnitNode> &unit, ASTNode *parent) override;
+    void bind(Binder &binder) override;
 };
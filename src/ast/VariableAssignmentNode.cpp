@@ -2,15 +2,18 @@
 #include <iostream>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Intrinsics.h>
+#include "ASTVisitor.h"
+#include "Binder.h"
 #include "FunctionCallNode.h"
 #include "UnitNode.h"
 #include "VariableAccessNode.h"
 #include "compiler/Context.h"
+#include "compiler/codegen.h"
 #include "exceptions/CompilerException.h"
 
-VariableAssignmentNode::VariableAssignmentNode(const Token &variableName, const std::shared_ptr<ASTNode> &expression,
+VariableAssignmentNode::VariableAssignmentNode(const Token &variableName, ASTNode *expression,
                                                bool dereference) :
-    ASTNode(variableName), m_variable(variableName), m_variableName(std::string(m_variable.lexical())),
+    ASTNode(variableName, KIND), m_variable(variableName), m_variableName(std::string(m_variable.lexical())),
     m_expression(expression), m_dereference(dereference)
 {
 }
@@ -25,36 +28,23 @@ void VariableAssignmentNode::print()
 llvm::Value *VariableAssignmentNode::codegen(std::unique_ptr<Context> &context)
 {
     // Look this variable up in the function.
-    llvm::Value *allocatedValue = context->NamedAllocations[m_variableName];
-
+    llvm::Value *allocatedValue = nullptr;
     llvm::Type *type = nullptr;
 
-    if (!allocatedValue)
+    if (m_slot.kind == SlotKind::LOCAL)
     {
-        for (auto &arg: context->TopLevelFunction->args())
-        {
-            if (arg.getName() == m_variableName)
-            {
-                auto functionDefinition =
-                        context->ProgramUnit->getFunctionDefinition(context->TopLevelFunction->getName().str());
-                if (functionDefinition.has_value())
-                {
-                    const auto argType = functionDefinition.value()->getParam(arg.getArgNo());
-                    type = argType->type->generateLlvmType(context);
-                    const auto argValue = context->TopLevelFunction->getArg(arg.getArgNo());
-                    if (argType->isReference)
-                    {
-
-                        allocatedValue = argValue;
-                        break;
-                    }
-                }
-            }
-        }
+        const auto allocation = llvm::cast<llvm::AllocaInst>(codegen::slotValue(context, m_slot));
+        allocatedValue = allocation;
+        type = allocation->getAllocatedType();
     }
-    else
+    else if (m_slot.kind == SlotKind::ARGUMENT)
     {
-        type = context->NamedAllocations[m_variableName]->getAllocatedType();
+        const auto argType = context->TopLevelDefinition->getParam(m_slot.index);
+        type = argType->type->generateLlvmType(context);
+        if (argType->isReference)
+        {
+            allocatedValue = codegen::slotValue(context, m_slot);
+        }
     }
 
 
@@ -86,27 +76,6 @@ llvm::Value *VariableAssignmentNode::codegen(std::unique_ptr<Context> &context)
 
     if (type->isStructTy() && expressionResult->getType()->isPointerTy())
     {
-        // we might have to free the value
-        auto variable_definition = context->ProgramUnit->getVariableDefinition(m_variableName);
-        std::shared_ptr<VariableType> varType =
-                (variable_definition) ? variable_definition.value().variableType : nullptr;
-        if (context->TopLevelFunction && !variable_definition)
-        {
-            if (const auto def =
-                        context->ProgramUnit->getFunctionDefinition(context->TopLevelFunction->getName().str()))
-            {
-                variable_definition = def.value()->body()->getVariableDefinition(m_variableName);
-
-                if (!variable_definition)
-                {
-                    varType = def.value()->getParam(m_variableName)->type;
-                }
-                else
-                {
-                    varType = variable_definition->variableType;
-                }
-            }
-        }
         // TODO not everything is allocated by malloc this needs proper ref counting
         // if (varType->baseType == VariableBaseType::String)
         // {
@@ -144,7 +113,10 @@ llvm::Value *VariableAssignmentNode::codegen(std::unique_ptr<Context> &context)
     {
         if (llvm::isa<llvm::AllocaInst>(expressionResult))
         {
-            context->NamedAllocations[m_variableName] = llvm::cast<llvm::AllocaInst>(expressionResult);
+            if (m_slot.kind == SlotKind::LOCAL)
+            {
+                codegen::setSlotValue(context, m_slot, expressionResult);
+            }
             return expressionResult;
         }
 
@@ -160,11 +132,11 @@ void VariableAssignmentNode::typeCheck(const std::unique_ptr<UnitNode> &unit, AS
 {
     if (parentNode != unit.get())
     {
-        if (const auto functionDef = dynamic_cast<FunctionDefinitionNode *>(parentNode))
+        if (const auto functionDef = nodeCast<FunctionDefinitionNode>(parentNode))
         {
             if (const auto varType = functionDef->body()->getVariableDefinition(m_variableName))
             {
-                const auto expressionType = m_expression->resolveType(unit, parentNode);
+                const auto expressionType = ast::resolveType(m_expression, unit, parentNode);
                 if (*expressionType != *varType.value().variableType)
                 {
 
@@ -179,7 +151,7 @@ void VariableAssignmentNode::typeCheck(const std::unique_ptr<UnitNode> &unit, AS
     }
     else if (const auto varType = unit->getVariableDefinition(m_variableName))
     {
-        const auto expressionType = m_expression->resolveType(unit, parentNode);
+        const auto expressionType = ast::resolveType(m_expression, unit, parentNode);
         if (*expressionType != *varType.value().variableType)
         {
 
@@ -191,3 +163,9 @@ void VariableAssignmentNode::typeCheck(const std::unique_ptr<UnitNode> &unit, AS
         }
     }
 }
+
+void VariableAssignmentNode::bind(Binder &binder)
+{
+    m_expression->bind(binder);
+    m_slot = binder.storage(m_variable.identifier());
+}
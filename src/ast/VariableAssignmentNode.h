@@ -1,19 +1,24 @@
 #pragma once
 #include <string>
 #include "ASTNode.h"
+#include "VariableSlot.h"
 
 class VariableAssignmentNode : public ASTNode
 {
 private:
     Token m_variable;
     std::string m_variableName;
-    std::shared_ptr<ASTNode> m_expression;
+    ASTNode *m_expression;
     bool m_dereference;
+    VariableSlot m_slot;
 
 public:
-    VariableAssignmentNode(const Token &variableName, const std::shared_ptr<ASTNode> &expression, bool dereference);
+    static constexpr NodeKind KIND = NodeKind::VARIABLE_ASSIGNMENT;
+
+    VariableAssignmentNode(const Token &variableName, ASTNode *expression, bool dereference);
     ~VariableAssignmentNode() override = default;
     void print() override;
     llvm::Value *codegen(std::unique_ptr<Context> &context) override;
     void typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode) override;
+    void bind(Binder &binder) override;
 };
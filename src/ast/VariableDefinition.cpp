@@ -11,7 +11,7 @@ using namespace std::literals;
 
 llvm::AllocaInst *VariableDefinition::generateCode(std::unique_ptr<Context> &context) const
 {
-    if (const auto array = std::dynamic_pointer_cast<ArrayType>(this->variableType))
+    if (const auto array = typeCast<ArrayType>(this->variableType))
     {
         const auto arrayType = array->generateLlvmType(context);
 
@@ -24,7 +24,7 @@ llvm::AllocaInst *VariableDefinition::generateCode(std::unique_ptr<Context> &con
         }
 
         auto *gvar_array_a = new llvm::GlobalVariable(*context->TheModule, arrayType, true,
-                                                      llvm::GlobalValue::ExternalLinkage, nullptr, this->variableName);
+                                                      llvm::GlobalValue::PrivateLinkage, nullptr, this->variableName);
 
         // Constant Definitions
         llvm::ConstantAggregateZero *const_array_2 = llvm::ConstantAggregateZero::get(arrayType);
@@ -79,7 +79,7 @@ llvm::AllocaInst *VariableDefinition::generateCode(std::unique_ptr<Context> &con
                                                   this->variableName);
         case VariableBaseType::Struct:
         {
-            const auto structType = std::dynamic_pointer_cast<RecordType>(this->variableType);
+            const auto structType = typeCast<RecordType>(this->variableType);
             if (structType != nullptr)
             {
                 return context->Builder->CreateAlloca(structType->generateLlvmType(context), nullptr,
@@ -88,7 +88,7 @@ llvm::AllocaInst *VariableDefinition::generateCode(std::unique_ptr<Context> &con
         }
         case VariableBaseType::String:
         {
-            const auto stringType = std::dynamic_pointer_cast<StringType>(this->variableType);
+            const auto stringType = typeCast<StringType>(this->variableType);
             if (stringType != nullptr)
             {
                 return context->Builder->CreateAlloca(stringType->generateLlvmType(context), nullptr,
@@ -97,7 +97,7 @@ llvm::AllocaInst *VariableDefinition::generateCode(std::unique_ptr<Context> &con
         }
         case VariableBaseType::Pointer:
         {
-            const auto type = std::dynamic_pointer_cast<PointerType>(this->variableType);
+            const auto type = typeCast<PointerType>(this->variableType);
             if (type->pointerBase)
                 return context->Builder->CreateAlloca(type->pointerBase->generateLlvmType(context), nullptr,
                                                       this->variableName);
@@ -105,7 +105,7 @@ llvm::AllocaInst *VariableDefinition::generateCode(std::unique_ptr<Context> &con
         }
         case VariableBaseType::File:
         {
-            const auto fileType = std::dynamic_pointer_cast<FileType>(this->variableType);
+            const auto fileType = typeCast<FileType>(this->variableType);
             if (fileType != nullptr)
             {
                 auto llvmFileType = fileType->generateLlvmType(context);
@@ -132,7 +132,7 @@ llvm::Value *VariableDefinition::generateCodeForConstant(std::unique_ptr<Context
     if (TheFunction)
         llvm::IRBuilder<> TmpB(&TheFunction->getEntryBlock(), TheFunction->getEntryBlock().begin());
 
-    // auto array = std::dynamic_pointer_cast<ArrayType>(this->variableType);
+    // auto array = typeCast<ArrayType>(this->variableType);
 
     return this->value->codegen(context);
 }
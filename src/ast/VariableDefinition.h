@@ -1,5 +1,7 @@
 #pragma once
 #include <string>
+#include "Identifier.h"
+#include "VariableSlot.h"
 #include "types/VariableType.h"
 
 class ASTNode;
@@ -11,11 +13,15 @@ struct VariableDefinition
 {
     std::shared_ptr<VariableType> variableType;
     std::string variableName;
+    // the interned variableName, used by the lookups of the parser
+    Identifier identifier = Identifier::NONE;
     std::string alias;
     size_t scopeId;
-    std::shared_ptr<ASTNode> value = nullptr;
+    ASTNode *value = nullptr;
     llvm::Value *llvmValue = nullptr;
     bool constant = false;
+    // assigned by the Binder
+    VariableSlot slot{};
 
     llvm::AllocaInst *generateCode(std::unique_ptr<Context> &context) const;
     llvm::Value *generateCodeForConstant(std::unique_ptr<Context> &context) const;
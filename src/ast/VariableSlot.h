@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * where the code generation finds a variable, assigned by the Binder.
+ */
+enum class SlotKind : uint8_t
+{
+    UNBOUND,
+    // an allocation of the function which is generated, stored in Context::Slots
+    LOCAL,
+    // a constant or the loop variable of a for loop, the value is stored in Context::Slots
+    VALUE,
+    // an argument of the function which is generated, the index is the number of the argument
+    ARGUMENT,
+    // a constant of the program, stored in Context::Globals
+    GLOBAL
+};
+
+struct VariableSlot
+{
+    SlotKind kind = SlotKind::UNBOUND;
+    uint32_t index = 0;
+
+    [[nodiscard]] bool bound() const { return kind != SlotKind::UNBOUND; }
+};
@@ -1,12 +1,14 @@
 #include "WhileNode.h"
 #include <llvm/IR/IRBuilder.h>
 #include <utility>
+#include "ASTVisitor.h"
+#include "Binder.h"
 #include "compiler/Context.h"
 #include "exceptions/CompilerException.h"
 
-WhileNode::WhileNode(const Token &token, std::shared_ptr<ASTNode> loopCondition,
-                     std::vector<std::shared_ptr<ASTNode>> nodes) :
-    ASTNode(token), m_loopCondition(std::move(loopCondition)), m_nodes(std::move(nodes))
+WhileNode::WhileNode(const Token &token, ASTNode *loopCondition,
+                     std::vector<ASTNode *> nodes) :
+    ASTNode(token, KIND), m_loopCondition(loopCondition), m_nodes(std::move(nodes))
 {
 }
 
@@ -28,7 +30,7 @@ llvm::Value *WhileNode::codegen(std::unique_ptr<Context> &context)
     //     EndCond, llvm::ConstantInt::get(*context->TheContext, llvm::APInt(64, 0)), "loopcond");
     // Create the "after loop" block and insert it.
     // Compute the end condition.
-    llvm::Value *EndCond = m_loopCondition->codegen(context);
+    llvm::Value *EndCond = ast::codegen(m_loopCondition, context);
     if (!EndCond)
         return nullptr;
 
@@ -50,7 +52,7 @@ llvm::Value *WhileNode::codegen(std::unique_ptr<Context> &context)
     for (auto &node: m_nodes)
     {
         context->Builder->SetInsertPoint(LoopBB);
-        node->codegen(context);
+        ast::codegen(node, context);
     }
     context->Builder->CreateBr(LoopCondBB);
 
@@ -64,7 +66,7 @@ llvm::Value *WhileNode::codegen(std::unique_ptr<Context> &context)
 }
 void WhileNode::typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parentNode)
 {
-    if (const auto &conditionType = m_loopCondition->resolveType(unit, parentNode))
+    if (const auto &conditionType = ast::resolveType(m_loopCondition, unit, parentNode))
     {
         if (conditionType->baseType != VariableBaseType::Boolean)
         {
@@ -76,6 +78,15 @@ void WhileNode::typeCheck(const std::unique_ptr<UnitNode> &unit, ASTNode *parent
 
     for (const auto &node: m_nodes)
     {
-        node->typeCheck(unit, parentNode);
+        ast::typeCheck(node, unit, parentNode);
+    }
+}
+
+void WhileNode::bind(Binder &binder)
+{
+    m_loopCondition->bind(binder);
+    for (const auto &exp: m_nodes)
+    {
+        exp->bind(binder);
     }
 }
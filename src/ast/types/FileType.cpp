@@ -4,24 +4,20 @@
 #include <vector>
 
 FileType::FileType(const std::string &typeName, std::optional<std::shared_ptr<VariableType>> childType) :
-    VariableType(VariableBaseType::File, typeName), m_childType(std::move(childType))
+    VariableType(KIND, VariableBaseType::File, typeName), m_childType(std::move(childType))
 {
 }
-llvm::Type *FileType::generateLlvmType(std::unique_ptr<Context> &context)
+llvm::Type *FileType::createLlvmType(std::unique_ptr<Context> &context)
 {
-    if (m_cachedType == nullptr)
-    {
-        std::vector<llvm::Type *> types;
-        types.emplace_back(::PointerType::getPointerTo(VariableType::getInteger(8))->generateLlvmType(context));
-        types.emplace_back(VariableType::getPointer()->generateLlvmType(context));
-        types.emplace_back(VariableType::getBoolean()->generateLlvmType(context));
+    std::vector<llvm::Type *> types;
+    types.emplace_back(::PointerType::getPointerTo(VariableType::getInteger(8))->generateLlvmType(context));
+    types.emplace_back(VariableType::getPointer()->generateLlvmType(context));
+    types.emplace_back(VariableType::getBoolean()->generateLlvmType(context));
 
-        const llvm::ArrayRef<llvm::Type *> elements(types);
+    const llvm::ArrayRef<llvm::Type *> elements(types);
 
 
-        m_cachedType = llvm::StructType::create(elements, typeName);
-    }
-    return m_cachedType;
+    return llvm::StructType::create(elements, typeName);
 }
 std::shared_ptr<VariableType> FileType::getFileType(std::optional<std::shared_ptr<VariableType>> childType)
 {
@@ -7,12 +7,15 @@ class FileType : public VariableType
 {
 private:
     std::optional<std::shared_ptr<VariableType>> m_childType;
-    llvm::Type *m_cachedType = nullptr;
+
+protected:
+    llvm::Type *createLlvmType(std::unique_ptr<Context> &context) override;
 
 public:
+    static constexpr TypeKind KIND = TypeKind::FILE;
+
     explicit FileType(const std::string &typeName,
                       std::optional<std::shared_ptr<VariableType>> childType = std::nullopt);
-    llvm::Type *generateLlvmType(std::unique_ptr<Context> &context) override;
 
     static std::shared_ptr<VariableType>
     getFileType(std::optional<std::shared_ptr<VariableType>> childType = std::nullopt);
@@ -6,10 +6,8 @@
 #include "compiler/Context.h"
 
 RecordType::RecordType(std::vector<VariableDefinition> fields, const std::string &typeName) :
-    m_fields(std::move(fields))
+    VariableType(KIND, VariableBaseType::Struct, typeName), m_fields(std::move(fields))
 {
-    this->typeName = typeName;
-    this->baseType = VariableBaseType::Struct;
 }
 
 void RecordType::addField(const VariableDefinition &field) { m_fields.push_back(field); }
@@ -40,22 +38,18 @@ int RecordType::getFieldIndexByName(const std::string &name) const
     return 0;
 }
 
-llvm::Type *RecordType::generateLlvmType(std::unique_ptr<Context> &context)
+llvm::Type *RecordType::createLlvmType(std::unique_ptr<Context> &context)
 {
-    if (m_cachedType == nullptr)
+    std::vector<llvm::Type *> types;
+    for (size_t i = 0; i < size(); ++i)
     {
-        std::vector<llvm::Type *> types;
-        for (size_t i = 0; i < size(); ++i)
-        {
-            types.emplace_back(getField(i).variableType->generateLlvmType(context));
-        }
+        types.emplace_back(m_fields[i].variableType->generateLlvmType(context));
+    }
 
-        llvm::ArrayRef<llvm::Type *> Elements(types);
+    llvm::ArrayRef<llvm::Type *> Elements(types);
 
 
-        m_cachedType = llvm::StructType::create(Elements, typeName);
-    }
-    return m_cachedType;
+    return llvm::StructType::create(Elements, typeName);
 }
 
 size_t RecordType::size() const { return m_fields.size(); }
@@ -10,9 +10,13 @@ class RecordType : public VariableType
 {
 private:
     std::vector<VariableDefinition> m_fields;
-    llvm::Type *m_cachedType = nullptr;
+
+protected:
+    llvm::Type *createLlvmType(std::unique_ptr<Context> &context) override;
 
 public:
+    static constexpr TypeKind KIND = TypeKind::RECORD;
+
     VariableDefinition getField(size_t index);
     [[nodiscard]] size_t size() const;
     void addField(const VariableDefinition &field);
@@ -20,5 +24,4 @@ public:
     [[nodiscard]] int getFieldIndexByName(const std::string &name) const;
 
     RecordType(std::vector<VariableDefinition> fields, const std::string &typeName);
-    llvm::Type *generateLlvmType(std::unique_ptr<Context> &context) override;
 };
@@ -6,50 +6,30 @@
 #include "exceptions/CompilerException.h"
 
 
-llvm::Type *StringType::generateLlvmType(std::unique_ptr<Context> &context)
-{
-    if (llvmType != nullptr && llvmType->getContext().pImpl != context->TheContext->pImpl)
-    {
-        llvmType = nullptr;
-    }
+StringType::StringType() : VariableType(KIND, VariableBaseType::String, "string") {}
 
-    if (llvmType == nullptr)
-    {
-        const auto baseType = IntegerType::getInteger(8);
-        const auto charType = baseType->generateLlvmType(context);
-        std::vector<llvm::Type *> types;
-        types.emplace_back(VariableType::getInteger(64)->generateLlvmType(context));
-        types.emplace_back(VariableType::getInteger(64)->generateLlvmType(context));
-        types.emplace_back(llvm::PointerType::getUnqual(charType));
+llvm::Type *StringType::createLlvmType(std::unique_ptr<Context> &context)
+{
+    const auto baseType = IntegerType::getInteger(8);
+    const auto charType = baseType->generateLlvmType(context);
+    std::vector<llvm::Type *> types;
+    types.emplace_back(VariableType::getInteger(64)->generateLlvmType(context));
+    types.emplace_back(VariableType::getInteger(64)->generateLlvmType(context));
+    types.emplace_back(llvm::PointerType::getUnqual(charType));
 
 
-        llvm::ArrayRef<llvm::Type *> Elements(types);
+    llvm::ArrayRef<llvm::Type *> Elements(types);
 
 
-        llvmType = llvm::StructType::create(Elements, "string");
-    }
-    return llvmType;
+    return llvm::StructType::create(Elements, "string");
 }
 
-llvm::Value *StringType::generateFieldAccess(Token &token, llvm::Value *indexValue, std::unique_ptr<Context> &context)
+llvm::Value *StringType::generateFieldAccess(Token &token, llvm::Value *variable, llvm::Value *indexValue,
+                                             std::unique_ptr<Context> &context)
 {
-    const auto arrayName = token.lexical();
-    llvm::Value *V = context->NamedAllocations[arrayName];
-
-    if (!V)
-    {
-        for (auto &arg: context->TopLevelFunction->args())
-        {
-            if (arg.getName() == arrayName)
-            {
-                V = context->TopLevelFunction->getArg(arg.getArgNo());
-                break;
-            }
-        }
-    }
-
+    llvm::Value *V = variable;
     if (!V)
-        return LogErrorV("Unknown variable for string access: " + arrayName);
+        return LogErrorV("Unknown variable for string access: " + std::string(token.lexical()));
 
 
     auto llvmRecordType = this->generateLlvmType(context);
@@ -70,30 +50,14 @@ llvm::Value *StringType::generateFieldAccess(Token &token, llvm::Value *indexVal
 
 std::shared_ptr<StringType> StringType::getString()
 {
-    static auto stringType = std::make_shared<StringType>();
-    stringType->baseType = VariableBaseType::String;
-    stringType->typeName = "string";
+    static const auto stringType = std::make_shared<StringType>();
     return stringType;
 }
-llvm::Value *StringType::generateLengthValue(const Token &token, std::unique_ptr<Context> &context)
+llvm::Value *StringType::generateLengthValue(llvm::Value *variable, std::unique_ptr<Context> &context)
 {
-    const auto arrayName = token.lexical();
-    llvm::Value *value = context->NamedAllocations[arrayName];
-
-    if (!value)
-    {
-        for (auto &arg: context->TopLevelFunction->args())
-        {
-            if (arg.getName() == arrayName)
-            {
-                value = context->TopLevelFunction->getArg(arg.getArgNo());
-                break;
-            }
-        }
-    }
-
+    llvm::Value *value = variable;
     if (!value)
-        return LogErrorV("Unknown variable for string access: " + arrayName);
+        return LogErrorV("Unknown variable for string access");
 
 
     const auto llvmRecordType = generateLlvmType(context);
@@ -104,7 +68,7 @@ llvm::Value *StringType::generateLengthValue(const Token &token, std::unique_ptr
     return context->Builder->CreateSub(context->Builder->CreateLoad(indexType, arraySizeOffset, "loaded.length"),
                                        context->Builder->getInt64(1));
 }
-llvm::Value *StringType::generateHighValue(const Token &token, std::unique_ptr<Context> &context)
+llvm::Value *StringType::generateHighValue(llvm::Value *variable, std::unique_ptr<Context> &context)
 {
-    return context->Builder->CreateSub(generateLengthValue(token, context), context->Builder->getInt64(1));
+    return context->Builder->CreateSub(generateLengthValue(variable, context), context->Builder->getInt64(1));
 }
@@ -4,16 +4,19 @@
 
 class StringType : public VariableType, public FieldAccessableType
 {
-private:
-    llvm::Type *llvmType = nullptr;
+protected:
+    llvm::Type *createLlvmType(std::unique_ptr<Context> &context) override;
 
 public:
-    llvm::Type *generateLlvmType(std::unique_ptr<Context> &context) override;
-    llvm::Value *generateFieldAccess(Token &token, llvm::Value *indexValue, std::unique_ptr<Context> &context) override;
+    static constexpr TypeKind KIND = TypeKind::STRING;
+
+    StringType();
+    llvm::Value *generateFieldAccess(Token &token, llvm::Value *variable, llvm::Value *indexValue,
+                                     std::unique_ptr<Context> &context) override;
     static std::shared_ptr<StringType> getString();
 
     bool operator==(const StringType &) const { return true; }
 
-    llvm::Value *generateLengthValue(const Token &token, std::unique_ptr<Context> &context) override;
-    llvm::Value *generateHighValue(const Token &token, std::unique_ptr<Context> &context) override;
+    llvm::Value *generateLengthValue(llvm::Value *variable, std::unique_ptr<Context> &context) override;
+    llvm::Value *generateHighValue(llvm::Value *variable, std::unique_ptr<Context> &context) override;
 };
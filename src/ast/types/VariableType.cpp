@@ -1,12 +1,76 @@
 #include "VariableType.h"
+#include "StringType.h"
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <llvm/IR/IRBuilder.h>
+#include <map>
+#include <mutex>
+#include <tuple>
 
 #include "compiler/Context.h"
 #include "exceptions/CompilerException.h"
 
+namespace
+{
+    /**
+     * holds the types weakly, so that a type is freed with the last node that uses it. The expired entries are removed
+     * whenever the map has doubled in size since the last sweep.
+     */
+    template<typename Key, typename Type>
+    struct TypeMap
+    {
+        std::map<Key, std::weak_ptr<Type>> entries;
+        size_t sweepSize = 64;
+
+        template<typename Create>
+        std::shared_ptr<Type> get(const Key &key, Create create)
+        {
+            if (const auto it = entries.find(key); it != entries.end())
+            {
+                if (auto type = it->second.lock())
+                {
+                    return type;
+                }
+            }
+            auto type = create();
+            entries.insert_or_assign(key, type);
+            if (entries.size() >= sweepSize)
+            {
+                std::erase_if(entries, [](const auto &entry) { return entry.second.expired(); });
+                sweepSize = std::max<size_t>(64, entries.size() * 2);
+            }
+            return type;
+        }
+    };
+
+    /**
+     * the canonical instances of the types which are created with parameters. The base types are keyed by their
+     * address, a live entry keeps its base type alive, so the address can not be reused while the entry is in use.
+     */
+    struct TypeTable
+    {
+        std::mutex mutex;
+        TypeMap<size_t, IntegerType> integers;
+        TypeMap<const VariableType *, PointerType> pointers;
+        TypeMap<const VariableType *, ArrayType> dynArrays;
+        TypeMap<std::tuple<size_t, size_t, const VariableType *>, ArrayType> fixedArrays;
+    };
+
+    TypeTable &typeTable()
+    {
+        static TypeTable table;
+        return table;
+    }
+} // namespace
+
 VariableType::VariableType(const VariableBaseType baseType, const std::string &typeName) :
-    baseType(baseType), typeName(typeName)
+    m_mangledName(Identifiers::intern(typeName)), baseType(baseType), typeName(typeName)
+{
+}
+
+VariableType::VariableType(const TypeKind kind, const VariableBaseType baseType, const std::string &typeName) :
+    m_mangledName(Identifiers::intern(typeName)), m_kind(kind), baseType(baseType), typeName(typeName)
 {
 }
 bool VariableType::isSimpleType() const
@@ -30,6 +94,18 @@ bool VariableType::isSimpleType() const
 }
 
 llvm::Type *VariableType::generateLlvmType(std::unique_ptr<Context> &context)
+{
+    if (m_llvmTypeGeneration != context->Generation)
+    {
+        m_llvmType = createLlvmType(context);
+        m_llvmTypeGeneration = context->Generation;
+    }
+    return m_llvmType;
+}
+
+Identifier VariableType::mangledName() const { return m_mangledName; }
+
+llvm::Type *VariableType::createLlvmType(std::unique_ptr<Context> &context)
 {
     switch (this->baseType)
     {
@@ -47,131 +123,136 @@ llvm::Type *VariableType::generateLlvmType(std::unique_ptr<Context> &context)
     }
 }
 
-std::shared_ptr<IntegerType> VariableType::getInteger(size_t length)
+std::shared_ptr<IntegerType> VariableType::getInteger(const size_t length)
 {
-    auto integer = std::make_shared<IntegerType>();
-    integer->baseType = VariableBaseType::Integer;
-    integer->length = length;
-    integer->typeName = "integer" + std::to_string(length);
-    return integer;
+    // the lengths of the builtin integer types are found without taking the lock
+    static const std::array builtinIntegers = {std::make_shared<IntegerType>(8), std::make_shared<IntegerType>(16),
+                                               std::make_shared<IntegerType>(32), std::make_shared<IntegerType>(64)};
+    switch (length)
+    {
+        case 8:
+            return builtinIntegers[0];
+        case 16:
+            return builtinIntegers[1];
+        case 32:
+            return builtinIntegers[2];
+        case 64:
+            return builtinIntegers[3];
+        default:
+            break;
+    }
+    auto &table = typeTable();
+    std::scoped_lock lock(table.mutex);
+    return table.integers.get(length, [length] { return std::make_shared<IntegerType>(length); });
 }
 std::shared_ptr<VariableType> VariableType::getSingle()
 {
-    auto floatType = std::make_shared<VariableType>();
-    floatType->baseType = VariableBaseType::Float;
-    floatType->typeName = "single";
+    static const auto floatType = std::make_shared<VariableType>(VariableBaseType::Float, "single");
     return floatType;
 }
 std::shared_ptr<VariableType> VariableType::getDouble()
 {
-    auto doubleType = std::make_shared<VariableType>();
-    doubleType->baseType = VariableBaseType::Double;
-    doubleType->typeName = "double";
+    static const auto doubleType = std::make_shared<VariableType>(VariableBaseType::Double, "double");
     return doubleType;
 }
 
 std::shared_ptr<VariableType> VariableType::getBoolean()
 {
-    auto boolean = std::make_shared<VariableType>();
-    boolean->baseType = VariableBaseType::Boolean;
-    boolean->typeName = "boolean";
+    static const auto boolean = std::make_shared<VariableType>(VariableBaseType::Boolean, "boolean");
     return boolean;
 }
 
 std::shared_ptr<VariableType> VariableType::getPointer()
 {
-    auto pointer = std::make_shared<VariableType>();
-    pointer->baseType = VariableBaseType::Pointer;
-    pointer->typeName = "pointer";
+    static const auto pointer = std::make_shared<VariableType>(VariableBaseType::Pointer, "pointer");
     return pointer;
 }
+
+std::shared_ptr<VariableType> VariableType::getUnknown()
+{
+    static const auto unknown = std::make_shared<VariableType>();
+    return unknown;
+}
 bool VariableType::operator==(const VariableType &other) const { return this->baseType == other.baseType; }
+template<>
+std::shared_ptr<FieldAccessableType> typeCast<FieldAccessableType>(const std::shared_ptr<VariableType> &type)
+{
+    if (auto array = typeCast<ArrayType>(type))
+        return array;
+    if (auto string = typeCast<StringType>(type))
+        return string;
+    return nullptr;
+}
+
 llvm::Value *FieldAccessableType::getLowValue(std::unique_ptr<Context> &context)
 {
     return context->Builder->getInt64(0);
 }
 
 
+ArrayType::ArrayType(const size_t low, const size_t high, const bool isDynArray,
+                     std::shared_ptr<VariableType> arrayBase) :
+    VariableType(KIND, VariableBaseType::Array, ""), low(low), high(high), isDynArray(isDynArray),
+    arrayBase(std::move(arrayBase))
+{
+}
+
 std::shared_ptr<ArrayType> ArrayType::getFixedArray(size_t low, size_t heigh,
                                                     const std::shared_ptr<VariableType> &baseType)
 {
-    auto type = std::make_shared<ArrayType>();
-    type->baseType = VariableBaseType::Array;
-    type->low = low;
-    type->high = heigh;
-    type->arrayBase = baseType;
-    type->isDynArray = false;
-    return type;
+    auto &table = typeTable();
+    std::scoped_lock lock(table.mutex);
+    return table.fixedArrays.get({low, heigh, baseType.get()},
+                                 [&] { return std::make_shared<ArrayType>(low, heigh, false, baseType); });
 }
 
 std::shared_ptr<ArrayType> ArrayType::getDynArray(const std::shared_ptr<VariableType> &baseType)
 {
-    auto type = std::make_shared<ArrayType>();
-    type->baseType = VariableBaseType::Array;
-    type->low = 0;
-    type->high = 0;
-    type->arrayBase = baseType;
-    type->isDynArray = true;
-    return type;
+    auto &table = typeTable();
+    std::scoped_lock lock(table.mutex);
+    return table.dynArrays.get(baseType.get(), [&] { return std::make_shared<ArrayType>(0, 0, true, baseType); });
 }
 
+IntegerType::IntegerType(const size_t length) :
+    VariableType(KIND, VariableBaseType::Integer, "integer" + std::to_string(length)), length(length)
+{
+}
 
-llvm::Type *IntegerType::generateLlvmType(std::unique_ptr<Context> &context)
+llvm::Type *IntegerType::createLlvmType(std::unique_ptr<Context> &context)
 {
     return llvm::IntegerType::get(*context->TheContext, this->length);
 }
 
 
-llvm::Type *ArrayType::generateLlvmType(std::unique_ptr<Context> &context)
+llvm::Type *ArrayType::createLlvmType(std::unique_ptr<Context> &context)
 {
-    if (llvmType == nullptr)
+    auto arrayBaseType = arrayBase->generateLlvmType(context);
+    if (isDynArray)
     {
-        auto arrayBaseType = arrayBase->generateLlvmType(context);
-        if (isDynArray)
-        {
 
-            std::vector<llvm::Type *> types;
-            types.emplace_back(VariableType::getInteger(64)->generateLlvmType(context));
+        std::vector<llvm::Type *> types;
+        types.emplace_back(VariableType::getInteger(64)->generateLlvmType(context));
 
-            types.emplace_back(llvm::PointerType::getUnqual(arrayBaseType));
+        types.emplace_back(llvm::PointerType::getUnqual(arrayBaseType));
 
 
-            llvm::ArrayRef<llvm::Type *> Elements(types);
+        llvm::ArrayRef<llvm::Type *> Elements(types);
 
 
-            llvmType = llvm::StructType::create(Elements);
-        }
-        else
-        {
+        return llvm::StructType::create(Elements);
+    }
 
-            const auto arraySize = high - low + 1;
+    const auto arraySize = high - low + 1;
 
-            llvmType = llvm::ArrayType::get(arrayBaseType, arraySize);
-        }
-    }
-    return llvmType;
+    return llvm::ArrayType::get(arrayBaseType, arraySize);
 }
 
-llvm::Value *ArrayType::generateFieldAccess(Token &token, llvm::Value *indexValue, std::unique_ptr<Context> &context)
+llvm::Value *ArrayType::generateFieldAccess(Token &token, llvm::Value *variable, llvm::Value *indexValue,
+                                            std::unique_ptr<Context> &context)
 {
-    const auto arrayName = std::string(token.lexical());
-    llvm::Value *V = context->NamedAllocations[arrayName];
-
-    if (!V)
-    {
-        for (auto &arg: context->TopLevelFunction->args())
-        {
-            if (arg.getName() == arrayName)
-            {
-                V = context->TopLevelFunction->getArg(arg.getArgNo());
-                break;
-            }
-        }
-    }
-
-
+    llvm::Value *V = variable;
     if (!V)
-        return LogErrorV("Unknown variable for array access: " + arrayName);
+        return LogErrorV("Unknown variable for array access: " + std::string(token.lexical()));
 
     if (this->isDynArray)
     {
@@ -212,26 +293,11 @@ llvm::Value *ArrayType::generateFieldAccess(Token &token, llvm::Value *indexValu
             context->Builder->CreateGEP(arrayType, V, {context->Builder->getInt64(0), index}, "arrayindex", false);
     return context->Builder->CreateLoad(arrayType->getArrayElementType(), arrayValue);
 }
-llvm::Value *ArrayType::generateLengthValue(const Token &token, std::unique_ptr<Context> &context)
+llvm::Value *ArrayType::generateLengthValue(llvm::Value *variable, std::unique_ptr<Context> &context)
 {
-    const auto arrayName = std::string(token.lexical());
-    llvm::Value *value = context->NamedAllocations[arrayName];
-
+    llvm::Value *value = variable;
     if (!value)
-    {
-        for (auto &arg: context->TopLevelFunction->args())
-        {
-            if (arg.getName() == arrayName)
-            {
-                value = context->TopLevelFunction->getArg(arg.getArgNo());
-                break;
-            }
-        }
-    }
-
-
-    if (!value)
-        return LogErrorV("Unknown variable for array access: " + arrayName);
+        return LogErrorV("Unknown variable for array access");
 
 
     if (isDynArray)
@@ -254,33 +320,33 @@ llvm::Value *ArrayType::getLowValue(std::unique_ptr<Context> &context)
     }
     return context->Builder->getInt64(value);
 }
-llvm::Value *ArrayType::generateHighValue(const Token &token, std::unique_ptr<Context> &context)
+llvm::Value *ArrayType::generateHighValue(llvm::Value *variable, std::unique_ptr<Context> &context)
 {
     if (isDynArray)
     {
-        return context->Builder->CreateSub(generateLengthValue(token, context), context->Builder->getInt64(1));
+        return context->Builder->CreateSub(generateLengthValue(variable, context), context->Builder->getInt64(1));
     }
     return context->Builder->getInt64(high);
 }
 
-std::shared_ptr<PointerType> PointerType::getPointerTo(const std::shared_ptr<VariableType> &baseType)
+PointerType::PointerType(std::shared_ptr<VariableType> pointerBase) :
+    VariableType(KIND, VariableBaseType::Pointer, pointerBase ? pointerBase->typeName + "_ptr" : "pointer"),
+    pointerBase(std::move(pointerBase))
 {
-    auto ptrType = std::make_shared<PointerType>();
+}
 
-    ptrType->pointerBase = baseType;
-    ptrType->baseType = VariableBaseType::Pointer;
-    ptrType->typeName = baseType->typeName + "_ptr";
-    return ptrType;
+std::shared_ptr<PointerType> PointerType::getPointerTo(const std::shared_ptr<VariableType> &baseType)
+{
+    auto &table = typeTable();
+    std::scoped_lock lock(table.mutex);
+    return table.pointers.get(baseType.get(), [&] { return std::make_shared<PointerType>(baseType); });
 }
 std::shared_ptr<PointerType> PointerType::getUnqual()
 {
-    auto ptrType = std::make_shared<PointerType>();
-    ptrType->pointerBase = nullptr;
-    ptrType->baseType = VariableBaseType::Pointer;
-    ptrType->typeName = "pointer";
+    static const auto ptrType = std::make_shared<PointerType>(nullptr);
     return ptrType;
 }
-llvm::Type *PointerType::generateLlvmType(std::unique_ptr<Context> &context)
+llvm::Type *PointerType::createLlvmType(std::unique_ptr<Context> &context)
 {
     if (pointerBase)
     {
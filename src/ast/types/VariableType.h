@@ -1,5 +1,6 @@
 #pragma once
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include "Token.h"
@@ -19,6 +20,20 @@ enum class VariableBaseType
     File
 };
 
+/**
+ * the concrete class of a type, so the class of a type can be tested without RTTI, see typeCast.
+ */
+enum class TypeKind : uint8_t
+{
+    BASIC,
+    ARRAY,
+    FILE,
+    INTEGER,
+    POINTER,
+    RECORD,
+    STRING
+};
+
 namespace llvm
 {
     class Type;
@@ -31,42 +46,86 @@ struct Context;
 class IntegerType;
 
 
+/**
+ * the types are interned, the factory functions return the same instance for the same type. So the llvm type and the
+ * mangled name of a type are computed once and types can be compared by their address.
+ * Only record and file types are created by their declaration.
+ */
 class VariableType
 {
+    // the llvm type belongs to the LLVMContext of one compilation, it is created again for the next one
+    llvm::Type *m_llvmType = nullptr;
+    uint64_t m_llvmTypeGeneration = 0;
+    // interned in the constructor, so the parser threads only read it
+    Identifier m_mangledName = Identifier::NONE;
+    TypeKind m_kind = TypeKind::BASIC;
+
+protected:
+    virtual llvm::Type *createLlvmType(std::unique_ptr<Context> &context);
+    VariableType(TypeKind kind, VariableBaseType baseType, const std::string &typeName);
+
 public:
     explicit VariableType(VariableBaseType baseType = VariableBaseType::Unknown, const std::string &typeName = "");
     virtual ~VariableType() = default;
+    [[nodiscard]] TypeKind kind() const { return m_kind; }
     [[nodiscard]] bool isSimpleType() const;
     VariableBaseType baseType = VariableBaseType::Unknown;
     std::string typeName = "";
 
-    virtual llvm::Type *generateLlvmType(std::unique_ptr<Context> &context);
+    /**
+     * returns the llvm type, it is created once for the context of every compilation.
+     */
+    llvm::Type *generateLlvmType(std::unique_ptr<Context> &context);
+    /**
+     * the interned type name, which identifies the type in the keys of the function overloads.
+     */
+    [[nodiscard]] Identifier mangledName() const;
     static std::shared_ptr<IntegerType> getInteger(size_t length = 32);
     static std::shared_ptr<VariableType> getSingle();
     static std::shared_ptr<VariableType> getDouble();
     static std::shared_ptr<VariableType> getBoolean();
     static std::shared_ptr<VariableType> getPointer();
+    /**
+     * the type of an expression whose type could not be resolved.
+     */
+    static std::shared_ptr<VariableType> getUnknown();
 
     bool operator==(const VariableType &other) const;
 };
 
+/**
+ * returns the type as a T if it is one and nullptr otherwise, the replacement of dynamic_pointer_cast for types.
+ */
+template<typename T>
+std::shared_ptr<T> typeCast(const std::shared_ptr<VariableType> &type)
+{
+    if (type == nullptr || type->kind() != T::KIND)
+        return nullptr;
+    return std::static_pointer_cast<T>(type);
+}
+
 class FieldAccessableType
 {
 public:
     virtual ~FieldAccessableType() = default;
-    virtual llvm::Value *generateFieldAccess(Token &token, llvm::Value *indexValue,
+    /**
+     * the variable is the memory of the array or string, the token names it in the error messages.
+     */
+    virtual llvm::Value *generateFieldAccess(Token &token, llvm::Value *variable, llvm::Value *indexValue,
                                              std::unique_ptr<Context> &context) = 0;
-    virtual llvm::Value *generateLengthValue(const Token &token, std::unique_ptr<Context> &context) = 0;
-    virtual llvm::Value *generateHighValue(const Token &token, std::unique_ptr<Context> &context) = 0;
+    virtual llvm::Value *generateLengthValue(llvm::Value *variable, std::unique_ptr<Context> &context) = 0;
+    virtual llvm::Value *generateHighValue(llvm::Value *variable, std::unique_ptr<Context> &context) = 0;
     virtual llvm::Value *getLowValue(std::unique_ptr<Context> &context);
 };
 
 class ArrayType final : public VariableType, public FieldAccessableType
 {
-private:
-    llvm::Type *llvmType = nullptr;
+protected:
+    llvm::Type *createLlvmType(std::unique_ptr<Context> &context) override;
 
 public:
+    static constexpr TypeKind KIND = TypeKind::ARRAY;
+
     size_t low;
     size_t high;
     bool isDynArray;
@@ -74,15 +133,17 @@ public:
 
     std::shared_ptr<VariableType> arrayBase;
 
+    ArrayType(size_t low, size_t high, bool isDynArray, std::shared_ptr<VariableType> arrayBase);
+
     static std::shared_ptr<ArrayType> getFixedArray(size_t low, size_t heigh,
                                                     const std::shared_ptr<VariableType> &baseType);
     static std::shared_ptr<ArrayType> getDynArray(const std::shared_ptr<VariableType> &baseType);
 
-    llvm::Type *generateLlvmType(std::unique_ptr<Context> &context) override;
-    llvm::Value *generateFieldAccess(Token &token, llvm::Value *indexValue, std::unique_ptr<Context> &context) override;
-    llvm::Value *generateLengthValue(const Token &token, std::unique_ptr<Context> &context) override;
+    llvm::Value *generateFieldAccess(Token &token, llvm::Value *variable, llvm::Value *indexValue,
+                                     std::unique_ptr<Context> &context) override;
+    llvm::Value *generateLengthValue(llvm::Value *variable, std::unique_ptr<Context> &context) override;
     llvm::Value *getLowValue(std::unique_ptr<Context> &context) override;
-    llvm::Value *generateHighValue(const Token &token, std::unique_ptr<Context> &context) override;
+    llvm::Value *generateHighValue(llvm::Value *variable, std::unique_ptr<Context> &context) override;
 
 
     bool operator==(const ArrayType &other) const
@@ -95,26 +156,39 @@ public:
 
 class IntegerType final : public VariableType
 {
+protected:
+    llvm::Type *createLlvmType(std::unique_ptr<Context> &context) override;
+
 public:
+    static constexpr TypeKind KIND = TypeKind::INTEGER;
+
     size_t length;
-    llvm::Type *generateLlvmType(std::unique_ptr<Context> &context) override;
+
+    explicit IntegerType(size_t length);
 };
 
 
 class PointerType : public VariableType
 {
-private:
-    llvm::Type *llvmType = nullptr;
+protected:
+    llvm::Type *createLlvmType(std::unique_ptr<Context> &context) override;
 
 public:
+    static constexpr TypeKind KIND = TypeKind::POINTER;
+
     std::shared_ptr<VariableType> pointerBase;
 
+    explicit PointerType(std::shared_ptr<VariableType> pointerBase);
+
     static std::shared_ptr<PointerType> getPointerTo(const std::shared_ptr<VariableType> &baseType);
     static std::shared_ptr<PointerType> getUnqual();
 
 
-    llvm::Type *generateLlvmType(std::unique_ptr<Context> &context) override;
-
-
     bool operator==(const PointerType &other) const { return this->baseType == other.baseType; }
 };
+
+/**
+ * arrays and strings are the field accessable types.
+ */
+template<>
+std::shared_ptr<FieldAccessableType> typeCast<FieldAccessableType>(const std::shared_ptr<VariableType> &type);
@@ -0,0 +1,75 @@
+#include "BuildManifest.h"
+
+#include <fstream>
+#include <ranges>
+#include <sstream>
+#include <utility>
+
+BuildManifest::BuildManifest(std::filesystem::path path) : m_path(std::move(path)) {}
+
+void BuildManifest::load()
+{
+    m_entries.clear();
+    std::ifstream file(m_path);
+    if (!file.is_open())
+    {
+        return;
+    }
+    // one unit per line: name, source path, hashes and the comma separated imports, separated by tabs
+    for (std::string line; std::getline(file, line);)
+    {
+        std::istringstream fields(line);
+        ManifestEntry entry;
+        std::string sourcePath;
+        std::string imports;
+        if (!std::getline(fields, entry.unitName, '\t') || !std::getline(fields, sourcePath, '\t'))
+        {
+            continue;
+        }
+        fields >> std::hex >> entry.contentHash >> entry.interfaceHash >> entry.optionsHash >> entry.importsHash;
+        if (fields.fail())
+        {
+            continue;
+        }
+        fields >> imports;
+        std::istringstream importList(imports);
+        for (std::string import; std::getline(importList, import, ',');)
+        {
+            if (!import.empty())
+                entry.imports.push_back(import);
+        }
+        entry.sourcePath = sourcePath;
+        m_entries[sourcePath] = entry;
+    }
+}
+
+bool BuildManifest::save() const
+{
+    std::ofstream file(m_path, std::ios::trunc);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    for (const auto &entry: m_entries | std::views::values)
+    {
+        file << entry.unitName << '\t' << entry.sourcePath.string() << '\t' << std::hex << entry.contentHash << ' '
+             << entry.interfaceHash << ' ' << entry.optionsHash << ' ' << entry.importsHash << ' ';
+        for (size_t i = 0; i < entry.imports.size(); ++i)
+        {
+            file << (i > 0 ? "," : "") << entry.imports[i];
+        }
+        file << '\n';
+    }
+    return file.good();
+}
+
+std::optional<ManifestEntry> BuildManifest::find(const std::filesystem::path &sourcePath) const
+{
+    if (const auto it = m_entries.find(sourcePath.string()); it != m_entries.end())
+    {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+void BuildManifest::update(const ManifestEntry &entry) { m_entries[entry.sourcePath.string()] = entry; }
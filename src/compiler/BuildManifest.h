@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * describes the state of a unit at the time its object file was created.
+ */
+struct ManifestEntry
+{
+    std::string unitName;
+    std::filesystem::path sourcePath;
+    uint64_t contentHash = 0;
+    uint64_t interfaceHash = 0;
+    uint64_t optionsHash = 0;
+    // combined interface hash of the imported units
+    uint64_t importsHash = 0;
+    std::vector<std::string> imports;
+};
+
+/**
+ * the dependency manifest of the object files in an output directory, used for incremental builds.
+ */
+class BuildManifest
+{
+    std::filesystem::path m_path;
+    std::map<std::string, ManifestEntry> m_entries;
+
+public:
+    explicit BuildManifest(std::filesystem::path path);
+    ~BuildManifest() = default;
+
+    void load();
+    bool save() const;
+
+    [[nodiscard]] std::optional<ManifestEntry> find(const std::filesystem::path &sourcePath) const;
+    void update(const ManifestEntry &entry);
+};
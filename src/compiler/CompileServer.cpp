@@ -0,0 +1,179 @@
+#include "compiler/CompileServer.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include "compiler/Compiler.h"
+#include "os/socket.h"
+
+// every field is prefixed with its size
+std::string encodeFields(const std::vector<std::string> &fields)
+{
+    std::string message;
+    for (auto &field: fields)
+    {
+        const uint64_t size = field.size();
+        message.append(reinterpret_cast<const char *>(&size), sizeof(size));
+        message.append(field);
+    }
+    return message;
+}
+
+std::optional<std::vector<std::string>> decodeFields(const std::string &message)
+{
+    std::vector<std::string> fields;
+    size_t position = 0;
+    while (position < message.size())
+    {
+        uint64_t size = 0;
+        if (message.size() - position < sizeof(size))
+            return std::nullopt;
+        std::memcpy(&size, message.data() + position, sizeof(size));
+        position += sizeof(size);
+        if (message.size() - position < size)
+            return std::nullopt;
+        fields.emplace_back(message.substr(position, size));
+        position += size;
+    }
+    return fields;
+}
+
+static int runCompileRequest(const CompilerOptions &options, const std::vector<std::string> &argList,
+                             std::ostream &outputStream, std::ostream &errorStream)
+{
+    if (!options.serverSocket.empty() || !options.connectSocket.empty())
+    {
+        errorStream << "a request to the compiler server can not start or connect to another server\n";
+        return 1;
+    }
+    if (options.option == CompileOption::BUILD_RTL)
+    {
+        return build_rtl(options, errorStream, outputStream) ? 0 : 1;
+    }
+    if (argList.empty())
+    {
+        errorStream << "input file is missing\n";
+        return 1;
+    }
+    const std::filesystem::path filePath(argList[0]);
+    if (!std::filesystem::exists(filePath))
+    {
+        errorStream << "the first argument is not a valid input file\n";
+        return 1;
+    }
+    switch (options.option)
+    {
+        case CompileOption::COMPILE:
+            return compile_file(options, filePath, outputStream, outputStream, outputStream) ? 0 : 1;
+        case CompileOption::JIT:
+            return jit_file(options, filePath, outputStream, outputStream, outputStream) ? 0 : 1;
+        case CompileOption::BUILD_RTL:
+            break;
+    }
+    return 0;
+}
+
+/**
+ * handles a request of a client, it consists of the working directory of the client and its command line arguments.
+ * The reply contains the exit code, the standard output and the error output of the compilation.
+ */
+static std::string handleCompileRequest(const CompilerOptions &serverOptions, const std::string &request)
+{
+    std::stringstream output;
+    std::stringstream errors;
+    int exitCode = 1;
+    const auto fields = decodeFields(request);
+    std::error_code error;
+    if (!fields || fields->empty())
+    {
+        errors << "invalid request\n";
+    }
+    else if (std::filesystem::current_path(fields->front(), error); error)
+    {
+        errors << "the working directory " << fields->front() << " is not valid: " << error.message() << "\n";
+    }
+    else
+    {
+        // a failing request must not end the server, it is answered like a failed compilation
+        try
+        {
+            std::vector<std::string> argList = {serverOptions.compilerPath};
+            argList.insert(argList.end(), fields->begin() + 1, fields->end());
+            auto options = parseCompilerOptions(argList);
+            for (auto &rtlDirectory: serverOptions.rtlDirectories)
+            {
+                options.rtlDirectories.push_back(rtlDirectory);
+            }
+            if (options.cacheDirectory.empty())
+            {
+                options.cacheDirectory = serverOptions.cacheDirectory;
+            }
+            exitCode = runCompileRequest(options, argList, output, errors);
+        }
+        catch (const std::exception &e)
+        {
+            errors << "the compilation failed: " << e.what() << "\n";
+            exitCode = 1;
+        }
+        catch (...)
+        {
+            errors << "the compilation failed\n";
+            exitCode = 1;
+        }
+    }
+    return encodeFields({std::to_string(exitCode), output.str(), errors.str()});
+}
+
+int run_compile_server(const CompilerOptions &options)
+{
+    // the requests change the working directory, so all paths of the server have to be absolute
+    CompilerOptions serverOptions = options;
+    serverOptions.compilerPath = std::filesystem::absolute(options.compilerPath).string();
+    for (auto &rtlDirectory: serverOptions.rtlDirectories)
+    {
+        rtlDirectory = std::filesystem::absolute(rtlDirectory);
+    }
+    if (!serverOptions.cacheDirectory.empty())
+    {
+        serverOptions.cacheDirectory = std::filesystem::absolute(serverOptions.cacheDirectory);
+    }
+
+    init_compiler();
+    std::cout << "listening on " << options.serverSocket << "\n";
+    const auto handler = [&serverOptions](const std::string &request)
+    { return handleCompileRequest(serverOptions, request); };
+    return serve_local_socket(std::cerr, options.serverSocket, handler) ? 0 : 1;
+}
+
+int run_compile_client(const CompilerOptions &options, std::vector<std::string> arguments)
+{
+    if (const auto it = std::ranges::find(arguments, "--connect"); it != arguments.end())
+    {
+        // removes the option and the socket path
+        arguments.erase(it, it + std::min<std::ptrdiff_t>(2, std::distance(it, arguments.end())));
+    }
+
+    std::vector<std::string> fields = {std::filesystem::current_path().string()};
+    fields.insert(fields.end(), arguments.begin(), arguments.end());
+    const auto reply = request_local_socket(std::cerr, options.connectSocket, encodeFields(fields));
+    if (!reply)
+    {
+        return 1;
+    }
+    const auto result = decodeFields(*reply);
+    if (!result || result->size() != 3)
+    {
+        std::cerr << "invalid reply from the compiler server\n";
+        return 1;
+    }
+    std::cout << (*result)[1];
+    std::cerr << (*result)[2];
+
+    int exitCode = 1;
+    std::from_chars((*result)[0].data(), (*result)[0].data() + (*result)[0].size(), exitCode);
+    return exitCode;
+}
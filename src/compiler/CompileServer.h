@@ -0,0 +1,29 @@
+#pragma once
+#include <optional>
+#include <string>
+#include <vector>
+#include "compiler/CompilerOptions.h"
+
+/**
+ * encodes the fields of a message between the client and the server.
+ * A request consists of the working directory of the client and its command line arguments, a reply of the exit code,
+ * the standard output and the error output of the compilation.
+ */
+std::string encodeFields(const std::vector<std::string> &fields);
+/**
+ * returns the fields of a message or nothing if the message is malformed.
+ */
+std::optional<std::vector<std::string>> decodeFields(const std::string &message);
+
+/**
+ * runs the compiler as a server on the local socket of the options.
+ * The server keeps the initialized targets, the target machines and the parsed units of the rtl between the
+ * requests, so the clients do not pay for them on every invocation.
+ */
+int run_compile_server(const CompilerOptions &options);
+
+/**
+ * sends the command line arguments to the server of the options and prints its output like a normal compile.
+ * returns the exit code of the request.
+ */
+int run_compile_client(const CompilerOptions &options, std::vector<std::string> arguments);
@@ -1,40 +1,54 @@
 #include "compiler/Compiler.h"
 
 #include <MacroParser.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
 #include <filesystem>
-#include <fstream>
+#include <future>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <set>
 #include <sstream>
+#include <stdexcept>
 #include "Lexer.h"
 #include "Parser.h"
+#include "ast/Binder.h"
 #include "ast/FunctionDefinitionNode.h"
 #include "ast/UnitNode.h"
 
+#include "compiler/BuildManifest.h"
 #include "compiler/Context.h"
 #include "compiler/intrinsics.h"
 #include "linker/pascal_linker.h"
 #include "llvm/IR/PassManager.h"
 
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
 #include "llvm/IR/LegacyPassManager.h"
 
 #include "llvm/IR/Verifier.h"
 #include "llvm/LTO/LTO.h"
+#include "llvm/Linker/Linker.h"
 #include "llvm/MC/TargetRegistry.h"
 #include "llvm/Passes/PassBuilder.h"
-#include "llvm/Passes/StandardInstrumentations.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_os_ostream.h"
 #include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Target/TargetOptions.h"
 #include "llvm/TargetParser/Host.h"
-#include "llvm/Transforms/IPO/AlwaysInliner.h"
-#include "llvm/Transforms/InstCombine/InstCombine.h"
-#include "llvm/Transforms/Scalar/GVN.h"
-#include "llvm/Transforms/Scalar/MemCpyOptimizer.h"
-#include "llvm/Transforms/Scalar/Reassociate.h"
-#include "llvm/Transforms/Scalar/SCCP.h"
-#include "llvm/Transforms/Scalar/SimplifyCFG.h"
+#include "llvm/Transforms/IPO/Internalize.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 #include "os/command.h"
 
 static auto TargetTriple = llvm::sys::getDefaultTargetTriple();
@@ -45,53 +59,14 @@ std::unique_ptr<Context> InitializeModule(std::unique_ptr<UnitNode> &unit, const
     context->compilerOptions = options;
     // Open a new context and module.
     context->TheContext = std::make_unique<llvm::LLVMContext>();
+    static std::atomic<uint64_t> generation = 0;
+    context->Generation = ++generation;
     context->TheModule = std::make_unique<llvm::Module>(unit->getUnitName(), *context->TheContext);
 
     // Create a new builder for the module.
     context->Builder = std::make_unique<llvm::IRBuilder<>>(*context->TheContext);
-    // Create new pass and analysis managers.
-    context->TheFPM = std::make_unique<llvm::FunctionPassManager>();
-    const auto TheLAM = std::make_unique<llvm::LoopAnalysisManager>();
-    context->TheFAM = std::make_unique<llvm::FunctionAnalysisManager>();
-    const auto TheCGAM = std::make_unique<llvm::CGSCCAnalysisManager>();
-    context->TheMAM = std::make_unique<llvm::ModuleAnalysisManager>();
-    context->ThePIC = std::make_unique<llvm::PassInstrumentationCallbacks>();
-    context->TheSI = std::make_unique<llvm::StandardInstrumentations>(*context->TheContext,
-                                                                      /*DebugLogging*/ true);
-
-    context->TheSI->registerCallbacks(*context->ThePIC, context->TheMAM.get());
     context->TargetTriple = std::make_unique<llvm::Triple>(TargetTriple);
 
-    // Add transform passes.
-    // Do simple "peephole" optimizations and bit-twiddling optzns.
-    if (context->compilerOptions.buildMode == BuildMode::Release)
-    {
-        context->TheFPM->addPass(llvm::InstCombinePass());
-        // Reassociate expressions.
-        context->TheFPM->addPass(llvm::ReassociatePass());
-        // Eliminate Common SubExpressions.
-        context->TheFPM->addPass(llvm::GVNPass());
-        // Simplify the control flow graph (deleting unreachable blocks, etc).
-        context->TheFPM->addPass(llvm::SimplifyCFGPass());
-
-        context->TheFPM->addPass(llvm::SCCPPass());
-
-        context->TheFPM->addPass(llvm::LoopSimplifyPass());
-
-        context->TheFPM->addPass(llvm::MemCpyOptPass());
-    }
-
-
-    // context->TheFPM->addPass(llvm::createLoopSimplifyPass());
-
-    // Register analysis passes used in these transform passes.
-    llvm::PassBuilder PB;
-
-    PB.registerModuleAnalyses(*context->TheMAM);
-    PB.registerFunctionAnalyses(*context->TheFAM);
-    PB.crossRegisterProxies(*TheLAM, *context->TheFAM, *TheCGAM, *context->TheMAM);
-
-
     context->ProgramUnit = std::move(unit);
     return context;
 }
@@ -111,84 +86,34 @@ void init_compiler()
     InitializeNativeTargetAsmParser();
     InitializeNativeTargetAsmPrinter();
 }
-void compile_file(const CompilerOptions &options, const std::filesystem::path &inputPath, std::ostream &errorStream,
-                  std::ostream &outputStream)
+static MacroMap createTargetDefines(const llvm::Triple &target)
 {
-    std::ifstream file;
-    std::istringstream is;
-
-    file.open(inputPath, std::ios::in);
-    if (!file.is_open())
-    {
-        return;
-    }
-    file.seekg(0, std::ios::end);
-    std::streamsize size = file.tellg();
-    std::string buffer(size, ' ');
-    file.seekg(0);
-    file.read(&buffer[0], size);
-
-
-    using namespace llvm;
-    using namespace llvm::sys;
-
-
-    std::string Error;
-    auto Target = llvm::TargetRegistry::lookupTarget(TargetTriple, Error);
-
-    // Print an error and exit if we couldn't find the requested target.
-    // This generally occurs if we've forgotten to initialise the
-    // TargetRegistry or we have a bogus target triple.
-    if (!Target)
-    {
-        errs() << Error;
-        return;
-    }
-
-    auto CPU = "generic";
-    auto Features = "";
-
-    TargetOptions opt;
-    auto TheTargetMachine = Target->createTargetMachine(TargetTriple, CPU, Features, opt, Reloc::PIC_);
-    Triple target(TargetTriple);
-    Lexer lexer;
     MacroMap defines;
     switch (target.getOS())
     {
-        case Triple::Darwin:
-        case Triple::Linux:
-        case Triple::OpenBSD:
-        case Triple::FreeBSD:
+        case llvm::Triple::Darwin:
+        case llvm::Triple::Linux:
+        case llvm::Triple::OpenBSD:
+        case llvm::Triple::FreeBSD:
             defines["UNIX"] = true;
             break;
-        case Triple::Win32:
+        case llvm::Triple::Win32:
             defines["WINDOWS"] = true;
             break;
         default:
             break;
     }
     defines.insert(std::make_pair(target.getArchName(), true));
+    return defines;
+}
 
-
-    auto tokens = lexer.tokenize(inputPath.string(), buffer);
-    MacroParser macroParser(defines);
-    Parser parser(options.rtlDirectories, inputPath, macroParser.macroDefinitions(), macroParser.parseFile(tokens));
-    auto unit = parser.parseFile();
-    if (parser.hasError())
-    {
-        parser.printErrors(errorStream, options.colorOutput);
-        return;
-    }
-    if (parser.hasMessages())
-    {
-        parser.printErrors(errorStream, options.colorOutput);
-    }
-    auto context = InitializeModule(unit, options);
+static void createSystemFunctions(std::unique_ptr<Context> &context, const llvm::Triple &target)
+{
+    using namespace llvm;
     auto intType = VariableType::getInteger();
     auto int64Type = VariableType::getInteger(64);
     auto int8Type = VariableType::getInteger(8);
     auto pCharType = ::PointerType::getPointerTo(VariableType::getInteger(8));
-    context->TheModule->setDataLayout(TheTargetMachine->createDataLayout());
 
     createSystemCall(context, "exit", {FunctionArgument{.type = intType, .argumentName = "X", .isReference = false}});
     createSystemCall(context, "fflush",
@@ -239,80 +164,846 @@ void compile_file(const CompilerOptions &options, const std::filesystem::path &i
     createRewriteCall(context);
     createCloseFileCall(context);
     createReadLnCall(context);
+}
+
+static llvm::CodeGenOptLevel toCodeGenOptLevel(const OptimizationLevel level)
+{
+    switch (level)
+    {
+        case OptimizationLevel::O0:
+            return llvm::CodeGenOptLevel::None;
+        case OptimizationLevel::O1:
+            return llvm::CodeGenOptLevel::Less;
+        case OptimizationLevel::O3:
+            return llvm::CodeGenOptLevel::Aggressive;
+        case OptimizationLevel::O2:
+        case OptimizationLevel::Os:
+            break;
+    }
+    return llvm::CodeGenOptLevel::Default;
+}
+
+/**
+ * runs the default module pipeline of the new pass manager for the selected optimization level.
+ * The target machine is passed to the pass builder so that the cost models of the inliner and the
+ * vectorizers know the real target.
+ */
+static void optimizeModule(llvm::Module &module, llvm::TargetMachine *targetMachine, const OptimizationLevel level)
+{
+    llvm::LoopAnalysisManager loopAnalysisManager;
+    llvm::FunctionAnalysisManager functionAnalysisManager;
+    llvm::CGSCCAnalysisManager cgsccAnalysisManager;
+    llvm::ModuleAnalysisManager moduleAnalysisManager;
+
+    llvm::PassBuilder passBuilder(targetMachine);
+    passBuilder.registerModuleAnalyses(moduleAnalysisManager);
+    passBuilder.registerCGSCCAnalyses(cgsccAnalysisManager);
+    passBuilder.registerFunctionAnalyses(functionAnalysisManager);
+    passBuilder.registerLoopAnalyses(loopAnalysisManager);
+    passBuilder.crossRegisterProxies(loopAnalysisManager, functionAnalysisManager, cgsccAnalysisManager,
+                                     moduleAnalysisManager);
+
+    llvm::ModulePassManager modulePassManager;
+    switch (level)
+    {
+        case OptimizationLevel::O0:
+            // still runs the always inliner, the intrinsics rely on it
+            modulePassManager = passBuilder.buildO0DefaultPipeline(llvm::OptimizationLevel::O0);
+            break;
+        case OptimizationLevel::O1:
+            modulePassManager = passBuilder.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O1);
+            break;
+        case OptimizationLevel::O2:
+            modulePassManager = passBuilder.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O2);
+            break;
+        case OptimizationLevel::O3:
+            modulePassManager = passBuilder.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O3);
+            break;
+        case OptimizationLevel::Os:
+            modulePassManager = passBuilder.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::Os);
+            break;
+    }
+    modulePassManager.run(module, moduleAnalysisManager);
+}
+
+/**
+ * returns a copy of the options with the target cpu resolved.
+ * An empty cpu is replaced by the default cpu and "native" by the cpu name and the features of the host.
+ * Explicitly given features are appended to the host features, so they take precedence.
+ */
+static CompilerOptions resolveTargetCPU(CompilerOptions options, const std::string &defaultCPU)
+{
+    if (options.targetCPU.empty())
+    {
+        options.targetCPU = defaultCPU;
+    }
+    if (options.targetCPU != "native")
+    {
+        return options;
+    }
+    options.targetCPU = llvm::sys::getHostCPUName().str();
+
+    std::string features;
+    llvm::StringMap<bool> hostFeatures;
+    if (llvm::sys::getHostCPUFeatures(hostFeatures))
+    {
+        for (const auto &feature: hostFeatures)
+        {
+            if (!features.empty())
+            {
+                features += ",";
+            }
+            features += (feature.getValue() ? "+" : "-") + feature.getKey().str();
+        }
+    }
+    if (!options.targetFeatures.empty())
+    {
+        features += features.empty() ? options.targetFeatures : "," + options.targetFeatures;
+    }
+    options.targetFeatures = features;
+    return options;
+}
+
+/**
+ * creates the target machine for the object files, returns nullptr if the target is not available.
+ */
+static llvm::TargetMachine *createTargetMachine(const CompilerOptions &targetOptions, std::ostream &errorStream)
+{
+    using namespace llvm;
+    std::string Error;
+    auto Target = llvm::TargetRegistry::lookupTarget(TargetTriple, Error);
+
+    // Print an error and exit if we couldn't find the requested target.
+    // This generally occurs if we've forgotten to initialise the
+    // TargetRegistry or we have a bogus target triple.
+    if (!Target)
+    {
+        errorStream << Error << "\n";
+        return nullptr;
+    }
+
+    TargetOptions opt;
+    return Target->createTargetMachine(TargetTriple, targetOptions.targetCPU, targetOptions.targetFeatures, opt,
+                                       Reloc::PIC_, std::nullopt, toCodeGenOptLevel(targetOptions.optimizationLevel));
+}
+
+/**
+ * returns the target machine for the options.
+ * The machines are kept for the lifetime of the process, so the compilations of a server do not create them again.
+ */
+static llvm::TargetMachine *getTargetMachine(const CompilerOptions &targetOptions, std::ostream &errorStream)
+{
+    static std::mutex targetMachinesMutex;
+    static std::map<std::string, std::unique_ptr<llvm::TargetMachine>> targetMachines;
+
+    const auto key = targetOptions.targetCPU + ";" + targetOptions.targetFeatures + ";" +
+                     std::to_string(static_cast<int>(targetOptions.optimizationLevel));
+    std::scoped_lock lock(targetMachinesMutex);
+    auto &targetMachine = targetMachines[key];
+    if (!targetMachine)
+    {
+        targetMachine.reset(createTargetMachine(targetOptions, errorStream));
+    }
+    return targetMachine.get();
+}
+
+/**
+ * returns the names of the units whose functions are used by the given unit.
+ */
+static std::vector<std::string> collectUsedUnits(UnitNode &unit)
+{
+    std::set<std::string> unitNames;
+    for (auto &function: unit.getFunctionDefinitions())
+    {
+        if (!function->unitName().empty() && function->unitName() != unit.getUnitName())
+        {
+            unitNames.insert(function->unitName());
+        }
+    }
+    return {unitNames.begin(), unitNames.end()};
+}
+
+/**
+ * finds the source file of a unit. The units are searched in the same order as Parser::importUnit does.
+ */
+static std::optional<std::filesystem::path> findUnitSource(const CompilerOptions &options,
+                                                           const std::filesystem::path &inputPath,
+                                                           const std::string &unitName)
+{
+    std::vector<std::filesystem::path> searchPath = {inputPath.parent_path()};
+    searchPath.insert(searchPath.end(), options.rtlDirectories.begin(), options.rtlDirectories.end());
+    for (auto &directory: searchPath)
+    {
+        auto sourcePath = directory / (unitName + ".pas");
+        if (std::filesystem::exists(sourcePath))
+        {
+            return sourcePath;
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * maps the source file into the source file table, the lexer and the diagnostics read it from there.
+ */
+static std::optional<SourceFileReference> loadSourceFile(const std::filesystem::path &inputPath)
+{
+    return SourceFiles::map(inputPath.string(), inputPath);
+}
+
+static uint64_t hashSource(const uint32_t fileId)
+{
+    const auto source = SourceFiles::source(fileId);
+    return llvm::xxHash64(llvm::StringRef(source.data(), source.size()));
+}
+
+/**
+ * hashes the tokens of the interface section of a unit.
+ * Changes to comments or to the implementation do not change the hash, so the importing units are not rebuilt.
+ */
+static uint64_t hashUnitInterface(const uint32_t fileId)
+{
+    Lexer lexer;
+    std::string interface;
+    for (auto &token: lexer.tokenize(fileId))
+    {
+        if (token.keyword() == Keyword::IMPLEMENTATION)
+        {
+            break;
+        }
+        interface += token.lexical();
+        interface += ' ';
+    }
+    return llvm::xxHash64(interface);
+}
+
+/**
+ * hashes the options which change the generated code of a unit: the target, the optimization level, the cpu, its
+ * features and the defines of the target.
+ */
+static uint64_t hashTargetOptions(const CompilerOptions &options)
+{
+    std::stringstream key;
+    key << TargetTriple << ';' << static_cast<int>(options.optimizationLevel) << ';' << options.targetCPU << ';'
+        << options.targetFeatures;
+    std::vector<std::string> defines;
+    for (auto &[name, value]: createTargetDefines(llvm::Triple(TargetTriple)))
+    {
+        defines.push_back(name + (value ? "=1" : "=0"));
+    }
+    std::ranges::sort(defines);
+    for (auto &define: defines)
+    {
+        key << ';' << define;
+    }
+    return llvm::xxHash64(key.str());
+}
+
+/**
+ * returns the names of the units in the uses clauses of a unit without parsing it, including both branches of
+ * conditional imports. Every unit except the system unit imports the system unit.
+ */
+static std::vector<std::string> scanUnitImports(const uint32_t fileId, const std::string &unitName)
+{
+    std::vector<std::string> imports;
+    bool inUses = false;
+    for (auto &token: Lexer().tokenize(fileId))
+    {
+        if (token.keyword() == Keyword::USES)
+        {
+            inUses = true;
+        }
+        else if (inUses && token.tokenType() == TokenType::NAMEDTOKEN)
+        {
+            imports.emplace_back(token.lexical());
+        }
+        else if (token.tokenType() == TokenType::SEMICOLON)
+        {
+            inUses = false;
+        }
+    }
+    if (unitName != "system")
+    {
+        imports.emplace_back("system");
+    }
+    return imports;
+}
+
+/**
+ * the bitcode of a precompiled unit is only valid for the options, the source of the unit and the interfaces of its
+ * imports with which it was generated. A hash of them is part of the file name: <unit>.<key>.bc
+ */
+static std::optional<std::filesystem::path> precompiledUnitPath(const CompilerOptions &options,
+                                                                const std::filesystem::path &sourcePath)
+{
+    const auto file = loadSourceFile(sourcePath);
+    if (!file)
+    {
+        return std::nullopt;
+    }
+    std::string key = std::to_string(hashTargetOptions(options)) + ";" + std::to_string(hashSource(file->fileId()));
+    for (auto &import: scanUnitImports(file->fileId(), sourcePath.stem().string()))
+    {
+        const auto importPath = findUnitSource(options, sourcePath, import);
+        const auto importFile = importPath ? loadSourceFile(*importPath) : std::nullopt;
+        key += ";" + import + ":" + (importFile ? std::to_string(hashUnitInterface(importFile->fileId())) : "");
+    }
+    auto bitcodePath = sourcePath;
+    bitcodePath.replace_extension("." + llvm::utohexstr(llvm::xxHash64(key), true) + ".bc");
+    return bitcodePath;
+}
+
+/**
+ * finds the units used by the program which have a bitcode file for the current options next to their source.
+ */
+static std::map<std::string, std::filesystem::path> findPrecompiledUnits(const CompilerOptions &options,
+                                                                         const std::filesystem::path &inputPath,
+                                                                         UnitNode &unit)
+{
+    std::map<std::string, std::filesystem::path> result;
+    for (auto &unitName: collectUsedUnits(unit))
+    {
+        const auto sourcePath = findUnitSource(options, inputPath, unitName);
+        if (!sourcePath)
+        {
+            continue;
+        }
+        if (const auto bitcodePath = precompiledUnitPath(options, *sourcePath);
+            bitcodePath && std::filesystem::exists(*bitcodePath))
+        {
+            result[unitName] = *bitcodePath;
+        }
+    }
+    return result;
+}
+
+/**
+ * links the functions of the precompiled units which are used by the module into it.
+ * The units are combined first, so that functions of a unit which are only used by another unit are found as well.
+ */
+static bool linkPrecompiledUnits(std::unique_ptr<Context> &context,
+                                 const std::map<std::string, std::filesystem::path> &units, std::ostream &errorStream)
+{
+    if (units.empty())
+    {
+        return true;
+    }
+    auto combinedUnits = std::make_unique<llvm::Module>("units", *context->TheContext);
+    combinedUnits->setDataLayout(context->TheModule->getDataLayout());
+    llvm::Linker unitLinker(*combinedUnits);
+    for (auto &[unitName, bitcodePath]: units)
+    {
+        auto buffer = llvm::MemoryBuffer::getFile(bitcodePath.string());
+        if (!buffer)
+        {
+            errorStream << "could not read " << bitcodePath.string() << ": " << buffer.getError().message() << "\n";
+            return false;
+        }
+        auto unitModule = llvm::parseBitcodeFile(buffer.get()->getMemBufferRef(), *context->TheContext);
+        if (!unitModule)
+        {
+            errorStream << bitcodePath.string() << ": " << llvm::toString(unitModule.takeError()) << "\n";
+            return false;
+        }
+        (*unitModule)->setDataLayout(context->TheModule->getDataLayout());
+        if (unitLinker.linkInModule(std::move(*unitModule)))
+        {
+            errorStream << "could not link the precompiled unit " << unitName << "\n";
+            return false;
+        }
+    }
+    // every function of the used units is declared, the unused declarations would pull in all of them
+    for (auto &function: llvm::make_early_inc_range(*context->TheModule))
+    {
+        if (function.isDeclaration() && function.use_empty())
+        {
+            function.eraseFromParent();
+        }
+    }
+    return !llvm::Linker::linkModules(
+            *context->TheModule, std::move(combinedUnits), llvm::Linker::LinkOnlyNeeded,
+            [](llvm::Module &module, const llvm::StringSet<> &linkedSymbols)
+            {
+                // the program is the only user of the linked functions
+                llvm::internalizeModule(module, [&linkedSymbols](const llvm::GlobalValue &value)
+                                        { return !value.hasName() || !linkedSymbols.contains(value.getName()); });
+            });
+}
+
+// the minimum size of a chunk of a source file which is lexed on its own thread
+static constexpr size_t MIN_CHUNK_SIZE = 4 * 1024 * 1024;
+
+/**
+ * parses the source of a program or unit, returns nullptr and prints the errors if it contains errors.
+ */
+static std::unique_ptr<UnitNode> parseSourceFile(const CompilerOptions &options, const std::filesystem::path &inputPath,
+                                                 const uint32_t fileId, std::ostream &errorStream)
+{
+    llvm::Triple target(TargetTriple);
+    MacroMap defines = createTargetDefines(target);
+
+    // the identifiers and the source files are interned for the whole process, a compiler server may exhaust them
+    try
+    {
+        // the tokens are lexed and the macros are evaluated on demand while the parser pulls them, only very large
+        // files are lexed up front in chunks on the threads of the jobs
+        std::unique_ptr<TokenSource> source;
+        if (const size_t chunkCount =
+                    std::min<size_t>(options.jobs, SourceFiles::source(fileId).size() / MIN_CHUNK_SIZE);
+            chunkCount > 1)
+        {
+            source = std::make_unique<TokenVectorSource>(Lexer().tokenize(fileId, chunkCount));
+        }
+        else
+        {
+            source = std::make_unique<LexerSource>(fileId);
+        }
+        auto tokens = std::make_unique<MacroParser>(defines, std::move(source));
+        Parser parser(options.rtlDirectories, inputPath, defines, std::move(tokens));
+        if (!options.cacheDirectory.empty())
+        {
+            // only the interfaces of the units whose functions are not generated with the module are loaded from the
+            // cache, their bodies are linked in from the object files of the units or from their precompiled bitcode
+            parser.setInterfaceCache(
+                    options.cacheDirectory,
+                    [options, inputPath, target](const std::filesystem::path &unitPath)
+                    {
+                        // compile_file builds the whole program in one module on windows, even if it is incremental
+                        if (target.getOS() == llvm::Triple::Win32)
+                        {
+                            return false;
+                        }
+                        if (options.option == CompileOption::COMPILE && options.incremental)
+                        {
+                            return true;
+                        }
+                        // the unit has to be the one which generateModule finds the bitcode for
+                        std::error_code error;
+                        const auto sourcePath = findUnitSource(options, inputPath, unitPath.stem().string());
+                        if (!sourcePath || !std::filesystem::equivalent(*sourcePath, unitPath, error))
+                        {
+                            return false;
+                        }
+                        const auto bitcodePath = precompiledUnitPath(options, unitPath);
+                        return bitcodePath && std::filesystem::exists(*bitcodePath);
+                    });
+        }
+        auto unit = parser.parseFile();
+        if (parser.hasError())
+        {
+            parser.printErrors(errorStream, options.colorOutput);
+            return nullptr;
+        }
+        if (parser.hasMessages())
+        {
+            parser.printErrors(errorStream, options.colorOutput);
+        }
+        return unit;
+    }
+    catch (const std::length_error &e)
+    {
+        errorStream << inputPath.string() << " could not be compiled: " << e.what() << "\n";
+        return nullptr;
+    }
+}
+
+/**
+ * generates the llvm module for the parsed program or unit.
+ * Functions of units with precompiled bitcode are not generated again but linked in from the bitcode.
+ * With separateUnits no function of a used unit is generated, they are linked from the object files of the units.
+ * The module is optimized for the given target machine according to the selected optimization level.
+ * returns nullptr if the code generation failed.
+ */
+static std::unique_ptr<Context> generateModule(const CompilerOptions &options, const std::filesystem::path &inputPath,
+                                               std::unique_ptr<UnitNode> unit, llvm::TargetMachine *targetMachine,
+                                               std::ostream &errorStream, std::ostream &messageStream,
+                                               const bool separateUnits = false)
+{
+    llvm::Triple target(TargetTriple);
+    auto context = InitializeModule(unit, options);
+    context->TheModule->setDataLayout(targetMachine->createDataLayout());
+
+    createSystemFunctions(context, target);
+
+    // the standard streams of a unit module are not initialized on windows
+    std::map<std::string, std::filesystem::path> precompiledUnits;
+    if (separateUnits)
+    {
+        for (auto &unitName: collectUsedUnits(*context->ProgramUnit))
+        {
+            context->PrecompiledUnits.insert(unitName);
+        }
+    }
+    else if (context->ProgramUnit->getUnitType() == UnitType::PROGRAM && target.getOS() != llvm::Triple::Win32)
+    {
+        precompiledUnits = findPrecompiledUnits(options, inputPath, *context->ProgramUnit);
+    }
+    for (auto &unitName: precompiledUnits | std::views::keys)
+    {
+        context->PrecompiledUnits.insert(unitName);
+    }
 
     try
     {
         context->ProgramUnit->typeCheck(context->ProgramUnit, nullptr);
+        Binder binder;
+        context->ProgramUnit->bind(binder);
         context->ProgramUnit->codegen(context);
     }
     catch (CompilerException &e)
     {
         errorStream << e.what();
-        return;
+        return nullptr;
+    }
+    if (!linkPrecompiledUnits(context, precompiledUnits, errorStream))
+    {
+        return nullptr;
     }
 
+    llvm::raw_os_ostream messages(messageStream);
+    llvm::verifyModule(*context->TheModule, &messages);
+    optimizeModule(*context->TheModule, targetMachine, options.optimizationLevel);
+    if (context->compilerOptions.printLLVMIR)
+    {
+        context->TheModule->print(messages, nullptr, false, false);
+    }
+    return context;
+}
 
-    auto basePath = context->compilerOptions.outputDirectory;
+bool generate_ir(const CompilerOptions &options, std::unique_ptr<UnitNode> unit, std::ostream &errorStream)
+{
+    auto context = InitializeModule(unit, options);
+    createSystemFunctions(context, llvm::Triple(TargetTriple));
+    try
+    {
+        context->ProgramUnit->typeCheck(context->ProgramUnit, nullptr);
+        Binder binder;
+        context->ProgramUnit->bind(binder);
+        context->ProgramUnit->codegen(context);
+    }
+    catch (CompilerException &e)
+    {
+        errorStream << e.what();
+        return false;
+    }
+    return true;
+}
 
+/**
+ * parses the given file and generates the llvm module for it.
+ * returns nullptr if the file could not be parsed or the code generation failed.
+ */
+static std::unique_ptr<Context> generateModule(const CompilerOptions &options, const std::filesystem::path &inputPath,
+                                               llvm::TargetMachine *targetMachine, std::ostream &errorStream,
+                                               std::ostream &messageStream)
+{
+    const auto file = loadSourceFile(inputPath);
+    if (!file)
+    {
+        return nullptr;
+    }
+    auto unit = parseSourceFile(options, inputPath, file->fileId(), errorStream);
+    if (!unit)
+    {
+        return nullptr;
+    }
+    return generateModule(options, inputPath, std::move(unit), targetMachine, errorStream, messageStream);
+}
 
-    auto objectFileName = basePath / (context->ProgramUnit->getUnitName() + ".o");
-    std::vector<std::string> objectFiles;
-    objectFiles.emplace_back(objectFileName.string());
+static bool emitObjectFile(llvm::Module &module, llvm::TargetMachine *targetMachine,
+                           const std::filesystem::path &objectFileName, std::ostream &errorStream,
+                           std::ostream &messageStream)
+{
+    using namespace llvm;
     std::error_code EC;
     raw_fd_ostream dest(objectFileName.string(), EC, sys::fs::OF_None);
 
     if (EC)
     {
-        errs() << "Could not open file: " << EC.message();
-        return;
+        errorStream << "Could not open file: " << EC.message() << "\n";
+        return false;
     }
 
     legacy::PassManager pass;
-    if (context->compilerOptions.buildMode == BuildMode::Release)
+    if (targetMachine->addPassesToEmitFile(pass, dest, nullptr, CodeGenFileType::ObjectFile))
     {
-        pass.add(llvm::createAlwaysInlinerLegacyPass());
-        pass.add(llvm::createInstructionCombiningPass());
-        TheTargetMachine->setOptLevel(CodeGenOptLevel::Aggressive);
+        errorStream << "TheTargetMachine can't emit a file of this type\n";
+        return false;
     }
-    else
+
+    pass.run(module);
+    dest.flush();
+    dest.close();
+
+    messageStream << "Wrote " << objectFileName.string() << "\n";
+    return true;
+}
+
+/**
+ * splits the module into the given number of partitions and emits the object file of every partition on its own
+ * thread with its own target machine.
+ * The partitions are moved into separate LLVMContexts through bitcode, because a context must not be used by more
+ * than one thread at a time.
+ */
+static bool emitObjectFiles(llvm::Module &module, const CompilerOptions &targetOptions,
+                            const std::filesystem::path &basePath, const std::string &unitName,
+                            std::vector<std::string> &objectFiles, std::ostream &errorStream,
+                            std::ostream &messageStream)
+{
+    using namespace llvm;
+    std::vector<SmallString<0>> partitions;
+    SplitModule(module, targetOptions.jobs,
+                [&partitions](std::unique_ptr<Module> partition)
+                {
+                    raw_svector_ostream stream(partitions.emplace_back());
+                    WriteBitcodeToFile(*partition, stream);
+                });
+
+    // every partition writes its messages into its own streams, they are printed in the order of the partitions
+    std::vector<std::future<bool>> results;
+    std::vector<std::stringstream> partitionErrors(partitions.size());
+    std::vector<std::stringstream> partitionMessages(partitions.size());
+    for (size_t i = 0; i < partitions.size(); ++i)
     {
-        TheTargetMachine->setOptLevel(CodeGenOptLevel::None);
+        auto objectFileName = basePath / (unitName + "." + std::to_string(i) + ".o");
+        objectFiles.emplace_back(objectFileName.string());
+        results.push_back(std::async(
+                std::launch::async,
+                [&targetOptions, &bitcode = partitions[i], objectFileName, &errors = partitionErrors[i],
+                 &messages = partitionMessages[i]]
+                {
+                    LLVMContext partitionContext;
+                    auto partition = parseBitcodeFile(MemoryBufferRef(bitcode.str(), "partition"), partitionContext);
+                    if (!partition)
+                    {
+                        errors << toString(partition.takeError()) << "\n";
+                        return false;
+                    }
+                    const std::unique_ptr<TargetMachine> targetMachine(createTargetMachine(targetOptions, errors));
+                    return targetMachine &&
+                           emitObjectFile(**partition, targetMachine.get(), objectFileName, errors, messages);
+                }));
     }
 
+    bool success = true;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        success = results[i].get() && success;
+        errorStream << partitionErrors[i].str();
+        messageStream << partitionMessages[i].str();
+    }
+    return success;
+}
 
-    if (TheTargetMachine->addPassesToEmitFile(pass, dest, nullptr, CodeGenFileType::ObjectFile))
+/**
+ * hashes the options of an incremental build, the rtl directories decide which source a unit name refers to.
+ */
+static uint64_t hashOptions(const CompilerOptions &options)
+{
+    std::string key = std::to_string(hashTargetOptions(options));
+    for (auto &rtlDirectory: options.rtlDirectories)
     {
-        errs() << "TheTargetMachine can't emit a file of this type";
-        return;
+        key += ";" + std::filesystem::absolute(rtlDirectory).lexically_normal().string();
     }
+    return llvm::xxHash64(key);
+}
 
-    pass.run(*context->TheModule);
-    dest.flush();
-    dest.close();
+struct UnitSource
+{
+    std::filesystem::path sourcePath;
+    uint64_t contentHash = 0;
+    uint64_t interfaceHash = 0;
+    SourceFileReference file;
+};
+
+static uint64_t hashImports(const std::vector<std::string> &imports, const std::map<std::string, UnitSource> &units)
+{
+    std::string key;
+    for (auto &import: imports)
+    {
+        const auto unit = units.find(import);
+        key += import + ":" + (unit != units.end() ? std::to_string(unit->second.interfaceHash) : "") + ";";
+    }
+    return llvm::xxHash64(key);
+}
 
+/**
+ * compiles the program and every unit it uses into their own object file in the output directory.
+ * Object files whose source, options and imported interfaces did not change since the last build are reused.
+ */
+static bool compileIncremental(const CompilerOptions &options, const std::filesystem::path &inputPath,
+                               const uint32_t programFileId, std::unique_ptr<UnitNode> program,
+                               llvm::TargetMachine *targetMachine, std::vector<std::string> &objectFiles,
+                               std::ostream &errorStream, std::ostream &messageStream)
+{
+    BuildManifest manifest(options.outputDirectory / "wirthx.manifest");
+    manifest.load();
+    const auto optionsHash = hashOptions(options);
 
-    llvm::verifyModule(*context->TheModule, &llvm::errs());
-    if (context->compilerOptions.printLLVMIR)
+    std::map<std::string, UnitSource> units;
+    for (auto &unitName: collectUsedUnits(*program))
+    {
+        const auto sourcePath = findUnitSource(options, inputPath, unitName);
+        auto file = sourcePath ? loadSourceFile(*sourcePath) : std::nullopt;
+        if (!file)
+        {
+            errorStream << "could not read the source of the unit " << unitName << "\n";
+            return false;
+        }
+        units[unitName] = UnitSource{.sourcePath = std::filesystem::absolute(*sourcePath).lexically_normal(),
+                                     .contentHash = hashSource(file->fileId()),
+                                     .interfaceHash = hashUnitInterface(file->fileId()),
+                                     .file = std::move(*file)};
+    }
+
+    auto isUpToDate = [&](const std::filesystem::path &sourcePath, const uint64_t contentHash,
+                          const std::filesystem::path &objectFile)
+    {
+        const auto entry = manifest.find(sourcePath);
+        return entry && std::filesystem::exists(objectFile) && entry->contentHash == contentHash &&
+               entry->optionsHash == optionsHash && entry->importsHash == hashImports(entry->imports, units);
+    };
+
+    const auto programObject = options.outputDirectory / (program->getUnitName() + ".o");
+    objectFiles.emplace_back(programObject.string());
+    for (auto &[unitName, unit]: units)
+    {
+        const auto objectFile = options.outputDirectory / (unitName + ".o");
+        objectFiles.emplace_back(objectFile.string());
+        if (isUpToDate(unit.sourcePath, unit.contentHash, objectFile))
+        {
+            continue;
+        }
+
+        auto unitNode = parseSourceFile(options, unit.sourcePath, unit.file.fileId(), errorStream);
+        if (!unitNode)
+        {
+            return false;
+        }
+        ManifestEntry entry{.unitName = unitName,
+                            .sourcePath = unit.sourcePath,
+                            .contentHash = unit.contentHash,
+                            .interfaceHash = unit.interfaceHash,
+                            .optionsHash = optionsHash,
+                            .imports = collectUsedUnits(*unitNode)};
+        entry.importsHash = hashImports(entry.imports, units);
+        auto context = generateModule(options, unit.sourcePath, std::move(unitNode), targetMachine, errorStream,
+                                      messageStream);
+        if (!context || !emitObjectFile(*context->TheModule, targetMachine, objectFile, errorStream, messageStream))
+        {
+            return false;
+        }
+        manifest.update(entry);
+    }
+
+    const auto programPath = std::filesystem::absolute(inputPath).lexically_normal();
+    const auto programHash = hashSource(programFileId);
+    if (!isUpToDate(programPath, programHash, programObject))
+    {
+        ManifestEntry entry{.unitName = program->getUnitName(),
+                            .sourcePath = programPath,
+                            .contentHash = programHash,
+                            .optionsHash = optionsHash,
+                            .imports = collectUsedUnits(*program)};
+        entry.importsHash = hashImports(entry.imports, units);
+        auto context = generateModule(options, inputPath, std::move(program), targetMachine, errorStream,
+                                      messageStream, true);
+        if (!context ||
+            !emitObjectFile(*context->TheModule, targetMachine, programObject, errorStream, messageStream))
+        {
+            return false;
+        }
+        manifest.update(entry);
+    }
+
+    if (!manifest.save())
+    {
+        errorStream << "could not write the build manifest to " << options.outputDirectory.string() << "\n";
+    }
+    return true;
+}
+
+bool compile_file(const CompilerOptions &options, const std::filesystem::path &inputPath, std::ostream &errorStream,
+                  std::ostream &outputStream, std::ostream &messageStream)
+{
+    using namespace llvm;
+    using namespace llvm::sys;
+
+
+    const auto targetOptions = resolveTargetCPU(options, "generic");
+    auto TheTargetMachine = getTargetMachine(targetOptions, errorStream);
+    if (!TheTargetMachine)
+    {
+        return false;
+    }
+    Triple target(TargetTriple);
+
+    // the program is referenced by the locations of its nodes until it is compiled
+    const auto file = loadSourceFile(inputPath);
+    if (!file)
+    {
+        return false;
+    }
+    auto unit = parseSourceFile(targetOptions, inputPath, file->fileId(), errorStream);
+    if (!unit)
     {
-        context->TheModule->print(llvm::errs(), nullptr, false, false);
+        return false;
     }
+    const auto unitName = unit->getUnitName();
+    const auto libsToLink = unit->collectLibsToLink();
 
-    outs() << "Wrote " << objectFileName.string() << "\n";
+    auto basePath = targetOptions.outputDirectory;
+    std::vector<std::string> objectFiles;
+    // the standard streams of a unit object are not initialized on windows, so it is always built as a whole
+    if (targetOptions.incremental && target.getOS() != Triple::Win32)
+    {
+        if (!compileIncremental(targetOptions, inputPath, file->fileId(), std::move(unit), TheTargetMachine,
+                                objectFiles, errorStream, messageStream))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        auto context = generateModule(targetOptions, inputPath, std::move(unit), TheTargetMachine, errorStream,
+                                      messageStream);
+        if (!context)
+        {
+            return false;
+        }
+        if (targetOptions.jobs > 1)
+        {
+            if (!emitObjectFiles(*context->TheModule, targetOptions, basePath, unitName, objectFiles, errorStream,
+                                 messageStream))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            auto objectFileName = basePath / (unitName + ".o");
+            if (!emitObjectFile(*context->TheModule, TheTargetMachine, objectFileName, errorStream, messageStream))
+            {
+                return false;
+            }
+            objectFiles.emplace_back(objectFileName.string());
+        }
+    }
 
     std::vector<std::string> flags;
-    for (const auto &lib: context->ProgramUnit->collectLibsToLink())
+    for (const auto &lib: libsToLink)
     {
         flags.push_back("-l" + lib);
     }
 
 
-    if (context->compilerOptions.buildMode == BuildMode::Debug && target.getOS() != Triple::Win32)
+    if (targetOptions.optimizationLevel == ::OptimizationLevel::O0 && target.getOS() != Triple::Win32)
     {
         flags.emplace_back("-fsanitize=address");
         flags.emplace_back("-fno-omit-frame-pointer");
     }
 
-    std::string executableName = context->ProgramUnit->getUnitName();
+    std::string executableName = unitName;
 
     if (target.getOS() == Triple::Win32)
     {
@@ -322,15 +1013,193 @@ void compile_file(const CompilerOptions &options, const std::filesystem::path &i
 
     if (!pascal_link_modules(errorStream, basePath, executableName, flags, objectFiles))
     {
-        return;
+        return false;
     }
 
-    if (context->compilerOptions.runProgram)
+    if (targetOptions.runProgram)
     {
 
         if (!execute_command(outputStream, errorStream, (basePath / executableName).string()))
         {
             errorStream << "program could not be executed!\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool build_rtl(const CompilerOptions &options, std::ostream &errorStream, std::ostream &messageStream)
+{
+    using namespace llvm;
+
+    Triple target(TargetTriple);
+    if (target.getOS() == Triple::Win32)
+    {
+        errorStream << "precompiled units are not supported on windows\n";
+        return false;
+    }
+    if (options.rtlDirectories.empty())
+    {
+        errorStream << "no rtl directory given\n";
+        return false;
+    }
+
+    const auto targetOptions = resolveTargetCPU(options, "generic");
+    auto TheTargetMachine = getTargetMachine(targetOptions, errorStream);
+    if (!TheTargetMachine)
+    {
+        return false;
+    }
+
+    bool success = true;
+    const auto &rtlDirectory = options.rtlDirectories.front();
+    for (auto &entry: std::filesystem::directory_iterator(rtlDirectory))
+    {
+        if (entry.path().extension() != ".pas")
+        {
+            continue;
+        }
+        auto context = generateModule(targetOptions, entry.path(), TheTargetMachine, errorStream, messageStream);
+        if (!context)
+        {
+            errorStream << "could not compile " << entry.path().string() << "\n";
+            success = false;
+            continue;
+        }
+
+        const auto bitcodePath = precompiledUnitPath(targetOptions, entry.path());
+        if (!bitcodePath)
+        {
+            errorStream << "could not read " << entry.path().string() << "\n";
+            success = false;
+            continue;
+        }
+        std::error_code EC;
+        raw_fd_ostream dest(bitcodePath->string(), EC, sys::fs::OF_None);
+        if (EC)
+        {
+            errorStream << "Could not open file: " << EC.message() << "\n";
+            success = false;
+            continue;
+        }
+        WriteBitcodeToFile(*context->TheModule, dest);
+        messageStream << "Wrote " << bitcodePath->string() << "\n";
+    }
+    return success;
+}
+
+/**
+ * replacement for the libc exit inside of jitted programs.
+ * The generated main always ends with a call to exit, which would otherwise run the atexit handlers
+ * of the compiler itself.
+ */
+static void jit_exit(int status)
+{
+    fflush(nullptr);
+    std::_Exit(status);
+}
+
+bool jit_file(const CompilerOptions &options, const std::filesystem::path &inputPath, std::ostream &errorStream,
+              std::ostream &outputStream, std::ostream &messageStream)
+{
+    using namespace llvm;
+    using namespace llvm::orc;
+
+    // without fork the program would run inside of the compiler, and its exit would terminate the compiler as well
+    if (Triple(sys::getProcessTriple()).isOSWindows())
+    {
+        errorStream << "--jit is not supported on windows, compile the program with --run instead\n";
+        return false;
+    }
+
+    auto targetMachineBuilder = JITTargetMachineBuilder::detectHost();
+    if (!targetMachineBuilder)
+    {
+        errorStream << toString(targetMachineBuilder.takeError()) << "\n";
+        return false;
+    }
+    // the program runs on this machine, so the host cpu is the natural default
+    const auto targetOptions = resolveTargetCPU(options, "native");
+    targetMachineBuilder->setCPU(targetOptions.targetCPU);
+    targetMachineBuilder->getFeatures() = SubtargetFeatures(targetOptions.targetFeatures);
+    targetMachineBuilder->setCodeGenOptLevel(toCodeGenOptLevel(options.optimizationLevel));
+    auto targetMachine = targetMachineBuilder->createTargetMachine();
+    if (!targetMachine)
+    {
+        errorStream << toString(targetMachine.takeError()) << "\n";
+        return false;
+    }
+
+    auto jit = LLJITBuilder().setJITTargetMachineBuilder(std::move(*targetMachineBuilder)).create();
+    if (!jit)
+    {
+        errorStream << toString(jit.takeError()) << "\n";
+        return false;
+    }
+
+    auto context = generateModule(targetOptions, inputPath, targetMachine->get(), errorStream, messageStream);
+    if (!context)
+    {
+        return false;
+    }
+
+    auto &mainLibrary = (*jit)->getMainJITDylib();
+    const char globalPrefix = (*jit)->getDataLayout().getGlobalPrefix();
+    MangleAndInterner mangle((*jit)->getExecutionSession(), (*jit)->getDataLayout());
+    if (auto error = mainLibrary.define(absoluteSymbols(
+                {{mangle("exit"), ExecutorSymbolDef(ExecutorAddr::fromPtr(&jit_exit), JITSymbolFlags::Exported)}})))
+    {
+        errorStream << toString(std::move(error)) << "\n";
+        return false;
+    }
+
+    // libc and everything else which is already loaded into the compiler process
+    auto processSymbols = DynamicLibrarySearchGenerator::GetForCurrentProcess(globalPrefix);
+    if (!processSymbols)
+    {
+        errorStream << toString(processSymbols.takeError()) << "\n";
+        return false;
+    }
+    mainLibrary.addGenerator(std::move(*processSymbols));
+
+    const Triple target(TargetTriple);
+    for (const auto &lib: context->ProgramUnit->collectLibsToLink())
+    {
+        if (lib == "c")
+            continue;
+        std::string libraryName = "lib" + lib + ".so";
+        if (target.getOS() == Triple::Win32)
+            libraryName = lib + ".dll";
+        else if (target.isOSDarwin())
+            libraryName = "lib" + lib + ".dylib";
+        auto librarySymbols = DynamicLibrarySearchGenerator::Load(libraryName.c_str(), globalPrefix);
+        if (!librarySymbols)
+        {
+            errorStream << toString(librarySymbols.takeError()) << "\n";
+            return false;
         }
+        mainLibrary.addGenerator(std::move(*librarySymbols));
+    }
+
+    if (auto error =
+                (*jit)->addIRModule(ThreadSafeModule(std::move(context->TheModule), std::move(context->TheContext))))
+    {
+        errorStream << toString(std::move(error)) << "\n";
+        return false;
+    }
+
+    auto mainSymbol = (*jit)->lookup("main");
+    if (!mainSymbol)
+    {
+        errorStream << toString(mainSymbol.takeError()) << "\n";
+        return false;
+    }
+
+    auto *mainFunction = mainSymbol->toPtr<int()>();
+    if (!execute_function(outputStream, errorStream, mainFunction))
+    {
+        errorStream << "program could not be executed!\n";
+        return false;
     }
+    return true;
 }
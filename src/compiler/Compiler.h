@@ -1,10 +1,38 @@
 
 #pragma once
 #include <filesystem>
+#include <memory>
 #include <sstream>
 #include "compiler/CompilerOptions.h"
 
+class UnitNode;
+
 void init_compiler();
 
-void compile_file(const CompilerOptions &options, const std::filesystem::path &inputPath, std::ostream &errorStream,
-                  std::ostream &outputStream);
+/**
+ * compiles the program into an executable and runs it if requested, the program writes into the output stream.
+ * The message stream receives the progress of the compiler, e.g. the written files, the diagnostics of llvm and the
+ * llvm ir if it is requested.
+ * returns false if the program could not be compiled or could not be run.
+ */
+bool compile_file(const CompilerOptions &options, const std::filesystem::path &inputPath, std::ostream &errorStream,
+                  std::ostream &outputStream, std::ostream &messageStream);
+
+/**
+ * compiles the program in memory and runs it, returns false if the program could not be compiled or could not be run.
+ */
+bool jit_file(const CompilerOptions &options, const std::filesystem::path &inputPath, std::ostream &errorStream,
+              std::ostream &outputStream, std::ostream &messageStream);
+
+/**
+ * compiles every unit of the first rtl directory into a bitcode file next to its source.
+ * Programs link the functions of these units in instead of generating them again, if the bitcode was built with the
+ * same options from the same source and the same interfaces of the imported units.
+ */
+bool build_rtl(const CompilerOptions &options, std::ostream &errorStream, std::ostream &messageStream);
+
+/**
+ * type checks the unit and generates its llvm module without optimizing or emitting it.
+ * returns false if the code generation failed.
+ */
+bool generate_ir(const CompilerOptions &options, std::unique_ptr<UnitNode> unit, std::ostream &errorStream);
@@ -1,6 +1,15 @@
 #include "CompilerOptions.h"
+#include <algorithm>
+#include <charconv>
 #include <filesystem>
 
+static unsigned parseJobs(const std::string &value)
+{
+    unsigned jobs = 1;
+    std::from_chars(value.data(), value.data() + value.size(), jobs);
+    return std::max(jobs, 1u);
+}
+
 std::string shiftarg(std::vector<std::string> &args)
 {
     auto result = args.front();
@@ -43,13 +52,73 @@ CompilerOptions parseCompilerOptions(std::vector<std::string> &argList)
         {
             options.option = CompileOption::COMPILE;
         }
+        else if (arg == "--jit")
+        {
+            options.option = CompileOption::JIT;
+        }
+        else if (arg == "--incremental")
+        {
+            options.incremental = true;
+        }
+        else if (arg == "-j" && !argList.empty())
+        {
+            options.jobs = parseJobs(shiftarg(argList));
+        }
+        else if (arg.starts_with("-j") && arg.size() > 2)
+        {
+            options.jobs = parseJobs(arg.substr(2));
+        }
+        else if (arg == "--build-rtl")
+        {
+            options.option = CompileOption::BUILD_RTL;
+        }
         else if (arg == "--release")
         {
-            options.buildMode = BuildMode::Release;
+            options.optimizationLevel = OptimizationLevel::O2;
+        }
+        else if (arg == "--debug" or arg == "-O0" or arg == "--O0")
+        {
+            options.optimizationLevel = OptimizationLevel::O0;
+        }
+        else if (arg == "-O1" or arg == "--O1")
+        {
+            options.optimizationLevel = OptimizationLevel::O1;
+        }
+        else if (arg == "-O2" or arg == "--O2")
+        {
+            options.optimizationLevel = OptimizationLevel::O2;
+        }
+        else if (arg == "-O3" or arg == "--O3")
+        {
+            options.optimizationLevel = OptimizationLevel::O3;
+        }
+        else if (arg == "-Os" or arg == "--Os")
+        {
+            options.optimizationLevel = OptimizationLevel::Os;
+        }
+        else if (arg.starts_with("--march="))
+        {
+            options.targetCPU = arg.substr("--march="sv.size());
+        }
+        else if (arg.starts_with("--mcpu="))
+        {
+            options.targetCPU = arg.substr("--mcpu="sv.size());
+        }
+        else if (arg.starts_with("--mattr="))
+        {
+            options.targetFeatures = arg.substr("--mattr="sv.size());
+        }
+        else if (arg == "--server"sv && !argList.empty())
+        {
+            options.serverSocket = shiftarg(argList);
+        }
+        else if (arg == "--connect"sv && !argList.empty())
+        {
+            options.connectSocket = shiftarg(argList);
         }
-        else if (arg == "--debug")
+        else if (arg == "--cache-dir"sv && !argList.empty())
         {
-            options.buildMode = BuildMode::Debug;
+            options.cacheDirectory = shiftarg(argList);
         }
         else if (arg == "--lsp")
         {
@@ -7,23 +7,40 @@
 enum class CompileOption
 {
     COMPILE,
-    JIT
+    JIT,
+    BUILD_RTL
 };
-enum class BuildMode
+enum class OptimizationLevel
 {
-    Debug,
-    Release
+    O0,
+    O1,
+    O2,
+    O3,
+    Os
 };
 
 struct CompilerOptions
 {
     CompileOption option = CompileOption::COMPILE;
-    BuildMode buildMode = BuildMode::Debug;
+    OptimizationLevel optimizationLevel = OptimizationLevel::O0;
+    // empty means the default cpu of the selected mode, "native" selects the host cpu and its features
+    std::string targetCPU;
+    std::string targetFeatures;
 
     std::filesystem::path outputDirectory;
     std::vector<std::filesystem::path> rtlDirectories;
     std::string compilerPath;
     bool runProgram = false;
+    // compiles every unit into its own object file and only rebuilds the changed ones
+    bool incremental = false;
+    // number of threads which lex very large source files and emit the machine code of a program, the module is split
+    // into as many partitions
+    unsigned jobs = 1;
+    // path of the local socket the compiler server listens on or the client connects to
+    std::string serverSocket;
+    std::string connectSocket;
+    // directory of the cached interfaces of the units, empty disables the cache
+    std::filesystem::path cacheDirectory;
     bool printLLVMIR = false;
     bool printAST = false;
     bool lsp = false;
@@ -1,12 +1,15 @@
 #pragma once
 
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 
 #include "CompilerOptions.h"
 
 #include <unordered_map>
+#include <vector>
 
 namespace llvm
 {
@@ -18,8 +21,6 @@ namespace llvm
     class Value;
     class Function;
 
-    class PassInstrumentationCallbacks;
-    class StandardInstrumentations;
     class BasicBlock;
     class ConstantFolder;
     class IRBuilderDefaultInserter;
@@ -28,22 +29,11 @@ namespace llvm
     template<class FolderTy, class InserterTy>
     class IRBuilder;
 
-    template<typename IRUnitT, typename... ExtraArgTs>
-    class AnalysisManager;
-
-    template<typename IRUnitT, typename AnalysisManagerT, typename... ExtraArgTs>
-    class PassManager;
-
-    using FunctionPassManager = PassManager<Function, AnalysisManager<Function>>;
-    using FunctionAnalysisManager = AnalysisManager<Function>;
-    using ModuleAnalysisManager = AnalysisManager<Module>;
-
 } // namespace llvm
 
 
-// #include "llvm/IR/PassManager.h"
-
 class UnitNode;
+class FunctionDefinitionNode;
 
 struct BreakBasicBlock
 {
@@ -54,20 +44,27 @@ struct BreakBasicBlock
 struct Context
 {
     std::unique_ptr<llvm::LLVMContext> TheContext;
+    // identifies the compilation, the types cache their llvm types for it because an LLVMContext may be allocated at
+    // the address of a previous one
+    uint64_t Generation = 0;
     std::unique_ptr<llvm::Module> TheModule;
     std::unique_ptr<llvm::IRBuilder<llvm::ConstantFolder, llvm::IRBuilderDefaultInserter>> Builder;
-    std::unordered_map<std::string, llvm::AllocaInst *> NamedAllocations;
-    std::unordered_map<std::string, llvm::Value *> NamedValues;
+    // the variables of the function which is generated, indexed by the slots of the Binder
+    std::vector<llvm::Value *> Slots;
+    // the constants of the program, indexed by the global slots of the Binder
+    std::vector<llvm::Value *> Globals;
+    llvm::Value *StdIn = nullptr;
+    llvm::Value *StdOut = nullptr;
+    llvm::Value *StdErr = nullptr;
     llvm::Function *TopLevelFunction;
+    // the definition of TopLevelFunction, nullptr for the main function of a program
+    FunctionDefinitionNode *TopLevelDefinition = nullptr;
     std::unordered_map<std::string, llvm::Function *> FunctionDefinitions;
     BreakBasicBlock BreakBlock;
 
-    std::unique_ptr<llvm::FunctionPassManager> TheFPM;
-    std::unique_ptr<llvm::FunctionAnalysisManager> TheFAM;
-    std::unique_ptr<llvm::ModuleAnalysisManager> TheMAM;
-    std::unique_ptr<llvm::PassInstrumentationCallbacks> ThePIC;
-    std::unique_ptr<llvm::StandardInstrumentations> TheSI;
     std::unique_ptr<llvm::Triple> TargetTriple;
+    // units whose function bodies are not generated into this module but linked in from their own module
+    std::set<std::string> PrecompiledUnits;
 
     std::unique_ptr<UnitNode> ProgramUnit;
     CompilerOptions compilerOptions;
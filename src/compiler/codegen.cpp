@@ -78,3 +78,49 @@ llvm::Value *codegen::codegen_while(std::unique_ptr<Context> &context, llvm::Val
     // for expr always returns 0.0.
     return llvm::Constant::getNullValue(llvm::Type::getInt64Ty(*context->TheContext));
 }
+
+void codegen::addTargetAttributes(std::unique_ptr<Context> &context, llvm::Function *function)
+{
+    if (!context->compilerOptions.targetCPU.empty())
+    {
+        function->addFnAttr("target-cpu", context->compilerOptions.targetCPU);
+    }
+    if (!context->compilerOptions.targetFeatures.empty())
+    {
+        function->addFnAttr("target-features", context->compilerOptions.targetFeatures);
+    }
+}
+
+llvm::Value *codegen::slotValue(const std::unique_ptr<Context> &context, const VariableSlot slot)
+{
+    switch (slot.kind)
+    {
+        case SlotKind::LOCAL:
+        case SlotKind::VALUE:
+            return context->Slots[slot.index];
+        case SlotKind::ARGUMENT:
+            return context->TopLevelFunction->getArg(slot.index);
+        case SlotKind::GLOBAL:
+            return context->Globals[slot.index];
+        case SlotKind::UNBOUND:
+            break;
+    }
+    return nullptr;
+}
+
+void codegen::setSlotValue(const std::unique_ptr<Context> &context, const VariableSlot slot, llvm::Value *value)
+{
+    switch (slot.kind)
+    {
+        case SlotKind::LOCAL:
+        case SlotKind::VALUE:
+            context->Slots[slot.index] = value;
+            break;
+        case SlotKind::GLOBAL:
+            context->Globals[slot.index] = value;
+            break;
+        case SlotKind::ARGUMENT:
+        case SlotKind::UNBOUND:
+            break;
+    }
+}
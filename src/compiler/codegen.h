@@ -7,9 +7,11 @@
 
 #include <functional>
 #include <memory>
+#include "ast/VariableSlot.h"
 namespace llvm
 {
     class Value;
+    class Function;
 
 };
 struct Context;
@@ -21,6 +23,19 @@ namespace codegen
 
     llvm::Value *codegen_while(std::unique_ptr<Context> &context, llvm::Value *condition,
                                std::function<void(std::unique_ptr<Context> &)> body);
+
+    /**
+     * adds the target-cpu and target-features attributes of the compiler options to the function,
+     * so that the inliner and the vectorizers know which instructions may be used.
+     */
+    void addTargetAttributes(std::unique_ptr<Context> &context, llvm::Function *function);
+
+    /**
+     * returns the value of the slot: the allocation of a local variable, the value of a constant or loop variable or
+     * the argument of the function. nullptr if the slot is unbound.
+     */
+    llvm::Value *slotValue(const std::unique_ptr<Context> &context, VariableSlot slot);
+    void setSlotValue(const std::unique_ptr<Context> &context, VariableSlot slot, llvm::Value *value);
 } // namespace codegen
 
 #endif // CODEGEN_H
@@ -320,7 +320,7 @@ void createReadLnCall(std::unique_ptr<Context> &context)
                     const auto bounds = ctx->Builder->CreateGEP(
                             arrayBaseType, buffer,
                             llvm::ArrayRef<llvm::Value *>{ctx->Builder->getInt64(0),
-                                                          dynamic_cast<llvm::Value *>(loadedSize)},
+                                                          static_cast<llvm::Value *>(loadedSize)},
                             "", true);
 
                     ctx->Builder->CreateStore(value, bounds);
@@ -355,7 +355,7 @@ void createReadLnCall(std::unique_ptr<Context> &context)
                 const auto boundsRHS = ctx->Builder->CreateGEP(
                         llvm::ArrayType::get(valueType, bufferSize), buffer,
                         llvm::ArrayRef<llvm::Value *>{ctx->Builder->getInt64(0),
-                                                      dynamic_cast<llvm::Value *>(ctx->Builder->getInt64(0))},
+                                                      static_cast<llvm::Value *>(ctx->Builder->getInt64(0))},
                         "", false);
                 auto memcpyCall = llvm::Intrinsic::getDeclaration(
                         ctx->TheModule.get(), llvm::Intrinsic::memcpy,
@@ -398,7 +398,7 @@ void createReadLnStdinCall(std::unique_ptr<Context> &context)
     //
 
 
-    auto filePtrOffset = context->Builder->CreateStructGEP(llvmFileType, context->NamedValues["stdin"], 1, "stdin");
+    auto filePtrOffset = context->Builder->CreateStructGEP(llvmFileType, context->StdIn, 1, "stdin");
     auto filePtr = context->Builder->CreateLoad(llvm::PointerType::getUnqual(*context->TheContext), filePtrOffset);
 
     auto stringPtr = context->Builder->CreateStructGEP(llvmStringType, F->getArg(0), 2, "string.ptr");
@@ -465,7 +465,7 @@ void createReadLnStdinCall(std::unique_ptr<Context> &context)
                     const auto bounds = ctx->Builder->CreateGEP(
                             arrayBaseType, buffer,
                             llvm::ArrayRef<llvm::Value *>{ctx->Builder->getInt64(0),
-                                                          dynamic_cast<llvm::Value *>(loadedSize)},
+                                                          static_cast<llvm::Value *>(loadedSize)},
                             "", true);
 
                     ctx->Builder->CreateStore(value, bounds);
@@ -500,7 +500,7 @@ void createReadLnStdinCall(std::unique_ptr<Context> &context)
                 const auto boundsRHS = ctx->Builder->CreateGEP(
                         llvm::ArrayType::get(valueType, bufferSize), buffer,
                         llvm::ArrayRef<llvm::Value *>{ctx->Builder->getInt64(0),
-                                                      dynamic_cast<llvm::Value *>(ctx->Builder->getInt64(0))},
+                                                      static_cast<llvm::Value *>(ctx->Builder->getInt64(0))},
                         "", false);
                 auto memcpyCall = llvm::Intrinsic::getDeclaration(
                         ctx->TheModule.get(), llvm::Intrinsic::memcpy,
@@ -33,16 +33,16 @@ Color::Modifier outputTypeToColor(OutputType outputType)
 void ParserError::msg(std::ostream &ostream, bool printColor) const
 {
     if (printColor)
-        ostream << token.sourceLocation.filename << ":" << token.row << ":" << token.col << ": "
+        ostream << token.sourceLocation.filename() << ":" << token.row() << ":" << token.col() << ": "
                 << outputTypeToColor(outputType) << outputTypeString(outputType) << Color::Modifier(Color::FG_DEFAULT)
                 << ": " << message << "\n";
     else
-        ostream << token.sourceLocation.filename << ":" << token.row << ":" << token.col << ": "
+        ostream << token.sourceLocation.filename() << ":" << token.row() << ":" << token.col() << ": "
                 << outputTypeString(outputType) << ": " << message << "\n";
 
     ostream << token.sourceLocation.sourceline() << "\n";
     size_t startOffset = token.sourceLocation.byte_offset - token.sourceLocation.lineStart() + 1;
-    size_t endOffset = (token.sourceLocation.source->find('\n', token.sourceLocation.byte_offset) - 1) -
+    size_t endOffset = (token.sourceLocation.source().find('\n', token.sourceLocation.byte_offset) - 1) -
                        (token.sourceLocation.byte_offset - 1);
 
     ostream << std::setw(startOffset) << std::setfill(' ') << '^' << std::setw(endOffset) << std::setfill('-') << "\n";
@@ -2,8 +2,17 @@
 #include "llvm/Support/CommandLine.h"
 #include "os/command.h"
 
-bool pascal_link_modules(std::ostream &errStream, const std::filesystem::path &baseDir, const std::string &program_name,
-                         const std::vector<std::string> &flags, const std::vector<std::string> &object_files)
+#ifdef WIRTHX_HAS_LLD
+#include "config.h"
+#include "lld/Common/Driver.h"
+#include "llvm/Support/raw_ostream.h"
+
+LLD_HAS_DRIVER(elf)
+#endif
+
+static bool link_with_cc(std::ostream &errStream, const std::filesystem::path &baseDir,
+                         const std::string &program_name, const std::vector<std::string> &flags,
+                         const std::vector<std::string> &object_files)
 {
     std::vector<std::string> args;
     // args.emplace_back("-nostdlib");
@@ -17,3 +26,79 @@ bool pascal_link_modules(std::ostream &errStream, const std::filesystem::path &b
 
     return execute_command_list(errStream, errStream, "cc", args);
 }
+
+#ifdef WIRTHX_HAS_LLD
+/**
+ * the arguments which the system compiler driver passes to the linker around the object files, CMake asks the driver
+ * for them when it configures the build.
+ */
+struct SystemLinkArguments
+{
+    std::vector<std::string> beforeObjects;
+    std::vector<std::string> afterObjects;
+};
+
+static const SystemLinkArguments &system_link_arguments(const bool sanitize)
+{
+    static const SystemLinkArguments arguments = {.beforeObjects = {WIRTHX_LINK_BEFORE_OBJECTS},
+                                                  .afterObjects = {WIRTHX_LINK_AFTER_OBJECTS}};
+    static const SystemLinkArguments sanitizeArguments = {.beforeObjects = {WIRTHX_SANITIZE_LINK_BEFORE_OBJECTS},
+                                                          .afterObjects = {WIRTHX_SANITIZE_LINK_AFTER_OBJECTS}};
+    return sanitize ? sanitizeArguments : arguments;
+}
+
+static bool link_with_lld(std::ostream &errStream, const std::filesystem::path &baseDir,
+                          const std::string &program_name, const std::vector<std::string> &libraries,
+                          const std::vector<std::string> &object_files, const bool sanitize)
+{
+    // lld can not be used again after it failed in a way that left its global state dirty
+    static bool lldUsable = true;
+    const auto &arguments = system_link_arguments(sanitize);
+    if (!lldUsable || arguments.beforeObjects.empty())
+        return false;
+
+    std::vector<std::string> args = {"ld.lld", "-o", (baseDir / program_name).string()};
+    args.insert(args.end(), arguments.beforeObjects.begin(), arguments.beforeObjects.end());
+    args.insert(args.end(), object_files.begin(), object_files.end());
+    args.insert(args.end(), libraries.begin(), libraries.end());
+    args.insert(args.end(), arguments.afterObjects.begin(), arguments.afterObjects.end());
+
+    std::vector<const char *> argv;
+    argv.reserve(args.size());
+    for (auto &arg: args)
+        argv.push_back(arg.c_str());
+
+    std::string output;
+    llvm::raw_string_ostream outputStream(output);
+    const auto result = lld::lldMain(argv, outputStream, outputStream, {{lld::Gnu, &lld::elf::link}});
+    outputStream.flush();
+    // on failure the fallback to cc reports the errors
+    if (result.retCode == 0)
+        errStream << output;
+    lldUsable = result.canRunAgain;
+    return result.retCode == 0;
+}
+#endif
+
+bool pascal_link_modules(std::ostream &errStream, const std::filesystem::path &baseDir, const std::string &program_name,
+                         const std::vector<std::string> &flags, const std::vector<std::string> &object_files)
+{
+#ifdef WIRTHX_HAS_LLD
+    // the sanitizer runtime is part of the configured arguments, other driver flags need the compiler driver
+    std::vector<std::string> libraries;
+    bool sanitize = false;
+    bool driverOnly = false;
+    for (auto &flag: flags)
+    {
+        if (flag.starts_with("-l"))
+            libraries.emplace_back(flag);
+        else if (flag == "-fsanitize=address")
+            sanitize = true;
+        else if (flag != "-fno-omit-frame-pointer")
+            driverOnly = true;
+    }
+    if (!driverOnly && link_with_lld(errStream, baseDir, program_name, libraries, object_files, sanitize))
+        return true;
+#endif
+    return link_with_cc(errStream, baseDir, program_name, flags, object_files);
+}
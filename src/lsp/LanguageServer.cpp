@@ -95,7 +95,7 @@ void sentDiagnostics(std::vector<ParserError> &errors)
     std::map<std::string, std::vector<ParserError>> errorsMap;
     for (auto &error: errors)
     {
-        errorsMap[error.token.sourceLocation.filename].push_back(error);
+        errorsMap[error.token.sourceLocation.filename()].push_back(error);
     }
 
     for (auto &[fileName, messsages]: errorsMap)
@@ -105,18 +105,18 @@ void sentDiagnostics(std::vector<ParserError> &errors)
         {
             llvm::json::Object logMessage;
             llvm::json::Object range;
-            range["start"] = buildPosition(token.row, token.col);
-            range["end"] = buildPosition(token.row, token.col + token.sourceLocation.num_bytes);
+            range["start"] = buildPosition(token.row(), token.col());
+            range["end"] = buildPosition(token.row(), token.col() + token.sourceLocation.num_bytes);
             logMessage["range"] = std::move(range);
             logMessage["severity"] = mapOutputTypeToSeverity(outputType);
             logMessage["message"] = message;
             llvm::json::Array relatedInformations;
             llvm::json::Object source;
             llvm::json::Object location;
-            location["uri"] = token.sourceLocation.filename;
+            location["uri"] = token.sourceLocation.filename();
             llvm::json::Object range2;
-            range2["start"] = buildPosition(token.row, token.col);
-            range2["end"] = buildPosition(token.row, token.col + token.sourceLocation.num_bytes);
+            range2["start"] = buildPosition(token.row(), token.col());
+            range2["end"] = buildPosition(token.row(), token.col() + token.sourceLocation.num_bytes);
             location["range"] = std::move(range2);
             source["location"] = std::move(location);
             source["message"] = message;
@@ -238,12 +238,11 @@ void LanguageServer::handleRequest()
                 auto text = params->getObject("textDocument")->getString("text");
                 m_openDocuments[uri.value().str()] = LspDocument{.uri = uri.value().str(), .text = text.value().str()};
                 response["result"] = std::move(result);
-                Lexer lexer;
-                auto tokens = lexer.tokenize(uri.value().str(), text.value().str());
                 std::filesystem::path filePath = uri.value().str();
                 std::unordered_map<std::string, bool> definitions;
-                MacroParser macro_parser(definitions);
-                Parser parser(m_options.rtlDirectories, filePath, definitions, macro_parser.parseFile(tokens));
+                auto tokens = std::make_unique<MacroParser>(
+                        definitions, std::make_unique<LexerSource>(uri.value().str(), text.value().str()));
+                Parser parser(m_options.rtlDirectories, filePath, definitions, std::move(tokens));
                 auto ast = parser.parseFile();
                 for (auto error: parser.getErrors())
                 {
@@ -264,14 +263,11 @@ void LanguageServer::handleRequest()
                 auto text = params->getArray("contentChanges")->front().getAsObject()->getString("text");
                 m_openDocuments[uri.value().str()] = LspDocument{.uri = uri.value().str(), .text = text.value().str()};
                 response["result"] = std::move(result);
-                Lexer lexer;
-                auto tokens = lexer.tokenize(uri.value().str(), text.value().str());
                 std::filesystem::path filePath = uri.value().str();
-
                 std::unordered_map<std::string, bool> definitions;
-                MacroParser macro_parser(definitions);
-
-                Parser parser(m_options.rtlDirectories, filePath, definitions, macro_parser.parseFile(tokens));
+                auto tokens = std::make_unique<MacroParser>(
+                        definitions, std::make_unique<LexerSource>(uri.value().str(), text.value().str()));
+                Parser parser(m_options.rtlDirectories, filePath, definitions, std::move(tokens));
                 auto ast = parser.parseFile();
                 for (auto &error: parser.getErrors())
                 {
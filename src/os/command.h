@@ -7,6 +7,11 @@
 bool execute_command_list(std::ostream &outstream, std::ostream &errorStream, const std::string &command,
                           std::vector<std::string> args);
 
+/**
+ * runs the given function in a separate process and redirects its standard and error output to the given streams.
+ */
+bool execute_function(std::ostream &outstream, std::ostream &errorStream, int (*function)());
+
 template<typename... Args>
 bool execute_command(std::ostream &outstream, std::ostream &errorStream, const std::string &command, Args... args)
 {
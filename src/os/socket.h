@@ -0,0 +1,21 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <string>
+
+/**
+ * listens on the local socket at the given path and answers every received message with the result of the handler.
+ * The connections are handled one after another, the function only returns if the socket could not be created.
+ * A connection whose request exceeds the size limit of the server is closed without a reply. An existing file at the
+ * path is only replaced if it is a socket.
+ */
+bool serve_local_socket(std::ostream &errorStream, const std::string &socketPath,
+                        const std::function<std::string(const std::string &)> &handler);
+
+/**
+ * sends the message to the server listening on the local socket and returns its reply.
+ */
+std::optional<std::string> request_local_socket(std::ostream &errorStream, const std::string &socketPath,
+                                                const std::string &message);
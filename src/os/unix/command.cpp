@@ -2,6 +2,9 @@
 #include <climits>
 #include <iostream>
 #include <llvm/Support/FileSystem.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
 bool execute_command_list(std::ostream &outstream, std::ostream &errorStream, const std::string &command,
                           std::vector<std::string> args)
 {
@@ -35,3 +38,68 @@ bool execute_command_list(std::ostream &outstream, std::ostream &errorStream, co
     close(pfd[0]), close(pfd[1]);
     return status != -1;
 }
+
+bool execute_function(std::ostream &outstream, std::ostream &errorStream, int (*function)())
+{
+    int pout[2];
+    int perr[2];
+    if (pipe(pout) < 0)
+        return false;
+    if (pipe(perr) < 0)
+    {
+        close(pout[0]), close(pout[1]);
+        return false;
+    }
+
+    // buffered output of the compiler would otherwise be written twice
+    fflush(nullptr);
+    const pid_t pid = fork();
+    if (pid < 0)
+    {
+        close(pout[0]), close(pout[1]);
+        close(perr[0]), close(perr[1]);
+        return false;
+    }
+    if (pid == 0)
+    {
+        dup2(pout[1], STDOUT_FILENO);
+        dup2(perr[1], STDERR_FILENO);
+        close(pout[0]), close(pout[1]);
+        close(perr[0]), close(perr[1]);
+        const int result = function();
+        fflush(nullptr);
+        _exit(result);
+    }
+    close(pout[1]);
+    close(perr[1]);
+
+    constexpr int LINE_LEN = 1024;
+    char line[LINE_LEN];
+    pollfd fds[2] = {{.fd = pout[0], .events = POLLIN, .revents = 0}, {.fd = perr[0], .events = POLLIN, .revents = 0}};
+    std::ostream *streams[2] = {&outstream, &errorStream};
+    int openStreams = 2;
+    while (openStreams > 0)
+    {
+        if (poll(fds, 2, -1) < 0)
+            break;
+        for (size_t i = 0; i < 2; ++i)
+        {
+            if (fds[i].fd < 0 || fds[i].revents == 0)
+                continue;
+            const auto bytesRead = read(fds[i].fd, line, LINE_LEN);
+            if (bytesRead <= 0)
+            {
+                close(fds[i].fd);
+                fds[i].fd = -1;
+                openStreams--;
+                continue;
+            }
+            streams[i]->write(line, bytesRead);
+        }
+    }
+
+    int status = 0;
+    if (waitpid(pid, &status, 0) < 0)
+        return false;
+    return WIFEXITED(status);
+}
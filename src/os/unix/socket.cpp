@@ -0,0 +1,155 @@
+#include "os/socket.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// the largest request the server accepts, a request consists of a working directory and command line arguments
+static constexpr uint64_t MAX_REQUEST_SIZE = 4 * 1024 * 1024;
+
+static bool write_all(const int fd, const char *data, size_t size)
+{
+    while (size > 0)
+    {
+        const auto written = write(fd, data, size);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            return false;
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+static bool read_all(const int fd, char *data, size_t size)
+{
+    while (size > 0)
+    {
+        const auto bytesRead = read(fd, data, size);
+        if (bytesRead < 0 && errno == EINTR)
+            continue;
+        if (bytesRead <= 0)
+            return false;
+        data += bytesRead;
+        size -= static_cast<size_t>(bytesRead);
+    }
+    return true;
+}
+
+// every message is prefixed with its size
+static bool write_message(const int fd, const std::string &message)
+{
+    const uint64_t size = message.size();
+    return write_all(fd, reinterpret_cast<const char *>(&size), sizeof(size)) &&
+           write_all(fd, message.data(), message.size());
+}
+
+// a message larger than maxSize is not read, the connection has to be dropped
+static std::optional<std::string> read_message(const int fd, const uint64_t maxSize)
+{
+    uint64_t size = 0;
+    if (!read_all(fd, reinterpret_cast<char *>(&size), sizeof(size)) || size > maxSize)
+        return std::nullopt;
+    std::string message(size, '\0');
+    if (!read_all(fd, message.data(), message.size()))
+        return std::nullopt;
+    return message;
+}
+
+static std::optional<sockaddr_un> socket_address(std::ostream &errorStream, const std::string &socketPath)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path))
+    {
+        errorStream << "the socket path " << socketPath << " is too long\n";
+        return std::nullopt;
+    }
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+    return address;
+}
+
+bool serve_local_socket(std::ostream &errorStream, const std::string &socketPath,
+                        const std::function<std::string(const std::string &)> &handler)
+{
+    const auto address = socket_address(errorStream, socketPath);
+    if (!address)
+        return false;
+
+    // a socket file left behind by a previous server would make bind fail, any other file is not removed
+    struct stat status = {};
+    if (lstat(socketPath.c_str(), &status) == 0)
+    {
+        if (!S_ISSOCK(status.st_mode))
+        {
+            errorStream << "could not listen on " << socketPath << ": the file exists and is not a socket\n";
+            return false;
+        }
+        unlink(socketPath.c_str());
+    }
+
+    const int serverFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (serverFd < 0)
+    {
+        errorStream << "could not create the socket: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    if (bind(serverFd, reinterpret_cast<const sockaddr *>(&*address), sizeof(*address)) < 0 ||
+        listen(serverFd, SOMAXCONN) < 0)
+    {
+        errorStream << "could not listen on " << socketPath << ": " << std::strerror(errno) << "\n";
+        close(serverFd);
+        return false;
+    }
+
+    while (true)
+    {
+        const int clientFd = accept(serverFd, nullptr, nullptr);
+        if (clientFd < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            errorStream << "could not accept a connection: " << std::strerror(errno) << "\n";
+            break;
+        }
+        if (const auto request = read_message(clientFd, MAX_REQUEST_SIZE))
+        {
+            write_message(clientFd, handler(*request));
+        }
+        close(clientFd);
+    }
+    close(serverFd);
+    unlink(socketPath.c_str());
+    return false;
+}
+
+std::optional<std::string> request_local_socket(std::ostream &errorStream, const std::string &socketPath,
+                                                const std::string &message)
+{
+    const auto address = socket_address(errorStream, socketPath);
+    if (!address)
+        return std::nullopt;
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        errorStream << "could not create the socket: " << std::strerror(errno) << "\n";
+        return std::nullopt;
+    }
+    if (connect(fd, reinterpret_cast<const sockaddr *>(&*address), sizeof(*address)) < 0)
+    {
+        errorStream << "could not connect to " << socketPath << ": " << std::strerror(errno) << "\n";
+        close(fd);
+        return std::nullopt;
+    }
+    std::optional<std::string> reply;
+    if (write_message(fd, message))
+        reply = read_message(fd, std::numeric_limits<uint64_t>::max());
+    close(fd);
+    return reply;
+}
@@ -115,3 +115,11 @@ bool execute_command_list(std::ostream &outstream, std::ostream &errorStream, co
 
     return exit_code == 0;
 }
+
+bool execute_function(std::ostream &outstream, std::ostream &errorStream, int (*function)())
+{
+    // there is no fork on windows, inside of the current process the exit of the function would terminate the caller
+    // and its output would bypass outstream.
+    errorStream << "functions can not be executed in a separate process on windows\n";
+    return false;
+}
@@ -0,0 +1,15 @@
+#include "os/socket.h"
+
+bool serve_local_socket(std::ostream &errorStream, const std::string &socketPath,
+                        const std::function<std::string(const std::string &)> &)
+{
+    errorStream << "the compiler server is not supported on windows, " << socketPath << " can not be used\n";
+    return false;
+}
+
+std::optional<std::string> request_local_socket(std::ostream &errorStream, const std::string &socketPath,
+                                                const std::string &)
+{
+    errorStream << "the compiler server is not supported on windows, " << socketPath << " can not be used\n";
+    return std::nullopt;
+}
@@ -0,0 +1,387 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <new>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Lexer.h"
+#include "MacroParser.h"
+#include "Parser.h"
+#include "ScanKernels.h"
+#include "ast/ASTVisitor.h"
+#include "compiler/Compiler.h"
+#include "linker/pascal_linker.h"
+
+/**
+ * throughput benchmark of the front end of the compiler.
+ * A synthetic program is lexed, macro expanded and parsed several times and the best time of every phase is reported.
+ * The parser is measured again on a program with expressions of 10000 terms.
+ * The walks over the syntax tree are measured with dynamic_cast and with the kind of the nodes, followed by the type
+ * check and the code generation of the parsed program.
+ * The lexer is measured again on a multi-megabyte input with long comments, strings and identifiers, serially and
+ * split into a chunk per hardware thread.
+ * Finally the parser is measured with 500 and 4000 declarations in one scope and the type check with expressions
+ * nested 100 and 800 levels deep. With 8 times the input a linear phase takes about 8 times longer, a lookup which
+ * scans all declarations or a type resolution which revisits the subexpressions about 64 times.
+ * The last phase links the object file of the synthetic program into an executable.
+ * usage: wirthx_benchmark [number of functions] [iterations] [megabytes of the lexer input]
+ */
+
+// counts the heap allocations, so the allocations of a phase can be reported
+static std::atomic<size_t> allocationCount = 0;
+
+void *operator new(const size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size == 0 ? 1 : size))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+
+void operator delete(void *memory, size_t) noexcept { std::free(memory); }
+
+static std::string generateProgram(const size_t functionCount)
+{
+    std::stringstream program;
+    program << "program benchmark;\n\n";
+    for (size_t i = 0; i < functionCount; ++i)
+    {
+        program << "{ function number " << i << " of the benchmark }\n";
+        program << "function calc" << i << "(a : integer; b : integer): integer;\n";
+        program << "var\n    i : integer;\n    x : integer;\n";
+        program << "begin\n";
+        program << "    x := a;\n";
+        program << "    for i := 0 to b do\n";
+        program << "    begin\n";
+        program << "        if x > 1000 then\n";
+        program << "            x := x - b * 2\n";
+        program << "        else\n";
+        program << "            x := x + (i mod 7) + " << i << ";\n";
+        program << "    end;\n";
+        program << "    calc" << i << " := x;\n";
+        program << "end;\n\n";
+    }
+    program << "var\n    total : integer;\n";
+    program << "begin\n    total := 0;\n";
+    for (size_t i = 0; i < functionCount; ++i)
+    {
+        program << "    total := total + calc" << i << "(" << i << ", 10);\n";
+    }
+    program << "    writeln(total);\nend.\n";
+    return program.str();
+}
+
+// long chains of operators of every precedence, "a + b * 2 - c mod 3 ..." and comparisons joined by and and or
+static std::string generateExpressions(const size_t terms)
+{
+    std::stringstream program;
+    program << "program expressions;\n\nvar\n    a : integer;\n    b : integer;\n    c : boolean;\nbegin\n";
+    program << "    a := 1;\n    b := 2;\n    a := a";
+    for (size_t i = 1; i < terms; ++i)
+    {
+        switch (i % 4)
+        {
+            case 0:
+                program << " + b * " << i;
+                break;
+            case 1:
+                program << " - (a mod 7)";
+                break;
+            case 2:
+                program << " + a div 3";
+                break;
+            default:
+                program << " - " << i;
+                break;
+        }
+    }
+    program << ";\n    c := a > 0";
+    for (size_t i = 1; i < terms; ++i)
+    {
+        program << (i % 2 == 0 ? " and " : " or ") << "a + " << i << " <> b";
+    }
+    program << ";\n    writeln(a);\nend.\n";
+    return program.str();
+}
+
+static std::string generateLexerInput(const size_t megabytes)
+{
+    std::stringstream input;
+    input << "program lexer;\n";
+    for (size_t i = 0; input.tellp() < static_cast<std::streamoff>(megabytes * 1024 * 1024); ++i)
+    {
+        input << "{ this is a longer comment which describes the next statement, number " << i << ",\n"
+              << "  it spans two lines like the documentation of a function }\n";
+        input << "// a comment until the end of the line\n";
+        input << "someRatherLongIdentifierName" << i << " := anotherQuiteLongVariableName + "
+              << "'a string literal which is written to the console';\n";
+    }
+    input << "end.\n";
+    return input.str();
+}
+
+// a program with many globals and two procedures which declare the same locals
+static std::string generateDeclarations(const size_t count)
+{
+    std::stringstream program;
+    program << "program declarations;\n\nvar\n";
+    for (size_t i = 0; i < count; ++i)
+    {
+        program << "    g" << i << " : integer;\n";
+    }
+    for (const auto *procedure: {"first", "second"})
+    {
+        program << "\nprocedure " << procedure << "(a : integer);\nvar\n";
+        for (size_t i = 0; i < count; ++i)
+        {
+            program << "    l" << i << " : integer;\n";
+        }
+        program << "begin\n";
+        for (size_t i = 0; i < count; ++i)
+        {
+            program << "    l" << i << " := g" << i << " + a;\n";
+        }
+        program << "end;\n";
+    }
+    program << "\nbegin\n";
+    for (size_t i = 0; i < count; ++i)
+    {
+        program << "    g" << i << " := " << i << ";\n";
+    }
+    program << "    first(1);\n    second(2);\nend.\n";
+    return program.str();
+}
+
+// an expression nested to the given depth and a chain of calls of the same depth
+static std::string generateNestedExpressions(const size_t depth)
+{
+    std::stringstream program;
+    program << "program nested;\n\nfunction inc(x : integer): integer;\nbegin\n    inc := x + 1;\nend;\n\n";
+    program << "var\n    a : integer;\nbegin\n    a := 1;\n    a := a";
+    for (size_t i = 0; i < depth; ++i)
+    {
+        program << " + (a * 2";
+    }
+    program << std::string(depth, ')') << ";\n    a := ";
+    for (size_t i = 0; i < depth; ++i)
+    {
+        program << "inc(";
+    }
+    program << "a" << std::string(depth, ')') << ";\n    writeln(a);\nend.\n";
+    return program.str();
+}
+
+static double measure(const std::string &name, const size_t iterations, const size_t bytes, const size_t tokens,
+                      const std::function<void()> &function)
+{
+    double best = 0;
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+        if (i == 0 || duration.count() < best)
+            best = duration.count();
+    }
+    std::cout << name << ": " << best * 1000.0 << " ms, " << static_cast<double>(bytes) / best / (1024.0 * 1024.0)
+              << " MiB/s, " << static_cast<double>(tokens) / best / 1e6 << " M tokens/s\n";
+    return best;
+}
+
+int main(int argc, char **argv)
+{
+    const size_t functionCount = argc > 1 ? std::stoul(argv[1]) : 2000;
+    const size_t iterations = argc > 2 ? std::stoul(argv[2]) : 5;
+    const auto source = generateProgram(functionCount);
+    const MacroMap definitions = {{"UNIX", true}};
+
+    Lexer lexer;
+    auto tokens = lexer.tokenize("benchmark.pas", source);
+    MacroParser macroParser(definitions);
+    auto expandedTokens = macroParser.parseFile(tokens);
+    std::cout << "source: " << source.size() << " bytes, " << tokens.size() << " tokens, sizeof(Token) "
+              << sizeof(Token) << "\n";
+
+    measure("lexer", iterations, source.size(), tokens.size(),
+            [&] { tokens = Lexer().tokenize("benchmark.pas", source); });
+    measure("macro parser", iterations, source.size(), tokens.size(),
+            [&] { expandedTokens = MacroParser(definitions).parseFile(tokens); });
+    measure("parser", iterations, source.size(), expandedTokens.size(),
+            [&]
+            {
+                Parser parser({"rtl"}, "benchmark.pas", definitions, expandedTokens);
+                const auto unit = parser.parseFile();
+                if (parser.hasError())
+                    parser.printErrors(std::cerr, false);
+            });
+    {
+        const size_t terms = 10000;
+        const auto expressionSource = generateExpressions(terms);
+        const auto expressionTokens =
+                MacroParser(definitions).parseFile(lexer.tokenize("expressions.pas", expressionSource));
+        measure("parser (" + std::to_string(terms) + "-term expressions)", iterations, expressionSource.size(),
+                expressionTokens.size(),
+                [&]
+                {
+                    Parser parser({"rtl"}, "expressions.pas", definitions, expressionTokens);
+                    const auto unit = parser.parseFile();
+                    if (parser.hasError())
+                        parser.printErrors(std::cerr, false);
+                });
+    }
+    {
+        const size_t allocationsBefore = allocationCount.load();
+        Parser parser({"rtl"}, "benchmark.pas", definitions, expandedTokens);
+        const auto unit = parser.parseFile();
+        const size_t allocations = allocationCount.load() - allocationsBefore;
+        if (unit)
+        {
+            const auto &arena = unit->arena();
+            std::cout << "parser: " << allocations << " heap allocations, " << arena->nodeCount() << " AST nodes in "
+                      << arena->blockCount() << " arena blocks (" << arena->bytesUsed() / 1024 << " KiB)\n";
+        }
+    }
+    {
+        Parser parser({"rtl"}, "benchmark.pas", definitions, expandedTokens);
+        const auto unit = parser.parseFile();
+        const auto &nodes = unit->arena()->nodes();
+        size_t calls = 0;
+        measure("AST walk (dynamic_cast)", iterations, source.size(), expandedTokens.size(),
+                [&]
+                {
+                    calls = 0;
+                    for (auto *node: nodes)
+                    {
+                        if (dynamic_cast<FunctionCallNode *>(node) != nullptr)
+                            ++calls;
+                    }
+                });
+        measure("AST walk (node kind)", iterations, source.size(), expandedTokens.size(),
+                [&]
+                {
+                    calls = 0;
+                    for (auto *node: nodes)
+                    {
+                        if (nodeCast<FunctionCallNode>(node) != nullptr)
+                            ++calls;
+                    }
+                });
+        std::cout << "AST walk: " << nodes.size() << " nodes, " << calls << " function calls\n";
+    }
+    {
+        // every iteration generates the code of its own unit, so only the code generation is measured
+        std::vector<std::unique_ptr<UnitNode>> units;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            Parser parser({"rtl"}, "benchmark.pas", definitions, expandedTokens);
+            units.push_back(parser.parseFile());
+        }
+        measure("type check and codegen", iterations, source.size(), expandedTokens.size(),
+                [&]
+                {
+                    auto unit = std::move(units.back());
+                    units.pop_back();
+                    generate_ir(CompilerOptions{}, std::move(unit), std::cerr);
+                });
+    }
+    measure("streaming front end", iterations, source.size(), expandedTokens.size(),
+            [&]
+            {
+                auto tokenSource =
+                        std::make_unique<MacroParser>(definitions, std::make_unique<LexerSource>("benchmark.pas", source));
+                Parser parser({"rtl"}, "benchmark.pas", definitions, std::move(tokenSource));
+                const auto unit = parser.parseFile();
+                if (parser.hasError())
+                    parser.printErrors(std::cerr, false);
+            });
+
+    const size_t megabytes = argc > 3 ? std::stoul(argv[3]) : 16;
+    const auto lexerInput = generateLexerInput(megabytes);
+    auto lexerTokens = lexer.tokenize("lexer.pas", lexerInput);
+    std::cout << "lexer input: " << lexerInput.size() << " bytes, " << lexerTokens.size() << " tokens, "
+              << scanKernelName() << " scan kernels\n";
+    measure("lexer (long comments and strings)", iterations, lexerInput.size(), lexerTokens.size(),
+            [&] { lexerTokens = Lexer().tokenize("lexer.pas", lexerInput); });
+    const size_t chunkCount = std::max(std::thread::hardware_concurrency(), 1u);
+    measure("lexer (" + std::to_string(chunkCount) + " chunks)", iterations, lexerInput.size(), lexerTokens.size(),
+            [&] { lexerTokens = Lexer().tokenize(SourceFiles::add("lexer.pas", lexerInput).fileId(), chunkCount); });
+
+    std::vector<double> declarationTimes;
+    for (const size_t count: {500, 4000})
+    {
+        const auto declarationSource = generateDeclarations(count);
+        const auto declarationTokens =
+                MacroParser(definitions).parseFile(lexer.tokenize("declarations.pas", declarationSource));
+        declarationTimes.push_back(measure("parser (" + std::to_string(count) + " declarations)", iterations,
+                                           declarationSource.size(), declarationTokens.size(),
+                                           [&]
+                                           {
+                                               Parser parser({"rtl"}, "declarations.pas", definitions,
+                                                             declarationTokens);
+                                               const auto unit = parser.parseFile();
+                                               if (parser.hasError())
+                                                   parser.printErrors(std::cerr, false);
+                                           }));
+    }
+    std::cout << "parser: 8 times the declarations take " << declarationTimes[1] / declarationTimes[0]
+              << " times longer\n";
+
+    std::vector<double> nestingTimes;
+    for (const size_t depth: {100, 800})
+    {
+        const auto nestedSource = generateNestedExpressions(depth);
+        const auto nestedTokens = MacroParser(definitions).parseFile(lexer.tokenize("nested.pas", nestedSource));
+        // every iteration checks its own unit, so only the type check and the code generation are measured
+        std::vector<std::unique_ptr<UnitNode>> units;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            Parser parser({"rtl"}, "nested.pas", definitions, nestedTokens);
+            units.push_back(parser.parseFile());
+        }
+        nestingTimes.push_back(measure("type check and codegen (depth " + std::to_string(depth) + ")", iterations,
+                                       nestedSource.size(), nestedTokens.size(),
+                                       [&]
+                                       {
+                                           auto unit = std::move(units.back());
+                                           units.pop_back();
+                                           generate_ir(CompilerOptions{}, std::move(unit), std::cerr);
+                                       }));
+    }
+    std::cout << "type check: 8 times the depth takes " << nestingTimes[1] / nestingTimes[0] << " times longer\n";
+
+    {
+        // the program is compiled once, only the link of its object file is measured
+        const auto directory = std::filesystem::current_path() / "benchmark_link";
+        std::filesystem::create_directories(directory);
+        const auto programPath = directory / "benchmark.pas";
+        std::ofstream(programPath) << source;
+        CompilerOptions options;
+        options.rtlDirectories.emplace_back("rtl");
+        options.optimizationLevel = OptimizationLevel::O2;
+        options.outputDirectory = directory;
+        init_compiler();
+        std::stringstream output;
+        compile_file(options, programPath, std::cerr, output, output);
+
+        Parser parser({"rtl"}, "benchmark.pas", definitions, expandedTokens);
+        std::vector<std::string> flags;
+        for (const auto &lib: parser.parseFile()->collectLibsToLink())
+        {
+            flags.push_back("-l" + lib);
+        }
+        const auto objectFile = directory / "benchmark.o";
+        measure("linker", iterations, std::filesystem::file_size(objectFile), 0,
+                [&] { pascal_link_modules(std::cerr, directory, "benchmark", flags, {objectFile.string()}); });
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include "compiler/CompileServer.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "compiler/Compiler.h"
+#include "os/socket.h"
+
+/**
+ * starts a compiler server on a new socket in the temporary directory, the server runs until the tests end.
+ */
+static std::string startCompileServer()
+{
+    const auto socketPath =
+            std::filesystem::temp_directory_path() /
+            ("wirthx_test_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".sock");
+    CompilerOptions options;
+    options.compilerPath = "wirthx";
+    options.rtlDirectories.emplace_back("rtl");
+    options.serverSocket = socketPath.string();
+    std::thread([options] { run_compile_server(options); }).detach();
+
+    // the socket file exists as soon as the server listens
+    for (int i = 0; i < 1000 && !std::filesystem::exists(socketPath); ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::cout.flush();
+    return socketPath.string();
+}
+
+// the tests share one server, like the clients of a build
+static const std::string &compileServerSocket()
+{
+    static const std::string socketPath = startCompileServer();
+    return socketPath;
+}
+
+TEST(CompileServerTest, CompilesThroughTheServer)
+{
+#ifdef _WIN32
+    GTEST_SKIP() << "the compiler server is not supported on windows";
+#endif
+    const auto &socketPath = compileServerSocket();
+    ASSERT_TRUE(std::filesystem::exists(socketPath));
+    const auto outputDirectory = std::filesystem::current_path() / "compile_server";
+    std::filesystem::remove_all(outputDirectory);
+    std::filesystem::create_directories(outputDirectory);
+
+    CompilerOptions options;
+    options.connectSocket = socketPath;
+    testing::internal::CaptureStdout();
+    testing::internal::CaptureStderr();
+    const int exitCode = run_compile_client(options, {"--connect", socketPath, "--run", "-O2", "--output",
+                                                      outputDirectory.string(), "testfiles/helloworld.pas"});
+    const auto output = testing::internal::GetCapturedStdout();
+    const auto errors = testing::internal::GetCapturedStderr();
+
+    ASSERT_EQ(exitCode, 0) << errors;
+    ASSERT_EQ(errors, "");
+    std::ifstream expected("testfiles/helloworld.txt");
+    std::stringstream expectedOutput;
+    expectedOutput << expected.rdbuf();
+    // the messages of the compiler are written before the output of the program
+    ASSERT_TRUE(output.ends_with(expectedOutput.str())) << output;
+    ASSERT_NE(output.find("Wrote"), std::string::npos) << output;
+}
+
+TEST(CompileServerTest, ReportsACompileError)
+{
+#ifdef _WIN32
+    GTEST_SKIP() << "the compiler server is not supported on windows";
+#endif
+    const auto &socketPath = compileServerSocket();
+    ASSERT_TRUE(std::filesystem::exists(socketPath));
+    const auto outputDirectory = std::filesystem::current_path() / "compile_server_error";
+    std::filesystem::remove_all(outputDirectory);
+    std::filesystem::create_directories(outputDirectory);
+
+    CompilerOptions options;
+    options.connectSocket = socketPath;
+    testing::internal::CaptureStdout();
+    testing::internal::CaptureStderr();
+    const int exitCode = run_compile_client(options, {"--connect", socketPath, "--run", "-O2", "--output",
+                                                      outputDirectory.string(), "errortests/missing_return_type.pas"});
+    const auto output = testing::internal::GetCapturedStdout();
+    const auto errors = testing::internal::GetCapturedStderr();
+
+    ASSERT_EQ(exitCode, 1) << output << errors;
+    // the compiler writes its errors into the same stream as the output of the program, like the command line does
+    ASSERT_NE(output.find("the return type for the function \"my_function\" is missing."), std::string::npos)
+            << output;
+    ASSERT_FALSE(std::filesystem::exists(outputDirectory / "missing_return_type"));
+}
+
+TEST(CompileServerTest, RejectsAnInvalidWorkingDirectory)
+{
+#ifdef _WIN32
+    GTEST_SKIP() << "the compiler server is not supported on windows";
+#endif
+    const auto &socketPath = compileServerSocket();
+    ASSERT_TRUE(std::filesystem::exists(socketPath));
+    const auto workingDirectory = std::filesystem::current_path() / "compile_server_missing";
+    std::filesystem::remove_all(workingDirectory);
+
+    std::stringstream errorStream;
+    const auto reply = request_local_socket(
+            errorStream, socketPath, encodeFields({workingDirectory.string(), "testfiles/helloworld.pas"}));
+    ASSERT_TRUE(reply.has_value()) << errorStream.str();
+    const auto fields = decodeFields(*reply);
+    ASSERT_TRUE(fields.has_value());
+    ASSERT_EQ(fields->size(), 3);
+    ASSERT_EQ((*fields)[0], "1");
+    ASSERT_EQ((*fields)[1], "");
+    ASSERT_NE((*fields)[2].find("is not valid"), std::string::npos) << (*fields)[2];
+
+    // the server still answers after the failed request
+    const auto nextReply = request_local_socket(errorStream, socketPath, encodeFields({}));
+    ASSERT_TRUE(nextReply.has_value()) << errorStream.str();
+    ASSERT_TRUE(decodeFields(*nextReply).has_value());
+}
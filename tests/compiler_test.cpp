@@ -1,11 +1,18 @@
 #include "compiler/Compiler.h"
 #include <algorithm>
+#include <chrono>
 #include <fstream>
+#include <functional>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <set>
+#include <sstream>
 #include <string>
 #include <utility>
 
+#include "Lexer.h"
+#include "MacroParser.h"
+#include "Parser.h"
 #include "os/command.h"
 
 using namespace std::literals;
@@ -34,6 +41,77 @@ public:
     static void SetUpTestSuite() { init_compiler(); }
 };
 
+class JitTest : public testing::TestWithParam<std::string>
+{
+public:
+    static void SetUpTestSuite() { init_compiler(); }
+};
+
+class IncrementalTest : public testing::TestWithParam<std::string>
+{
+public:
+    static void SetUpTestSuite() { init_compiler(); }
+};
+
+class ParallelCodegenTest : public testing::TestWithParam<std::string>
+{
+public:
+    static void SetUpTestSuite() { init_compiler(); }
+};
+
+class PrecompiledRtlTest : public testing::TestWithParam<std::string>
+{
+public:
+    static void SetUpTestSuite()
+    {
+        init_compiler();
+        std::filesystem::remove_all("precompiled_rtl");
+        std::filesystem::copy("rtl", "precompiled_rtl", std::filesystem::copy_options::recursive);
+    }
+};
+
+/**
+ * compares the output of a program with the expected output in the given file, carriage returns are ignored.
+ */
+static void assertProgramOutput(const std::filesystem::path &output_path, std::string result)
+{
+    std::ifstream file(output_path);
+    ASSERT_TRUE(file.is_open()) << std::filesystem::absolute(output_path);
+    std::stringstream expected;
+    expected << file.rdbuf();
+    result.erase(std::ranges::remove(result, '\r').begin(), result.end());
+    ASSERT_EQ(result, expected.str());
+}
+
+/**
+ * compiles and runs the test program with the given name with -O2 and the rtl of the tests and compares its output
+ * with the expected output. adjustOptions changes the options for a test before the program is compiled.
+ */
+static void assertTestProgram(const std::string &name, const std::function<void(CompilerOptions &)> &adjustOptions,
+                              std::ostream &messageStream = std::cout)
+{
+    std::filesystem::path base_path = "testfiles";
+    std::filesystem::path input_path = base_path / (name + ".pas");
+    std::filesystem::path output_path = base_path / (name + ".txt");
+    ASSERT_TRUE(std::filesystem::exists(input_path));
+    ASSERT_TRUE(std::filesystem::exists(output_path));
+    std::stringstream ostream;
+    std::stringstream erstream;
+    CompilerOptions options;
+    options.rtlDirectories.emplace_back("rtl");
+    options.runProgram = true;
+    options.optimizationLevel = OptimizationLevel::O2;
+    options.outputDirectory = std::filesystem::current_path();
+    adjustOptions(options);
+    if (options.option == CompileOption::JIT)
+        jit_file(options, input_path, erstream, ostream, messageStream);
+    else
+        compile_file(options, input_path, erstream, ostream, messageStream);
+
+    ASSERT_EQ(erstream.str(), "");
+    assertProgramOutput(output_path, ostream.str());
+}
+
 TEST_P(CompilerTest, TestNoError)
 {
     // Inside a test, access the test parameter with the GetParam() method
@@ -56,9 +134,9 @@ TEST_P(CompilerTest, TestNoError)
     options.rtlDirectories.emplace_back("rtl");
 
     options.runProgram = true;
-    options.buildMode = BuildMode::Release;
+    options.optimizationLevel = OptimizationLevel::O2;
     options.outputDirectory = std::filesystem::current_path();
-    compile_file(options, input_path, erstream, ostream);
+    compile_file(options, input_path, erstream, ostream, std::cout);
 
     std::ifstream file;
     std::istringstream is;
@@ -105,11 +183,11 @@ TEST_P(ProjectEulerTest, TestNoError)
     CompilerOptions options;
     options.rtlDirectories.emplace_back("rtl");
 
-    options.buildMode = BuildMode::Release;
+    options.optimizationLevel = OptimizationLevel::O2;
 
     options.runProgram = true;
     options.outputDirectory = std::filesystem::current_path();
-    compile_file(options, input_path, erstream, ostream);
+    compile_file(options, input_path, erstream, ostream, std::cout);
 
     std::ifstream file;
     std::istringstream is;
@@ -153,7 +231,7 @@ TEST_P(CompilerTestError, CompilerTestWithError)
     CompilerOptions options;
     options.rtlDirectories.emplace_back("rtl");
     options.colorOutput = false;
-    compile_file(options, input_path, erstream, ostream);
+    compile_file(options, input_path, erstream, ostream, std::cout);
 
     std::ifstream file;
     std::istringstream is;
@@ -206,9 +284,9 @@ TEST_P(WriteToStdErrTest, WriteToStdErrTest)
     options.rtlDirectories.emplace_back("rtl");
 
     options.runProgram = true;
-    options.buildMode = BuildMode::Release;
+    options.optimizationLevel = OptimizationLevel::O2;
     options.outputDirectory = std::filesystem::current_path();
-    compile_file(options, input_path, erstream, ostream);
+    compile_file(options, input_path, erstream, ostream, std::cout);
 
     std::ifstream file;
     std::istringstream is;
@@ -240,19 +318,412 @@ TEST_P(WriteToStdErrTest, WriteToStdErrTest)
     ASSERT_EQ(result, expected);
 }
 
+TEST_P(JitTest, TestNoError)
+{
+#ifdef _WIN32
+    GTEST_SKIP() << "the jit is not supported on windows";
+#endif
+    const auto jit = [](CompilerOptions &options) { options.option = CompileOption::JIT; };
+    ASSERT_NO_FATAL_FAILURE(assertTestProgram(GetParam(), jit));
+}
+
+TEST_P(ParallelCodegenTest, TestNoError)
+{
+    const auto name = GetParam();
+    const auto outputDirectory = std::filesystem::current_path() / "parallel";
+    // object files of an earlier run would satisfy the checks below
+    std::filesystem::remove_all(outputDirectory);
+    std::filesystem::create_directories(outputDirectory);
+    const auto parallel = [&](CompilerOptions &options)
+    {
+        options.jobs = 4;
+        options.outputDirectory = outputDirectory;
+    };
+    ASSERT_NO_FATAL_FAILURE(assertTestProgram(name, parallel));
+
+    for (int partition = 0; partition < 4; ++partition)
+    {
+        ASSERT_TRUE(std::filesystem::exists(outputDirectory / (name + "." + std::to_string(partition) + ".o")));
+    }
+}
+
+/**
+ * returns the names of the object files which the compiler reported as written.
+ */
+static std::set<std::string> writtenObjectFiles(const std::stringstream &messages)
+{
+    std::set<std::string> objectFiles;
+    std::istringstream lines(messages.str());
+    for (std::string line; std::getline(lines, line);)
+    {
+        if (line.starts_with("Wrote ") && line.ends_with(".o"))
+        {
+            objectFiles.insert(std::filesystem::path(line.substr(6)).stem().string());
+        }
+    }
+    return objectFiles;
+}
+
+TEST_P(IncrementalTest, TestNoError)
+{
+    const auto outputDirectory = std::filesystem::current_path() / "incremental";
+    // the first build has to be a cold build without a manifest or object files of an earlier run
+    std::filesystem::remove_all(outputDirectory);
+    std::filesystem::create_directories(outputDirectory);
+    const auto incremental = [&](CompilerOptions &options)
+    {
+        options.incremental = true;
+        options.outputDirectory = outputDirectory;
+    };
+    ASSERT_NO_FATAL_FAILURE(assertTestProgram(GetParam(), incremental));
+
+    ASSERT_TRUE(std::filesystem::exists(outputDirectory / "wirthx.manifest"));
+    ASSERT_TRUE(std::filesystem::exists(outputDirectory / "system.o"));
+
+    // the second build has to reuse every object file
+    std::stringstream messages;
+    ASSERT_NO_FATAL_FAILURE(assertTestProgram(GetParam(), incremental, messages));
+    ASSERT_EQ(writtenObjectFiles(messages), std::set<std::string>{});
+}
+
+static void replaceInFile(const std::filesystem::path &path, const std::string &from, const std::string &to)
+{
+    std::ifstream input(path);
+    std::stringstream content;
+    content << input.rdbuf();
+    input.close();
+    auto source = content.str();
+    ASSERT_NE(source.find(from), std::string::npos) << from;
+    source.replace(source.find(from), from.size(), to);
+    std::ofstream(path) << source;
+}
+
+// usesdiamond uses testunit directly and through diamondunit, the copies of the files can be changed by the tests
+static std::filesystem::path copyDiamondUnits(const std::string &name)
+{
+    const auto directory = std::filesystem::current_path() / name;
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    for (const auto *file: {"usesdiamond.pas", "testunit.pas", "diamondunit.pas"})
+    {
+        std::filesystem::copy_file(std::filesystem::path("testfiles") / file, directory / file);
+    }
+    return directory;
+}
+
+TEST(IncrementalChangeTest, RebuildsOnlyAffectedUnits)
+{
+    init_compiler();
+    const auto directory = copyDiamondUnits("incremental_change");
+    const auto input_path = directory / "usesdiamond.pas";
+    CompilerOptions options;
+    options.rtlDirectories.emplace_back("rtl");
+    options.incremental = true;
+    options.runProgram = true;
+    options.optimizationLevel = OptimizationLevel::O2;
+    options.outputDirectory = directory;
+
+    const auto build = [&](const std::string &expected)
+    {
+        std::stringstream ostream;
+        std::stringstream erstream;
+        std::stringstream messages;
+        compile_file(options, input_path, erstream, ostream, messages);
+        EXPECT_EQ(erstream.str(), "");
+        EXPECT_EQ(ostream.str(), expected);
+        return writtenObjectFiles(messages);
+    };
+
+    ASSERT_EQ(build("126\n"), (std::set<std::string>{"usesdiamond", "testunit", "diamondunit", "system"}));
+    ASSERT_EQ(build("126\n"), std::set<std::string>{});
+
+    // a change of the implementation only rebuilds the unit itself
+    replaceInFile(directory / "testunit.pas", "t42 := 42;", "t42 := 43;");
+    ASSERT_EQ(build("129\n"), std::set<std::string>{"testunit"});
+
+    // a change of the interface rebuilds the units and the program which import it
+    replaceInFile(directory / "testunit.pas", "function t42(): integer;\n\nimplementation",
+                  "function t42(): integer;\n    function t1(): integer;\n\nimplementation");
+    replaceInFile(directory / "testunit.pas", "end.",
+                  "    function t1(): integer;\n    begin\n        t1 := 1;\n    end;\nend.");
+    ASSERT_EQ(build("129\n"), (std::set<std::string>{"usesdiamond", "testunit", "diamondunit"}));
+}
+
+// the units are out of date for the cache of the parsed units, but their sources are unchanged
+static void touchUnits(const std::filesystem::path &directory)
+{
+    for (const auto *file: {"testunit.pas", "diamondunit.pas"})
+    {
+        const auto path = directory / file;
+        std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::hours(1));
+    }
+}
+
+TEST(InterfaceCacheTest, LoadsInterfacesWithoutBodies)
+{
+    const auto directory = copyDiamondUnits("interface_cache");
+    const auto cacheDirectory = directory / "cache";
+    const MacroMap definitions = {{"UNIX", true}};
+    std::ifstream file(directory / "usesdiamond.pas");
+    const std::string source((std::istreambuf_iterator(file)), std::istreambuf_iterator<char>());
+
+    // the units next to the program are treated as if their bodies were compiled on their own
+    const auto parse = [&]
+    {
+        Parser parser({"rtl"}, directory / "usesdiamond.pas", definitions,
+                      MacroParser(definitions).parseFile(Lexer().tokenize("usesdiamond.pas", source)));
+        parser.setInterfaceCache(cacheDirectory, [&directory](const std::filesystem::path &unitPath)
+                                 { return unitPath.parent_path() == directory; });
+        auto unit = parser.parseFile();
+        if (parser.hasError())
+        {
+            parser.printErrors(std::cerr, false);
+        }
+        EXPECT_FALSE(parser.hasMessages());
+        return unit;
+    };
+
+    // the first parse reads the sources and fills the cache
+    const auto parsedUnit = parse();
+    ASSERT_NE(parsedUnit, nullptr);
+    ASSERT_TRUE(parsedUnit->getFunctionDefinition("t42").has_value());
+    ASSERT_NE(parsedUnit->getFunctionDefinition("t42").value()->body(), nullptr);
+    const auto entries = std::ranges::count_if(std::filesystem::directory_iterator(cacheDirectory),
+                                               [](const std::filesystem::directory_entry &entry)
+                                               { return entry.path().extension() == ".interface"; });
+    ASSERT_GE(entries, 2);
+
+    // the units are out of date now, their unchanged sources are loaded from the cache
+    touchUnits(directory);
+    const auto cachedUnit = parse();
+    ASSERT_NE(cachedUnit, nullptr);
+    ASSERT_TRUE(cachedUnit->getFunctionDefinition("t42").has_value());
+    ASSERT_EQ(cachedUnit->getFunctionDefinition("t42").value()->body(), nullptr);
+    ASSERT_TRUE(cachedUnit->getFunctionDefinition("t84").has_value());
+    ASSERT_EQ(cachedUnit->getFunctionDefinition("t84").value()->unitName(), "diamondunit");
+}
+
+TEST(InterfaceCacheTest, IncrementalBuild)
+{
+    init_compiler();
+    const auto directory = copyDiamondUnits("interface_cache_incremental");
+    CompilerOptions options;
+    options.rtlDirectories.emplace_back("rtl");
+    options.incremental = true;
+    options.runProgram = true;
+    options.optimizationLevel = OptimizationLevel::O2;
+    options.outputDirectory = directory;
+    options.cacheDirectory = directory / "cache";
+
+    const auto build = [&](const std::string &expected)
+    {
+        std::stringstream ostream;
+        std::stringstream erstream;
+        std::stringstream messages;
+        compile_file(options, directory / "usesdiamond.pas", erstream, ostream, messages);
+        EXPECT_EQ(erstream.str(), "");
+        EXPECT_EQ(ostream.str(), expected);
+    };
+    ASSERT_NO_FATAL_FAILURE(build("126\n"));
+
+    // the program is rebuilt against the cached interfaces of the units
+    touchUnits(directory);
+    replaceInFile(directory / "usesdiamond.pas", "writeln(x);", "writeln(x + 1);");
+    ASSERT_NO_FATAL_FAILURE(build("127\n"));
+}
+
+TEST(InterfaceCacheTest, IncrementalBuildReadsTheCache)
+{
+#ifdef _WIN32
+    GTEST_SKIP() << "incremental builds are not supported on windows";
+#endif
+    init_compiler();
+    const auto directory = copyDiamondUnits("interface_cache_read");
+    const auto cacheDirectory = directory / "cache";
+    CompilerOptions options;
+    options.rtlDirectories.emplace_back("rtl");
+    options.incremental = true;
+    options.runProgram = true;
+    options.optimizationLevel = OptimizationLevel::O2;
+    options.outputDirectory = directory;
+    options.cacheDirectory = cacheDirectory;
+
+    const auto build = [&](std::string &output, std::string &errors)
+    {
+        std::stringstream ostream;
+        std::stringstream erstream;
+        std::stringstream messages;
+        compile_file(options, directory / "usesdiamond.pas", erstream, ostream, messages);
+        output = ostream.str();
+        errors = erstream.str();
+    };
+    std::string output;
+    std::string errors;
+    build(output, errors);
+    ASSERT_EQ(errors, "");
+    ASSERT_EQ(output, "126\n");
+
+    // the unchanged units are out of date, the same program is built against their cached interfaces
+    touchUnits(directory);
+    build(output, errors);
+    ASSERT_EQ(errors, "");
+    ASSERT_EQ(output, "126\n");
+
+    // without t42 in the cached interface of testunit the program only fails if the interface is read from the cache
+    size_t changedEntries = 0;
+    for (const auto &entry: std::filesystem::directory_iterator(cacheDirectory))
+    {
+        const auto filename = entry.path().filename().string();
+        if (filename.starts_with("testunit.") && filename.ends_with(".interface"))
+        {
+            ASSERT_NO_FATAL_FAILURE(replaceInFile(entry.path(), "function \"t42\"", "function \"t43\""));
+            ++changedEntries;
+        }
+    }
+    ASSERT_GE(changedEntries, 1u);
+    touchUnits(directory);
+    build(output, errors);
+    ASSERT_NE(errors.find("t42"), std::string::npos) << errors;
+}
+
+TEST_P(PrecompiledRtlTest, TestNoError)
+{
+#ifdef _WIN32
+    GTEST_SKIP() << "precompiled units are not supported on windows";
+#endif
+    const auto precompiledRtl = [](CompilerOptions &options) { options.rtlDirectories = {"precompiled_rtl"}; };
+
+    // the rtl is built once for all programs of the suite, the name of the bitcode contains the hash of its options
+    static bool rtlBuilt = false;
+    if (!rtlBuilt)
+    {
+        CompilerOptions options;
+        options.optimizationLevel = OptimizationLevel::O2;
+        precompiledRtl(options);
+        std::stringstream erstream;
+        ASSERT_TRUE(build_rtl(options, erstream, std::cout));
+        ASSERT_EQ(erstream.str(), "");
+        rtlBuilt = true;
+    }
+    ASSERT_TRUE(std::ranges::any_of(std::filesystem::directory_iterator("precompiled_rtl"),
+                                    [](const std::filesystem::directory_entry &entry)
+                                    {
+                                        const auto name = entry.path().filename().string();
+                                        return name.starts_with("system.") && name.ends_with(".bc");
+                                    }));
+
+    ASSERT_NO_FATAL_FAILURE(assertTestProgram(GetParam(), precompiledRtl));
+}
+
+// a program with many globals and two procedures which declare the same locals, so the locals of the first one have
+// to be dropped when it ends
+static std::string generateDeclarations(const size_t count)
+{
+    std::stringstream program;
+    program << "program declarations;\n\nvar\n";
+    for (size_t i = 0; i < count; ++i)
+    {
+        program << "    g" << i << " : integer;\n";
+    }
+    for (const auto *procedure: {"first", "second"})
+    {
+        program << "\nprocedure " << procedure << "(a : integer);\nvar\n";
+        for (size_t i = 0; i < count; ++i)
+        {
+            program << "    l" << i << " : integer;\n";
+        }
+        program << "begin\n";
+        for (size_t i = 0; i < count; ++i)
+        {
+            program << "    l" << i << " := g" << i << " + a;\n";
+        }
+        program << "end;\n";
+    }
+    program << "\nbegin\n";
+    for (size_t i = 0; i < count; ++i)
+    {
+        program << "    g" << i << " := " << i << ";\n";
+    }
+    program << "    first(1);\n    second(2);\nend.\n";
+    return program.str();
+}
+
+TEST(ParserTest, ManyDeclarations)
+{
+    const MacroMap definitions = {{"UNIX", true}};
+    const auto source = generateDeclarations(4000);
+    Parser parser({"rtl"}, "declarations.pas", definitions,
+                  MacroParser(definitions).parseFile(Lexer().tokenize("declarations.pas", source)));
+    const auto unit = parser.parseFile();
+    if (parser.hasError())
+    {
+        parser.printErrors(std::cerr, false);
+    }
+    ASSERT_FALSE(parser.hasError());
+    ASSERT_NE(unit, nullptr);
+}
+
+// an expression nested to the given depth and a chain of calls of the same depth, the type of every subexpression
+// is needed by the expression which encloses it
+static std::string generateNestedExpressions(const size_t depth)
+{
+    std::stringstream program;
+    program << "program nested;\n\nfunction inc(x : integer): integer;\nbegin\n    inc := x + 1;\nend;\n\n";
+    program << "var\n    a : integer;\nbegin\n    a := 1;\n    a := a";
+    for (size_t i = 0; i < depth; ++i)
+    {
+        program << " + (a * 2";
+    }
+    program << std::string(depth, ')') << ";\n    a := ";
+    for (size_t i = 0; i < depth; ++i)
+    {
+        program << "inc(";
+    }
+    program << "a" << std::string(depth, ')') << ";\n    writeln(a);\nend.\n";
+    return program.str();
+}
+
+TEST(TypeCheckTest, DeeplyNestedExpressions)
+{
+    init_compiler();
+    const MacroMap definitions = {{"UNIX", true}};
+    const auto source = generateNestedExpressions(800);
+    Parser parser({"rtl"}, "nested.pas", definitions,
+                  MacroParser(definitions).parseFile(Lexer().tokenize("nested.pas", source)));
+    auto unit = parser.parseFile();
+    if (parser.hasError())
+    {
+        parser.printErrors(std::cerr, false);
+    }
+    ASSERT_FALSE(parser.hasError());
+    ASSERT_TRUE(generate_ir(CompilerOptions{}, std::move(unit), std::cerr));
+}
 
 INSTANTIATE_TEST_SUITE_P(CompilerTestNoError, CompilerTest,
                          testing::Values("helloworld", "functions", "math", "includetest", "whileloop", "conditions",
                                          "forloop", "arraytest", "constantstest", "customint", "logicalcondition",
                                          "basicvec2", "dynarray", "externalfunction", "stringtest", "readfile",
                                          "repeatuntil", "stringcompare", "pointer_test", "rule110", "positive_assert",
-                                         "stringconv", "singletest", "doubletest"));
+                                         "stringconv", "singletest", "doubletest", "usesdiamond", "shadowing",
+                                         "expressions"));
 
 INSTANTIATE_TEST_SUITE_P(CompilerTestWithError, CompilerTestError,
-                         testing::Values("arrayaccess", "missing_return_type", "wrong_return_type", "parsing_errors"));
+                         testing::Values("arrayaccess", "missing_return_type", "wrong_return_type", "parsing_errors",
+                                         "comparison_chain", "unitcycle"));
 
 INSTANTIATE_TEST_SUITE_P(ProjectEuler, ProjectEulerTest,
                          testing::Values("problem1", "problem2", "problem3", "problem4", "problem5", "problem6",
                                          "problem7", "problem8", "problem9", "problem10"));
 
 INSTANTIATE_TEST_SUITE_P(WriteToStdErrTest, WriteToStdErrTest, testing::Values("writetoerror"));
+
+INSTANTIATE_TEST_SUITE_P(JitTestNoError, JitTest,
+                         testing::Values("helloworld", "functions", "math", "includetest", "forloop", "arraytest",
+                                         "externalfunction", "stringtest", "readfile", "rule110"));
+
+INSTANTIATE_TEST_SUITE_P(ParallelCodegen, ParallelCodegenTest,
+                         testing::Values("helloworld", "functions", "includetest", "stringconv", "rule110"));
+INSTANTIATE_TEST_SUITE_P(Incremental, IncrementalTest, testing::Values("helloworld", "includetest", "stringconv"));
+
+INSTANTIATE_TEST_SUITE_P(PrecompiledRtl, PrecompiledRtlTest,
+                         testing::Values("helloworld", "stringconv", "stringcompare", "repeatuntil", "includetest"));
@@ -0,0 +1,10 @@
+program comparison_chain;
+var
+    a, b, c : integer;
+begin
+    a := 1;
+    b := 1;
+    c := 1;
+    if a = b = c then
+        writeln('chained');
+end.
@@ -0,0 +1,13 @@
+unit cyclea;
+
+interface
+    uses cycleb;
+
+    function twice(value: integer): integer;
+
+implementation
+    function twice(value: integer): integer;
+    begin
+        twice := value * 2;
+    end;
+end.
@@ -0,0 +1,13 @@
+unit cycleb;
+
+interface
+    uses cyclea;
+
+    function half(value: integer): integer;
+
+implementation
+    function half(value: integer): integer;
+    begin
+        half := value div 2;
+    end;
+end.
@@ -0,0 +1,5 @@
+program unitcycle;
+uses cyclea;
+begin
+    writeln(1);
+end.
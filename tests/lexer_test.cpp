@@ -1,4 +1,9 @@
 #include "Lexer.h"
+#include "MacroParser.h"
+#include "ScanKernels.h"
+#include <fstream>
+#include <random>
+#include <set>
 #include <gtest/gtest.h>
 #include <magic_enum/magic_enum.hpp>
 #include <string>
@@ -17,9 +22,9 @@ TEST(LexerTest, LexHelloWorld)
     end.)");
 
     EXPECT_EQ(result.size(), 12);
-    ASSERT_EQ(result[0].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[0].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[0].lexical(), "program"sv);
-    ASSERT_EQ(result[1].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[1].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[1].lexical(), "Test"sv);
 }
 
@@ -30,29 +35,29 @@ TEST(LexerTest, LexNumbers)
     auto result = lexer.tokenize("filename.pas", R"(x := (1 + 2) * 5;)");
 
     EXPECT_EQ(result.size(), 12);
-    ASSERT_EQ(result[0].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[0].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[0].lexical(), "x"sv);
-    ASSERT_EQ(result[1].tokenType, TokenType::COLON);
+    ASSERT_EQ(result[1].tokenType(), TokenType::COLON);
     ASSERT_EQ(result[1].lexical(), ":"sv);
-    ASSERT_EQ(result[2].tokenType, TokenType::EQUAL);
+    ASSERT_EQ(result[2].tokenType(), TokenType::EQUAL);
     ASSERT_EQ(result[2].lexical(), "="sv);
-    ASSERT_EQ(result[3].tokenType, TokenType::LEFT_CURLY);
+    ASSERT_EQ(result[3].tokenType(), TokenType::LEFT_CURLY);
     ASSERT_EQ(result[3].lexical(), "("sv);
-    ASSERT_EQ(result[4].tokenType, TokenType::NUMBER);
+    ASSERT_EQ(result[4].tokenType(), TokenType::NUMBER);
     ASSERT_EQ(result[4].lexical(), "1"sv);
-    ASSERT_EQ(result[5].tokenType, TokenType::PLUS);
+    ASSERT_EQ(result[5].tokenType(), TokenType::PLUS);
     ASSERT_EQ(result[5].lexical(), "+"sv);
-    ASSERT_EQ(result[6].tokenType, TokenType::NUMBER);
+    ASSERT_EQ(result[6].tokenType(), TokenType::NUMBER);
     ASSERT_EQ(result[6].lexical(), "2"sv);
-    ASSERT_EQ(result[7].tokenType, TokenType::RIGHT_CURLY);
+    ASSERT_EQ(result[7].tokenType(), TokenType::RIGHT_CURLY);
     ASSERT_EQ(result[7].lexical(), ")"sv);
-    ASSERT_EQ(result[8].tokenType, TokenType::MUL);
+    ASSERT_EQ(result[8].tokenType(), TokenType::MUL);
     ASSERT_EQ(result[8].lexical(), "*"sv);
-    ASSERT_EQ(result[9].tokenType, TokenType::NUMBER);
+    ASSERT_EQ(result[9].tokenType(), TokenType::NUMBER);
     ASSERT_EQ(result[9].lexical(), "5"sv);
-    ASSERT_EQ(result[10].tokenType, TokenType::SEMICOLON);
+    ASSERT_EQ(result[10].tokenType(), TokenType::SEMICOLON);
     ASSERT_EQ(result[10].lexical(), ";"sv);
-    ASSERT_EQ(result[11].tokenType, TokenType::T_EOF);
+    ASSERT_EQ(result[11].tokenType(), TokenType::T_EOF);
 }
 
 TEST(LexerTest, LexNegNumbers)
@@ -62,29 +67,29 @@ TEST(LexerTest, LexNegNumbers)
     auto result = lexer.tokenize("filename.pas", R"(x := (-1 + 2) * -5;)");
 
     EXPECT_EQ(result.size(), 12);
-    ASSERT_EQ(result[0].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[0].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[0].lexical(), "x"sv);
-    ASSERT_EQ(result[1].tokenType, TokenType::COLON);
+    ASSERT_EQ(result[1].tokenType(), TokenType::COLON);
     ASSERT_EQ(result[1].lexical(), ":"sv);
-    ASSERT_EQ(result[2].tokenType, TokenType::EQUAL);
+    ASSERT_EQ(result[2].tokenType(), TokenType::EQUAL);
     ASSERT_EQ(result[2].lexical(), "="sv);
-    ASSERT_EQ(result[3].tokenType, TokenType::LEFT_CURLY);
+    ASSERT_EQ(result[3].tokenType(), TokenType::LEFT_CURLY);
     ASSERT_EQ(result[3].lexical(), "("sv);
-    ASSERT_EQ(result[4].tokenType, TokenType::NUMBER);
+    ASSERT_EQ(result[4].tokenType(), TokenType::NUMBER);
     ASSERT_EQ(result[4].lexical(), "-1"sv);
-    ASSERT_EQ(result[5].tokenType, TokenType::PLUS);
+    ASSERT_EQ(result[5].tokenType(), TokenType::PLUS);
     ASSERT_EQ(result[5].lexical(), "+"sv);
-    ASSERT_EQ(result[6].tokenType, TokenType::NUMBER);
+    ASSERT_EQ(result[6].tokenType(), TokenType::NUMBER);
     ASSERT_EQ(result[6].lexical(), "2"sv);
-    ASSERT_EQ(result[7].tokenType, TokenType::RIGHT_CURLY);
+    ASSERT_EQ(result[7].tokenType(), TokenType::RIGHT_CURLY);
     ASSERT_EQ(result[7].lexical(), ")"sv);
-    ASSERT_EQ(result[8].tokenType, TokenType::MUL);
+    ASSERT_EQ(result[8].tokenType(), TokenType::MUL);
     ASSERT_EQ(result[8].lexical(), "*"sv);
-    ASSERT_EQ(result[9].tokenType, TokenType::NUMBER);
+    ASSERT_EQ(result[9].tokenType(), TokenType::NUMBER);
     ASSERT_EQ(result[9].lexical(), "-5"sv);
-    ASSERT_EQ(result[10].tokenType, TokenType::SEMICOLON);
+    ASSERT_EQ(result[10].tokenType(), TokenType::SEMICOLON);
     ASSERT_EQ(result[10].lexical(), ";"sv);
-    ASSERT_EQ(result[11].tokenType, TokenType::T_EOF);
+    ASSERT_EQ(result[11].tokenType(), TokenType::T_EOF);
 }
 
 TEST(LexerTest, LexVarDeclaration)
@@ -94,17 +99,17 @@ TEST(LexerTest, LexVarDeclaration)
     auto result = lexer.tokenize("filename.pas", R"(var x :integer;)");
 
     EXPECT_EQ(result.size(), 6);
-    ASSERT_EQ(result[0].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[0].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[0].lexical(), "var"sv);
-    ASSERT_EQ(result[1].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[1].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[1].lexical(), "x"sv);
-    ASSERT_EQ(result[2].tokenType, TokenType::COLON);
+    ASSERT_EQ(result[2].tokenType(), TokenType::COLON);
     ASSERT_EQ(result[2].lexical(), ":"sv);
-    ASSERT_EQ(result[3].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[3].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[3].lexical(), "integer"sv);
-    ASSERT_EQ(result[4].tokenType, TokenType::SEMICOLON);
+    ASSERT_EQ(result[4].tokenType(), TokenType::SEMICOLON);
     ASSERT_EQ(result[4].lexical(), ";"sv);
-    ASSERT_EQ(result[5].tokenType, TokenType::T_EOF);
+    ASSERT_EQ(result[5].tokenType(), TokenType::T_EOF);
 }
 
 TEST(LexerTest, LexProcedureDeclaration)
@@ -117,23 +122,23 @@ TEST(LexerTest, LexProcedureDeclaration)
     END;)");
 
     EXPECT_EQ(result.size(), 7);
-    ASSERT_EQ(result[0].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[0].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[0].lexical(), "procedure"sv);
-    ASSERT_EQ(result[0].row, 1);
-    ASSERT_EQ(result[1].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[0].row(), 1);
+    ASSERT_EQ(result[1].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[1].lexical(), "MyProc"sv);
-    ASSERT_EQ(result[2].tokenType, TokenType::SEMICOLON);
+    ASSERT_EQ(result[2].tokenType(), TokenType::SEMICOLON);
     ASSERT_EQ(result[2].lexical(), ";"sv);
-    ASSERT_EQ(result[3].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[3].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[3].lexical(), "Begin"sv);
-    ASSERT_EQ(result[3].row, 2);
-    ASSERT_EQ(result[4].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[3].row(), 2);
+    ASSERT_EQ(result[4].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[4].lexical(), "END"sv);
-    ASSERT_EQ(result[4].row, 4);
-    ASSERT_EQ(result[5].tokenType, TokenType::SEMICOLON);
+    ASSERT_EQ(result[4].row(), 4);
+    ASSERT_EQ(result[5].tokenType(), TokenType::SEMICOLON);
     ASSERT_EQ(result[5].lexical(), ";"sv);
 
-    ASSERT_EQ(result[6].tokenType, TokenType::T_EOF);
+    ASSERT_EQ(result[6].tokenType(), TokenType::T_EOF);
 }
 
 TEST(LexerTest, LexProcedureDeclarationWithArgs)
@@ -146,41 +151,41 @@ TEST(LexerTest, LexProcedureDeclarationWithArgs)
     END;)");
 
     EXPECT_EQ(result.size(), 16);
-    ASSERT_EQ(result[0].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[0].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[0].lexical(), "procedure"sv);
-    ASSERT_EQ(result[1].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[1].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[1].lexical(), "MyProc"sv);
-    ASSERT_EQ(result[2].tokenType, TokenType::LEFT_CURLY);
+    ASSERT_EQ(result[2].tokenType(), TokenType::LEFT_CURLY);
     ASSERT_EQ(result[2].lexical(), "("sv);
-    ASSERT_EQ(result[3].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[3].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[3].lexical(), "arg1"sv);
-    ASSERT_EQ(result[4].tokenType, TokenType::COLON);
+    ASSERT_EQ(result[4].tokenType(), TokenType::COLON);
     ASSERT_EQ(result[4].lexical(), ":"sv);
-    ASSERT_EQ(result[5].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[5].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[5].lexical(), "integer"sv);
-    ASSERT_EQ(result[6].tokenType, TokenType::SEMICOLON);
+    ASSERT_EQ(result[6].tokenType(), TokenType::SEMICOLON);
     ASSERT_EQ(result[6].lexical(), ";"sv);
 
-    ASSERT_EQ(result[7].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[7].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[7].lexical(), "arg2"sv);
-    ASSERT_EQ(result[8].tokenType, TokenType::COLON);
+    ASSERT_EQ(result[8].tokenType(), TokenType::COLON);
     ASSERT_EQ(result[8].lexical(), ":"sv);
-    ASSERT_EQ(result[9].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[9].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[9].lexical(), "real"sv);
-    ASSERT_EQ(result[10].tokenType, TokenType::RIGHT_CURLY);
+    ASSERT_EQ(result[10].tokenType(), TokenType::RIGHT_CURLY);
     ASSERT_EQ(result[10].lexical(), ")"sv);
 
-    ASSERT_EQ(result[11].tokenType, TokenType::SEMICOLON);
+    ASSERT_EQ(result[11].tokenType(), TokenType::SEMICOLON);
     ASSERT_EQ(result[11].lexical(), ";"sv);
-    ASSERT_EQ(result[12].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[12].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[12].lexical(), "Begin"sv);
 
-    ASSERT_EQ(result[13].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[13].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[13].lexical(), "END"sv);
-    ASSERT_EQ(result[14].tokenType, TokenType::SEMICOLON);
+    ASSERT_EQ(result[14].tokenType(), TokenType::SEMICOLON);
     ASSERT_EQ(result[14].lexical(), ";"sv);
 
-    ASSERT_EQ(result[15].tokenType, TokenType::T_EOF);
+    ASSERT_EQ(result[15].tokenType(), TokenType::T_EOF);
 }
 
 TEST(LexerTest, LexFunctionDeclaration)
@@ -195,38 +200,38 @@ TEST(LexerTest, LexFunctionDeclaration)
     END;)");
 
     EXPECT_EQ(result.size(), 14);
-    ASSERT_EQ(result[0].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[0].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[0].lexical(), "function"sv);
-    ASSERT_EQ(result[1].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[1].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[1].lexical(), "MyFunc"sv);
-    ASSERT_EQ(result[2].tokenType, TokenType::COLON);
+    ASSERT_EQ(result[2].tokenType(), TokenType::COLON);
     ASSERT_EQ(result[2].lexical(), ":"sv);
-    ASSERT_EQ(result[3].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[3].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[3].lexical(), "integer"sv);
 
-    ASSERT_EQ(result[4].tokenType, TokenType::SEMICOLON);
+    ASSERT_EQ(result[4].tokenType(), TokenType::SEMICOLON);
     ASSERT_EQ(result[4].lexical(), ";"sv);
-    ASSERT_EQ(result[5].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[5].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[5].lexical(), "Begin"sv);
-    ASSERT_EQ(result[6].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[6].tokenType(), TokenType::NAMEDTOKEN);
 
     ASSERT_EQ(result[6].lexical(), "MyFunc"sv);
-    ASSERT_EQ(result[7].tokenType, TokenType::COLON);
+    ASSERT_EQ(result[7].tokenType(), TokenType::COLON);
     ASSERT_EQ(result[7].lexical(), ":"sv);
-    ASSERT_EQ(result[8].tokenType, TokenType::EQUAL);
+    ASSERT_EQ(result[8].tokenType(), TokenType::EQUAL);
     ASSERT_EQ(result[8].lexical(), "="sv);
-    ASSERT_EQ(result[9].tokenType, TokenType::NUMBER);
+    ASSERT_EQ(result[9].tokenType(), TokenType::NUMBER);
     ASSERT_EQ(result[9].lexical(), "100"sv);
-    ASSERT_EQ(result[10].tokenType, TokenType::SEMICOLON);
+    ASSERT_EQ(result[10].tokenType(), TokenType::SEMICOLON);
     ASSERT_EQ(result[10].lexical(), ";"sv);
-    ASSERT_EQ(result[11].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[11].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[11].lexical(), "END"sv);
-    ASSERT_EQ(result[11].row, 6);
-    ASSERT_EQ(result[12].tokenType, TokenType::SEMICOLON);
+    ASSERT_EQ(result[11].row(), 6);
+    ASSERT_EQ(result[12].tokenType(), TokenType::SEMICOLON);
     ASSERT_EQ(result[12].lexical(), ";"sv);
-    ASSERT_EQ(result[12].row, 6);
+    ASSERT_EQ(result[12].row(), 6);
 
-    ASSERT_EQ(result[13].tokenType, TokenType::T_EOF);
+    ASSERT_EQ(result[13].tokenType(), TokenType::T_EOF);
 }
 TEST(LexerTest, LexQuotedString)
 {
@@ -235,13 +240,13 @@ TEST(LexerTest, LexQuotedString)
     auto result = lexer.tokenize("filename.pas", R"(str4 := 'this is a ''quoted'' string'; )");
 
     EXPECT_EQ(result.size(), 6);
-    ASSERT_EQ(result[0].tokenType, TokenType::NAMEDTOKEN);
-    ASSERT_EQ(result[1].tokenType, TokenType::COLON);
-    ASSERT_EQ(result[2].tokenType, TokenType::EQUAL);
-    ASSERT_EQ(result[3].tokenType, TokenType::STRING);
+    ASSERT_EQ(result[0].tokenType(), TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[1].tokenType(), TokenType::COLON);
+    ASSERT_EQ(result[2].tokenType(), TokenType::EQUAL);
+    ASSERT_EQ(result[3].tokenType(), TokenType::STRING);
     ASSERT_EQ(result[3].lexical(), "this is a ''quoted'' string"s);
-    ASSERT_EQ(result[4].tokenType, TokenType::SEMICOLON);
-    ASSERT_EQ(result[5].tokenType, TokenType::T_EOF);
+    ASSERT_EQ(result[4].tokenType(), TokenType::SEMICOLON);
+    ASSERT_EQ(result[5].tokenType(), TokenType::T_EOF);
 }
 
 
@@ -253,13 +258,13 @@ TEST(LexerTest, LexEscapedString)
     auto result = lexer.tokenize("filename.pas", R"(str4 := #13#10; )");
 
     EXPECT_EQ(result.size(), 6);
-    ASSERT_EQ(result[0].tokenType, TokenType::NAMEDTOKEN);
-    ASSERT_EQ(result[1].tokenType, TokenType::COLON);
-    ASSERT_EQ(result[2].tokenType, TokenType::EQUAL);
-    ASSERT_EQ(result[3].tokenType, TokenType::ESCAPED_STRING);
+    ASSERT_EQ(result[0].tokenType(), TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[1].tokenType(), TokenType::COLON);
+    ASSERT_EQ(result[2].tokenType(), TokenType::EQUAL);
+    ASSERT_EQ(result[3].tokenType(), TokenType::ESCAPED_STRING);
     ASSERT_EQ(result[3].lexical(), "#13#10"sv);
-    ASSERT_EQ(result[4].tokenType, TokenType::SEMICOLON);
-    ASSERT_EQ(result[5].tokenType, TokenType::T_EOF);
+    ASSERT_EQ(result[4].tokenType(), TokenType::SEMICOLON);
+    ASSERT_EQ(result[5].tokenType(), TokenType::T_EOF);
 }
 
 TEST(LexerTest, LexPointer)
@@ -269,18 +274,18 @@ TEST(LexerTest, LexPointer)
     auto result = lexer.tokenize("filename.pas", R"(ptr := @myvar; )");
 
     EXPECT_EQ(result.size(), 7);
-    ASSERT_EQ(result[0].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[0].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[0].lexical(), "ptr"sv);
-    ASSERT_EQ(result[1].tokenType, TokenType::COLON);
-    ASSERT_EQ(result[2].tokenType, TokenType::EQUAL);
-    ASSERT_EQ(result[3].tokenType, TokenType::AT);
-    ASSERT_EQ(result[3].col, 8);
+    ASSERT_EQ(result[1].tokenType(), TokenType::COLON);
+    ASSERT_EQ(result[2].tokenType(), TokenType::EQUAL);
+    ASSERT_EQ(result[3].tokenType(), TokenType::AT);
+    ASSERT_EQ(result[3].col(), 8);
     ASSERT_EQ(result[3].lexical(), "@"sv);
-    ASSERT_EQ(result[4].tokenType, TokenType::NAMEDTOKEN);
-    ASSERT_EQ(result[4].col, 9);
+    ASSERT_EQ(result[4].tokenType(), TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[4].col(), 9);
     ASSERT_EQ(result[4].lexical(), "myvar"sv);
-    ASSERT_EQ(result[5].tokenType, TokenType::SEMICOLON);
-    ASSERT_EQ(result[6].tokenType, TokenType::T_EOF);
+    ASSERT_EQ(result[5].tokenType(), TokenType::SEMICOLON);
+    ASSERT_EQ(result[6].tokenType(), TokenType::T_EOF);
 }
 
 TEST(LexerTest, LexUnit)
@@ -306,40 +311,40 @@ TEST(LexerTest, LexUnit)
  end.)");
 
     EXPECT_EQ(result.size(), 16);
-    ASSERT_EQ(result[0].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[0].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[0].lexical(), "unit"sv);
-    ASSERT_EQ(result[1].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[1].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[1].lexical(), "unitname"sv);
-    ASSERT_EQ(result[2].tokenType, TokenType::SEMICOLON);
+    ASSERT_EQ(result[2].tokenType(), TokenType::SEMICOLON);
     ASSERT_EQ(result[2].lexical(), ";"sv);
-    ASSERT_EQ(result[3].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[3].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[3].lexical(), "interface"sv);
-    ASSERT_EQ(result[4].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[4].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[4].lexical(), "uses"sv);
-    ASSERT_EQ(result[5].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[5].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[5].lexical(), "myimport"sv);
-    ASSERT_EQ(result[6].tokenType, TokenType::SEMICOLON);
+    ASSERT_EQ(result[6].tokenType(), TokenType::SEMICOLON);
     ASSERT_EQ(result[6].lexical(), ";"sv);
 
-    ASSERT_EQ(result[7].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[7].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[7].lexical(), "implementation"sv);
-    ASSERT_EQ(result[8].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[8].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[8].lexical(), "uses"sv);
-    ASSERT_EQ(result[9].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[9].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[9].lexical(), "import2"sv);
-    ASSERT_EQ(result[10].tokenType, TokenType::SEMICOLON);
+    ASSERT_EQ(result[10].tokenType(), TokenType::SEMICOLON);
     ASSERT_EQ(result[10].lexical(), ";"sv);
-    ASSERT_EQ(result[11].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[11].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[11].lexical(), "initialization"sv);
-    ASSERT_EQ(result[12].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[12].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[12].lexical(), "finalization"sv);
 
-    ASSERT_EQ(result[13].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[13].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[13].lexical(), "end"sv);
-    ASSERT_EQ(result[14].tokenType, TokenType::DOT);
+    ASSERT_EQ(result[14].tokenType(), TokenType::DOT);
     ASSERT_EQ(result[14].lexical(), "."sv);
 
-    ASSERT_EQ(result[15].tokenType, TokenType::T_EOF);
+    ASSERT_EQ(result[15].tokenType(), TokenType::T_EOF);
 }
 
 
@@ -355,21 +360,21 @@ TEST(LexerTest, LexMacroSimple)
 )");
 
     EXPECT_EQ(result.size(), 8);
-    ASSERT_EQ(result[0].tokenType, TokenType::MACRO_START);
+    ASSERT_EQ(result[0].tokenType(), TokenType::MACRO_START);
     ASSERT_EQ(result[0].lexical(), "{$"sv);
-    ASSERT_EQ(result[1].tokenType, TokenType::MACROKEYWORD);
+    ASSERT_EQ(result[1].tokenType(), TokenType::MACROKEYWORD);
     ASSERT_EQ(result[1].lexical(), "ifdef"sv);
-    ASSERT_EQ(result[2].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[2].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[2].lexical(), "UNIX"sv);
-    ASSERT_EQ(result[3].tokenType, TokenType::MACRO_END);
-    ASSERT_EQ(result[4].tokenType, TokenType::MACRO_START);
+    ASSERT_EQ(result[3].tokenType(), TokenType::MACRO_END);
+    ASSERT_EQ(result[4].tokenType(), TokenType::MACRO_START);
     ASSERT_EQ(result[4].lexical(), "{$"sv);
-    ASSERT_EQ(result[5].tokenType, TokenType::MACROKEYWORD);
+    ASSERT_EQ(result[5].tokenType(), TokenType::MACROKEYWORD);
     ASSERT_EQ(result[5].lexical(), "endif"sv);
-    ASSERT_EQ(result[6].tokenType, TokenType::MACRO_END);
+    ASSERT_EQ(result[6].tokenType(), TokenType::MACRO_END);
 
 
-    ASSERT_EQ(result[7].tokenType, TokenType::T_EOF);
+    ASSERT_EQ(result[7].tokenType(), TokenType::T_EOF);
 }
 
 
@@ -385,64 +390,64 @@ begin
 end.)");
 
     EXPECT_EQ(result.size(), 26);
-    ASSERT_EQ(result[0].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[0].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[0].lexical(), "program"sv);
 
-    ASSERT_EQ(result[1].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[1].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[1].lexical(), "test"sv);
 
-    ASSERT_EQ(result[2].tokenType, TokenType::SEMICOLON);
+    ASSERT_EQ(result[2].tokenType(), TokenType::SEMICOLON);
     ASSERT_EQ(result[2].lexical(), ";"sv);
 
-    ASSERT_EQ(result[3].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[3].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[3].lexical(), "begin"sv);
 
-    ASSERT_EQ(result[4].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[4].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[4].lexical(), "for"sv);
 
 
-    ASSERT_EQ(result[5].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[5].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[5].lexical(), "i"sv);
-    ASSERT_EQ(result[5].row, 3);
-    ASSERT_EQ(result[5].col, 9);
+    ASSERT_EQ(result[5].row(), 3);
+    ASSERT_EQ(result[5].col(), 9);
 
-    ASSERT_EQ(result[6].tokenType, TokenType::COLON);
+    ASSERT_EQ(result[6].tokenType(), TokenType::COLON);
     ASSERT_EQ(result[6].lexical(), ":"sv);
-    ASSERT_EQ(result[6].row, 3);
-    ASSERT_EQ(result[6].col, 11);
+    ASSERT_EQ(result[6].row(), 3);
+    ASSERT_EQ(result[6].col(), 11);
 
-    ASSERT_EQ(result[7].tokenType, TokenType::EQUAL);
+    ASSERT_EQ(result[7].tokenType(), TokenType::EQUAL);
     ASSERT_EQ(result[7].lexical(), "="sv);
-    ASSERT_EQ(result[7].row, 3);
-    ASSERT_EQ(result[7].col, 12);
+    ASSERT_EQ(result[7].row(), 3);
+    ASSERT_EQ(result[7].col(), 12);
 
-    ASSERT_EQ(result[8].tokenType, TokenType::NUMBER);
+    ASSERT_EQ(result[8].tokenType(), TokenType::NUMBER);
     ASSERT_EQ(result[8].lexical(), "0"sv);
-    ASSERT_EQ(result[8].row, 3);
-    ASSERT_EQ(result[8].col, 14);
+    ASSERT_EQ(result[8].row(), 3);
+    ASSERT_EQ(result[8].col(), 14);
 
-    ASSERT_EQ(result[9].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[9].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[9].lexical(), "to"sv);
-    ASSERT_EQ(result[9].row, 3);
-    ASSERT_EQ(result[9].col, 16);
+    ASSERT_EQ(result[9].row(), 3);
+    ASSERT_EQ(result[9].col(), 16);
 
-    ASSERT_EQ(result[10].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[10].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[10].lexical(), "high"sv);
-    ASSERT_EQ(result[10].row, 3);
-    ASSERT_EQ(result[10].col, 19);
+    ASSERT_EQ(result[10].row(), 3);
+    ASSERT_EQ(result[10].col(), 19);
 
-    ASSERT_EQ(result[11].tokenType, TokenType::LEFT_CURLY);
+    ASSERT_EQ(result[11].tokenType(), TokenType::LEFT_CURLY);
     ASSERT_EQ(result[11].lexical(), "("sv);
-    ASSERT_EQ(result[11].row, 3);
-    ASSERT_EQ(result[11].col, 23);
+    ASSERT_EQ(result[11].row(), 3);
+    ASSERT_EQ(result[11].col(), 23);
 
-    ASSERT_EQ(result[12].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[12].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[12].lexical(), "arr"sv);
-    ASSERT_EQ(result[12].row, 3);
-    ASSERT_EQ(result[12].col, 24);
-    ASSERT_EQ(result[12].sourceLocation.num_bytes, 3);
+    ASSERT_EQ(result[12].row(), 3);
+    ASSERT_EQ(result[12].col(), 24);
+    ASSERT_EQ(result[12].sourceLocation.num_bytes, 3u);
 
-    // ASSERT_EQ(result[7].tokenType, TokenType::T_EOF);
+    // ASSERT_EQ(result[7].tokenType(), TokenType::T_EOF);
 }
 
 
@@ -455,34 +460,34 @@ TEST(LexerTest, LexFloatNumber)
 )");
     EXPECT_EQ(result.size(), 11);
     size_t i = 0;
-    ASSERT_EQ(result[i].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[i].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[i].lexical(), "myVar"sv);
     i++;
-    ASSERT_EQ(result[i].tokenType, TokenType::COLON);
+    ASSERT_EQ(result[i].tokenType(), TokenType::COLON);
     ASSERT_EQ(result[i].lexical(), ":"sv);
     i++;
-    ASSERT_EQ(result[i].tokenType, TokenType::EQUAL);
+    ASSERT_EQ(result[i].tokenType(), TokenType::EQUAL);
     ASSERT_EQ(result[i].lexical(), "="sv);
     i++;
-    ASSERT_EQ(result[i].tokenType, TokenType::NUMBER);
+    ASSERT_EQ(result[i].tokenType(), TokenType::NUMBER);
     ASSERT_EQ(result[i].lexical(), "2.55"sv);
     i++;
-    ASSERT_EQ(result[i].tokenType, TokenType::SEMICOLON);
+    ASSERT_EQ(result[i].tokenType(), TokenType::SEMICOLON);
     ASSERT_EQ(result[i].lexical(), ";"sv);
     i++;
-    ASSERT_EQ(result[i].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[i].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[i].lexical(), "myVar"sv);
     i++;
-    ASSERT_EQ(result[i].tokenType, TokenType::COLON);
+    ASSERT_EQ(result[i].tokenType(), TokenType::COLON);
     ASSERT_EQ(result[i].lexical(), ":"sv);
     i++;
-    ASSERT_EQ(result[i].tokenType, TokenType::EQUAL);
+    ASSERT_EQ(result[i].tokenType(), TokenType::EQUAL);
     ASSERT_EQ(result[i].lexical(), "="sv);
     i++;
-    ASSERT_EQ(result[i].tokenType, TokenType::NUMBER);
+    ASSERT_EQ(result[i].tokenType(), TokenType::NUMBER);
     ASSERT_EQ(result[i].lexical(), "-3.14"sv);
     i++;
-    ASSERT_EQ(result[i].tokenType, TokenType::SEMICOLON);
+    ASSERT_EQ(result[i].tokenType(), TokenType::SEMICOLON);
     ASSERT_EQ(result[i].lexical(), ";"sv);
 }
 
@@ -495,30 +500,280 @@ TEST(LexerTest, ParseArray)
 )");
     EXPECT_EQ(result.size(), 13);
     size_t i = 0;
-    ASSERT_EQ(result[i].tokenType, TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[i].tokenType(), TokenType::NAMEDTOKEN);
     ASSERT_EQ(result[i].lexical(), "buffer"sv);
     i++;
-    ASSERT_EQ(result[i].tokenType, TokenType::COLON);
+    ASSERT_EQ(result[i].tokenType(), TokenType::COLON);
     ASSERT_EQ(result[i].lexical(), ":"sv);
     i++;
-    ASSERT_EQ(result[i].tokenType, TokenType::KEYWORD);
+    ASSERT_EQ(result[i].tokenType(), TokenType::KEYWORD);
     ASSERT_EQ(result[i].lexical(), "array"sv);
     i++;
-    ASSERT_EQ(result[i].tokenType, TokenType::LEFT_SQUAR);
+    ASSERT_EQ(result[i].tokenType(), TokenType::LEFT_SQUAR);
     ASSERT_EQ(result[i].lexical(), "["sv);
     i++;
-    ASSERT_EQ(result[i].tokenType, TokenType::NUMBER);
+    ASSERT_EQ(result[i].tokenType(), TokenType::NUMBER);
     ASSERT_EQ(result[i].lexical(), "0"sv);
     i++;
-    ASSERT_EQ(result[i].tokenType, TokenType::DOT);
+    ASSERT_EQ(result[i].tokenType(), TokenType::DOT);
     ASSERT_EQ(result[i].lexical(), "."sv);
     i++;
-    ASSERT_EQ(result[i].tokenType, TokenType::DOT);
+    ASSERT_EQ(result[i].tokenType(), TokenType::DOT);
     ASSERT_EQ(result[i].lexical(), "."sv);
     i++;
-    ASSERT_EQ(result[i].tokenType, TokenType::NUMBER);
+    ASSERT_EQ(result[i].tokenType(), TokenType::NUMBER);
     ASSERT_EQ(result[i].lexical(), "100"sv);
     i++;
-    ASSERT_EQ(result[i].tokenType, TokenType::RIGHT_SQUAR);
+    ASSERT_EQ(result[i].tokenType(), TokenType::RIGHT_SQUAR);
     ASSERT_EQ(result[i].lexical(), "]"sv);
 }
+
+TEST(LexerTest, LexKeywords)
+{
+    Lexer lexer;
+
+    auto result = lexer.tokenize("filename.pas", R"(BEGIN Begins Downto {$IfDef UNIX} else {$ENDIF} end)");
+
+    ASSERT_EQ(result.size(), 13);
+    ASSERT_EQ(result[0].tokenType(), TokenType::KEYWORD);
+    ASSERT_EQ(result[0].keyword(), Keyword::BEGIN);
+    ASSERT_EQ(result[1].tokenType(), TokenType::NAMEDTOKEN);
+    ASSERT_EQ(result[1].keyword(), Keyword::NONE);
+    ASSERT_EQ(result[2].keyword(), Keyword::DOWNTO);
+    ASSERT_EQ(result[4].tokenType(), TokenType::MACROKEYWORD);
+    ASSERT_EQ(result[4].keyword(), Keyword::IFDEF);
+    ASSERT_EQ(result[7].tokenType(), TokenType::KEYWORD);
+    ASSERT_EQ(result[7].keyword(), Keyword::ELSE);
+    ASSERT_EQ(result[9].tokenType(), TokenType::MACROKEYWORD);
+    ASSERT_EQ(result[9].keyword(), Keyword::ENDIF);
+    ASSERT_EQ(result[11].keyword(), Keyword::END);
+}
+
+TEST(LexerTest, LexIdentifiers)
+{
+    Lexer lexer;
+
+    auto result = lexer.tokenize("filename.pas", R"(Counter counter COUNTER count_2 begin)");
+
+    ASSERT_EQ(result.size(), 6);
+    ASSERT_NE(result[0].identifier(), Identifier::NONE);
+    ASSERT_EQ(result[0].identifier(), result[1].identifier());
+    ASSERT_EQ(result[0].identifier(), result[2].identifier());
+    ASSERT_NE(result[0].identifier(), result[3].identifier());
+    ASSERT_EQ(result[4].identifier(), Identifier::NONE);
+    ASSERT_EQ(Identifiers::name(result[2].identifier()), "counter");
+    ASSERT_EQ(Identifiers::find("cOuNt_2"), result[3].identifier());
+    ASSERT_EQ(Identifiers::find("not_interned_yet"), Identifier::NONE);
+}
+
+TEST(LexerTest, StreamMacros)
+{
+    const std::string source = R"(
+    {$ifdef UNIX}
+        a
+        {$ifdef WINDOWS} b {$else} c {$endif}
+    {$else}
+        {$define(WINDOWS)}
+        {$ifdef UNIX} d {$endif}
+    {$endif}
+    {$ifdef WINDOWS} e {$endif}
+    f)";
+
+    MacroParser macroParser({{"UNIX", true}}, std::make_unique<LexerSource>("filename.pas", source));
+    std::vector<Token> result;
+    do
+    {
+        result.push_back(macroParser.nextToken());
+    }
+    while (result.back().tokenType() != TokenType::T_EOF);
+
+    // the tokens of a nested block are only used if all enclosing branches are used
+    ASSERT_EQ(result.size(), 4);
+    ASSERT_EQ(result[0].lexical(), "a"sv);
+    ASSERT_EQ(result[1].lexical(), "c"sv);
+    ASSERT_EQ(result[2].lexical(), "f"sv);
+    ASSERT_EQ(result[3].tokenType(), TokenType::T_EOF);
+
+    // the same tokens are produced from an already tokenized file
+    auto tokens = MacroParser({{"UNIX", true}}).parseFile(Lexer().tokenize("filename.pas", source));
+    ASSERT_EQ(tokens.size(), result.size());
+    for (size_t i = 0; i < tokens.size(); ++i)
+    {
+        ASSERT_EQ(tokens[i].lexical(), result[i].lexical());
+    }
+
+    MacroParser unterminated({}, std::make_unique<LexerSource>("filename.pas", "{$ifdef UNIX} a"));
+    const auto readAll = [&unterminated]
+    {
+        while (unterminated.nextToken().tokenType() != TokenType::T_EOF)
+        {
+        }
+    };
+    ASSERT_THROW(readAll(), CompilerException);
+}
+
+TEST(LexerTest, LexCommentsAndStrings)
+{
+    Lexer lexer;
+
+    auto result = lexer.tokenize("filename.pas", "a {} b //\nc { x\ny } 'it''s' 'a''' d");
+
+    ASSERT_EQ(result.size(), 7);
+    ASSERT_EQ(result[0].lexical(), "a"sv);
+    ASSERT_EQ(result[1].lexical(), "b"sv);
+    ASSERT_EQ(result[2].lexical(), "c"sv);
+    ASSERT_EQ(result[2].row(), 2u);
+    ASSERT_EQ(result[3].tokenType(), TokenType::STRING);
+    ASSERT_EQ(result[3].lexical(), "it''s"sv);
+    ASSERT_EQ(result[4].tokenType(), TokenType::STRING);
+    ASSERT_EQ(result[4].lexical(), "a''"sv);
+    ASSERT_EQ(result[5].lexical(), "d"sv);
+    ASSERT_EQ(result[5].row(), 3u);
+}
+
+TEST(LexerTest, ScanKernels)
+{
+    // the inputs are longer than the vector width and have the matches at every position of a block
+    for (size_t length = 0; length < 100; ++length)
+    {
+        for (size_t match = 0; match <= length; ++match)
+        {
+            std::string text(length, 'a');
+            if (match < length)
+            {
+                text[match] = '}';
+            }
+            for (size_t start = 0; start <= length; start += 7)
+            {
+                const size_t expected = start <= match ? match : length;
+                ASSERT_EQ(scanForChar(text, start, '}'), expected);
+                ASSERT_EQ(scanIdentifierEnd(text, start), expected);
+            }
+            ASSERT_EQ(countChar(text, '}'), match < length ? 1u : 0u);
+        }
+    }
+    const std::string identifiers = "azAZ09_@[`{/:\x80";
+    ASSERT_EQ(scanIdentifierEnd(identifiers, 0), 7u);
+    for (size_t i = 7; i < identifiers.size(); ++i)
+    {
+        ASSERT_EQ(scanIdentifierEnd(identifiers, i), i);
+    }
+}
+
+TEST(LexerTest, LexMappedFile)
+{
+    const auto path = std::filesystem::temp_directory_path() / "wirthx_mapped_file_test.pas";
+    {
+        // larger than a few pages, so the file is memory mapped and not read
+        std::ofstream file(path, std::ios::trunc);
+        for (int i = 0; i < 10000; ++i)
+        {
+            file << "x" << i << " := " << i << ";\n";
+        }
+    }
+    const auto file = SourceFiles::map("mapped.pas", path);
+    ASSERT_TRUE(file.has_value());
+    const auto fileId = file->fileId();
+    ASSERT_EQ(SourceFiles::filename(fileId), "mapped.pas");
+    ASSERT_EQ(SourceFiles::source(fileId).size(), std::filesystem::file_size(path));
+    // mapping the unchanged file again reuses its entry
+    ASSERT_EQ(SourceFiles::map("mapped.pas", path)->fileId(), fileId);
+
+    auto result = Lexer().tokenize(fileId);
+    ASSERT_EQ(result.size(), 50001u);
+    ASSERT_EQ(result[49995].lexical(), "x9999"sv);
+    ASSERT_EQ(result[49995].row(), 10000u);
+    ASSERT_FALSE(SourceFiles::map("missing.pas", path.parent_path() / "wirthx_missing_file.pas").has_value());
+    std::filesystem::remove(path);
+}
+
+TEST(LexerTest, MappedFileTruncatedOnDisk)
+{
+    const auto path = std::filesystem::temp_directory_path() / "wirthx_truncated_file_test.pas";
+    {
+        std::ofstream file(path, std::ios::trunc);
+        for (int i = 0; i < 10000; ++i)
+        {
+            file << "x" << i << " := " << i << ";\n";
+        }
+    }
+    // the unreferenced mapping is kept as the latest version of the file
+    auto source = std::string(SourceFiles::source(SourceFiles::map("truncated.pas", path)->fileId()));
+    std::filesystem::resize_file(path, 16);
+
+    // the pages of the old mapping behind the new end of the file can not be read anymore, a version which only
+    // differs at its end must not be compared with it
+    source.back() = ' ';
+    const auto edited = SourceFiles::add("truncated.pas", source);
+    ASSERT_EQ(SourceFiles::source(edited.fileId()), source);
+    const auto file = SourceFiles::map("truncated.pas", path);
+    ASSERT_TRUE(file.has_value());
+    ASSERT_EQ(SourceFiles::source(file->fileId()).size(), 16u);
+    std::filesystem::remove(path);
+}
+
+TEST(LexerTest, LexInParallel)
+{
+    // fragments whose comments, strings and macros span line breaks, so they reach into the following chunks
+    const std::vector<std::string> fragments = {
+            "program Test;\n", "x := (1 + 2) * 5;\n", "a := -5 - b;\n", "{ a comment\n over\n lines }", "{}",
+            "// line comment { '\n", "'a string\n over lines'", "'it''s'", "'a'''", "#13#10", "#", "3.14 ",
+            "{$ifdef UNIX}\n", "{$else}\n", "{$endif}\n", "{$define X\n}", "begin\n", "end;\n", " ", "\n", "\n\n",
+            "{", "}", "'", "if a <= b then\n", "WriteLn('HelloWorld');\n", "@p^.x", "$", "value_1"};
+    std::mt19937 random(42);
+    for (int corpus = 0; corpus < 8; ++corpus)
+    {
+        std::string source;
+        while (source.size() < 200000)
+        {
+            source += fragments[random() % fragments.size()];
+        }
+        const auto file = SourceFiles::add("parallel" + std::to_string(corpus) + ".pas", source);
+        const auto fileId = file.fileId();
+        const auto expected = Lexer().tokenize(fileId);
+        for (const size_t chunkCount: {2u, 3u, 7u, 16u, 64u})
+        {
+            const auto result = Lexer().tokenize(fileId, chunkCount);
+            ASSERT_EQ(result.size(), expected.size());
+            for (size_t i = 0; i < expected.size(); ++i)
+            {
+                ASSERT_EQ(result[i].tokenType(), expected[i].tokenType());
+                ASSERT_EQ(result[i].keyword(), expected[i].keyword());
+                ASSERT_EQ(result[i].identifier(), expected[i].identifier());
+                ASSERT_EQ(result[i].sourceLocation.byte_offset, expected[i].sourceLocation.byte_offset);
+                ASSERT_EQ(result[i].sourceLocation.num_bytes, expected[i].sourceLocation.num_bytes);
+            }
+        }
+    }
+    // a short file is not split further than its lines
+    const auto shortFile = SourceFiles::add("short.pas", "a\nb");
+    ASSERT_EQ(Lexer().tokenize(shortFile.fileId(), 16).size(), 3u);
+}
+
+TEST(LexerTest, SourceFilesReleaseReplacedVersions)
+{
+    auto first = SourceFiles::add("edited.pas", "first");
+    const auto firstId = first.fileId();
+    {
+        // a replaced version stays readable while it is referenced
+        const auto second = SourceFiles::add("edited.pas", "second");
+        ASSERT_NE(second.fileId(), firstId);
+        ASSERT_EQ(SourceFiles::source(firstId), "first"sv);
+        ASSERT_EQ(SourceFiles::add("edited.pas", "second").fileId(), second.fileId());
+    }
+    first = SourceFileReference();
+
+    // every edit replaces the previous version, so the ids of the freed versions are reused
+    std::set<uint32_t> fileIds;
+    for (int edit = 0; edit < 10000; ++edit)
+    {
+        const auto file = SourceFiles::add("edited.pas", "edit " + std::to_string(edit));
+        ASSERT_EQ(SourceFiles::source(file.fileId()), "edit " + std::to_string(edit));
+        fileIds.insert(file.fileId());
+    }
+    ASSERT_LE(fileIds.size(), 2u);
+
+    // the latest version is kept without references, so reading the same content again does not copy it
+    const auto latestId = SourceFiles::add("edited.pas", "edit 9999").fileId();
+    ASSERT_EQ(SourceFiles::add("edited.pas", "edit 9999").fileId(), latestId);
+}
@@ -0,0 +1,13 @@
+unit diamondunit;
+
+interface
+    uses testunit;
+
+    function t84(): integer;
+
+implementation
+    function t84(): integer;
+    begin
+        t84 := t42() * 2;
+    end;
+end.
\ No newline at end of file
@@ -0,0 +1,37 @@
+program expressions;
+
+var
+    a, b, c : integer;
+    x, y : integer;
+    flag : boolean;
+begin
+    a := 2;
+    b := 3;
+    c := 4;
+    writeln(a + b * c);
+    writeln(a - b - c);
+    writeln(c * b div a mod 4);
+    writeln((a + b) * c);
+
+    x := 9;
+    y := 0;
+    if x mod 3 = 0 or y > 1 then
+        writeln('x mod 3 = 0 or y > 1');
+    if not a = b then
+        writeln('not a = b');
+    if a <> b then
+        writeln('a <> b');
+    if not (a <> 2) then
+        writeln('not (a <> 2)');
+
+    // and binds stronger than or
+    if a = 2 or b = 0 and c = 0 then
+        writeln('a = 2 or (b = 0 and c = 0)');
+    if (a = 2 or b = 0) and c = 0 then
+        writeln('unreachable')
+    else
+        writeln('(a = 2 or b = 0) and c = 0 is false');
+    flag := a < b and b < c;
+    if flag then
+        writeln('a < b and b < c');
+end.
@@ -0,0 +1,25 @@
+program shadowing;
+
+const
+    value = 10;
+    limit = 3;
+
+function twice(value : integer) : integer;
+begin
+    twice := value * 2;
+end;
+
+function localLimit() : integer;
+var
+    limit : integer;
+begin
+    limit := 7;
+    localLimit := limit;
+end;
+
+begin
+    writeln(twice(4));
+    writeln(localLimit());
+    writeln(value);
+    writeln(limit);
+end.
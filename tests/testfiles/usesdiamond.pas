@@ -0,0 +1,8 @@
+program usesdiamond;
+uses testunit, diamondunit;
+var
+    x : integer;
+begin
+    x := t42() + t84();
+    writeln(x);
+end.
\ No newline at end of file